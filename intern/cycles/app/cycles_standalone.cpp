@@ -53,6 +53,7 @@ struct Options {
   bool quiet;
   bool show_help, interactive, pause;
   string output_path;
+  string stats_path;
 } options;
 
 static void session_print(const string &str)
@@ -164,9 +165,28 @@ static void session_init()
   options.session->start();
 }
 
+static void session_write_stats()
+{
+  RenderStats stats;
+  options.session->collect_statistics(&stats);
+
+  if (stats.timeline.empty()) {
+    fprintf(stderr, "No timeline events were recorded, statistics are incomplete\n");
+  }
+
+  string report = stats.json_report();
+  if (!path_write_text(options.stats_path, report)) {
+    fprintf(stderr, "Failed to write statistics to %s\n", options.stats_path.c_str());
+  }
+}
+
 static void session_exit()
 {
   if (options.session) {
+    if (!options.stats_path.empty()) {
+      session_write_stats();
+    }
+
     delete options.session;
     options.session = NULL;
   }
@@ -416,6 +436,9 @@ static void options_parse(int argc, const char **argv)
              "--output %s",
              &options.output_path,
              "File path to write output image",
+             "--stats-json %s",
+             &options.stats_path,
+             "File path to write render statistics and timeline as JSON, in Chrome trace format",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
@@ -530,6 +553,12 @@ static void options_parse(int argc, const char **argv)
     exit(EXIT_FAILURE);
   }
 
+  /* Timeline and kernel profiling for statistics export. */
+  if (!options.stats_path.empty()) {
+    options.session_params.use_timeline = true;
+    options.session_params.use_profiling = options.session_params.device.has_profiling;
+  }
+
   /* For smoother Viewport */
   options.session_params.start_resolution = 64;
 }
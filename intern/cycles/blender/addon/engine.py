@@ -70,6 +70,10 @@ def _configure_argument_parser():
     parser.add_argument("--cycles-print-stats",
                         help="Print rendering statistics to stderr",
                         action='store_true')
+    parser.add_argument("--cycles-export-stats",
+                        help="Write rendering statistics and timeline to a JSON file, "
+                        "'#' is replaced by the frame number",
+                        default=None)
     return parser
 
 
@@ -101,6 +105,9 @@ def _parse_command_line():
     if args.cycles_print_stats:
         import _cycles
         _cycles.enable_print_stats()
+    if args.cycles_export_stats is not None:
+        import _cycles
+        _cycles.set_export_stats_path(args.cycles_export_stats)
 
 
 def init():
@@ -349,6 +349,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Sample lights proportional to their estimated contribution to the shading point, "
+        "reduces noise in scenes with many lights (Path Tracing only)",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -757,6 +763,33 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_texture_limit
     )
 
+    use_texture_cache: BoolProperty(
+        name="Use Texture Cache",
+        description="Load image textures on demand from a tiled, mipmapped texture cache instead of fully into memory (CPU only)",
+        default=False,
+    )
+
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Maximum memory used by the texture cache, in megabytes",
+        default=1024,
+        min=1, max=1024 * 1024,
+        subtype='UNSIGNED',
+    )
+
+    use_texture_auto_convert: BoolProperty(
+        name="Auto Convert",
+        description="Convert image textures to tiled, mipmapped .tx files once, for faster loading in later renders",
+        default=True,
+    )
+
+    texture_cache_path: StringProperty(
+        name="Cache Directory",
+        description="Absolute path to store converted textures in, the user cache directory is used when empty",
+        default="",
+        subtype='DIR_PATH',
+    )
+
     ao_bounces: IntProperty(
         name="AO Bounces",
         default=0,
@@ -286,6 +286,10 @@ class CYCLES_RENDER_PT_sampling_advanced(CyclesButtonsPanel, Panel):
         col.prop(cscene, "min_transparent_bounces")
         col.prop(cscene, "light_sampling_threshold", text="Light Threshold")
 
+        if not use_branched_path(context):
+            col = layout.column(align=True)
+            col.prop(cscene, "use_light_tree")
+
         if cscene.progressive != 'PATH' and use_branched_path(context):
             col = layout.column(align=True)
             col.prop(cscene, "sample_all_lights_direct")
@@ -705,6 +709,32 @@ class CYCLES_RENDER_PT_performance_acceleration_structure(CyclesButtonsPanel, Pa
         sub.prop(cscene, "debug_bvh_time_steps")
 
 
+class CYCLES_RENDER_PT_performance_texture_cache(CyclesButtonsPanel, Panel):
+    bl_label = "Texture Cache"
+    bl_parent_id = "CYCLES_RENDER_PT_performance"
+
+    def draw_header(self, context):
+        cscene = context.scene.cycles
+
+        self.layout.prop(cscene, "use_texture_cache", text="")
+
+    def draw(self, context):
+        layout = self.layout
+        layout.use_property_split = True
+        layout.use_property_decorate = False
+
+        scene = context.scene
+        cscene = scene.cycles
+
+        col = layout.column()
+        col.active = cscene.use_texture_cache and use_cpu(context)
+        col.prop(cscene, "texture_cache_size")
+        col.prop(cscene, "use_texture_auto_convert")
+        sub = col.column()
+        sub.active = cscene.use_texture_auto_convert
+        sub.prop(cscene, "texture_cache_path", text="Directory")
+
+
 class CYCLES_RENDER_PT_performance_final_render(CyclesButtonsPanel, Panel):
     bl_label = "Final Render"
     bl_parent_id = "CYCLES_RENDER_PT_performance"
@@ -720,7 +750,7 @@ class CYCLES_RENDER_PT_performance_final_render(CyclesButtonsPanel, Panel):
         col = layout.column()
 
         col.prop(rd, "use_save_buffers")
-        col.prop(rd, "use_persistent_data", text="Persistent Images")
+        col.prop(rd, "use_persistent_data", text="Persistent Data")
 
 
 class CYCLES_RENDER_PT_performance_viewport(CyclesButtonsPanel, Panel):
@@ -2300,6 +2330,7 @@ classes = (
     CYCLES_RENDER_PT_performance_threads,
     CYCLES_RENDER_PT_performance_tiles,
     CYCLES_RENDER_PT_performance_acceleration_structure,
+    CYCLES_RENDER_PT_performance_texture_cache,
     CYCLES_RENDER_PT_performance_final_render,
     CYCLES_RENDER_PT_performance_viewport,
     CYCLES_RENDER_PT_passes,
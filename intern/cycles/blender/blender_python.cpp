@@ -960,6 +960,17 @@ static PyObject *enable_print_stats_func(PyObject * /*self*/, PyObject * /*args*
   Py_RETURN_NONE;
 }
 
+static PyObject *set_export_stats_path_func(PyObject * /*self*/, PyObject *args)
+{
+  const char *path;
+  if (!PyArg_ParseTuple(args, "s", &path)) {
+    return NULL;
+  }
+
+  BlenderSession::export_stats_path = path;
+  Py_RETURN_NONE;
+}
+
 static PyObject *get_device_types_func(PyObject * /*self*/, PyObject * /*args*/)
 {
   vector<DeviceType> device_types = Device::available_types();
@@ -1007,6 +1018,7 @@ static PyMethodDef methods[] = {
 
     /* Statistics. */
     {"enable_print_stats", enable_print_stats_func, METH_NOARGS, ""},
+    {"set_export_stats_path", set_export_stats_path_func, METH_VARARGS, ""},
 
     /* Resumable render */
     {"set_resumable_chunk", set_resumable_chunk_func, METH_VARARGS, ""},
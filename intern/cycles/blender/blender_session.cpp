@@ -38,6 +38,7 @@
 #include "util/util_hash.h"
 #include "util/util_logging.h"
 #include "util/util_murmurhash.h"
+#include "util/util_path.h"
 #include "util/util_progress.h"
 #include "util/util_time.h"
 
@@ -53,6 +54,7 @@ int BlenderSession::current_resumable_chunk = 0;
 int BlenderSession::start_resumable_chunk = 0;
 int BlenderSession::end_resumable_chunk = 0;
 bool BlenderSession::print_render_stats = false;
+string BlenderSession::export_stats_path = "";
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -168,6 +170,9 @@ void BlenderSession::create_session()
 
 void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsgraph)
 {
+  /* Evaluated datablocks only persist when Blender kept the render depsgraph. */
+  const bool is_same_depsgraph = (b_scene.ptr.data == b_depsgraph.scene_eval().ptr.data);
+
   this->b_data = b_data;
   this->b_depsgraph = b_depsgraph;
   this->b_scene = b_depsgraph.scene_eval();
@@ -206,7 +211,7 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
   SceneParams scene_params = BlenderSync::get_scene_params(b_scene, background);
 
   if (scene->params.modified(scene_params) || session->params.modified(session_params) ||
-      !scene_params.persistent_data) {
+      !scene_params.persistent_data || !is_same_depsgraph) {
     /* if scene or session parameters changed, it's easier to simply re-create
      * them rather than trying to distinguish which settings need to be updated
      */
@@ -218,7 +223,6 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
   }
 
   session->progress.reset();
-  scene->reset();
 
   session->tile_manager.set_tile_order(session_params.tile_order);
 
@@ -227,11 +231,14 @@ void BlenderSession::reset_session(BL::BlendData &b_data, BL::Depsgraph &b_depsg
    */
   session->stats.mem_peak = session->stats.mem_used;
 
-  /* There is no single depsgraph to use for the entire render.
-   * See note on create_session().
-   */
-  /* sync object should be re-created */
-  sync = new BlenderSync(b_engine, b_data, b_scene, scene, !background, session->progress);
+  if (!is_new_session) {
+    /* With persistent data the render depsgraph is kept between frames and view
+     * layers, so the existing Cycles nodes still correspond to the same Blender
+     * datablocks. Only sync what changed since the previous render, keeping
+     * unchanged shaders, images and geometry BVHs on the device. */
+    sync->reset(b_data, b_scene);
+    sync->sync_recalc(b_depsgraph, b_v3d);
+  }
 
   BL::SpaceView3D b_null_space_view3d(PointerRNA_NULL);
   BL::RegionView3D b_null_region_view3d(PointerRNA_NULL);
@@ -390,6 +397,38 @@ static void add_cryptomatte_layer(BL::RenderResult &b_rr, string name, string ma
   render_add_metadata(b_rr, prefix + "manifest", manifest);
 }
 
+void BlenderSession::export_render_stats(const string &view_layer_name)
+{
+  /* Replace '#' by the frame number, and add the view layer name when there
+   * are multiple, so every render writes its own file. */
+  string filepath = export_stats_path;
+  size_t pos = filepath.find('#');
+  if (pos != string::npos) {
+    size_t len = filepath.find_first_not_of('#', pos);
+    len = (len == string::npos) ? filepath.size() - pos : len - pos;
+    filepath.replace(pos, len, string_printf("%0*d", (int)len, b_scene.frame_current()));
+  }
+
+  if (b_scene.view_layers.length() > 1) {
+    const string extension = path_filename(filepath).find('.') != string::npos ?
+                                 filepath.substr(filepath.rfind('.')) :
+                                 "";
+    filepath = filepath.substr(0, filepath.size() - extension.size()) + "_" + view_layer_name +
+               extension;
+  }
+
+  RenderStats stats;
+  session->collect_statistics(&stats);
+
+  string report = stats.json_report();
+  if (!path_write_text(filepath, report)) {
+    fprintf(stderr, "Failed to write render statistics to %s\n", filepath.c_str());
+  }
+
+  /* Free the events, the next render starts a new timeline. */
+  scene->timeline.reset();
+}
+
 void BlenderSession::stamp_view_layer_metadata(Scene *scene, const string &view_layer_name)
 {
   BL::RenderResult b_rr = b_engine.get_result();
@@ -565,6 +604,10 @@ void BlenderSession::render(BL::Depsgraph &b_depsgraph_)
       break;
   }
 
+  if (!b_engine.is_preview() && background && !export_stats_path.empty()) {
+    export_render_stats(b_rlay_name);
+  }
+
   /* add metadata */
   stamp_view_layer_metadata(scene, b_rlay_name);
 
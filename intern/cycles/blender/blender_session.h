@@ -149,9 +149,14 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* File to write statistics to as JSON, empty if disabled. */
+  static string export_stats_path;
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
+  void export_render_stats(const string &view_layer_name);
+
   void do_write_update_render_result(BL::RenderLayer &b_rlay,
                                      RenderTile &rtile,
                                      bool do_update_only);
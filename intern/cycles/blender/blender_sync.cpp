@@ -78,6 +78,13 @@ BlenderSync::~BlenderSync()
 {
 }
 
+void BlenderSync::reset(BL::BlendData &b_data, BL::Scene &b_scene)
+{
+  /* Update data and scene pointers for a new render with persistent data. */
+  this->b_data = b_data;
+  this->b_scene = b_scene;
+}
+
 /* Sync */
 
 void BlenderSync::sync_recalc(BL::Depsgraph &b_depsgraph, BL::SpaceView3D &b_v3d)
@@ -301,6 +308,7 @@ void BlenderSync::sync_integrator()
   integrator->sample_all_lights_direct = get_boolean(cscene, "sample_all_lights_direct");
   integrator->sample_all_lights_indirect = get_boolean(cscene, "sample_all_lights_indirect");
   integrator->light_sampling_threshold = get_float(cscene, "light_sampling_threshold");
+  integrator->use_light_tree = get_boolean(cscene, "use_light_tree");
 
   if (RNA_boolean_get(&cscene, "use_adaptive_sampling")) {
     integrator->sampling_pattern = SAMPLING_PATTERN_PMJ;
@@ -353,6 +361,12 @@ void BlenderSync::sync_integrator()
     integrator->ao_bounces = 0;
   }
 
+  /* Light tree is built along with the light distribution. */
+  if (integrator->use_light_tree != previntegrator.use_light_tree ||
+      integrator->method != previntegrator.method) {
+    scene->light_manager->tag_update(scene);
+  }
+
   if (integrator->modified(previntegrator))
     integrator->tag_update(scene);
 }
@@ -700,7 +714,11 @@ void BlenderSync::free_data_after_sync(BL::Depsgraph &b_depsgraph)
    * footprint during synchronization process.
    */
   const bool is_interface_locked = b_engine.render() && b_engine.render().use_lock_interface();
-  const bool can_free_caches = BlenderSession::headless || is_interface_locked;
+  /* Persistent data keeps the depsgraph for the next frame, which must still
+   * have the evaluated data of unchanged objects. */
+  const bool is_persistent_data = b_engine.render() && b_engine.render().use_persistent_data();
+  const bool can_free_caches = (BlenderSession::headless || is_interface_locked) &&
+                               !is_persistent_data;
   if (!can_free_caches) {
     return;
   }
@@ -755,6 +773,11 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.use_texture_cache = RNA_boolean_get(&cscene, "use_texture_cache");
+  params.texture_cache_size = RNA_int_get(&cscene, "texture_cache_size");
+  params.use_texture_auto_convert = RNA_boolean_get(&cscene, "use_texture_auto_convert");
+  params.texture_cache_path = get_string(cscene, "texture_cache_path");
+
   /* TODO(sergey): Once OSL supports per-microarchitecture optimization get
    * rid of this.
    */
@@ -912,7 +935,10 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   }
 
   params.use_profiling = params.device.has_profiling && !b_engine.is_preview() && background &&
-                         BlenderSession::print_render_stats;
+                         (BlenderSession::print_render_stats ||
+                          !BlenderSession::export_stats_path.empty());
+  params.use_timeline = !b_engine.is_preview() && background &&
+                        !BlenderSession::export_stats_path.empty();
 
   params.adaptive_sampling = RNA_boolean_get(&cscene, "use_adaptive_sampling");
 
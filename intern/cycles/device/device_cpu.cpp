@@ -502,7 +502,9 @@ class CPUDevice : public Device {
     }
 
     texture_info[slot] = mem.info;
-    texture_info[slot].data = (uint64_t)mem.host_pointer;
+    if (!mem.info.use_cache) {
+      texture_info[slot].data = (uint64_t)mem.host_pointer;
+    }
     need_texture_info = true;
   }
 
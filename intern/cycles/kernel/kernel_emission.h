@@ -222,6 +222,9 @@ ccl_device_noinline_cpu float3 indirect_primitive_emission(
     /* multiple importance sampling, get triangle light pdf,
      * and compute weight with respect to BSDF pdf */
     float pdf = triangle_light_pdf(kg, sd, t);
+    if (kernel_data.integrator.use_light_tree) {
+      pdf *= light_tree_pdf_triangle(kg, sd->P + sd->I * t, sd->object, sd->prim);
+    }
     float mis_weight = power_heuristic(bsdf_pdf, pdf);
 
     return L * mis_weight;
@@ -498,6 +498,11 @@ background_light_sample(KernelGlobals *kg, float3 P, float randu, float randv, f
 
 ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direction)
 {
+  /* Probability of selecting the background light. */
+  const float pdf_select = (kernel_data.integrator.use_light_tree) ?
+                               light_tree_pdf_infinite(kg) :
+                               kernel_data.integrator.pdf_lights;
+
   /* Probability of sampling portals instead of the map. */
   float portal_sampling_pdf = kernel_data.integrator.portal_pdf;
 
@@ -511,7 +516,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
        * If map sampling is possible, it would be used instead,
        * otherwise fallback sampling is used. */
       if (portal_sampling_pdf == 1.0f) {
-        return kernel_data.integrator.pdf_lights / M_4PI_F;
+        return pdf_select / M_4PI_F;
       }
       else {
         /* Force map sampling. */
@@ -523,7 +528,7 @@ ccl_device float background_light_pdf(KernelGlobals *kg, float3 P, float3 direct
     /* Evaluate PDF of sampling this direction by map sampling. */
     map_pdf = background_map_pdf(kg, direction) * (1.0f - portal_sampling_pdf);
   }
-  return (portal_pdf + map_pdf) * kernel_data.integrator.pdf_lights;
+  return (portal_pdf + map_pdf) * pdf_select;
 }
 #endif
 
@@ -645,8 +650,6 @@ ccl_device_inline bool lamp_light_sample(
     }
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
-
   return (ls->pdf > 0.0f);
 }
 
@@ -783,7 +786,12 @@ ccl_device bool lamp_light_eval(
     return false;
   }
 
-  ls->pdf *= kernel_data.integrator.pdf_lights;
+  if (kernel_data.integrator.use_light_tree) {
+    ls->pdf *= light_tree_pdf_lamp(kg, P, lamp);
+  }
+  else {
+    ls->pdf *= kernel_data.integrator.pdf_lights;
+  }
 
   return true;
 }
@@ -825,9 +833,14 @@ ccl_device_inline bool triangle_world_space_vertices(
 ccl_device_inline float triangle_light_pdf_area(KernelGlobals *kg,
                                                 const float3 Ng,
                                                 const float3 I,
-                                                float t)
+                                                float t,
+                                                float area)
 {
-  float pdf = kernel_data.integrator.pdf_triangles;
+  /* The light tree selects triangles individually, with points uniform over
+   * the area the sample was taken from. Selection probability is applied
+   * separately. */
+  float pdf = (kernel_data.integrator.use_light_tree) ? 1.0f / area :
+                                                        kernel_data.integrator.pdf_triangles;
   float cos_pi = fabsf(dot(Ng, I));
 
   if (cos_pi == 0.0f)
@@ -873,6 +886,9 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
     if (UNLIKELY(solid_angle == 0.0f)) {
       return 0.0f;
     }
+    else if (kernel_data.integrator.use_light_tree) {
+      return 1.0f / solid_angle;
+    }
     else {
       float area = 1.0f;
       if (has_motion) {
@@ -888,12 +904,12 @@ ccl_device_forceinline float triangle_light_pdf(KernelGlobals *kg, ShaderData *s
     }
   }
   else {
-    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t);
-    if (has_motion) {
-      const float area = 0.5f * len(N);
-      if (UNLIKELY(area == 0.0f)) {
-        return 0.0f;
-      }
+    const float area = 0.5f * len(N);
+    if (UNLIKELY(area == 0.0f)) {
+      return 0.0f;
+    }
+    float pdf = triangle_light_pdf_area(kg, sd->Ng, sd->I, t, area);
+    if (has_motion && !kernel_data.integrator.use_light_tree) {
       /* scale the PDF.
        * area = the area the sample was taken from
        * area_pre = the are from which pdf_triangles was calculated from */
@@ -1030,6 +1046,9 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
       ls->pdf = 0.0f;
       return;
     }
+    else if (kernel_data.integrator.use_light_tree) {
+      ls->pdf = 1.0f / solid_angle;
+    }
     else {
       if (has_motion) {
         /* get the center frame vertices, this is what the PDF was calculated from */
@@ -1050,8 +1069,12 @@ ccl_device_forceinline void triangle_light_sample(KernelGlobals *kg,
     ls->P = u * V[0] + v * V[1] + t * V[2];
     /* compute incoming direction, distance and pdf */
     ls->D = normalize_len(ls->P - P, &ls->t);
-    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t);
-    if (has_motion && area != 0.0f) {
+    if (UNLIKELY(area == 0.0f)) {
+      ls->pdf = 0.0f;
+      return;
+    }
+    ls->pdf = triangle_light_pdf_area(kg, ls->Ng, -ls->D, ls->t, area);
+    if (has_motion && !kernel_data.integrator.use_light_tree) {
       /* scale the PDF.
        * area = the area the sample was taken from
        * area_pre = the are from which pdf_triangles was calculated from */
@@ -1118,9 +1141,20 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
                                       int bounce,
                                       LightSample *ls)
 {
+  float pdf_select = kernel_data.integrator.pdf_lights;
+
   if (lamp < 0) {
     /* sample index */
-    int index = light_distribution_sample(kg, &randu);
+    int index;
+    if (kernel_data.integrator.use_light_tree) {
+      index = light_tree_sample(kg, P, &randu, &pdf_select);
+      if (index < 0) {
+        return false;
+      }
+    }
+    else {
+      index = light_distribution_sample(kg, &randu);
+    }
 
     /* fetch light data */
     const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
@@ -1133,6 +1167,9 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
 
       triangle_light_sample(kg, prim, object, randu, randv, time, ls, P);
       ls->shader |= shader_flag;
+      if (kernel_data.integrator.use_light_tree) {
+        ls->pdf *= pdf_select;
+      }
       return (ls->pdf > 0.0f);
     }
 
@@ -1143,7 +1180,12 @@ ccl_device_noinline bool light_sample(KernelGlobals *kg,
     return false;
   }
 
-  return lamp_light_sample(kg, lamp, randu, randv, P, ls);
+  if (!lamp_light_sample(kg, lamp, randu, randv, P, ls)) {
+    return false;
+  }
+
+  ls->pdf *= pdf_select;
+  return (ls->pdf > 0.0f);
 }
 
 ccl_device_inline int light_select_num_samples(KernelGlobals *kg, int index)
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Selects a light proportional to an estimate of its contribution at the
+ * shading point, instead of uniformly or by area. Based on:
+ *
+ * Alejandro Conty Estevez and Christopher Kulla.
+ * Importance Sampling of Many Lights with Adaptive Tree Splitting.
+ *
+ * The tree is traversed top down, choosing either child with probability
+ * proportional to its importance. Distant and background lights have no
+ * position to bound, they are kept outside of the tree and chosen with a
+ * fixed probability instead. */
+
+ccl_device float light_tree_node_importance(KernelGlobals *kg, float3 P, int node_index)
+{
+  const ccl_global KernelLightTreeNode *node = &kernel_tex_fetch(__light_tree_nodes, node_index);
+
+  if (node->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(node->bbox_min[0], node->bbox_min[1], node->bbox_min[2]);
+  const float3 bbox_max = make_float3(node->bbox_max[0], node->bbox_max[1], node->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius = 0.5f * len(bbox_max - bbox_min);
+
+  float distance;
+  const float3 D = safe_normalize_len(P - centroid, &distance);
+
+  /* Inside the bounds any emitter may be arbitrarily close, only the energy
+   * is meaningful. */
+  if (distance <= radius) {
+    return node->energy / max(radius * radius, 1e-8f);
+  }
+
+  /* Smallest angle between the shading point and any emitter normal in the
+   * node, reduced by the angle the bounds subtend. */
+  const float3 axis = make_float3(node->axis[0], node->axis[1], node->axis[2]);
+  const float theta = fast_acosf(clamp(dot(axis, D), -1.0f, 1.0f));
+  const float theta_u = fast_asinf(radius / distance);
+  const float theta_min = max(theta - node->theta_o - theta_u, 0.0f);
+
+  if (theta_min >= node->theta_e) {
+    return 0.0f;
+  }
+
+  return node->energy * fast_cosf(theta_min) / (distance * distance);
+}
+
+ccl_device_inline float light_tree_pdf_infinite(KernelGlobals *kg)
+{
+  return kernel_data.integrator.light_tree_pdf_infinite /
+         kernel_data.integrator.light_tree_num_infinite;
+}
+
+/* Choose one light, returns its index in the light distribution or -1 if
+ * no light can contribute. randu is rescaled for reuse, like in
+ * light_distribution_sample(). */
+ccl_device int light_tree_sample(KernelGlobals *kg, float3 P, float *randu, float *pdf)
+{
+  const float pdf_infinite = kernel_data.integrator.light_tree_pdf_infinite;
+  const int num_emitters = kernel_data.integrator.light_tree_num_emitters;
+  float r = *randu;
+
+  if (r < pdf_infinite) {
+    /* Uniformly pick one of the distant and background lights. */
+    const int num_infinite = kernel_data.integrator.light_tree_num_infinite;
+    r = r * num_infinite / pdf_infinite;
+    const int index = min((int)r, num_infinite - 1);
+    *randu = r - index;
+    *pdf = light_tree_pdf_infinite(kg);
+    return kernel_tex_fetch(__light_tree_emitters, num_emitters + index).distribution_index;
+  }
+
+  r = (r - pdf_infinite) / (1.0f - pdf_infinite);
+  float pdf_select = 1.0f - pdf_infinite;
+
+  int node_index = 0;
+  const ccl_global KernelLightTreeNode *node = &kernel_tex_fetch(__light_tree_nodes, node_index);
+
+  while (node->num_emitters == 0) {
+    const int left = node_index + 1;
+    const int right = node->child_index;
+    const float importance_left = light_tree_node_importance(kg, P, left);
+    const float importance_right = light_tree_node_importance(kg, P, right);
+    const float importance_total = importance_left + importance_right;
+
+    if (importance_total == 0.0f) {
+      return -1;
+    }
+
+    const float pdf_left = importance_left / importance_total;
+    if (r < pdf_left) {
+      r = r / pdf_left;
+      pdf_select *= pdf_left;
+      node_index = left;
+    }
+    else {
+      r = (r - pdf_left) / (1.0f - pdf_left);
+      pdf_select *= 1.0f - pdf_left;
+      node_index = right;
+    }
+
+    node = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  }
+
+  /* Pick emitter in the leaf proportional to its energy. */
+  const int first = node->child_index;
+  const int num = node->num_emitters;
+
+  for (int i = 0; i < num; i++) {
+    const ccl_global KernelLightTreeEmitter *emitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                         first + i);
+    const float pdf_emitter = emitter->energy / node->energy;
+
+    if (pdf_emitter > 0.0f && (r < pdf_emitter || i == num - 1)) {
+      *randu = saturate(r / pdf_emitter);
+      *pdf = pdf_select * pdf_emitter;
+      return emitter->distribution_index;
+    }
+
+    r -= pdf_emitter;
+  }
+
+  return -1;
+}
+
+/* Probability of light_tree_sample() choosing the given light. */
+ccl_device float light_tree_pdf(KernelGlobals *kg, float3 P, int distribution_index)
+{
+  const uint emitter_index = kernel_tex_fetch(__light_tree_distribution_emitters,
+                                              distribution_index);
+  const int num_emitters = kernel_data.integrator.light_tree_num_emitters;
+  const float pdf_infinite = kernel_data.integrator.light_tree_pdf_infinite;
+
+  if (emitter_index == LIGHT_TREE_NO_EMITTER) {
+    /* Degenerate triangles are never sampled. */
+    return 0.0f;
+  }
+  if (emitter_index >= (uint)num_emitters) {
+    return light_tree_pdf_infinite(kg);
+  }
+
+  const ccl_global KernelLightTreeEmitter *emitter = &kernel_tex_fetch(__light_tree_emitters,
+                                                                       emitter_index);
+  int node_index = emitter->node_index;
+  const ccl_global KernelLightTreeNode *node = &kernel_tex_fetch(__light_tree_nodes, node_index);
+
+  if (node->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  float pdf = emitter->energy / node->energy;
+
+  /* Walk up to the root, same decisions as light_tree_sample() in reverse. */
+  while (node_index != 0) {
+    const int parent_index = node->parent_index;
+    const ccl_global KernelLightTreeNode *parent = &kernel_tex_fetch(__light_tree_nodes,
+                                                                     parent_index);
+    const int sibling_index = (node_index == parent_index + 1) ? parent->child_index :
+                                                                 parent_index + 1;
+
+    const float importance = light_tree_node_importance(kg, P, node_index);
+    const float importance_total = importance +
+                                   light_tree_node_importance(kg, P, sibling_index);
+
+    if (importance_total == 0.0f) {
+      return 0.0f;
+    }
+
+    pdf *= importance / importance_total;
+    node_index = parent_index;
+    node = parent;
+  }
+
+  return pdf * (1.0f - pdf_infinite);
+}
+
+ccl_device float light_tree_pdf_lamp(KernelGlobals *kg, float3 P, int lamp)
+{
+  /* Lamps are stored after the triangles, in the same order as in __lights. */
+  const int distribution_index = kernel_data.integrator.num_distribution -
+                                 kernel_data.integrator.num_all_lights + lamp;
+  return light_tree_pdf(kg, P, distribution_index);
+}
+
+ccl_device float light_tree_pdf_triangle(KernelGlobals *kg, float3 P, int object, int prim)
+{
+  /* Binary search in the range of the light distribution used by the object,
+   * triangles are stored in ascending order. */
+  const uint2 range = kernel_tex_fetch(__light_tree_object_distribution, object);
+  int first = range.x;
+  int len = range.y;
+
+  while (len > 0) {
+    const int half_len = len >> 1;
+    const int middle = first + half_len;
+
+    if (kernel_tex_fetch(__light_distribution, middle).prim < prim) {
+      first = middle + 1;
+      len = len - half_len - 1;
+    }
+    else {
+      len = half_len;
+    }
+  }
+
+  const int last = range.x + range.y;
+  if (first < last && kernel_tex_fetch(__light_distribution, first).prim == prim) {
+    return light_tree_pdf(kg, P, first);
+  }
+
+  return 0.0f;
+}
+
+CCL_NAMESPACE_END
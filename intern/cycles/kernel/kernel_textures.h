@@ -64,6 +64,10 @@ KERNEL_TEX(uchar4, __attributes_uchar4)
 /* lights */
 KERNEL_TEX(KernelLightDistribution, __light_distribution)
 KERNEL_TEX(KernelLight, __lights)
+KERNEL_TEX(KernelLightTreeNode, __light_tree_nodes)
+KERNEL_TEX(KernelLightTreeEmitter, __light_tree_emitters)
+KERNEL_TEX(uint, __light_tree_distribution_emitters)
+KERNEL_TEX(uint2, __light_tree_object_distribution)
 KERNEL_TEX(float2, __light_background_marginal_cdf)
 KERNEL_TEX(float2, __light_background_conditional_cdf)
 
@@ -1301,6 +1301,12 @@ typedef struct KernelIntegrator {
   int num_portals;
   int portal_offset;
 
+  /* light tree */
+  int use_light_tree;
+  int light_tree_num_emitters;
+  int light_tree_num_infinite;
+  float light_tree_pdf_infinite;
+
   /* bounces */
   int min_bounce;
   int max_bounce;
@@ -1529,6 +1535,40 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+/* Light tree node, bounding box and orientation cone of the emitters below it.
+ * Nodes are stored depth first, so the first child of an interior node is the
+ * next node, the second child is at child_index. Leaf nodes store the range of
+ * their emitters instead. */
+typedef struct KernelLightTreeNode {
+  float bbox_min[3];
+  float energy;
+  float bbox_max[3];
+  /* Spread of emitter normals around axis. */
+  float theta_o;
+  float axis[3];
+  /* Spread of emission around the emitter normals. */
+  float theta_e;
+  /* Second child for interior nodes, first emitter for leaf nodes. */
+  int child_index;
+  /* Zero for interior nodes. */
+  int num_emitters;
+  int parent_index;
+  int pad;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
+typedef struct KernelLightTreeEmitter {
+  float energy;
+  int distribution_index;
+  int node_index;
+  int pad;
+} KernelLightTreeEmitter;
+static_assert_align(KernelLightTreeEmitter, 16);
+
+/* Entry of __light_tree_distribution_emitters for distribution entries without
+ * an emitter, like degenerate triangles. */
+#define LIGHT_TREE_NO_EMITTER (~0u)
+
 typedef struct KernelParticle {
   int index;
   float age;
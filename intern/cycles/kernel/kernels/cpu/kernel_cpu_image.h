@@ -474,6 +474,12 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, fl
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
 
+  if (info.use_cache) {
+    /* Without differentials the texture cache reads the full resolution level. */
+    const float2 zero = make_float2(0.0f, 0.0f);
+    return ((TextureCacheHandle *)info.data)->lookup(x, y, zero, zero);
+  }
+
   switch (info.data_type) {
     case IMAGE_DATA_TYPE_HALF:
       return TextureInterpolator<half>::interp(info, x, y);
@@ -498,6 +504,20 @@ ccl_device float4 kernel_tex_image_interp(KernelGlobals *kg, int id, float x, fl
   }
 }
 
+/* Lookup with texture coordinate differentials, so that images in the texture
+ * cache only need tiles from the mip-map level matching the ray footprint. */
+ccl_device float4
+kernel_tex_image_interp_diff(KernelGlobals *kg, int id, float x, float y, float2 dx, float2 dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.use_cache) {
+    return ((TextureCacheHandle *)info.data)->lookup(x, y, dx, dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(KernelGlobals *kg,
                                              int id,
                                              float3 P,
@@ -16,14 +16,8 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+ccl_device_inline float4 svm_image_texture_apply_flags(float4 r, uint flags)
 {
-  if (id == -1) {
-    return make_float4(
-        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
-  }
-
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -38,6 +32,53 @@ ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y,
   return r;
 }
 
+ccl_device float4 svm_image_texture(KernelGlobals *kg, int id, float x, float y, uint flags)
+{
+  if (id == -1) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  return svm_image_texture_apply_flags(r, flags);
+}
+
+#ifdef __KERNEL_CPU__
+/* Differentials of the image texture coordinate, for mip-map level selection in
+ * the texture cache. The node does not know how its vector input was computed,
+ * so we use the default UV map, which is what most image textures are mapped with. */
+ccl_device_inline void svm_image_texco_differentials(KernelGlobals *kg,
+                                                     ShaderData *sd,
+                                                     float2 *dx,
+                                                     float2 *dy)
+{
+#  ifdef __RAY_DIFFERENTIALS__
+  const AttributeDescriptor desc = find_attribute(kg, sd, ATTR_STD_UV);
+  if (desc.offset != ATTR_STD_NOT_FOUND) {
+    primitive_surface_attribute_float2(kg, sd, desc, dx, dy);
+    return;
+  }
+#  endif
+  *dx = make_float2(0.0f, 0.0f);
+  *dy = make_float2(0.0f, 0.0f);
+}
+
+ccl_device float4 svm_image_texture_cached(
+    KernelGlobals *kg, ShaderData *sd, int id, float x, float y, uint flags)
+{
+  if (id == -1) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  float2 dx, dy;
+  svm_image_texco_differentials(kg, sd, &dx, &dy);
+
+  float4 r = kernel_tex_image_interp_diff(kg, id, x, y, dx, dy);
+  return svm_image_texture_apply_flags(r, flags);
+}
+#endif
+
 /* Remap coordnate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
@@ -108,7 +149,13 @@ ccl_device void svm_node_tex_image(
     id = -num_nodes;
   }
 
+#ifdef __KERNEL_CPU__
+  float4 f = (flags & NODE_IMAGE_USE_CACHE) ?
+                 svm_image_texture_cached(kg, sd, id, tex_co.x, tex_co.y, flags) :
+                 svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+#else
   float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+#endif
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -168,8 +168,13 @@ bool Geometry::has_true_displacement() const
   return false;
 }
 
-void Geometry::compute_bvh(
-    Device *device, DeviceScene *dscene, SceneParams *params, Progress *progress, int n, int total)
+void Geometry::compute_bvh(Device *device,
+                           DeviceScene *dscene,
+                           SceneParams *params,
+                           Progress *progress,
+                           Timeline *timeline,
+                           int n,
+                           int total)
 {
   if (progress->get_cancel())
     return;
@@ -185,6 +190,9 @@ void Geometry::compute_bvh(
     else
       msg += string_printf("%s %u/%u", name.c_str(), (uint)(n + 1), (uint)total);
 
+    scoped_timeline_event timeline_event(
+        timeline, name.empty() ? string("Geometry") : name.string(), "bvh");
+
     Object object;
     object.geometry = this;
 
@@ -1017,6 +1025,8 @@ void GeometryManager::device_update_bvh(Device *device,
   /* bvh build */
   progress.set_status("Updating Scene BVH", "Building");
 
+  scoped_timeline_event timeline_event(&scene->timeline, "Scene BVH", "bvh");
+
   BVHParams bparams;
   bparams.top_level = true;
   bparams.bvh_layout = BVHParams::best_bvh_layout(scene->params.bvh_layout,
@@ -1362,8 +1372,15 @@ void GeometryManager::device_update(Device *device,
   size_t i = 0;
   foreach (Geometry *geom, scene->geometry) {
     if (geom->need_update) {
-      pool.push(function_bind(
-          &Geometry::compute_bvh, geom, device, dscene, &scene->params, &progress, i, num_bvh));
+      pool.push(function_bind(&Geometry::compute_bvh,
+                              geom,
+                              device,
+                              dscene,
+                              &scene->params,
+                              &progress,
+                              &scene->timeline,
+                              i,
+                              num_bvh));
       if (geom->need_build_bvh(bvh_layout)) {
         i++;
       }
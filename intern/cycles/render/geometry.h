@@ -40,6 +40,7 @@ class RenderStats;
 class Scene;
 class SceneParams;
 class Shader;
+class Timeline;
 
 /* Geometry
  *
@@ -115,6 +116,7 @@ class Geometry : public Node {
                    DeviceScene *dscene,
                    SceneParams *params,
                    Progress *progress,
+                   Timeline *timeline,
                    int n,
                    int total);
 
@@ -17,6 +17,7 @@
 #include "render/image.h"
 #include "device/device.h"
 #include "render/colorspace.h"
+#include "render/image_cache.h"
 #include "render/image_oiio.h"
 #include "render/scene.h"
 #include "render/stats.h"
@@ -145,6 +146,18 @@ ImageMetaData ImageHandle::metadata()
   return img->metadata;
 }
 
+bool ImageHandle::use_texture_cache()
+{
+  if (tile_slots.empty()) {
+    return false;
+  }
+
+  /* All tiles have the same metadata, so they are all cached or none is. */
+  ImageManager::Image *img = manager->images[tile_slots.front()];
+  manager->load_image_metadata(img);
+  return img->use_cache;
+}
+
 int ImageHandle::svm_slot(const int tile_index) const
 {
   if (tile_index >= tile_slots.size()) {
@@ -259,20 +272,30 @@ bool ImageLoader::equals(const ImageLoader *a, const ImageLoader *b)
 
 /* Image Manager */
 
-ImageManager::ImageManager(const DeviceInfo &info)
+ImageManager::ImageManager(const DeviceInfo &info, const SceneParams &params)
 {
   need_update = true;
   osl_texture_system = NULL;
   animation_frame = 0;
+  image_cache = NULL;
 
   /* Set image limits */
   has_half_images = info.has_half_images;
+
+  /* The texture cache is only accessible from the CPU kernel, and OSL has its own. */
+  if (params.use_texture_cache && info.type == DEVICE_CPU &&
+      params.shadingsystem == SHADINGSYSTEM_SVM) {
+    image_cache = new ImageCache(
+        params.texture_cache_size, params.use_texture_auto_convert, params.texture_cache_path);
+  }
 }
 
 ImageManager::~ImageManager()
 {
   for (size_t slot = 0; slot < images.size(); slot++)
     assert(!images[slot]);
+
+  delete image_cache;
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -294,6 +317,15 @@ bool ImageManager::set_animation_frame_update(int frame)
   return false;
 }
 
+static bool image_associate_alpha(ImageManager::Image *img)
+{
+  /* For typical RGBA images we let OIIO convert to associated alpha,
+   * but some types we want to leave the RGB channels untouched. */
+  return !(ColorSpaceManager::colorspace_is_data(img->params.colorspace) ||
+           img->params.alpha_type == IMAGE_ALPHA_IGNORE ||
+           img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
+}
+
 void ImageManager::load_image_metadata(Image *img)
 {
   if (!img->need_metadata) {
@@ -328,6 +360,10 @@ void ImageManager::load_image_metadata(Image *img)
     }
   }
 
+  /* Only image files can be read through the cache, builtin images are in memory already. */
+  img->use_cache = image_cache && !img->builtin && !img->loader->osl_filepath().empty() &&
+                   ImageCache::supported(metadata, image_associate_alpha(img));
+
   img->need_metadata = false;
 }
 
@@ -408,6 +444,8 @@ int ImageManager::add_image_slot(ImageLoader *loader,
   img->builtin = builtin;
   img->users = 1;
   img->mem = NULL;
+  img->use_cache = false;
+  img->cache_handle = NULL;
 
   images[slot] = img;
 
@@ -439,15 +477,6 @@ void ImageManager::remove_image_user(int slot)
     need_update = true;
 }
 
-static bool image_associate_alpha(ImageManager::Image *img)
-{
-  /* For typical RGBA images we let OIIO convert to associated alpha,
-   * but some types we want to leave the RGB channels untouched. */
-  return !(ColorSpaceManager::colorspace_is_data(img->params.colorspace) ||
-           img->params.alpha_type == IMAGE_ALPHA_IGNORE ||
-           img->params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED);
-}
-
 template<TypeDesc::BASETYPE FileFormat, typename StorageType>
 bool ImageManager::file_load_image(Image *img, int texture_limit)
 {
@@ -604,6 +633,29 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+bool ImageManager::cache_load_image(Image *img)
+{
+  if (img->cache_handle == NULL) {
+    img->cache_handle = image_cache->create_handle(
+        img->loader->osl_filepath().string(), img->params, img->metadata);
+    if (img->cache_handle == NULL) {
+      VLOG(1) << "Failed to open " << img->loader->name()
+              << " through texture cache, loading fully instead.";
+      return false;
+    }
+  }
+
+  /* Placeholder pixel, the kernel reads through the cache handle instead. */
+  thread_scoped_lock device_lock(device_mutex);
+  uchar *pixels = (uchar *)img->mem->alloc(1, 1);
+  memset(pixels, 0, img->mem->memory_size());
+
+  img->mem->info.use_cache = true;
+  img->mem->info.data = (uint64_t)img->cache_handle;
+
+  return true;
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -614,6 +666,8 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
 
   progress->set_status("Updating Images", "Loading " + img->loader->name());
 
+  scoped_timeline_event timeline_event(&scene->timeline, img->loader->name(), "image");
+
   const int texture_limit = scene->params.texture_limit;
 
   load_image_metadata(img);
@@ -635,7 +689,10 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (img->use_cache && cache_load_image(img)) {
+    /* Tiles are loaded on demand during rendering. */
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -751,6 +808,10 @@ void ImageManager::device_free_image(Device *, int slot)
     delete img->mem;
   }
 
+  if (img->cache_handle) {
+    image_cache->free_handle(img->cache_handle);
+  }
+
   delete img->loader;
   delete img;
   images[slot] = NULL;
@@ -836,6 +897,10 @@ void ImageManager::collect_statistics(RenderStats *stats)
     stats->image.textures.add_entry(
         NamedSizeEntry(image->loader->name(), image->mem->memory_size()));
   }
+
+  if (image_cache) {
+    image_cache->collect_statistics(&stats->image);
+  }
 }
 
 CCL_NAMESPACE_END
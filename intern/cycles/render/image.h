@@ -31,6 +31,7 @@
 CCL_NAMESPACE_BEGIN
 
 class Device;
+class ImageCache;
 class ImageHandle;
 class ImageKey;
 class ImageMetaData;
@@ -38,6 +39,7 @@ class ImageManager;
 class Progress;
 class RenderStats;
 class Scene;
+class SceneParams;
 class ColorSpaceProcessor;
 
 /* Image Parameters */
@@ -146,6 +148,7 @@ class ImageHandle {
   int num_tiles();
 
   ImageMetaData metadata();
+  bool use_texture_cache();
   int svm_slot(const int tile_index = 0) const;
   device_texture *image_memory(const int tile_index = 0) const;
 
@@ -162,7 +165,7 @@ class ImageHandle {
  * texture images and 3D volume images. */
 class ImageManager {
  public:
-  explicit ImageManager(const DeviceInfo &info);
+  ImageManager(const DeviceInfo &info, const SceneParams &params);
   ~ImageManager();
 
   ImageHandle add_image(const string &filename, const ImageParams &params);
@@ -198,6 +201,10 @@ class ImageManager {
     string mem_name;
     device_texture *mem;
 
+    /* Looked up on demand through the image cache instead of fully loaded. */
+    bool use_cache;
+    TextureCacheHandle *cache_handle;
+
     int users;
     thread_mutex mutex;
   };
@@ -210,6 +217,7 @@ class ImageManager {
 
   vector<Image *> images;
   void *osl_texture_system;
+  ImageCache *image_cache;
 
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
@@ -220,6 +228,7 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  bool cache_load_image(Image *img);
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
 
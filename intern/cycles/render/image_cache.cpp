@@ -0,0 +1,286 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/image_cache.h"
+#include "render/stats.h"
+
+#include "util/util_image.h"
+#include "util/util_logging.h"
+#include "util/util_murmurhash.h"
+#include "util/util_path.h"
+#include "util/util_time.h"
+#include "util/util_unique_ptr.h"
+
+#include <OpenImageIO/filesystem.h>
+#include <OpenImageIO/imagebufalgo.h>
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+/* Tile size of converted files and of untiled files tiled on the fly. */
+const int TEXTURE_CACHE_TILE_SIZE = 64;
+
+TextureOpt::Wrap wrap_from_extension(ExtensionType extension)
+{
+  switch (extension) {
+    case EXTENSION_REPEAT:
+      return TextureOpt::WrapPeriodic;
+    case EXTENSION_EXTEND:
+      return TextureOpt::WrapClamp;
+    case EXTENSION_CLIP:
+    case EXTENSION_NUM_TYPES:
+      break;
+  }
+  return TextureOpt::WrapBlack;
+}
+
+TextureOpt::InterpMode interp_from_interpolation(InterpolationType interpolation)
+{
+  switch (interpolation) {
+    case INTERPOLATION_CLOSEST:
+      return TextureOpt::InterpClosest;
+    case INTERPOLATION_CUBIC:
+      return TextureOpt::InterpBicubic;
+    case INTERPOLATION_SMART:
+      return TextureOpt::InterpSmartBicubic;
+    case INTERPOLATION_NONE:
+    case INTERPOLATION_LINEAR:
+    case INTERPOLATION_NUM_TYPES:
+      break;
+  }
+  return TextureOpt::InterpBilinear;
+}
+
+/* OIIO reports statistics as either int or int64 depending on the counter. */
+uint64_t texture_system_stat(TextureSystem *ts, const char *name)
+{
+  long long value64 = 0;
+  if (ts->getattribute(name, TypeDesc::INT64, &value64)) {
+    return (uint64_t)value64;
+  }
+
+  int value = 0;
+  if (ts->getattribute(name, TypeDesc::INT, &value)) {
+    return (uint64_t)value;
+  }
+
+  return 0;
+}
+
+/* Handle to a single image in the OIIO texture system. */
+class OIIOTextureCacheHandle : public TextureCacheHandle {
+ public:
+  OIIOTextureCacheHandle(TextureSystem *ts,
+                         TextureSystem::TextureHandle *handle,
+                         const ImageParams &params,
+                         int channels)
+      : ts(ts), handle(handle), channels(channels)
+  {
+    options.swrap = wrap_from_extension(params.extension);
+    options.twrap = options.swrap;
+    options.interpmode = interp_from_interpolation(params.interpolation);
+    options.mipmode = (params.interpolation == INTERPOLATION_CLOSEST) ?
+                          TextureOpt::MipModeOneLevel :
+                          TextureOpt::MipModeTrilinear;
+  }
+
+  float4 lookup(float x, float y, float2 dx, float2 dy) override
+  {
+    /* Options are modified by lookups, so every thread needs its own copy. */
+    TextureOpt lookup_options = options;
+    TextureSystem::Perthread *thread_info = ts->get_perthread_info();
+
+    /* OIIO images start at the top row, Cycles ones at the bottom. */
+    float result[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    if (!ts->texture(handle,
+                     thread_info,
+                     lookup_options,
+                     x,
+                     1.0f - y,
+                     dx.x,
+                     -dx.y,
+                     dy.x,
+                     -dy.y,
+                     4,
+                     result)) {
+      return make_float4(
+          TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+    }
+
+    /* Expand to RGBA the same way as file_load_image() does for loaded images. */
+    switch (channels) {
+      case 1:
+        return make_float4(result[0], result[0], result[0], 1.0f);
+      case 2:
+        return make_float4(result[0], result[0], result[0], result[1]);
+      case 3:
+        return make_float4(result[0], result[1], result[2], 1.0f);
+      default:
+        return make_float4(result[0], result[1], result[2], result[3]);
+    }
+  }
+
+ protected:
+  TextureSystem *ts;
+  TextureSystem::TextureHandle *handle;
+  TextureOpt options;
+  int channels;
+};
+
+}  // namespace
+
+ImageCache::ImageCache(int max_memory_mb, bool use_auto_convert, const string &convert_path)
+    : use_auto_convert(use_auto_convert), convert_path(convert_path)
+{
+  /* Private texture system, so the memory budget is not shared with OSL. */
+  texture_system = TextureSystem::create(false);
+  texture_system->attribute("max_memory_MB", (float)max(max_memory_mb, 1));
+  texture_system->attribute("autotile", TEXTURE_CACHE_TILE_SIZE);
+  texture_system->attribute("automip", 1);
+  texture_system->attribute("accept_untiled", 1);
+  texture_system->attribute("accept_unmipped", 1);
+}
+
+ImageCache::~ImageCache()
+{
+  TextureSystem::destroy(texture_system);
+}
+
+bool ImageCache::supported(const ImageMetaData &metadata, const bool associate_alpha)
+{
+  /* Pixels are passed through as stored in the file. sRGB is converted in the
+   * kernel already, other color spaces would need conversion on load. */
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+
+  /* The texture system always associates alpha. */
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels == 4);
+  if (has_alpha && !associate_alpha) {
+    return false;
+  }
+
+  return metadata.channels >= 1 && metadata.channels <= 4 && metadata.depth <= 1 &&
+         metadata.width > 0 && metadata.height > 0 && !metadata.use_transform_3d;
+}
+
+string ImageCache::converted_filepath(const string &filepath)
+{
+  /* Include a hash of the full path, so files with the same name in different
+   * directories do not overwrite each other. */
+  const uint32_t hash = util_murmur_hash3(filepath.c_str(), filepath.size(), 0);
+  const string filename = string_printf("%s.%08x.tx", path_filename(filepath).c_str(), hash);
+  const string directory = convert_path.empty() ? path_cache_get("textures") : convert_path;
+  return path_join(directory, filename);
+}
+
+bool ImageCache::convert_file(const string &filepath, const string &tx_filepath)
+{
+  path_create_directories(tx_filepath);
+
+  ImageSpec config;
+  config.tile_width = TEXTURE_CACHE_TILE_SIZE;
+  config.tile_height = TEXTURE_CACHE_TILE_SIZE;
+  config.tile_depth = 1;
+  config.attribute("maketx:filtername", "lanczos3");
+  config.attribute("maketx:updatemode", 1);
+
+  /* Write to temporary file first, so that other renders reading the same
+   * cache directory never see a partially written file. */
+  const string extension = OIIO::Filesystem::extension(tx_filepath);
+  const string tmp_filepath = tx_filepath + ".tmp-" + OIIO::Filesystem::unique_path() +
+                              extension;
+
+  const double start_time = time_dt();
+  bool ok = ImageBufAlgo::make_texture(
+      ImageBufAlgo::MakeTxTexture, filepath, tmp_filepath, config);
+
+  string rename_error;
+  if (ok && !OIIO::Filesystem::rename(tmp_filepath, tx_filepath, rename_error)) {
+    VLOG(1) << "Failed to move converted texture to " << tx_filepath << ": " << rename_error;
+    ok = false;
+  }
+
+  if (!ok) {
+    OIIO::Filesystem::remove(tmp_filepath);
+    return false;
+  }
+
+  VLOG(1) << "Converted " << filepath << " to tiled texture " << tx_filepath << " in "
+          << time_dt() - start_time << " seconds.";
+  return true;
+}
+
+TextureCacheHandle *ImageCache::create_handle(const string &filepath,
+                                              const ImageParams &params,
+                                              const ImageMetaData &metadata)
+{
+  string cache_filepath = filepath;
+
+  if (use_auto_convert) {
+    /* Files written by maketx are already tiled and mip-mapped. */
+    unique_ptr<ImageInput> in(ImageInput::create(filepath));
+    ImageSpec spec;
+    const bool is_texture = in && in->open(filepath, spec) && spec.tile_width > 0 &&
+                            !spec.get_string_attribute("textureformat").empty();
+    if (in) {
+      in->close();
+    }
+
+    if (!is_texture) {
+      const string tx_filepath = converted_filepath(filepath);
+
+      thread_scoped_lock lock(convert_mutex);
+      if (path_exists(tx_filepath) &&
+          path_modified_time(tx_filepath) >= path_modified_time(filepath)) {
+        cache_filepath = tx_filepath;
+      }
+      else if (convert_file(filepath, tx_filepath)) {
+        cache_filepath = tx_filepath;
+      }
+      /* Otherwise fall back to the texture system tiling and mip-mapping the
+       * original file on the fly. */
+    }
+  }
+
+  TextureSystem::TextureHandle *handle = texture_system->get_texture_handle(
+      ustring(cache_filepath));
+  if (handle == NULL) {
+    return NULL;
+  }
+
+  return new OIIOTextureCacheHandle(texture_system, handle, params, metadata.channels);
+}
+
+void ImageCache::free_handle(TextureCacheHandle *handle)
+{
+  /* Tiles are owned by the texture system and freed as the budget requires. */
+  delete handle;
+}
+
+void ImageCache::collect_statistics(ImageStats *stats)
+{
+  TextureSystem *ts = texture_system;
+
+  stats->use_cache = true;
+  stats->cache_tile_lookups = texture_system_stat(ts, "stat:find_tile_calls");
+  stats->cache_tile_misses = texture_system_stat(ts, "stat:find_tile_cache_misses");
+  stats->cache_memory_used = texture_system_stat(ts, "stat:cache_memory_used");
+  stats->cache_bytes_read = texture_system_stat(ts, "stat:bytes_read");
+}
+
+CCL_NAMESPACE_END
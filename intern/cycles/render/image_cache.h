@@ -0,0 +1,69 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __IMAGE_CACHE_H__
+#define __IMAGE_CACHE_H__
+
+#include "render/image.h"
+
+#include "util/util_string.h"
+#include "util/util_texture.h"
+#include "util/util_thread.h"
+
+#include <OpenImageIO/texture.h>
+
+CCL_NAMESPACE_BEGIN
+
+class ImageStats;
+
+/* Image Cache
+ *
+ * Tiled, mip-mapped texture cache for SVM image textures on the CPU. Instead of
+ * loading every image at full resolution into memory, tiles are read on demand
+ * from the mip-map level matching the ray footprint, within a fixed memory
+ * budget. Built on OpenImageIO's TextureSystem, same as OSL uses. */
+class ImageCache {
+ public:
+  ImageCache(int max_memory_mb, bool use_auto_convert, const string &convert_path);
+  ~ImageCache();
+
+  /* Whether an image can be looked up through the cache. Images that need
+   * conversion on load (color spaces other than sRGB, channel packed alpha)
+   * or are 3D must be fully loaded instead. */
+  static bool supported(const ImageMetaData &metadata, const bool associate_alpha);
+
+  /* Create handle for the kernel to look up the image through, converting the
+   * file to a tiled, mip-mapped .tx file first if enabled. NULL on failure. */
+  TextureCacheHandle *create_handle(const string &filepath,
+                                    const ImageParams &params,
+                                    const ImageMetaData &metadata);
+  void free_handle(TextureCacheHandle *handle);
+
+  void collect_statistics(ImageStats *stats);
+
+ protected:
+  string converted_filepath(const string &filepath);
+  bool convert_file(const string &filepath, const string &tx_filepath);
+
+  OIIO::TextureSystem *texture_system;
+  bool use_auto_convert;
+  string convert_path;
+  thread_mutex convert_mutex;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __IMAGE_CACHE_H__ */
@@ -20,12 +20,14 @@
 #include "render/film.h"
 #include "render/graph.h"
 #include "render/integrator.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
 #include "render/scene.h"
 #include "render/shader.h"
 
+#include "util/util_algorithm.h"
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
@@ -257,6 +259,43 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Bounds, orientation and approximate intensity of a lamp, for the light tree. */
+static LightTreePrimitive light_tree_lamp_primitive(const Light *light, int distribution_index)
+{
+  LightTreePrimitive primitive;
+  primitive.bbox = BoundBox::empty;
+  primitive.distribution_index = distribution_index;
+
+  const float strength = average(light->strength);
+
+  if (light->type == LIGHT_AREA) {
+    const float3 axisu = light->axisu * (light->sizeu * light->size);
+    const float3 axisv = light->axisv * (light->sizev * light->size);
+    for (int i = 0; i < 4; i++) {
+      primitive.bbox.grow(light->co + axisu * ((i & 1) ? 0.5f : -0.5f) +
+                          axisv * ((i & 2) ? 0.5f : -0.5f));
+    }
+    /* One sided, cosine weighted emission. */
+    primitive.orientation = LightTreeOrientation(safe_normalize(light->dir), 0.0f, M_PI_2_F);
+    primitive.energy = 0.25f * strength;
+  }
+  else {
+    primitive.bbox.grow(light->co, light->size);
+    if (light->type == LIGHT_SPOT) {
+      primitive.orientation = LightTreeOrientation(
+          safe_normalize(light->dir), 0.0f, min(0.5f * light->spot_angle, M_PI_2_F));
+    }
+    else {
+      primitive.orientation = LightTreeOrientation(light->dir, M_PI_F, M_PI_2_F);
+    }
+    primitive.energy = 0.25f * M_1_PI_F * strength;
+  }
+
+  primitive.energy = max(primitive.energy, 0.0f);
+
+  return primitive;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -307,6 +346,25 @@ void LightManager::device_update_distribution(Device *,
   size_t num_distribution = num_triangles + num_lights;
   VLOG(1) << "Total " << num_distribution << " of light distribution primitives.";
 
+  /* Light tree, only used by the path integrator. Shadow catchers sample all
+   * lights in a way that relies on the regular distribution. */
+  bool use_light_tree = scene->integrator->use_light_tree &&
+                        scene->integrator->method == Integrator::PATH;
+  foreach (Object *object, scene->objects) {
+    if (object->is_shadow_catcher) {
+      use_light_tree = false;
+      break;
+    }
+  }
+
+  vector<LightTreePrimitive> tree_primitives;
+  vector<int> tree_infinite;
+  vector<uint2> tree_object_distribution;
+  if (use_light_tree) {
+    tree_primitives.reserve(num_distribution);
+    tree_object_distribution.resize(scene->objects.size(), make_uint2(0, 0));
+  }
+
   /* emission area */
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
@@ -347,6 +405,17 @@ void LightManager::device_update_distribution(Device *,
       use_light_visibility = true;
     }
 
+    /* Emission strength of constant emission shaders, for the light tree. */
+    vector<float> shader_strength;
+    const size_t object_offset = offset;
+    if (use_light_tree) {
+      foreach (Shader *shader, mesh->used_shaders) {
+        float3 emission;
+        shader_strength.push_back(
+            shader->is_constant_emission(&emission) ? max(average(emission), 0.0f) : 1.0f);
+      }
+    }
+
     size_t mesh_num_triangles = mesh->num_triangles();
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->shader[i];
@@ -355,6 +424,7 @@ void LightManager::device_update_distribution(Device *,
                            scene->default_surface;
 
       if (shader->use_mis && shader->has_surface_emission) {
+        const int distribution_index = offset;
         distribution[offset].totarea = totarea;
         distribution[offset].prim = i + mesh->prim_offset;
         distribution[offset].mesh_light.shader_flag = shader_flag;
@@ -363,6 +433,8 @@ void LightManager::device_update_distribution(Device *,
 
         Mesh::Triangle t = mesh->get_triangle(i);
         if (!t.valid(&mesh->verts[0])) {
+          /* Keeps its zero area distribution entry, but gets no tree primitive. The tree maps
+           * such entries to no emitter. */
           continue;
         }
         float3 p1 = mesh->verts[t.v[0]];
@@ -376,9 +448,30 @@ void LightManager::device_update_distribution(Device *,
         }
 
         totarea += triangle_area(p1, p2, p3);
+
+        if (use_light_tree) {
+          /* Two sided emission, with unknown strength for textured emission. */
+          LightTreePrimitive primitive;
+          primitive.bbox = BoundBox::empty;
+          primitive.bbox.grow(p1);
+          primitive.bbox.grow(p2);
+          primitive.bbox.grow(p3);
+          primitive.orientation = LightTreeOrientation(
+              safe_normalize(cross(p2 - p1, p3 - p1)), M_PI_F, M_PI_2_F);
+          primitive.energy = triangle_area(p1, p2, p3) *
+                             ((shader_index < shader_strength.size()) ?
+                                  shader_strength[shader_index] :
+                                  1.0f);
+          primitive.distribution_index = distribution_index;
+          tree_primitives.push_back(primitive);
+        }
       }
     }
 
+    if (use_light_tree) {
+      tree_object_distribution[j] = make_uint2(object_offset, offset - object_offset);
+    }
+
     j++;
   }
 
@@ -399,6 +492,15 @@ void LightManager::device_update_distribution(Device *,
     distribution[offset].lamp.size = light->size;
     totarea += lightarea;
 
+    if (use_light_tree) {
+      if (light->type == LIGHT_DISTANT || light->type == LIGHT_BACKGROUND) {
+        tree_infinite.push_back(offset);
+      }
+      else {
+        tree_primitives.push_back(light_tree_lamp_primitive(light, offset));
+      }
+    }
+
     if (light->type == LIGHT_DISTANT) {
       use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
     }
@@ -475,6 +577,59 @@ void LightManager::device_update_distribution(Device *,
     /* CDF */
     dscene->light_distribution.copy_to_device();
 
+    /* Light tree */
+    kintegrator->use_light_tree = use_light_tree;
+
+    if (use_light_tree) {
+      progress.set_status("Updating Lights", "Building light tree");
+
+      LightTree tree(tree_primitives, tree_infinite, num_distribution);
+
+      if (!tree.nodes.empty()) {
+        KernelLightTreeNode *nodes = dscene->light_tree_nodes.alloc(tree.nodes.size());
+        std::copy(tree.nodes.begin(), tree.nodes.end(), nodes);
+        dscene->light_tree_nodes.copy_to_device();
+      }
+
+      KernelLightTreeEmitter *emitters = dscene->light_tree_emitters.alloc(tree.emitters.size());
+      std::copy(tree.emitters.begin(), tree.emitters.end(), emitters);
+      dscene->light_tree_emitters.copy_to_device();
+
+      uint *distribution_emitters = dscene->light_tree_distribution_emitters.alloc(
+          tree.distribution_emitters.size());
+      std::copy(tree.distribution_emitters.begin(),
+                tree.distribution_emitters.end(),
+                distribution_emitters);
+      dscene->light_tree_distribution_emitters.copy_to_device();
+
+      if (!tree_object_distribution.empty()) {
+        uint2 *object_distribution = dscene->light_tree_object_distribution.alloc(
+            tree_object_distribution.size());
+        std::copy(tree_object_distribution.begin(),
+                  tree_object_distribution.end(),
+                  object_distribution);
+        dscene->light_tree_object_distribution.copy_to_device();
+      }
+
+      /* Distant and background lights are chosen with fixed probability. */
+      kintegrator->light_tree_num_emitters = tree.num_emitters;
+      kintegrator->light_tree_num_infinite = tree.num_infinite;
+      if (tree.num_infinite == 0) {
+        kintegrator->light_tree_pdf_infinite = 0.0f;
+      }
+      else if (tree.num_emitters == 0) {
+        kintegrator->light_tree_pdf_infinite = 1.0f;
+      }
+      else {
+        kintegrator->light_tree_pdf_infinite = 0.5f;
+      }
+    }
+    else {
+      kintegrator->light_tree_num_emitters = 0;
+      kintegrator->light_tree_num_infinite = 0;
+      kintegrator->light_tree_pdf_infinite = 0.0f;
+    }
+
     /* Portals */
     if (num_portals > 0) {
       kintegrator->portal_offset = light_index;
@@ -498,6 +653,10 @@ void LightManager::device_update_distribution(Device *,
     kintegrator->num_portals = 0;
     kintegrator->portal_offset = 0;
     kintegrator->portal_pdf = 0.0f;
+    kintegrator->use_light_tree = false;
+    kintegrator->light_tree_num_emitters = 0;
+    kintegrator->light_tree_num_infinite = 0;
+    kintegrator->light_tree_pdf_infinite = 0.0f;
 
     kfilm->pass_shadow_scale = 1.0f;
   }
@@ -937,6 +1096,10 @@ void LightManager::device_free(Device *, DeviceScene *dscene)
   dscene->lights.free();
   dscene->light_background_marginal_cdf.free();
   dscene->light_background_conditional_cdf.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitters.free();
+  dscene->light_tree_distribution_emitters.free();
+  dscene->light_tree_object_distribution.free();
   dscene->ies_lights.free();
 }
 
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_logging.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+const int LIGHT_TREE_NUM_BINS = 12;
+
+/* Deeper than this, fall back to median splits to bound the depth for
+ * degenerate distributions. */
+const int LIGHT_TREE_MAX_SAH_DEPTH = 48;
+
+struct LightTreeBin {
+  BoundBox bbox;
+  LightTreeOrientation orientation;
+  float energy;
+  int count;
+
+  LightTreeBin() : bbox(BoundBox::empty), energy(0.0f), count(0)
+  {
+  }
+
+  void add(const BoundBox &other_bbox,
+           const LightTreeOrientation &other_orientation,
+           float other_energy,
+           int other_count)
+  {
+    if (other_count == 0) {
+      return;
+    }
+    bbox.grow(other_bbox);
+    orientation = (count == 0) ? other_orientation : merge(orientation, other_orientation);
+    energy += other_energy;
+    count += other_count;
+  }
+
+  float cost() const
+  {
+    return energy * bbox.safe_area() * orientation.measure();
+  }
+};
+
+}  // namespace
+
+float LightTreeOrientation::measure() const
+{
+  /* Integral of the cosine weighted emission over the cone, from the paper. */
+  const float theta_w = min(theta_o + theta_e, M_PI_F);
+  const float cos_o = cosf(theta_o);
+  const float sin_o = sinf(theta_o);
+  return M_2PI_F * (1.0f - cos_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_o + cos_o);
+}
+
+LightTreeOrientation merge(const LightTreeOrientation &cone_a, const LightTreeOrientation &cone_b)
+{
+  /* Ensure a is the wider cone. */
+  const bool swap_cones = (cone_b.theta_o > cone_a.theta_o);
+  const LightTreeOrientation &a = (swap_cones) ? cone_b : cone_a;
+  const LightTreeOrientation &b = (swap_cones) ? cone_a : cone_b;
+
+  const float theta_d = safe_acosf(dot(a.axis, b.axis));
+  const float theta_e = max(a.theta_e, b.theta_e);
+
+  /* The wider cone already contains the other. */
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    return LightTreeOrientation(a.axis, a.theta_o, theta_e);
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  if (theta_o >= M_PI_F) {
+    return LightTreeOrientation(a.axis, M_PI_F, theta_e);
+  }
+
+  /* Rotate the axis of a towards b, to the middle of the merged cone. */
+  float3 rotation_axis = cross(a.axis, b.axis);
+  if (len_squared(rotation_axis) < 1e-12f) {
+    /* Opposite axes, any perpendicular rotation axis works. */
+    rotation_axis = cross(a.axis,
+                          (fabsf(a.axis.x) < 0.9f) ? make_float3(1.0f, 0.0f, 0.0f) :
+                                                     make_float3(0.0f, 1.0f, 0.0f));
+  }
+  rotation_axis = normalize(rotation_axis);
+
+  const float theta_r = theta_o - a.theta_o;
+  const float3 axis = a.axis * cosf(theta_r) + cross(rotation_axis, a.axis) * sinf(theta_r);
+
+  return LightTreeOrientation(normalize(axis), theta_o, theta_e);
+}
+
+LightTree::LightTree(vector<LightTreePrimitive> &primitives,
+                     const vector<int> &infinite_distribution_indices,
+                     int num_distribution)
+    : primitives(primitives)
+{
+  num_emitters = primitives.size();
+  num_infinite = infinite_distribution_indices.size();
+
+  emitters.resize(num_emitters + num_infinite);
+
+  if (num_emitters > 0) {
+    nodes.reserve(2 * num_emitters);
+    recursive_build(-1, 0, num_emitters, 0);
+  }
+
+  /* Primitives were reordered by the build, emitters follow that order. Distribution entries
+   * which have no primitive are not mapped to any emitter. */
+  distribution_emitters.resize(num_distribution, LIGHT_TREE_NO_EMITTER);
+
+  for (int i = 0; i < num_emitters; i++) {
+    const LightTreePrimitive &primitive = primitives[i];
+    emitters[i].energy = primitive.energy;
+    emitters[i].distribution_index = primitive.distribution_index;
+    distribution_emitters[primitive.distribution_index] = i;
+  }
+
+  for (int i = 0; i < num_infinite; i++) {
+    KernelLightTreeEmitter &emitter = emitters[num_emitters + i];
+    emitter.energy = 0.0f;
+    emitter.distribution_index = infinite_distribution_indices[i];
+    emitter.node_index = -1;
+    distribution_emitters[emitter.distribution_index] = num_emitters + i;
+  }
+
+  VLOG(1) << "Light tree built with " << nodes.size() << " nodes for " << num_emitters
+          << " emitters and " << num_infinite << " distant lights.";
+}
+
+int LightTree::recursive_build(int parent_index, int start, int end, int depth)
+{
+  const int node_index = nodes.size();
+  nodes.push_back(KernelLightTreeNode());
+
+  /* Bounds of the emitters and their centroids. */
+  BoundBox bbox = BoundBox::empty;
+  BoundBox centroid_bbox = BoundBox::empty;
+  LightTreeOrientation orientation = primitives[start].orientation;
+  float energy = 0.0f;
+
+  for (int i = start; i < end; i++) {
+    const LightTreePrimitive &primitive = primitives[i];
+    bbox.grow(primitive.bbox);
+    centroid_bbox.grow(primitive.bbox.center());
+    if (i != start) {
+      orientation = merge(orientation, primitive.orientation);
+    }
+    energy += primitive.energy;
+  }
+
+  KernelLightTreeNode &node = nodes[node_index];
+  node.bbox_min[0] = bbox.min.x;
+  node.bbox_min[1] = bbox.min.y;
+  node.bbox_min[2] = bbox.min.z;
+  node.bbox_max[0] = bbox.max.x;
+  node.bbox_max[1] = bbox.max.y;
+  node.bbox_max[2] = bbox.max.z;
+  node.axis[0] = orientation.axis.x;
+  node.axis[1] = orientation.axis.y;
+  node.axis[2] = orientation.axis.z;
+  node.theta_o = orientation.theta_o;
+  node.theta_e = orientation.theta_e;
+  node.energy = energy;
+  node.parent_index = parent_index;
+  node.pad = 0;
+
+  /* Find split, emitters with coincident centroids stay in one leaf. */
+  int mid = start;
+  if (end - start > 1) {
+    int axis;
+    float pos;
+
+    if (depth < LIGHT_TREE_MAX_SAH_DEPTH && find_split(start, end, centroid_bbox, &axis, &pos)) {
+      mid = std::partition(primitives.begin() + start,
+                           primitives.begin() + end,
+                           [axis, pos](const LightTreePrimitive &primitive) {
+                             return primitive.bbox.center()[axis] < pos;
+                           }) -
+            primitives.begin();
+    }
+
+    if (mid == start || mid == end) {
+      /* Median split along the largest extent. */
+      const float3 extent = centroid_bbox.size();
+      if (max3(extent) > 0.0f) {
+        axis = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z) ? 1 : 2;
+        mid = (start + end) / 2;
+        std::nth_element(primitives.begin() + start,
+                         primitives.begin() + mid,
+                         primitives.begin() + end,
+                         [axis](const LightTreePrimitive &a, const LightTreePrimitive &b) {
+                           return a.bbox.center()[axis] < b.bbox.center()[axis];
+                         });
+      }
+      else {
+        mid = start;
+      }
+    }
+  }
+
+  if (mid == start) {
+    /* Leaf. */
+    nodes[node_index].child_index = start;
+    nodes[node_index].num_emitters = end - start;
+
+    for (int i = start; i < end; i++) {
+      emitters[i].node_index = node_index;
+    }
+  }
+  else {
+    /* Interior node, first child follows directly. */
+    recursive_build(node_index, start, mid, depth + 1);
+    const int right_index = recursive_build(node_index, mid, end, depth + 1);
+
+    nodes[node_index].child_index = right_index;
+    nodes[node_index].num_emitters = 0;
+  }
+
+  return node_index;
+}
+
+bool LightTree::find_split(
+    int start, int end, const BoundBox &centroid_bbox, int *r_axis, float *r_pos)
+{
+  const float3 extent = centroid_bbox.size();
+  const float max_extent = max3(extent);
+  float best_cost = FLT_MAX;
+  bool found = false;
+
+  if (max_extent == 0.0f) {
+    return false;
+  }
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (extent[axis] == 0.0f) {
+      continue;
+    }
+
+    /* Bin emitters by centroid. */
+    LightTreeBin bins[LIGHT_TREE_NUM_BINS];
+    const float inv_extent = LIGHT_TREE_NUM_BINS / extent[axis];
+
+    for (int i = start; i < end; i++) {
+      const LightTreePrimitive &primitive = primitives[i];
+      const float centroid = primitive.bbox.center()[axis];
+      const int bin = clamp(
+          (int)((centroid - centroid_bbox.min[axis]) * inv_extent), 0, LIGHT_TREE_NUM_BINS - 1);
+      bins[bin].add(primitive.bbox, primitive.orientation, primitive.energy, 1);
+    }
+
+    /* Accumulate from the right, then sweep from the left. */
+    LightTreeBin right[LIGHT_TREE_NUM_BINS];
+    for (int i = LIGHT_TREE_NUM_BINS - 1; i > 0; i--) {
+      right[i] = (i == LIGHT_TREE_NUM_BINS - 1) ? LightTreeBin() : right[i + 1];
+      right[i].add(bins[i].bbox, bins[i].orientation, bins[i].energy, bins[i].count);
+    }
+
+    /* Penalize splits across thin axes, which give poorly separated bounds. */
+    const float regularization = max_extent / extent[axis];
+
+    LightTreeBin left;
+    for (int i = 0; i < LIGHT_TREE_NUM_BINS - 1; i++) {
+      left.add(bins[i].bbox, bins[i].orientation, bins[i].energy, bins[i].count);
+
+      if (left.count == 0 || right[i + 1].count == 0) {
+        continue;
+      }
+
+      const float cost = regularization * (left.cost() + right[i + 1].cost());
+      if (cost < best_cost) {
+        best_cost = cost;
+        *r_axis = axis;
+        *r_pos = centroid_bbox.min[axis] + extent[axis] * (i + 1) / LIGHT_TREE_NUM_BINS;
+        found = true;
+      }
+    }
+  }
+
+  return found;
+}
+
+CCL_NAMESPACE_END
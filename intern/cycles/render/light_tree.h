@@ -0,0 +1,90 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Cone bounding the emitter normals (axis and theta_o), and the spread of
+ * emission around each of them (theta_e). */
+struct LightTreeOrientation {
+  float3 axis;
+  float theta_o;
+  float theta_e;
+
+  LightTreeOrientation() : axis(make_float3(0.0f, 0.0f, 1.0f)), theta_o(0.0f), theta_e(0.0f)
+  {
+  }
+
+  LightTreeOrientation(const float3 &axis, float theta_o, float theta_e)
+      : axis(axis), theta_o(theta_o), theta_e(theta_e)
+  {
+  }
+
+  /* Solid angle measure used in the split cost. */
+  float measure() const;
+};
+
+LightTreeOrientation merge(const LightTreeOrientation &a, const LightTreeOrientation &b);
+
+/* Emitter with a position, distant and background lights are not part of the tree. */
+struct LightTreePrimitive {
+  BoundBox bbox;
+  LightTreeOrientation orientation;
+  float energy;
+  int distribution_index;
+};
+
+/* Light Tree
+ *
+ * Bounding volume hierarchy over lights and emissive triangles, with the
+ * energy and orientation of the emitters in every node. Used by the kernel to
+ * select lights proportional to their estimated contribution, see
+ * kernel_light_tree.h. Split using binned SAH weighted by energy and
+ * orientation. */
+class LightTree {
+ public:
+  LightTree(vector<LightTreePrimitive> &primitives,
+            const vector<int> &infinite_distribution_indices,
+            int num_distribution);
+
+  /* Flattened nodes, depth first. */
+  vector<KernelLightTreeNode> nodes;
+  /* Emitters in leaf order, followed by the infinite lights. */
+  vector<KernelLightTreeEmitter> emitters;
+  /* Emitter index for every entry of the light distribution. */
+  vector<uint> distribution_emitters;
+
+  int num_emitters;
+  int num_infinite;
+
+ protected:
+  int recursive_build(int parent_index, int start, int end, int depth);
+  bool find_split(int start, int end, const BoundBox &centroid_bbox, int *r_axis, float *r_pos);
+
+  vector<LightTreePrimitive> &primitives;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
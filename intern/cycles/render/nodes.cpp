@@ -386,6 +386,9 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
       flags |= NODE_IMAGE_ALPHA_UNASSOCIATE;
     }
   }
+  if (handle.use_texture_cache()) {
+    flags |= NODE_IMAGE_USE_CACHE;
+  }
 
   if (projection != NODE_IMAGE_PROJ_BOX) {
     /* If there only is one image (a very common case), we encode it as a negative value. */
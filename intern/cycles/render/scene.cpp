@@ -30,6 +30,7 @@
 #include "render/particles.h"
 #include "render/scene.h"
 #include "render/shader.h"
+#include "render/stats.h"
 #include "render/svm.h"
 #include "render/tables.h"
 
@@ -74,6 +75,10 @@ DeviceScene::DeviceScene(Device *device)
       lights(device, "__lights", MEM_GLOBAL),
       light_background_marginal_cdf(device, "__light_background_marginal_cdf", MEM_GLOBAL),
       light_background_conditional_cdf(device, "__light_background_conditional_cdf", MEM_GLOBAL),
+      light_tree_nodes(device, "__light_tree_nodes", MEM_GLOBAL),
+      light_tree_emitters(device, "__light_tree_emitters", MEM_GLOBAL),
+      light_tree_distribution_emitters(device, "__light_tree_distribution_emitters", MEM_GLOBAL),
+      light_tree_object_distribution(device, "__light_tree_object_distribution", MEM_GLOBAL),
       particles(device, "__particles", MEM_GLOBAL),
       svm_nodes(device, "__svm_nodes", MEM_GLOBAL),
       shaders(device, "__shaders", MEM_GLOBAL),
@@ -106,7 +111,7 @@ Scene::Scene(const SceneParams &params_, Device *device)
   geometry_manager = new GeometryManager();
   object_manager = new ObjectManager();
   integrator = new Integrator();
-  image_manager = new ImageManager(device->info);
+  image_manager = new ImageManager(device->info, params);
   particle_system_manager = new ParticleSystemManager();
   curve_system_manager = new CurveSystemManager();
   bake_manager = new BakeManager();
@@ -204,102 +209,121 @@ void Scene::device_update(Device *device_, Progress &progress)
    * - Lookup tables are done a second time to handle film tables
    */
 
+  scoped_timeline_stages stages(&timeline, "scene");
+
   progress.set_status("Updating Shaders");
+  stages.next("Shaders");
   shader_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Background");
+  stages.next("Background");
   background->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Camera");
+  stages.next("Camera");
   camera->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
+  stages.next("Geometry Preprocess");
   geometry_manager->device_update_preprocess(device, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Objects");
+  stages.next("Objects");
   object_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Hair Systems");
+  stages.next("Hair Systems");
   curve_system_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Particle Systems");
+  stages.next("Particle Systems");
   particle_system_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Meshes");
+  stages.next("Meshes");
   geometry_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Objects Flags");
+  stages.next("Objects Flags");
   object_manager->device_update_flags(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Images");
+  stages.next("Images");
   image_manager->device_update(device, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Camera Volume");
+  stages.next("Camera Volume");
   camera->device_update_volume(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lookup Tables");
+  stages.next("Lookup Tables");
   lookup_tables->device_update(device, &dscene);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lights");
+  stages.next("Lights");
   light_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Integrator");
+  stages.next("Integrator");
   integrator->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Film");
+  stages.next("Film");
   film->device_update(device, &dscene, this);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Lookup Tables");
+  stages.next("Lookup Tables");
   lookup_tables->device_update(device, &dscene);
 
   if (progress.get_cancel() || device->have_error())
     return;
 
   progress.set_status("Updating Baking");
+  stages.next("Baking");
   bake_manager->device_update(device, &dscene, this, progress);
 
   if (progress.get_cancel() || device->have_error())
@@ -307,9 +331,21 @@ void Scene::device_update(Device *device_, Progress &progress)
 
   if (device->have_error() == false) {
     progress.set_status("Updating Device", "Writing constant memory");
+    stages.next("Device");
     device->const_copy_to("__data", &dscene.data, sizeof(dscene.data));
   }
 
+  if (timeline.is_enabled()) {
+    NamedSizeStats device_memory;
+    collect_device_memory(&device_memory);
+
+    vector<pair<string, double>> memory;
+    foreach (const NamedSizeEntry &entry, device_memory.entries) {
+      memory.push_back(make_pair(entry.name, (double)entry.size));
+    }
+    timeline.add_counter("Device Memory", memory);
+  }
+
   if (print_stats) {
     size_t mem_used = util_guarded_get_mem_used();
     size_t mem_peak = util_guarded_get_mem_peak();
@@ -401,10 +437,58 @@ void Scene::device_free()
   free_memory(false);
 }
 
+void Scene::collect_device_memory(NamedSizeStats *stats)
+{
+  stats->add_entry(NamedSizeEntry(
+      "BVH",
+      dscene.bvh_nodes.memory_size() + dscene.bvh_leaf_nodes.memory_size() +
+          dscene.object_node.memory_size() + dscene.prim_tri_index.memory_size() +
+          dscene.prim_tri_verts.memory_size() + dscene.prim_type.memory_size() +
+          dscene.prim_visibility.memory_size() + dscene.prim_index.memory_size() +
+          dscene.prim_object.memory_size() + dscene.prim_time.memory_size()));
+  stats->add_entry(NamedSizeEntry(
+      "Geometry",
+      dscene.tri_shader.memory_size() + dscene.tri_vnormal.memory_size() +
+          dscene.tri_vindex.memory_size() + dscene.tri_patch.memory_size() +
+          dscene.tri_patch_uv.memory_size() + dscene.curves.memory_size() +
+          dscene.curve_keys.memory_size() + dscene.patches.memory_size()));
+  stats->add_entry(NamedSizeEntry(
+      "Objects",
+      dscene.objects.memory_size() + dscene.object_motion_pass.memory_size() +
+          dscene.object_motion.memory_size() + dscene.object_flag.memory_size() +
+          dscene.object_volume_step.memory_size() + dscene.camera_motion.memory_size() +
+          dscene.particles.memory_size()));
+  stats->add_entry(NamedSizeEntry(
+      "Attributes",
+      dscene.attributes_map.memory_size() + dscene.attributes_float.memory_size() +
+          dscene.attributes_float2.memory_size() + dscene.attributes_float3.memory_size() +
+          dscene.attributes_uchar4.memory_size()));
+  stats->add_entry(NamedSizeEntry(
+      "Lights",
+      dscene.light_distribution.memory_size() + dscene.lights.memory_size() +
+          dscene.light_background_marginal_cdf.memory_size() +
+          dscene.light_background_conditional_cdf.memory_size() +
+          dscene.light_tree_nodes.memory_size() + dscene.light_tree_emitters.memory_size() +
+          dscene.light_tree_distribution_emitters.memory_size() +
+          dscene.light_tree_object_distribution.memory_size() +
+          dscene.ies_lights.memory_size()));
+  stats->add_entry(NamedSizeEntry(
+      "Shaders",
+      dscene.svm_nodes.memory_size() + dscene.shaders.memory_size() +
+          dscene.lookup_table.memory_size() + dscene.sample_pattern_lut.memory_size()));
+}
+
 void Scene::collect_statistics(RenderStats *stats)
 {
   geometry_manager->collect_statistics(this, stats);
   image_manager->collect_statistics(stats);
+
+  stats->device_memory = NamedSizeStats();
+  collect_device_memory(&stats->device_memory);
+  stats->device_memory.add_entry(NamedSizeEntry("Images", stats->image.textures.total_size));
+
+  stats->mem_used = util_guarded_get_mem_used();
+  stats->mem_peak = util_guarded_get_mem_peak();
 }
 
 CCL_NAMESPACE_END
@@ -29,6 +29,7 @@
 #include "util/util_system.h"
 #include "util/util_texture.h"
 #include "util/util_thread.h"
+#include "util/util_timeline.h"
 #include "util/util_types.h"
 #include "util/util_vector.h"
 
@@ -56,6 +57,7 @@ class ShaderManager;
 class Progress;
 class BakeManager;
 class BakeData;
+class NamedSizeStats;
 class RenderStats;
 
 /* Scene Device Data */
@@ -108,6 +110,10 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<KernelLightTreeEmitter> light_tree_emitters;
+  device_vector<uint> light_tree_distribution_emitters;
+  device_vector<uint2> light_tree_object_distribution;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -171,6 +177,16 @@ class SceneParams {
   bool persistent_data;
   int texture_limit;
 
+  /* Load image textures on demand through a tiled, mip-mapped texture cache
+   * rather than fully into memory. Only used by SVM on the CPU. */
+  bool use_texture_cache;
+  /* Memory budget of the texture cache in megabytes. */
+  int texture_cache_size;
+  /* Convert images to tiled, mip-mapped .tx files once, for faster access. */
+  bool use_texture_auto_convert;
+  /* Directory for converted files, uses the user cache directory if empty. */
+  string texture_cache_path;
+
   bool background;
 
   SceneParams()
@@ -183,6 +199,9 @@ class SceneParams {
     num_bvh_time_steps = 0;
     persistent_data = false;
     texture_limit = 0;
+    use_texture_cache = false;
+    texture_cache_size = 1024;
+    use_texture_auto_convert = true;
     background = true;
   }
 
@@ -193,7 +212,11 @@ class SceneParams {
              use_bvh_spatial_split == params.use_bvh_spatial_split &&
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
-             persistent_data == params.persistent_data && texture_limit == params.texture_limit);
+             persistent_data == params.persistent_data && texture_limit == params.texture_limit &&
+             use_texture_cache == params.use_texture_cache &&
+             texture_cache_size == params.texture_cache_size &&
+             use_texture_auto_convert == params.use_texture_auto_convert &&
+             texture_cache_path == params.texture_cache_path);
   }
 };
 
@@ -246,6 +269,9 @@ class Scene {
   /* mutex must be locked manually by callers */
   thread_mutex mutex;
 
+  /* Timings of scene updates and rendering, for statistics. */
+  Timeline timeline;
+
   Scene(const SceneParams &params, Device *device);
   ~Scene();
 
@@ -267,6 +293,9 @@ class Scene {
   void collect_statistics(RenderStats *stats);
 
  protected:
+  /* Device memory used by the scene data, by category. */
+  void collect_device_memory(NamedSizeStats *stats);
+
   /* Check if some heavy data worth logging was updated.
    * Mainly used to suppress extra annoying logging.
    */
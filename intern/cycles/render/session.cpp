@@ -414,6 +414,13 @@ bool Session::acquire_tile(RenderTile &rtile, Device *tile_device, uint tile_typ
   rtile.tile_index = tile->index;
   rtile.task = tile->state == Tile::DENOISE ? RenderTile::DENOISE : RenderTile::PATH_TRACE;
 
+  if (scene->timeline.is_enabled()) {
+    if (tile_start_time.size() <= (size_t)tile->index) {
+      tile_start_time.resize(tile->index + 1);
+    }
+    tile_start_time[tile->index] = time_dt();
+  }
+
   tile_lock.unlock();
 
   /* in case of a permanent buffer, return it, otherwise we will allocate
@@ -483,6 +490,22 @@ void Session::release_tile(RenderTile &rtile)
 
   progress.add_finished_tile(rtile.task == RenderTile::DENOISE);
 
+  if (scene->timeline.is_enabled() && (size_t)rtile.tile_index < tile_start_time.size()) {
+    vector<pair<string, double>> args;
+    args.push_back(make_pair("x", (double)rtile.x));
+    args.push_back(make_pair("y", (double)rtile.y));
+    args.push_back(make_pair("pixels", (double)(rtile.w * rtile.h)));
+    if (rtile.task == RenderTile::DENOISE) {
+      scene->timeline.add_event(
+          "Denoise", "denoise", tile_start_time[rtile.tile_index], time_dt(), args);
+    }
+    else {
+      args.push_back(make_pair("samples", (double)rtile.num_samples));
+      scene->timeline.add_event(
+          "Path Trace", "tile", tile_start_time[rtile.tile_index], time_dt(), args);
+    }
+  }
+
   bool delete_tile;
 
   if (tile_manager.finish_tile(rtile.tile_index, delete_tile)) {
@@ -828,6 +851,10 @@ bool Session::load_kernels(bool lock_scene)
 
 void Session::run()
 {
+  /* Every render starts a new timeline, with persistent data the scene is reused. */
+  scene->timeline.reset();
+  scene->timeline.set_enabled(params.use_timeline);
+
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     profiler.start();
   }
@@ -1260,6 +1287,7 @@ void Session::device_free()
 void Session::collect_statistics(RenderStats *render_stats)
 {
   scene->collect_statistics(render_stats);
+  render_stats->timeline = scene->timeline.get_events();
   if (params.use_profiling && (params.device.type == DEVICE_CPU)) {
     render_stats->collect_profiling(scene, profiler);
   }
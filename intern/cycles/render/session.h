@@ -59,6 +59,8 @@ class SessionParams {
   bool adaptive_sampling;
 
   bool use_profiling;
+  /* Record a timeline of the render, for statistics export. */
+  bool use_timeline;
 
   bool display_buffer_linear;
 
@@ -93,6 +95,7 @@ class SessionParams {
     adaptive_sampling = false;
 
     use_profiling = false;
+    use_timeline = false;
 
     run_denoising = false;
     write_denoising_passes = false;
@@ -120,7 +123,7 @@ class SessionParams {
              tile_size == params.tile_size && start_resolution == params.start_resolution &&
              pixel_size == params.pixel_size && threads == params.threads &&
              adaptive_sampling == params.adaptive_sampling &&
-             use_profiling == params.use_profiling &&
+             use_profiling == params.use_profiling && use_timeline == params.use_timeline &&
              display_buffer_linear == params.display_buffer_linear &&
              cancel_timeout == params.cancel_timeout && reset_timeout == params.reset_timeout &&
              text_timeout == params.text_timeout &&
@@ -231,6 +234,9 @@ class Session {
   double last_update_time;
   double last_display_time;
 
+  /* Time at which tiles were acquired, by tile index, for the timeline. */
+  vector<double> tile_start_time;
+
   /* progressive refine */
   bool update_progressive_refine(bool cancel);
 
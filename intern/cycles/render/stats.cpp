@@ -19,6 +19,9 @@
 #include "util/util_algorithm.h"
 #include "util/util_foreach.h"
 #include "util/util_string.h"
+#include "util/util_version.h"
+
+#include <cmath>
 
 CCL_NAMESPACE_BEGIN
 
@@ -213,6 +216,11 @@ string MeshStats::full_report(int indent_level)
 /* Image statistics. */
 
 ImageStats::ImageStats()
+    : use_cache(false),
+      cache_tile_lookups(0),
+      cache_tile_misses(0),
+      cache_memory_used(0),
+      cache_bytes_read(0)
 {
 }
 
@@ -221,6 +229,22 @@ string ImageStats::full_report(int indent_level)
   const string indent(indent_level * kIndentNumSpaces, ' ');
   string result = "";
   result += indent + "Textures:\n" + textures.full_report(indent_level + 1);
+  if (use_cache) {
+    const string double_indent = indent + string(kIndentNumSpaces, ' ');
+    const uint64_t hits = cache_tile_lookups - cache_tile_misses;
+    const double hit_rate = (cache_tile_lookups > 0) ? (100.0 * hits) / cache_tile_lookups : 0.0;
+    result += indent + "Texture cache:\n";
+    result += string_printf("%sTile lookups: %s, hit rate %3.2f%%\n",
+                            double_indent.c_str(),
+                            string_human_readable_number(cache_tile_lookups).c_str(),
+                            hit_rate);
+    result += string_printf("%sMemory used: %s\n",
+                            double_indent.c_str(),
+                            string_human_readable_size(cache_memory_used).c_str());
+    result += string_printf("%sRead from disk: %s\n",
+                            double_indent.c_str(),
+                            string_human_readable_size(cache_bytes_read).c_str());
+  }
   return result;
 }
 
@@ -229,6 +253,8 @@ string ImageStats::full_report(int indent_level)
 RenderStats::RenderStats()
 {
   has_profiling = false;
+  mem_used = 0;
+  mem_peak = 0;
 }
 
 void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
@@ -317,4 +343,203 @@ string RenderStats::full_report()
   return result;
 }
 
+/* JSON report. */
+
+namespace {
+
+string json_string(const string &str)
+{
+  string result = "\"";
+  foreach (char c, str) {
+    switch (c) {
+      case '"':
+        result += "\\\"";
+        break;
+      case '\\':
+        result += "\\\\";
+        break;
+      case '\n':
+        result += "\\n";
+        break;
+      case '\t':
+        result += "\\t";
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          result += string_printf("\\u%04x", (int)c);
+        }
+        else {
+          result += c;
+        }
+        break;
+    }
+  }
+  return result + "\"";
+}
+
+/* JSON has no representation for NaN or infinity, those are written as null. */
+string json_number(double value, const char *format)
+{
+  return std::isfinite(value) ? string_printf(format, value) : string("null");
+}
+
+string json_args(const vector<pair<string, double>> &args)
+{
+  string result = "{";
+  for (size_t i = 0; i < args.size(); i++) {
+    result += string_printf("%s%s: %s",
+                            (i > 0) ? ", " : "",
+                            json_string(args[i].first).c_str(),
+                            json_number(args[i].second, "%.17g").c_str());
+  }
+  return result + "}";
+}
+
+string json_size_stats(const NamedSizeStats &stats)
+{
+  string result = string_printf("{\"total\": %zu, \"entries\": {", stats.total_size);
+  for (size_t i = 0; i < stats.entries.size(); i++) {
+    result += string_printf("%s%s: %zu",
+                            (i > 0) ? ", " : "",
+                            json_string(stats.entries[i].name).c_str(),
+                            stats.entries[i].size);
+  }
+  return result + "}}";
+}
+
+/* Profiler samples are taken every millisecond. */
+string json_nested_sample_stats(const NamedNestedSampleStats &stats)
+{
+  string result = string_printf("{\"name\": %s, \"self_time\": %.3f, \"time\": %.3f",
+                                json_string(stats.name).c_str(),
+                                stats.self_samples * 0.001,
+                                stats.sum_samples * 0.001);
+  if (!stats.entries.empty()) {
+    result += ", \"entries\": [";
+    for (size_t i = 0; i < stats.entries.size(); i++) {
+      result += (i > 0) ? ", " : "";
+      result += json_nested_sample_stats(stats.entries[i]);
+    }
+    result += "]";
+  }
+  return result + "}";
+}
+
+string json_sample_count_stats(const NamedSampleCountStats &stats)
+{
+  string result = "{";
+  bool first = true;
+  foreach (NamedSampleCountStats::entry_map::const_reference entry, stats.entries) {
+    const NamedSampleCountPair &pair = entry.second;
+    result += string_printf("%s%s: {\"time\": %.3f, \"hits\": %llu}",
+                            first ? "" : ", ",
+                            json_string(pair.name.string()).c_str(),
+                            pair.samples * 0.001,
+                            (unsigned long long)pair.hits);
+    first = false;
+  }
+  return result + "}";
+}
+
+/* Events in the Chrome trace event format, with times in microseconds. */
+string json_trace_event(const TimelineEvent &event)
+{
+  if (event.type == TimelineEvent::COUNTER) {
+    return string_printf("{\"name\": %s, \"cat\": %s, \"ph\": \"C\", \"ts\": %s, "
+                         "\"pid\": 0, \"tid\": 0, \"args\": %s}",
+                         json_string(event.name).c_str(),
+                         json_string(event.category).c_str(),
+                         json_number(event.start * 1e6, "%.3f").c_str(),
+                         json_args(event.args).c_str());
+  }
+
+  return string_printf("{\"name\": %s, \"cat\": %s, \"ph\": \"X\", \"ts\": %s, "
+                       "\"dur\": %s, \"pid\": 0, \"tid\": %d, \"args\": %s}",
+                       json_string(event.name).c_str(),
+                       json_string(event.category).c_str(),
+                       json_number(event.start * 1e6, "%.3f").c_str(),
+                       json_number(event.duration * 1e6, "%.3f").c_str(),
+                       event.thread,
+                       json_args(event.args).c_str());
+}
+
+/* Total duration of events in a category, as object with event names as keys. */
+string json_category_durations(const vector<TimelineEvent> &timeline, const string &category)
+{
+  map<string, double> durations;
+  foreach (const TimelineEvent &event, timeline) {
+    if (event.type == TimelineEvent::DURATION && event.category == category) {
+      durations[event.name] += event.duration;
+    }
+  }
+
+  string result = "{";
+  bool first = true;
+  for (map<string, double>::const_iterator it = durations.begin(); it != durations.end(); ++it) {
+    result += string_printf("%s%s: %s",
+                            first ? "" : ", ",
+                            json_string(it->first).c_str(),
+                            json_number(it->second, "%.6f").c_str());
+    first = false;
+  }
+  return result + "}";
+}
+
+double event_arg(const TimelineEvent &event, const char *name)
+{
+  for (size_t i = 0; i < event.args.size(); i++) {
+    if (event.args[i].first == name) {
+      return event.args[i].second;
+    }
+  }
+  return 0.0;
+}
+
+}  // namespace
+
+string RenderStats::json_report()
+{
+  string result = "{\n\"traceEvents\": [\n";
+  for (size_t i = 0; i < timeline.size(); i++) {
+    result += json_trace_event(timeline[i]);
+    result += (i + 1 < timeline.size()) ? ",\n" : "\n";
+  }
+  result += "],\n";
+  result += "\"displayTimeUnit\": \"ms\",\n";
+
+  /* Tile throughput in path samples per second. */
+  uint64_t num_tiles = 0;
+  double tile_time = 0.0, tile_samples = 0.0;
+  foreach (const TimelineEvent &event, timeline) {
+    if (event.type == TimelineEvent::DURATION && event.category == "tile") {
+      num_tiles++;
+      tile_time += event.duration;
+      tile_samples += event_arg(event, "pixels") * event_arg(event, "samples");
+    }
+  }
+
+  result += "\"stats\": {\n";
+  result += string_printf("  \"version\": %s,\n", json_string(CYCLES_VERSION_STRING).c_str());
+  result += "  \"scene_update\": " + json_category_durations(timeline, "scene") + ",\n";
+  result += "  \"bvh\": " + json_category_durations(timeline, "bvh") + ",\n";
+  result += "  \"image_load\": " + json_category_durations(timeline, "image") + ",\n";
+  result += "  \"geometry_memory\": " + json_size_stats(mesh.geometry) + ",\n";
+  result += "  \"texture_memory\": " + json_size_stats(image.textures) + ",\n";
+  result += "  \"device_memory\": " + json_size_stats(device_memory) + ",\n";
+  result += string_printf(
+      "  \"system_memory\": {\"used\": %zu, \"peak\": %zu},\n", mem_used, mem_peak);
+  result += string_printf(
+      "  \"tiles\": {\"count\": %llu, \"time\": %s, \"samples_per_second\": %s}",
+      (unsigned long long)num_tiles,
+      json_number(tile_time, "%.6f").c_str(),
+      json_number((tile_time > 0.0) ? tile_samples / tile_time : 0.0, "%.3f").c_str());
+  if (has_profiling) {
+    result += ",\n  \"kernel\": " + json_nested_sample_stats(kernel);
+    result += ",\n  \"shaders\": " + json_sample_count_stats(shaders);
+    result += ",\n  \"objects\": " + json_sample_count_stats(objects);
+  }
+  result += "\n}\n}\n";
+  return result;
+}
+
 CCL_NAMESPACE_END
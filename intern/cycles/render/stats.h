@@ -21,6 +21,7 @@
 
 #include "util/util_stats.h"
 #include "util/util_string.h"
+#include "util/util_timeline.h"
 #include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
@@ -133,6 +134,13 @@ class ImageStats {
   string full_report(int indent_level = 0);
 
   NamedSizeStats textures;
+
+  /* Texture cache, when images are loaded on demand. */
+  bool use_cache;
+  uint64_t cache_tile_lookups;
+  uint64_t cache_tile_misses;
+  size_t cache_memory_used;
+  size_t cache_bytes_read;
 };
 
 /* Render process statistics. */
@@ -143,6 +151,11 @@ class RenderStats {
   /* Return full report as string. */
   string full_report();
 
+  /* Return full report as JSON. The timeline is stored as "traceEvents", so
+   * the file can be opened directly in chrome://tracing or Perfetto, other
+   * statistics are stored under "stats". */
+  string json_report();
+
   /* Collect kernel sampling information from Stats. */
   void collect_profiling(Scene *scene, Profiler &prof);
 
@@ -153,6 +166,16 @@ class RenderStats {
   NamedNestedSampleStats kernel;
   NamedSampleCountStats shaders;
   NamedSampleCountStats objects;
+
+  /* Device memory used by the scene, by category. */
+  NamedSizeStats device_memory;
+
+  /* System memory. */
+  size_t mem_used;
+  size_t mem_peak;
+
+  /* Scene update, BVH build, image loading and tile rendering events. */
+  vector<TimelineEvent> timeline;
 };
 
 CCL_NAMESPACE_END
@@ -103,9 +103,29 @@ typedef struct TextureInfo {
   uint width, height, depth;
   /* Transform for 3D textures. */
   uint use_transform_3d;
+  /* Data points to a TextureCacheHandle instead of pixels (CPU only). */
+  uint use_cache;
   Transform transform_3d;
 } TextureInfo;
 
+#ifndef __KERNEL_GPU__
+/* Texture Cache Handle
+ *
+ * Image that is not loaded into memory, but looked up on demand from a tiled,
+ * mip-mapped texture cache. On the CPU the kernel calls into this through the
+ * TextureInfo data pointer. */
+class TextureCacheHandle {
+ public:
+  virtual ~TextureCacheHandle()
+  {
+  }
+
+  /* Filtered lookup, with texture coordinate differentials used for selecting
+   * the mip-map level. Zero differentials give the full resolution image. */
+  virtual float4 lookup(float x, float y, float2 dx, float2 dy) = 0;
+};
+#endif
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "util/util_timeline.h"
+#include "util/util_time.h"
+
+CCL_NAMESPACE_BEGIN
+
+TimelineEvent::TimelineEvent(Type type,
+                             const string &name,
+                             const string &category,
+                             double start,
+                             double duration,
+                             int thread)
+    : type(type), name(name), category(category), start(start), duration(duration), thread(thread)
+{
+}
+
+Timeline::Timeline() : enabled(false), begin_time(time_dt())
+{
+}
+
+void Timeline::reset()
+{
+  thread_scoped_lock lock(mutex);
+  events.clear();
+  thread_indices.clear();
+  begin_time = time_dt();
+}
+
+void Timeline::set_enabled(bool enabled_)
+{
+  thread_scoped_lock lock(mutex);
+  enabled = enabled_;
+}
+
+bool Timeline::is_enabled() const
+{
+  thread_scoped_lock lock(mutex);
+  return enabled;
+}
+
+int Timeline::thread_index()
+{
+  const std::thread::id id = std::this_thread::get_id();
+  map<std::thread::id, int>::iterator it = thread_indices.find(id);
+  if (it != thread_indices.end()) {
+    return it->second;
+  }
+
+  const int index = thread_indices.size();
+  thread_indices[id] = index;
+  return index;
+}
+
+void Timeline::add_event(const string &name,
+                         const string &category,
+                         double start_time,
+                         double end_time,
+                         const vector<pair<string, double>> &args)
+{
+  thread_scoped_lock lock(mutex);
+  if (!enabled) {
+    return;
+  }
+
+  events.push_back(TimelineEvent(TimelineEvent::DURATION,
+                                 name,
+                                 category,
+                                 start_time - begin_time,
+                                 end_time - start_time,
+                                 thread_index()));
+  events.back().args = args;
+}
+
+void Timeline::add_counter(const string &name, const vector<pair<string, double>> &values)
+{
+  thread_scoped_lock lock(mutex);
+  if (!enabled) {
+    return;
+  }
+
+  events.push_back(
+      TimelineEvent(TimelineEvent::COUNTER, name, "counter", time_dt() - begin_time, 0.0, 0));
+  events.back().args = values;
+}
+
+vector<TimelineEvent> Timeline::get_events()
+{
+  thread_scoped_lock lock(mutex);
+  return events;
+}
+
+/* Scoped event. */
+
+scoped_timeline_event::scoped_timeline_event(Timeline *timeline,
+                                             const string &name,
+                                             const string &category)
+    : timeline(timeline), name(name), category(category), start_time(time_dt())
+{
+}
+
+scoped_timeline_event::~scoped_timeline_event()
+{
+  if (timeline) {
+    timeline->add_event(name, category, start_time, time_dt());
+  }
+}
+
+/* Scoped stages. */
+
+scoped_timeline_stages::scoped_timeline_stages(Timeline *timeline, const string &category)
+    : timeline(timeline), category(category), start_time(0.0)
+{
+}
+
+scoped_timeline_stages::~scoped_timeline_stages()
+{
+  end();
+}
+
+void scoped_timeline_stages::end()
+{
+  if (timeline && !name.empty()) {
+    timeline->add_event(name, category, start_time, time_dt());
+  }
+}
+
+void scoped_timeline_stages::next(const string &name_)
+{
+  end();
+  name = name_;
+  start_time = time_dt();
+}
+
+CCL_NAMESPACE_END
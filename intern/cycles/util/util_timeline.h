@@ -0,0 +1,119 @@
+/*
+ * Copyright 2011-2020 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __UTIL_TIMELINE_H__
+#define __UTIL_TIMELINE_H__
+
+#include "util/util_map.h"
+#include "util/util_string.h"
+#include "util/util_thread.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Event on the timeline of a render. Times are in seconds since the timeline
+ * was reset. Counter events sample values at a point in time and have no
+ * duration. */
+class TimelineEvent {
+ public:
+  enum Type { DURATION, COUNTER };
+
+  TimelineEvent(Type type,
+                const string &name,
+                const string &category,
+                double start,
+                double duration,
+                int thread);
+
+  Type type;
+  string name;
+  string category;
+  double start;
+  double duration;
+  int thread;
+
+  /* Numeric arguments, like the number of samples of a tile, or the values
+   * of a counter. */
+  vector<pair<string, double>> args;
+};
+
+/* Thread safe recording of timeline events. Disabled by default, so that
+ * interactive renders do not accumulate events indefinitely, and only enabled
+ * when the events are used (see SessionParams::use_timeline). */
+class Timeline {
+ public:
+  Timeline();
+
+  void reset();
+
+  void set_enabled(bool enabled);
+  bool is_enabled() const;
+
+  /* Add event, with start and end time as returned by time_dt(). */
+  void add_event(const string &name,
+                 const string &category,
+                 double start_time,
+                 double end_time,
+                 const vector<pair<string, double>> &args = vector<pair<string, double>>());
+  void add_counter(const string &name, const vector<pair<string, double>> &values);
+
+  vector<TimelineEvent> get_events();
+
+ protected:
+  /* Small consecutive index for the calling thread, for display. */
+  int thread_index();
+
+  bool enabled;
+  double begin_time;
+  vector<TimelineEvent> events;
+  map<std::thread::id, int> thread_indices;
+  mutable thread_mutex mutex;
+};
+
+/* Adds an event for the lifetime of the scope. */
+class scoped_timeline_event {
+ public:
+  scoped_timeline_event(Timeline *timeline, const string &name, const string &category);
+  ~scoped_timeline_event();
+
+ protected:
+  Timeline *timeline;
+  string name;
+  string category;
+  double start_time;
+};
+
+/* Adds consecutive events for the stages of a process, each lasting until the
+ * next one starts or the scope ends. */
+class scoped_timeline_stages {
+ public:
+  scoped_timeline_stages(Timeline *timeline, const string &category);
+  ~scoped_timeline_stages();
+
+  void next(const string &name);
+
+ protected:
+  void end();
+
+  Timeline *timeline;
+  string category;
+  string name;
+  double start_time;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __UTIL_TIMELINE_H__ */
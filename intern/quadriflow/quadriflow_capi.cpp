@@ -49,18 +49,6 @@ struct ObjVertex {
   }
 };
 
-struct ObjVertexHash : std::unary_function<ObjVertex, size_t> {
-  std::size_t operator()(const ObjVertex &v) const
-  {
-    size_t hash = std::hash<uint32_t>()(v.p);
-    hash = hash * 37 + std::hash<uint32_t>()(v.uv);
-    hash = hash * 37 + std::hash<uint32_t>()(v.n);
-    return hash;
-  }
-};
-
-typedef std::unordered_map<ObjVertex, uint32_t, ObjVertexHash> VertexMap;
-
 static int check_if_canceled(float progress,
                              void (*update_cb)(void *, float progress, int *cancel),
                              void *update_cb_data)
@@ -75,7 +63,6 @@ void QFLOW_quadriflow_remesh(QuadriflowRemeshData *qrd,
                              void *update_cb_data)
 {
   Parametrizer field;
-  VertexMap vertexMap;
 
   /* Get remeshing parameters. */
   int faces = qrd->target_faces;
@@ -113,28 +100,18 @@ void QFLOW_quadriflow_remesh(QuadriflowRemeshData *qrd,
     positions.push_back(v);
   }
 
-  for (int q = 0; q < qrd->totfaces; q++) {
-    Vector3i f(qrd->faces[q * 3], qrd->faces[q * 3 + 1], qrd->faces[q * 3 + 2]);
+  /* Vertices are numbered in the order they are first used by a face, unused ones are skipped.
+   * A plain remap table does this without hashing every corner of the input. */
+  std::vector<uint32_t> vertexMap(qrd->totverts, (uint32_t)-1);
+  indices.reserve(qrd->totfaces * 3);
 
-    ObjVertex tri[6];
-    int nVertices = 3;
-
-    tri[0] = ObjVertex(f[0]);
-    tri[1] = ObjVertex(f[1]);
-    tri[2] = ObjVertex(f[2]);
-
-    for (int i = 0; i < nVertices; ++i) {
-      const ObjVertex &v = tri[i];
-      VertexMap::const_iterator it = vertexMap.find(v);
-      if (it == vertexMap.end()) {
-        vertexMap[v] = (uint32_t)vertices.size();
-        indices.push_back((uint32_t)vertices.size());
-        vertices.push_back(v);
-      }
-      else {
-        indices.push_back(it->second);
-      }
+  for (int q = 0; q < qrd->totfaces * 3; q++) {
+    const uint32_t p = qrd->faces[q];
+    if (vertexMap[p] == (uint32_t)-1) {
+      vertexMap[p] = (uint32_t)vertices.size();
+      vertices.push_back(ObjVertex(p));
     }
+    indices.push_back(vertexMap[p]);
   }
 
   field.F.resize(3, indices.size() / 3);
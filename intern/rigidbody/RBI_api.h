@@ -58,6 +58,11 @@ typedef struct rbMeshData rbMeshData;
 /* Constraint */
 typedef struct rbConstraint rbConstraint;
 
+/* Runs func for every index in [0, num), possibly in parallel */
+typedef void (*rbParallelRangeFunc)(void *userdata,
+                                    int num,
+                                    void (*func)(void *userdata, int index));
+
 /* ********************************** */
 /* Dynamics World Methods */
 
@@ -80,6 +85,8 @@ void RB_dworld_set_gravity(rbDynamicsWorld *world, const float g_in[3]);
 void RB_dworld_set_solver_iterations(rbDynamicsWorld *world, int num_solver_iterations);
 /* Split Impulse */
 void RB_dworld_set_split_impulse(rbDynamicsWorld *world, int split_impulse);
+/* Solve independent simulation islands in parallel, NULL solves them one at a time */
+void RB_dworld_set_parallel_range(rbDynamicsWorld *world, rbParallelRangeFunc parallel_range);
 
 /* Simulation ----------------------- */
 
@@ -51,7 +51,9 @@
  */
 
 #include <errno.h>
+#include <mutex>
 #include <stdio.h>
+#include <vector>
 
 #include "RBI_api.h"
 
@@ -63,12 +65,263 @@
 #include "LinearMath/btTransform.h"
 #include "LinearMath/btVector3.h"
 
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
 #include "BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h"
 #include "BulletCollision/Gimpact/btGImpactCollisionAlgorithm.h"
 #include "BulletCollision/Gimpact/btGImpactShape.h"
 
+/* ********************************** */
+/* Parallel Island Solving */
+
+/* Simulation islands don't interact with each other, so groups of them can be solved at the same
+ * time by separate constraint solvers. Islands are grouped into batches the same way Bullet
+ * groups them when solving one batch after another, which keeps the results identical.
+ *
+ * Requires Bullet to be built without its profiler, which is not thread safe. */
+
+struct rbIslandBatch {
+  btAlignedObjectArray<btCollisionObject *> bodies;
+  btAlignedObjectArray<btPersistentManifold *> manifolds;
+  btAlignedObjectArray<btTypedConstraint *> constraints;
+  /* Uses objects outside of islands which the solver keeps temporary state on (kinematic
+   * objects), these batches are solved one at a time. */
+  bool use_shared_objects;
+};
+
+static inline int rb_constraint_island_id(const btTypedConstraint *constraint)
+{
+  const btCollisionObject &object_a = constraint->getRigidBodyA();
+  const btCollisionObject &object_b = constraint->getRigidBodyB();
+  return (object_a.getIslandTag() >= 0) ? object_a.getIslandTag() : object_b.getIslandTag();
+}
+
+struct rbConstraintIslandLess {
+  bool operator()(const btTypedConstraint *a, const btTypedConstraint *b) const
+  {
+    return rb_constraint_island_id(a) < rb_constraint_island_id(b);
+  }
+};
+
+static inline bool rb_object_is_shared(const btCollisionObject *object)
+{
+  if (object->getIslandTag() >= 0) {
+    return false;
+  }
+  const btRigidBody *body = btRigidBody::upcast(object);
+  return body && (body->getInvMass() != btScalar(0) || body->isKinematicObject());
+}
+
+class rbParallelDynamicsWorld : public btDiscreteDynamicsWorld {
+ public:
+  rbParallelRangeFunc parallel_range;
+
+  rbParallelDynamicsWorld(btDispatcher *dispatcher,
+                          btBroadphaseInterface *pairCache,
+                          btConstraintSolver *constraintSolver,
+                          btCollisionConfiguration *collisionConfiguration)
+      : btDiscreteDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+        parallel_range(NULL),
+        m_batches_num(0),
+        m_solver_info(NULL)
+  {
+  }
+
+  virtual ~rbParallelDynamicsWorld()
+  {
+    for (size_t i = 0; i < m_solvers.size(); i++) {
+      delete m_solvers[i];
+    }
+  }
+
+ protected:
+  struct IslandCallback : public btSimulationIslandManager::IslandCallback {
+    rbParallelDynamicsWorld *world;
+    const btContactSolverInfo *solver_info;
+    btTypedConstraint **sorted_constraints;
+    int sorted_constraints_num;
+
+    /* Same grouping as Bullet's InplaceSolverIslandCallback. */
+    virtual void processIsland(btCollisionObject **bodies,
+                               int numBodies,
+                               btPersistentManifold **manifolds,
+                               int numManifolds,
+                               int islandId)
+    {
+      btTypedConstraint **constraints = sorted_constraints;
+      int constraints_num = sorted_constraints_num;
+
+      if (islandId >= 0) {
+        int i = 0;
+        while (i < sorted_constraints_num &&
+               rb_constraint_island_id(sorted_constraints[i]) != islandId) {
+          i++;
+        }
+        constraints = (i < sorted_constraints_num) ? &sorted_constraints[i] : NULL;
+        constraints_num = 0;
+        for (; i < sorted_constraints_num; i++) {
+          if (rb_constraint_island_id(sorted_constraints[i]) == islandId) {
+            constraints_num++;
+          }
+        }
+      }
+
+      rbIslandBatch &batch = world->batch_current();
+      for (int i = 0; i < numBodies; i++) {
+        batch.bodies.push_back(bodies[i]);
+      }
+      for (int i = 0; i < numManifolds; i++) {
+        batch.manifolds.push_back(manifolds[i]);
+        batch.use_shared_objects |= rb_object_is_shared(manifolds[i]->getBody0()) ||
+                                    rb_object_is_shared(manifolds[i]->getBody1());
+      }
+      for (int i = 0; i < constraints_num; i++) {
+        batch.constraints.push_back(constraints[i]);
+        batch.use_shared_objects |= rb_object_is_shared(&constraints[i]->getRigidBodyA()) ||
+                                    rb_object_is_shared(&constraints[i]->getRigidBodyB());
+      }
+
+      if (islandId < 0 || solver_info->m_minimumSolverBatchSize <= 1 ||
+          (batch.constraints.size() + batch.manifolds.size()) >
+              solver_info->m_minimumSolverBatchSize) {
+        world->batch_finish();
+      }
+    }
+  };
+
+  std::vector<rbIslandBatch> m_batches;
+  int m_batches_num;
+
+  /* Constraint solvers for the batches being solved, one per running task. */
+  std::vector<btSequentialImpulseConstraintSolver *> m_solvers;
+  std::mutex m_solvers_mutex;
+
+  const btContactSolverInfo *m_solver_info;
+
+  rbIslandBatch &batch_current()
+  {
+    if (m_batches_num == (int)m_batches.size()) {
+      m_batches.resize(m_batches_num + 1);
+      batch_clear(m_batches.back());
+    }
+    return m_batches[m_batches_num];
+  }
+
+  void batch_finish()
+  {
+    rbIslandBatch &batch = batch_current();
+    if (batch.bodies.size() || batch.manifolds.size() || batch.constraints.size()) {
+      m_batches_num++;
+      if (m_batches_num < (int)m_batches.size()) {
+        batch_clear(m_batches[m_batches_num]);
+      }
+    }
+  }
+
+  static void batch_clear(rbIslandBatch &batch)
+  {
+    batch.bodies.resize(0);
+    batch.manifolds.resize(0);
+    batch.constraints.resize(0);
+    batch.use_shared_objects = false;
+  }
+
+  btSequentialImpulseConstraintSolver *solver_acquire()
+  {
+    std::lock_guard<std::mutex> lock(m_solvers_mutex);
+    if (m_solvers.empty()) {
+      return new btSequentialImpulseConstraintSolver();
+    }
+    btSequentialImpulseConstraintSolver *solver = m_solvers.back();
+    m_solvers.pop_back();
+    return solver;
+  }
+
+  void solver_release(btSequentialImpulseConstraintSolver *solver)
+  {
+    std::lock_guard<std::mutex> lock(m_solvers_mutex);
+    m_solvers.push_back(solver);
+  }
+
+  void batch_solve(rbIslandBatch &batch, btConstraintSolver *solver)
+  {
+    solver->solveGroup(batch.bodies.size() ? &batch.bodies[0] : NULL,
+                       batch.bodies.size(),
+                       batch.manifolds.size() ? &batch.manifolds[0] : NULL,
+                       batch.manifolds.size(),
+                       batch.constraints.size() ? &batch.constraints[0] : NULL,
+                       batch.constraints.size(),
+                       *m_solver_info,
+                       m_debugDrawer,
+                       m_dispatcher1);
+  }
+
+  static void batch_solve_task(void *userdata, int index)
+  {
+    rbParallelDynamicsWorld *world = (rbParallelDynamicsWorld *)userdata;
+    rbIslandBatch &batch = world->m_batches[index];
+
+    if (batch.use_shared_objects) {
+      return;
+    }
+
+    btSequentialImpulseConstraintSolver *solver = world->solver_acquire();
+    world->batch_solve(batch, solver);
+    world->solver_release(solver);
+  }
+
+  virtual void solveConstraints(btContactSolverInfo &solverInfo)
+  {
+#ifdef BT_NO_PROFILE
+    const bool use_parallel = (parallel_range != NULL);
+#else
+    const bool use_parallel = false;
+#endif
+
+    if (!use_parallel) {
+      btDiscreteDynamicsWorld::solveConstraints(solverInfo);
+      return;
+    }
+
+    m_sortedConstraints.resize(m_constraints.size());
+    for (int i = 0; i < m_constraints.size(); i++) {
+      m_sortedConstraints[i] = m_constraints[i];
+    }
+    m_sortedConstraints.quickSort(rbConstraintIslandLess());
+
+    IslandCallback callback;
+    callback.world = this;
+    callback.solver_info = &solverInfo;
+    callback.sorted_constraints = m_sortedConstraints.size() ? &m_sortedConstraints[0] : NULL;
+    callback.sorted_constraints_num = m_sortedConstraints.size();
+
+    m_solver_info = &solverInfo;
+    m_batches_num = 0;
+    if (!m_batches.empty()) {
+      batch_clear(m_batches[0]);
+    }
+
+    m_constraintSolver->prepareSolve(getCollisionWorld()->getNumCollisionObjects(),
+                                     getCollisionWorld()->getDispatcher()->getNumManifolds());
+
+    /* Collect the batches, then solve them. */
+    m_islandManager->buildAndProcessIslands(
+        getCollisionWorld()->getDispatcher(), getCollisionWorld(), &callback);
+    batch_finish();
+
+    parallel_range(this, m_batches_num, batch_solve_task);
+
+    for (int i = 0; i < m_batches_num; i++) {
+      if (m_batches[i].use_shared_objects) {
+        batch_solve(m_batches[i], m_constraintSolver);
+      }
+    }
+
+    m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+  }
+};
+
 struct rbDynamicsWorld {
-  btDiscreteDynamicsWorld *dynamicsWorld;
+  rbParallelDynamicsWorld *dynamicsWorld;
   btDefaultCollisionConfiguration *collisionConfiguration;
   btDispatcher *dispatcher;
   btBroadphaseInterface *pairCache;
@@ -153,7 +406,7 @@ rbDynamicsWorld *RB_dworld_new(const float gravity[3])
   world->constraintSolver = new btSequentialImpulseConstraintSolver();
 
   /* world */
-  world->dynamicsWorld = new btDiscreteDynamicsWorld(
+  world->dynamicsWorld = new rbParallelDynamicsWorld(
       world->dispatcher, world->pairCache, world->constraintSolver, world->collisionConfiguration);
 
   RB_dworld_set_gravity(world, gravity);
@@ -202,6 +455,12 @@ void RB_dworld_set_split_impulse(rbDynamicsWorld *world, int split_impulse)
   info.m_splitImpulse = split_impulse;
 }
 
+/* Multithreading */
+void RB_dworld_set_parallel_range(rbDynamicsWorld *world, rbParallelRangeFunc parallel_range)
+{
+  world->dynamicsWorld->parallel_range = parallel_range;
+}
+
 /* Simulation ----------------------- */
 
 void RB_dworld_step_simulation(rbDynamicsWorld *world,
@@ -226,6 +226,10 @@ const UserDef U_default = {
     .sequencer_disk_cache_size_limit = 100,
     .sequencer_disk_cache_flag = 0,
 
+    .mesh_disk_cache_dir = "",
+    .mesh_disk_cache_size_limit = 2048,
+    .mesh_disk_cache_flag = 0,
+
     .runtime =
         {
             .is_dirty = 0,
@@ -491,6 +491,32 @@ class Mesh(bpy_types.ID):
     def edge_keys(self):
         return [ed.key for ed in self.edges]
 
+    def attribute_buffer(self, type, name=""):
+        """
+        Access an array of the mesh through the buffer protocol, without copying.
+
+        :arg type: The array to access, one of
+           ``'POSITION'``, ``'EDGE_VERTICES'``, ``'LOOP_VERTEX'``, ``'LOOP_EDGE'``,
+           ``'POLYGON_LOOP_START'``, ``'POLYGON_LOOP_TOTAL'``, ``'POLYGON_MATERIAL_INDEX'``,
+           ``'UV'``, ``'COLOR'``,
+           ``'VERTEX_FLOAT'``, ``'VERTEX_INT'``, ``'POLYGON_FLOAT'``, ``'POLYGON_INT'``.
+        :type type: string
+        :arg name: Name of the layer for types with multiple layers,
+           the active layer is used when empty.
+        :type name: string
+
+        Views of the buffer read and write the mesh data directly.
+        Writable views (``numpy.asarray(buffer)``) tag the mesh for update,
+        read-only views (``memoryview(buffer)``) leave the mesh untouched.
+
+        .. warning::
+
+           Views are invalid once the geometry of the mesh changes
+           (elements or layers added or removed, edit-mode toggled),
+           request a new view from the buffer then.
+        """
+        return _bpy._rna_mesh_attribute_buffer(self, type, name)
+
 
 class MeshEdge(StructRNA):
     __slots__ = ()
@@ -63,6 +63,11 @@ void BKE_cachefile_reader_open(struct CacheFile *cache_file,
                                const char *object_path);
 void BKE_cachefile_reader_free(struct CacheFile *cache_file, struct CacheReader **reader);
 
+/* Statistics of mesh samples read ahead in the background, for evaluated cache files. */
+void BKE_cachefile_prefetch_stats_get(const struct CacheFile *cache_file,
+                                      int *r_hits,
+                                      int *r_misses);
+
 #ifdef __cplusplus
 }
 #endif
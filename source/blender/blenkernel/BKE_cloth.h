@@ -47,6 +47,10 @@ struct Scene;
  * represented by a float, given its precision. */
 #define ALMOST_ZERO FLT_EPSILON
 
+/* Extra distance the self collision tree is inflated by, relative to the self collision
+ * distance. Candidate pairs are reused while vertices move less than this. */
+#define CLOTH_SELFCOLL_MARGIN_FACTOR 0.5f
+
 /* Bits to or into the ClothVertex.flags. */
 typedef enum eClothVertexFlag {
   CLOTH_VERT_FLAG_PINNED = (1 << 0),
@@ -67,6 +71,11 @@ typedef struct ClothSolverResult {
   int max_iterations, min_iterations;
   float avg_iterations;
   float max_error, min_error, avg_error;
+
+  /* Timings of the last solved frame, in seconds. */
+  int substeps;
+  float force_time, solve_time, collision_time;
+  float avg_substep_time, max_substep_time;
 } ClothSolverResult;
 
 /**
@@ -96,6 +105,7 @@ typedef struct Cloth {
   float initial_mesh_volume;    /* Initial volume of the mesh. Used for pressure */
   struct MEdge *edges;          /* Used for hair collisions. */
   struct GHash *sew_edge_graph; /* Sewing edges represented using a GHash */
+  struct ClothSelfCollisionCache *selfcoll_cache; /* Self collision pairs kept between steps. */
 } Cloth;
 
 /**
@@ -271,6 +281,7 @@ int cloth_bvh_collision(struct Depsgraph *depsgraph,
                         struct ClothModifierData *clmd,
                         float step,
                         float dt);
+void cloth_selfcollision_cache_free(struct Cloth *cloth);
 
 ////////////////////////////////////////////////
 
@@ -36,6 +36,7 @@ extern "C" {
 
 struct BMesh;
 struct CustomData;
+struct CustomDataLayerShared;
 struct CustomData_MeshMasks;
 struct ID;
 typedef uint64_t CustomDataMask;
@@ -69,7 +70,10 @@ typedef enum eCDAllocType {
   CD_CALLOC = 1,
   /** Allocate and set to default. */
   CD_DEFAULT = 2,
-  /** Use data pointers, set layer flag NOFREE. */
+  /**
+   * Use data pointers, when the source layer owns its data it's shared (copy-on-write),
+   * otherwise the layer flag NOFREE is set.
+   */
   CD_REFERENCE = 3,
   /** Do a full copy of all layers, only allowed if source has same number of elements. */
   CD_DUPLICATE = 4,
@@ -217,8 +221,8 @@ bool CustomData_has_layer(const struct CustomData *data, int type);
 int CustomData_number_of_layers(const struct CustomData *data, int type);
 int CustomData_number_of_layers_typemask(const struct CustomData *data, CustomDataMask mask);
 
-/* duplicate data of a layer with flag NOFREE, and remove that flag.
- * returns the layer data */
+/* duplicate data of a layer with flag NOFREE or data shared with other layers,
+ * and remove that flag. returns the layer data */
 void *CustomData_duplicate_referenced_layer(struct CustomData *data,
                                             const int type,
                                             const int totelem);
@@ -230,8 +234,25 @@ void *CustomData_duplicate_referenced_layer_named(struct CustomData *data,
                                                   const int type,
                                                   const char *name,
                                                   const int totelem);
+void CustomData_duplicate_referenced_layers(struct CustomData *data, const int totelem);
 bool CustomData_is_referenced_layer(struct CustomData *data, int type);
 
+void *CustomData_layer_export(struct CustomData *data,
+                              const int layer_index,
+                              const int totelem,
+                              const bool for_write,
+                              struct CustomDataLayerShared **r_shared);
+void CustomData_layer_export_release(struct CustomDataLayerShared *shared,
+                                     const int type,
+                                     void *layer_data,
+                                     const int totelem);
+
+/* Bytes of layer data which is currently shared with other layers (for statistics). */
+size_t CustomData_get_shared_size(const struct CustomData *data, const int totelem);
+
+/* Total bytes of layer data copied and shared since startup (for statistics). */
+void CustomData_memory_stats_get(size_t *r_bytes_copied, size_t *r_bytes_shared);
+
 /* set the CD_FLAG_NOCOPY flag in custom data layers where the mask is
  * zero for the layer type, so only layer types specified by the mask
  * will be copied
@@ -372,7 +393,8 @@ void CustomData_bmesh_set_n(
  */
 void CustomData_bmesh_set_layer_n(struct CustomData *data, void *block, int n, const void *source);
 
-/* set the pointer of to the first layer of type. the old data is not freed.
+/* set the pointer of to the first layer of type. the old data is not freed,
+ * shared layers have to be duplicated first (see CustomData_duplicate_referenced_layer).
  * returns the value of ptr if the layer is found, NULL otherwise
  */
 void *CustomData_set_layer(const struct CustomData *data, int type, void *ptr);
@@ -425,6 +447,7 @@ int CustomData_sizeof(int type);
 /* get the name of a layer type */
 const char *CustomData_layertype_name(int type);
 bool CustomData_layertype_is_singleton(int type);
+bool CustomData_layertype_is_plain_data(int type);
 int CustomData_layertype_layers_max(const int type);
 
 /* make sure the name of layer at index is unique */
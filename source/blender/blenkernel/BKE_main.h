@@ -52,6 +52,7 @@ struct GSet;
 struct ImBuf;
 struct Library;
 struct MainLock;
+struct MainNameMap;
 
 /* Blender thumbnail, as written on file (width, height, and data as char RGBA). */
 /* We pack pixel data after that struct. */
@@ -155,6 +156,13 @@ typedef struct Main {
    */
   struct MainIDRelations *relations;
 
+  /**
+   * Mapping of local ID names to IDs, for each ID type, used for name lookups and to generate
+   * unique names. Built on demand and kept in sync by the ID management code,
+   * see `BKE_main_idmap_names_` functions.
+   */
+  struct MainNameMap *name_map;
+
   struct MainLock *lock;
 } Main;
 
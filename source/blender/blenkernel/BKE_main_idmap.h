@@ -28,6 +28,7 @@
  * \section Function Names
  *
  * - `BKE_main_idmap_` Should be used for functions in that file.
+ * - `BKE_main_idmap_names_` for the persistent name mapping stored in #Main.name_map.
  */
 
 #include "BLI_compiler_attrs.h"
@@ -66,6 +67,19 @@ struct ID *BKE_main_idmap_lookup_uuid(struct IDNameLib_Map *id_typemap,
                                       const uint session_uuid) ATTR_WARN_UNUSED_RESULT
     ATTR_NONNULL(1);
 
+struct ID *BKE_main_idmap_names_lookup(struct Main *bmain,
+                                       const short id_type,
+                                       const char *name) ATTR_WARN_UNUSED_RESULT
+    ATTR_NONNULL();
+int BKE_main_idmap_names_number_unused(struct Main *bmain,
+                                       const short id_type,
+                                       const char *base_name,
+                                       const int number_min) ATTR_WARN_UNUSED_RESULT
+    ATTR_NONNULL();
+void BKE_main_idmap_names_add(struct Main *bmain, struct ID *id) ATTR_NONNULL();
+void BKE_main_idmap_names_remove(struct Main *bmain, struct ID *id) ATTR_NONNULL();
+void BKE_main_idmap_names_clear(struct Main *bmain) ATTR_NONNULL();
+
 #ifdef __cplusplus
 }
 #endif
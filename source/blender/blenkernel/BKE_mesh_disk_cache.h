@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+#ifndef __BKE_MESH_DISK_CACHE_H__
+#define __BKE_MESH_DISK_CACHE_H__
+
+/** \file
+ * \ingroup bke
+ *
+ * Optional on-disk cache of meshes evaluated by modifier stacks, which persists across file
+ * reloads and sessions. Enabled and configured in the user preferences.
+ */
+
+#include "BLI_sys_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct CustomData_MeshMasks;
+struct Depsgraph;
+struct Mesh;
+struct ModifierData;
+struct Object;
+struct Scene;
+
+#define MESH_DISK_CACHE_MAX_MODIFIERS 32
+
+/**
+ * Identifies a modifier stack evaluation. Besides the hash, data of the input is stored
+ * verbatim, so hash collisions between unrelated stacks are detected when reading.
+ */
+typedef struct MeshDiskCacheKey {
+  uint32_t hash[2];
+  int totvert, totedge, totloop, totpoly;
+  int totmodifier;
+  int modifier_types[MESH_DISK_CACHE_MAX_MODIFIERS];
+} MeshDiskCacheKey;
+
+bool BKE_mesh_disk_cache_is_enabled(void);
+
+bool BKE_mesh_disk_cache_key(const struct Scene *scene,
+                             const struct Object *ob,
+                             const struct Mesh *mesh_input,
+                             struct ModifierData *firstmd,
+                             const int required_mode,
+                             const int use_deform,
+                             const struct CustomData_MeshMasks *final_datamask,
+                             MeshDiskCacheKey *r_key);
+
+struct Mesh *BKE_mesh_disk_cache_read(const MeshDiskCacheKey *key,
+                                      const struct Mesh *mesh_input);
+bool BKE_mesh_disk_cache_write_is_allowed(const struct Depsgraph *depsgraph);
+void BKE_mesh_disk_cache_write(const MeshDiskCacheKey *key,
+                               const struct Object *ob,
+                               const struct Mesh *mesh);
+
+void BKE_mesh_disk_cache_exit(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BKE_MESH_DISK_CACHE_H__ */
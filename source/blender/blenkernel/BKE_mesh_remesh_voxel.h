@@ -44,11 +44,15 @@ struct Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLeve
                                                               bool relax_disoriented_triangles);
 #endif
 
+/* The remeshers take an optional `update_cb(update_cb_data, progress, &cancel)` callback, which
+ * is called with the progress between their stages. Setting cancel makes them return NULL. */
 struct Mesh *BKE_mesh_remesh_voxel_fix_poles(struct Mesh *mesh);
 struct Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(struct Mesh *mesh,
                                                   float voxel_size,
                                                   float adaptivity,
-                                                  float isovalue);
+                                                  float isovalue,
+                                                  void *update_cb,
+                                                  void *update_cb_data);
 struct Mesh *BKE_mesh_remesh_quadriflow_to_mesh_nomain(struct Mesh *mesh,
                                                        int target_faces,
                                                        int seed,
@@ -53,6 +53,7 @@
 #include "BKE_lib_id.h"
 #include "BKE_material.h"
 #include "BKE_mesh.h"
+#include "BKE_mesh_disk_cache.h"
 #include "BKE_mesh_iterators.h"
 #include "BKE_mesh_mapping.h"
 #include "BKE_mesh_runtime.h"
@@ -946,6 +947,28 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
   /* Clear errors before evaluation. */
   modifiers_clearErrors(ob);
 
+  /* Reuse the result of an earlier evaluation of the same stack, possibly from a previous session.
+   * Only supported when the whole stack is evaluated for the final mesh. */
+  MeshDiskCacheKey disk_cache_key;
+  const bool use_disk_cache = (index == -1 && !need_mapping && !sculpt_mode && previewmd == NULL &&
+                               BKE_mesh_disk_cache_key(scene,
+                                                       ob,
+                                                       mesh_input,
+                                                       firstmd,
+                                                       required_mode,
+                                                       useDeform,
+                                                       &final_datamask,
+                                                       &disk_cache_key));
+  Mesh *mesh_disk_cached = NULL;
+  if (use_disk_cache) {
+    mesh_disk_cached = BKE_mesh_disk_cache_read(&disk_cache_key, mesh_input);
+    if (mesh_disk_cached != NULL && r_deform == NULL) {
+      /* Skip all modifiers. */
+      md = NULL;
+    }
+  }
+  const bool is_disk_cached = (mesh_disk_cached != NULL);
+
   /* Apply all leading deform modifiers. */
   if (useDeform) {
     for (; md; md = md->next, md_datamask = md_datamask->next) {
@@ -998,6 +1021,16 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
     }
   }
 
+  /* Leading deform modifiers were only applied for the deformed mesh, the final mesh is read. */
+  if (is_disk_cached) {
+    if (mesh_final != NULL) {
+      BKE_id_free(NULL, mesh_final);
+    }
+    MEM_SAFE_FREE(deformed_verts);
+    mesh_final = mesh_disk_cached;
+    md = NULL;
+  }
+
   /* Apply all remaining constructive and deforming modifiers. */
   bool have_non_onlydeform_modifiers_appled = false;
   for (; md; md = md->next, md_datamask = md_datamask->next) {
@@ -1309,7 +1342,7 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
   if (final_datamask.vmask & CD_MASK_ORCO) {
     /* No need in ORCO layer if the mesh was not deformed or modified: undeformed mesh in this case
      * matches input mesh. */
-    if (is_own_mesh) {
+    if (is_own_mesh && !is_disk_cached) {
       add_orco_mesh(ob, NULL, mesh_final, mesh_orco, CD_ORCO);
     }
 
@@ -1325,6 +1358,11 @@ static void mesh_calc_modifiers(struct Depsgraph *depsgraph,
     BKE_id_free(NULL, mesh_orco_cloth);
   }
 
+  if (use_disk_cache && !is_disk_cached && is_own_mesh &&
+      BKE_mesh_disk_cache_write_is_allowed(depsgraph)) {
+    BKE_mesh_disk_cache_write(&disk_cache_key, ob, mesh_final);
+  }
+
   /* Compute normals. */
   if (is_own_mesh) {
     mesh_calc_modifier_final_normals(mesh_input, &final_datamask, sculpt_dyntopo, mesh_final);
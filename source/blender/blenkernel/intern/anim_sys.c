@@ -36,6 +36,7 @@
 #include "BLI_math_rotation.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -244,6 +245,8 @@ bool BKE_animdata_set_action(ReportList *reports, ID *id, bAction *act)
 
 /* Freeing -------------------------------------------- */
 
+static void animsys_eval_cache_free(AnimData *adt);
+
 /* Free AnimData used by the nominated ID-block, and clear ID-block's AnimData pointer */
 void BKE_animdata_free(ID *id, const bool do_id_user)
 {
@@ -276,6 +279,9 @@ void BKE_animdata_free(ID *id, const bool do_id_user)
       /* free driver array cache */
       MEM_SAFE_FREE(adt->driver_array);
 
+      /* free resolved channels cache */
+      animsys_eval_cache_free(adt);
+
       /* free overrides */
       /* TODO... */
 
@@ -344,6 +350,7 @@ AnimData *BKE_animdata_copy(Main *bmain, AnimData *adt, const int flag)
   /* duplicate drivers (F-Curves) */
   copy_fcurves(&dadt->drivers, &adt->drivers);
   dadt->driver_array = NULL;
+  dadt->eval_cache = NULL;
 
   /* don't copy overrides */
   BLI_listbase_clear(&dadt->overrides);
@@ -2077,6 +2084,175 @@ void animsys_evaluate_action(PointerRNA *ptr,
   animsys_evaluate_action_ex(ptr, act, ctime, flush_to_original);
 }
 
+/* ----------------------------------------- */
+/* Cached Action Evaluation */
+
+/* Resolving the RNA path of every F-Curve is a large part of evaluating animation. For evaluated
+ * data-blocks, the resolved paths of the active action are stored on the AnimData, and reused as
+ * long as no evaluated data-block has been copied from its original again, as that may free
+ * anything the paths resolved to. Changing frames doesn't do that, so this covers playback.
+ * The F-Curves are then evaluated in parallel and the values written in order afterwards. */
+
+/* Minimum number of F-Curves to evaluate in parallel. */
+#define ANIMSYS_EVAL_PARALLEL_MIN 256
+
+typedef struct AnimsysEvalChannel {
+  FCurve *fcu;
+  PathResolvedRNA anim_rna;
+  /** Original property to flush to, resolved on first use. */
+  PathResolvedRNA orig_anim_rna;
+  bool is_resolved;
+  bool is_orig_checked;
+  bool is_orig_resolved;
+
+  /** Per evaluation, value to write when evaluated in parallel. */
+  bool is_evaluated;
+  float value;
+} AnimsysEvalChannel;
+
+typedef struct AnimsysEvalCache {
+  bAction *action;
+  /** Value of #animsys_eval_cache_generation the paths were resolved at. */
+  unsigned int generation;
+  int totchannel;
+  AnimsysEvalChannel *channels;
+} AnimsysEvalCache;
+
+static unsigned int animsys_eval_cache_generation = 0;
+
+/**
+ * Invalidate resolved paths of animated channels on all evaluated AnimData,
+ * to be called when an evaluated data-block is copied from its original.
+ */
+void BKE_animsys_eval_cache_invalidate_all(void)
+{
+  atomic_add_and_fetch_u(&animsys_eval_cache_generation, 1);
+}
+
+static void animsys_eval_cache_free(AnimData *adt)
+{
+  AnimsysEvalCache *cache = adt->eval_cache;
+
+  if (cache) {
+    MEM_SAFE_FREE(cache->channels);
+    MEM_freeN(cache);
+    adt->eval_cache = NULL;
+  }
+}
+
+static AnimsysEvalCache *animsys_eval_cache_ensure(PointerRNA *ptr, AnimData *adt, bAction *act)
+{
+  const unsigned int generation = atomic_add_and_fetch_u(&animsys_eval_cache_generation, 0);
+  AnimsysEvalCache *cache = adt->eval_cache;
+
+  if (cache && cache->action == act && cache->generation == generation) {
+    return cache;
+  }
+
+  if (cache == NULL) {
+    cache = MEM_callocN(sizeof(*cache), __func__);
+    adt->eval_cache = cache;
+  }
+  MEM_SAFE_FREE(cache->channels);
+
+  cache->action = act;
+  cache->generation = generation;
+  cache->totchannel = BLI_listbase_count(&act->curves);
+  cache->channels = MEM_callocN(sizeof(*cache->channels) * cache->totchannel, __func__);
+
+  AnimsysEvalChannel *channel = cache->channels;
+  for (FCurve *fcu = act->curves.first; fcu; fcu = fcu->next, channel++) {
+    channel->fcu = fcu;
+    channel->is_resolved = BKE_animsys_store_rna_setting(
+        ptr, fcu->rna_path, fcu->array_index, &channel->anim_rna);
+  }
+
+  return cache;
+}
+
+/* Same checks as #animsys_evaluate_fcurves. */
+BLI_INLINE bool animsys_eval_channel_is_active(const AnimsysEvalChannel *channel)
+{
+  FCurve *fcu = channel->fcu;
+
+  return channel->is_resolved && !((fcu->grp != NULL) && (fcu->grp->flag & AGRP_MUTED)) &&
+         !(fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) && !BKE_fcurve_is_empty(fcu);
+}
+
+typedef struct AnimsysEvalChannelsData {
+  AnimsysEvalChannel *channels;
+  float ctime;
+} AnimsysEvalChannelsData;
+
+static void animsys_evaluate_channels_cb(void *__restrict userdata,
+                                         const int index,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const AnimsysEvalChannelsData *data = userdata;
+  AnimsysEvalChannel *channel = &data->channels[index];
+
+  /* Drivers may read properties written by other channels, keep those in order. */
+  channel->is_evaluated = animsys_eval_channel_is_active(channel) && channel->fcu->driver == NULL;
+  if (channel->is_evaluated) {
+    channel->value = calculate_fcurve(&channel->anim_rna, channel->fcu, data->ctime);
+  }
+}
+
+/* Same as #animsys_evaluate_action_ex, using the resolved channels cached on the AnimData. */
+static void animsys_evaluate_action_cached(PointerRNA *ptr,
+                                           AnimData *adt,
+                                           bAction *act,
+                                           float ctime,
+                                           const bool flush_to_original)
+{
+  action_idcode_patch_check(ptr->owner_id, act);
+
+  AnimsysEvalCache *cache = animsys_eval_cache_ensure(ptr, adt, act);
+  AnimsysEvalChannelsData data = {
+      .channels = cache->channels,
+      .ctime = ctime,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (cache->totchannel >= ANIMSYS_EVAL_PARALLEL_MIN);
+  settings.min_iter_per_thread = ANIMSYS_EVAL_PARALLEL_MIN / 4;
+  BLI_task_parallel_range(0, cache->totchannel, &data, animsys_evaluate_channels_cb, &settings);
+
+  for (int i = 0; i < cache->totchannel; i++) {
+    AnimsysEvalChannel *channel = &cache->channels[i];
+    FCurve *fcu = channel->fcu;
+    float curval;
+
+    if (channel->is_evaluated) {
+      curval = channel->value;
+    }
+    else if (fcu->driver && animsys_eval_channel_is_active(channel)) {
+      curval = calculate_fcurve(&channel->anim_rna, fcu, ctime);
+    }
+    else {
+      continue;
+    }
+
+    BKE_animsys_write_rna_setting(&channel->anim_rna, curval);
+
+    if (flush_to_original) {
+      if (!channel->is_orig_checked) {
+        PointerRNA ptr_orig;
+        channel->is_orig_checked = true;
+        channel->is_orig_resolved = animsys_construct_orig_pointer_rna(ptr, &ptr_orig) &&
+                                    BKE_animsys_store_rna_setting(&ptr_orig,
+                                                                  fcu->rna_path,
+                                                                  fcu->array_index,
+                                                                  &channel->orig_anim_rna);
+      }
+      if (channel->is_orig_resolved) {
+        BKE_animsys_write_rna_setting(&channel->orig_anim_rna, curval);
+      }
+    }
+  }
+}
+
 /* ***************************************** */
 /* NLA System - Evaluation */
 
@@ -3902,7 +4078,12 @@ void BKE_animsys_evaluate_animdata(
     }
     /* evaluate Active Action only */
     else if (adt->action) {
-      animsys_evaluate_action_ex(&id_ptr, adt->action, ctime, flush_to_original);
+      if (DEG_is_evaluated_id(id)) {
+        animsys_evaluate_action_cached(&id_ptr, adt, adt->action, ctime, flush_to_original);
+      }
+      else {
+        animsys_evaluate_action_ex(&id_ptr, adt->action, ctime, flush_to_original);
+      }
     }
   }
 
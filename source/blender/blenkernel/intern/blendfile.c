@@ -52,6 +52,7 @@
 #include "BKE_layer.h"
 #include "BKE_lib_id.h"
 #include "BKE_main.h"
+#include "BKE_main_idmap.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
 #include "BKE_screen.h"
@@ -200,6 +201,8 @@ static void setup_app_data(bContext *C,
     SWAP(ListBase, bmain->wm, bfd->main->wm);
     SWAP(ListBase, bmain->workspaces, bfd->main->workspaces);
     SWAP(ListBase, bmain->screens, bfd->main->screens);
+    BKE_main_idmap_names_clear(bmain);
+    BKE_main_idmap_names_clear(bfd->main);
 
     /* we re-use current window and screen */
     win = CTX_wm_window(C);
@@ -881,6 +884,7 @@ bool BKE_blendfile_write_partial(Main *bmain_src,
     }
   }
 
+  BKE_main_idmap_names_clear(bmain_dst);
   MEM_freeN(bmain_dst);
 
   return retval;
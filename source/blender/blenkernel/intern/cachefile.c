@@ -170,6 +170,19 @@ void BKE_cachefile_reader_free(CacheFile *cache_file, struct CacheReader **reade
 #endif
 }
 
+void BKE_cachefile_prefetch_stats_get(const CacheFile *cache_file, int *r_hits, int *r_misses)
+{
+  *r_hits = *r_misses = 0;
+
+#ifdef WITH_ALEMBIC
+  if (cache_file->handle) {
+    ABC_get_prefetch_stats(cache_file->handle, r_hits, r_misses);
+  }
+#else
+  UNUSED_VARS(cache_file);
+#endif
+}
+
 static void cachefile_handle_free(CacheFile *cache_file)
 {
 #ifdef WITH_ALEMBIC
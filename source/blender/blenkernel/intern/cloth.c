@@ -575,6 +575,8 @@ void cloth_free_modifier(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    cloth_selfcollision_cache_free(cloth);
+
     // we save our faces for collision objects
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -657,6 +659,8 @@ void cloth_free_modifier_extern(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    cloth_selfcollision_cache_free(cloth);
+
     // we save our faces for collision objects
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -925,7 +929,8 @@ static int cloth_from_object(
   }
 
   clmd->clothObject->bvhtree = bvhtree_build_from_cloth(clmd, clmd->coll_parms->epsilon);
-  clmd->clothObject->bvhselftree = bvhtree_build_from_cloth(clmd, clmd->coll_parms->selfepsilon);
+  clmd->clothObject->bvhselftree = bvhtree_build_from_cloth(
+      clmd, clmd->coll_parms->selfepsilon * (1.0f + CLOTH_SELFCOLL_MARGIN_FACTOR));
 
   return 1;
 }
@@ -1139,17 +1139,17 @@ static void cloth_collision(void *__restrict userdata,
   }
 }
 
-static bool cloth_bvh_selfcollision_is_active(const Cloth *cloth,
-                                              const MVertTri *tri_a,
-                                              const MVertTri *tri_b,
-                                              bool sewing_active)
+/* Neighboring triangles and triangles connected by a sewing edge, which never collide.
+ * Only depends on topology and settings, unlike #cloth_bvh_selfcollision_is_excluded. */
+static bool cloth_bvh_selfcollision_is_connected(const Cloth *cloth,
+                                                 const MVertTri *tri_a,
+                                                 const MVertTri *tri_b,
+                                                 bool sewing_active)
 {
-  const ClothVertex *verts = cloth->verts;
-  /* Ignore overlap of neighboring triangles and triangles connected by a sewing edge. */
   for (uint i = 0; i < 3; i++) {
     for (uint j = 0; j < 3; j++) {
       if (tri_a->tri[i] == tri_b->tri[j]) {
-        return false;
+        return true;
       }
 
       if (sewing_active) {
@@ -1164,19 +1164,37 @@ static bool cloth_bvh_selfcollision_is_active(const Cloth *cloth,
           vertex_index_pair[1] = tri_a->tri[i];
         }
         if (BLI_ghash_haskey(cloth->sew_edge_graph, vertex_index_pair)) {
-          return false;
+          return true;
         }
       }
     }
   }
 
-  if (((verts[tri_a->tri[0]].flags & verts[tri_a->tri[1]].flags & verts[tri_a->tri[2]].flags) |
-       (verts[tri_b->tri[0]].flags & verts[tri_b->tri[1]].flags & verts[tri_b->tri[2]].flags)) &
-      CLOTH_VERT_FLAG_NOSELFCOLL) {
-    return false;
-  }
+  return false;
+}
 
-  return true;
+/* Triangles excluded by the self collision vertex group, whose flags are updated every frame
+ * (see #cloth_apply_vgroup). */
+static bool cloth_bvh_selfcollision_is_excluded(const Cloth *cloth,
+                                                const MVertTri *tri_a,
+                                                const MVertTri *tri_b)
+{
+  const ClothVertex *verts = cloth->verts;
+
+  return (((verts[tri_a->tri[0]].flags & verts[tri_a->tri[1]].flags &
+            verts[tri_a->tri[2]].flags) |
+           (verts[tri_b->tri[0]].flags & verts[tri_b->tri[1]].flags &
+            verts[tri_b->tri[2]].flags)) &
+          CLOTH_VERT_FLAG_NOSELFCOLL) != 0;
+}
+
+static bool cloth_bvh_selfcollision_is_active(const Cloth *cloth,
+                                              const MVertTri *tri_a,
+                                              const MVertTri *tri_b,
+                                              bool sewing_active)
+{
+  return !cloth_bvh_selfcollision_is_connected(cloth, tri_a, tri_b, sewing_active) &&
+         !cloth_bvh_selfcollision_is_excluded(cloth, tri_a, tri_b);
 }
 
 static void cloth_selfcollision(void *__restrict userdata,
@@ -1610,13 +1628,262 @@ static bool cloth_bvh_self_overlap_cb(void *userdata, int index_a, int index_b,
 
     bool sewing_active = (clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_SEW);
 
-    if (cloth_bvh_selfcollision_is_active(clothObject, tri_a, tri_b, sewing_active)) {
+    /* Pairs excluded by the vertex group are kept as candidates, the group may change while the
+     * candidates are reused. They are skipped when the active pairs are gathered. */
+    if (!cloth_bvh_selfcollision_is_connected(clothObject, tri_a, tri_b, sewing_active)) {
       return true;
     }
   }
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Self Collision Pair Cache
+ *
+ * The self collision tree is built with a margin on top of the self collision distance
+ * (#CLOTH_SELFCOLL_MARGIN_FACTOR). Candidate pairs found with it remain a superset of the
+ * overlapping pairs for as long as no vertex moved further than that margin, so until then the
+ * pairs are reused across substeps and frames without refitting or traversing the tree.
+ *
+ * The candidates are narrowed down to the pairs whose bounds overlap without the margin and
+ * which aren't excluded by the self collision vertex group at this step, so collision response
+ * sees exactly the pairs a tree built with the self collision distance would have given.
+ * \{ */
+
+#define CLOTH_SELFCOLL_KDOP_AXES 13
+
+typedef struct ClothSelfCollisionCache {
+  /* Candidate pairs, sorted so collision response runs in a deterministic order. */
+  BVHTreeOverlap *overlap;
+  uint overlap_num, overlap_len;
+  /* Candidate pairs that overlap without the margin, allocated with overlap_len. */
+  BVHTreeOverlap *overlap_active;
+  uint overlap_active_num;
+  /* Near check results for the active pairs, allocated with overlap_len. */
+  CollPair *collisions;
+  /* Bounds of each triangle without the margin. */
+  float (*tri_bv)[CLOTH_SELFCOLL_KDOP_AXES * 2];
+  uint tri_num;
+  /* Vertex positions the candidate pairs were found for. */
+  float (*co)[3];
+  uint mvert_num;
+  bool is_valid;
+  bool sewing_active;
+} ClothSelfCollisionCache;
+
+void cloth_selfcollision_cache_free(Cloth *cloth)
+{
+  ClothSelfCollisionCache *cache = cloth->selfcoll_cache;
+
+  if (cache) {
+    MEM_SAFE_FREE(cache->overlap);
+    MEM_SAFE_FREE(cache->overlap_active);
+    MEM_SAFE_FREE(cache->collisions);
+    MEM_SAFE_FREE(cache->tri_bv);
+    MEM_SAFE_FREE(cache->co);
+    MEM_freeN(cache);
+    cloth->selfcoll_cache = NULL;
+  }
+}
+
+static int cloth_selfcollision_overlap_cmp(const void *a_v, const void *b_v)
+{
+  const BVHTreeOverlap *a = a_v, *b = b_v;
+
+  if (a->indexA != b->indexA) {
+    return (a->indexA < b->indexA) ? -1 : 1;
+  }
+  if (a->indexB != b->indexB) {
+    return (a->indexB < b->indexB) ? -1 : 1;
+  }
+  return 0;
+}
+
+/* Margin the self collision tree was built with, on top of the self collision distance. */
+static float cloth_selfcollision_margin(const ClothModifierData *clmd)
+{
+  const float tree_epsilon = BLI_bvhtree_get_epsilon(clmd->clothObject->bvhselftree);
+  return max_ff(tree_epsilon - clmd->coll_parms->selfepsilon, 0.0f);
+}
+
+static bool cloth_selfcollision_cache_is_valid(const ClothModifierData *clmd,
+                                               const ClothSelfCollisionCache *cache)
+{
+  const Cloth *cloth = clmd->clothObject;
+  const bool sewing_active = (clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_SEW);
+  /* Diagonal k-DOP axes are not unit length, a displacement changes projections on them by up
+   * to sqrt(3) times its length. */
+  const float margin = cloth_selfcollision_margin(clmd) / (float)M_SQRT3;
+  const float margin_sq = margin * margin;
+
+  if (!cache->is_valid || cache->mvert_num != cloth->mvert_num ||
+      cache->tri_num != cloth->primitive_num || cache->sewing_active != sewing_active ||
+      margin == 0.0f) {
+    return false;
+  }
+
+  for (uint i = 0; i < cloth->mvert_num; i++) {
+    if (len_squared_v3v3(cloth->verts[i].tx, cache->co[i]) > margin_sq) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/* Same bounds as #BLI_bvhtree_update_node gives a triangle of a 26-DOP tree. */
+static void cloth_selfcollision_tri_bounds(const ClothVertex *verts,
+                                           const MVertTri *tri,
+                                           const float epsilon,
+                                           float r_bv[CLOTH_SELFCOLL_KDOP_AXES * 2])
+{
+  for (int axis = 0; axis < CLOTH_SELFCOLL_KDOP_AXES; axis++) {
+    r_bv[2 * axis] = FLT_MAX;
+    r_bv[2 * axis + 1] = -FLT_MAX;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    const float *co = verts[tri->tri[i]].tx;
+    for (int axis = 0; axis < CLOTH_SELFCOLL_KDOP_AXES; axis++) {
+      const float value = dot_v3v3(co, bvhtree_kdop_axes[axis]);
+      if (value < r_bv[2 * axis]) {
+        r_bv[2 * axis] = value;
+      }
+      if (value > r_bv[2 * axis + 1]) {
+        r_bv[2 * axis + 1] = value;
+      }
+    }
+  }
+
+  for (int axis = 0; axis < CLOTH_SELFCOLL_KDOP_AXES; axis++) {
+    r_bv[2 * axis] -= epsilon;
+    r_bv[2 * axis + 1] += epsilon;
+  }
+}
+
+static bool cloth_selfcollision_bounds_overlap(const float bv_a[CLOTH_SELFCOLL_KDOP_AXES * 2],
+                                               const float bv_b[CLOTH_SELFCOLL_KDOP_AXES * 2])
+{
+  for (int axis = 0; axis < CLOTH_SELFCOLL_KDOP_AXES; axis++) {
+    if ((bv_a[2 * axis] > bv_b[2 * axis + 1]) || (bv_b[2 * axis] > bv_a[2 * axis + 1])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void cloth_selfcollision_tri_bounds_cb(void *__restrict userdata,
+                                              const int index,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  ClothModifierData *clmd = userdata;
+  Cloth *cloth = clmd->clothObject;
+
+  cloth_selfcollision_tri_bounds(cloth->verts,
+                                 &cloth->tri[index],
+                                 clmd->coll_parms->selfepsilon,
+                                 cloth->selfcoll_cache->tri_bv[index]);
+}
+
+static void cloth_selfcollision_cache_update_active(ClothModifierData *clmd,
+                                                    ClothSelfCollisionCache *cache)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(
+      0, (int)cache->tri_num, clmd, cloth_selfcollision_tri_bounds_cb, &settings);
+
+  const Cloth *cloth = clmd->clothObject;
+  uint active_num = 0;
+  for (uint i = 0; i < cache->overlap_num; i++) {
+    const BVHTreeOverlap *overlap = &cache->overlap[i];
+    if (cloth_selfcollision_bounds_overlap(cache->tri_bv[overlap->indexA],
+                                           cache->tri_bv[overlap->indexB]) &&
+        !cloth_bvh_selfcollision_is_excluded(
+            cloth, &cloth->tri[overlap->indexA], &cloth->tri[overlap->indexB])) {
+      cache->overlap_active[active_num++] = *overlap;
+    }
+  }
+  cache->overlap_active_num = active_num;
+}
+
+/**
+ * Get the self collision pairs for the current vertex positions (tx),
+ * only refitting and traversing the tree when the cached candidates are outdated.
+ */
+static ClothSelfCollisionCache *cloth_selfcollision_cache_ensure(ClothModifierData *clmd)
+{
+  Cloth *cloth = clmd->clothObject;
+  ClothSelfCollisionCache *cache = cloth->selfcoll_cache;
+
+  if (cache == NULL) {
+    cache = cloth->selfcoll_cache = MEM_callocN(sizeof(ClothSelfCollisionCache), __func__);
+  }
+
+  if (cloth_selfcollision_cache_is_valid(clmd, cache)) {
+    cloth_selfcollision_cache_update_active(clmd, cache);
+    return cache;
+  }
+
+  bvhtree_update_from_cloth(clmd, false, true);
+
+  uint overlap_num = BLI_bvhtree_overlap_buffer(cloth->bvhselftree,
+                                                cloth->bvhselftree,
+                                                cache->overlap,
+                                                cache->overlap_len,
+                                                cloth_bvh_self_overlap_cb,
+                                                clmd);
+
+  if (overlap_num > cache->overlap_len) {
+    /* Leave some room, the number of pairs changes little from one step to the next. */
+    cache->overlap_len = overlap_num + overlap_num / 4;
+    MEM_SAFE_FREE(cache->overlap);
+    MEM_SAFE_FREE(cache->overlap_active);
+    MEM_SAFE_FREE(cache->collisions);
+    cache->overlap = MEM_mallocN(sizeof(BVHTreeOverlap) * cache->overlap_len, __func__);
+    cache->overlap_active = MEM_mallocN(sizeof(BVHTreeOverlap) * cache->overlap_len, __func__);
+    cache->collisions = MEM_mallocN(sizeof(CollPair) * cache->overlap_len, __func__);
+
+    overlap_num = BLI_bvhtree_overlap_buffer(cloth->bvhselftree,
+                                             cloth->bvhselftree,
+                                             cache->overlap,
+                                             cache->overlap_len,
+                                             cloth_bvh_self_overlap_cb,
+                                             clmd);
+    BLI_assert(overlap_num <= cache->overlap_len);
+  }
+
+  cache->overlap_num = overlap_num;
+  if (overlap_num > 1) {
+    qsort(cache->overlap, overlap_num, sizeof(BVHTreeOverlap), cloth_selfcollision_overlap_cmp);
+  }
+
+  if (cache->mvert_num != cloth->mvert_num) {
+    MEM_SAFE_FREE(cache->co);
+    cache->co = MEM_mallocN(sizeof(*cache->co) * cloth->mvert_num, __func__);
+    cache->mvert_num = cloth->mvert_num;
+  }
+  for (uint i = 0; i < cloth->mvert_num; i++) {
+    copy_v3_v3(cache->co[i], cloth->verts[i].tx);
+  }
+
+  if (cache->tri_num != cloth->primitive_num) {
+    MEM_SAFE_FREE(cache->tri_bv);
+    cache->tri_bv = MEM_mallocN(sizeof(*cache->tri_bv) * cloth->primitive_num, __func__);
+    cache->tri_num = cloth->primitive_num;
+  }
+
+  cache->sewing_active = (clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_SEW);
+  cache->is_valid = true;
+
+  cloth_selfcollision_cache_update_active(clmd, cache);
+
+  return cache;
+}
+
+/** \} */
+
 int cloth_bvh_collision(
     Depsgraph *depsgraph, Object *ob, ClothModifierData *clmd, float step, float dt)
 {
@@ -1630,8 +1897,7 @@ int cloth_bvh_collision(
   unsigned int numcollobj = 0;
   uint *coll_counts_obj = NULL;
   BVHTreeOverlap **overlap_obj = NULL;
-  uint coll_count_self = 0;
-  BVHTreeOverlap *overlap_self = NULL;
+  ClothSelfCollisionCache *selfcoll_cache = NULL;
 
   if ((clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_COLLOBJ) || cloth_bvh == NULL) {
     return 0;
@@ -1674,11 +1940,8 @@ int cloth_bvh_collision(
     }
   }
 
-  if (clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF) {
-    bvhtree_update_from_cloth(clmd, false, true);
-
-    overlap_self = BLI_bvhtree_overlap(
-        cloth->bvhselftree, cloth->bvhselftree, &coll_count_self, cloth_bvh_self_overlap_cb, clmd);
+  if ((clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF) && cloth->bvhselftree) {
+    selfcoll_cache = cloth_selfcollision_cache_ensure(clmd);
   }
 
   do {
@@ -1728,25 +1991,19 @@ int cloth_bvh_collision(
 
     /* Self collisions. */
     if (clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF) {
-      CollPair *collisions = NULL;
-
       verts = cloth->verts;
       mvert_num = cloth->mvert_num;
 
-      if (cloth->bvhselftree) {
-        if (coll_count_self && overlap_self) {
-          collisions = (CollPair *)MEM_mallocN(sizeof(CollPair) * coll_count_self,
-                                               "collision array");
+      if (selfcoll_cache && selfcoll_cache->overlap_active_num) {
+        CollPair *collisions = selfcoll_cache->collisions;
+        const uint coll_count_self = selfcoll_cache->overlap_active_num;
 
-          if (cloth_bvh_selfcollisions_nearcheck(
-                  clmd, collisions, coll_count_self, overlap_self)) {
-            ret += cloth_bvh_selfcollisions_resolve(clmd, collisions, coll_count_self, dt);
-            ret2 += ret;
-          }
+        if (cloth_bvh_selfcollisions_nearcheck(
+                clmd, collisions, coll_count_self, selfcoll_cache->overlap_active)) {
+          ret += cloth_bvh_selfcollisions_resolve(clmd, collisions, coll_count_self, dt);
+          ret2 += ret;
         }
       }
-
-      MEM_SAFE_FREE(collisions);
     }
 
     /* Apply all collision resolution. */
@@ -1775,8 +2032,6 @@ int cloth_bvh_collision(
 
   MEM_SAFE_FREE(coll_counts_obj);
 
-  MEM_SAFE_FREE(overlap_self);
-
   BKE_collision_objects_free(collobjs);
 
   return MIN2(ret, 1);
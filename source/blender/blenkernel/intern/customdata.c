@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 /* Since we have versioning code here (CustomData_verify_versions()). */
 #define DNA_DEPRECATED_ALLOW
 
@@ -1867,6 +1869,237 @@ static bool customdata_typemap_is_valid(const CustomData *data)
 }
 #endif
 
+/* -------------------------------------------------------------------- */
+/** \name Layer Sharing
+ *
+ * Copying a layer which owns its data with #CD_REFERENCE shares the data array
+ * instead of copying it, a user count is kept so the last layer freed also frees the data.
+ * Shared layers count as referenced, so the data is only copied once a layer
+ * is written to, see #CustomData_duplicate_referenced_layer.
+ *
+ * Every layer pointing to the user count holds one user. A layer which is the only user left
+ * owns the data again, the user count is freed the next time the layer is written to.
+ *
+ * Code outside of custom-data can hold users as well, see #CustomData_layer_export. Exports
+ * don't make a layer referenced: the layer keeps writing to the data in place, but it never
+ * frees or reallocates exported data, that's left to the last user.
+ * \{ */
+
+typedef struct CustomDataLayerShared {
+  /** Layers and exports using the data. */
+  int users;
+  /** Users outside of custom-data. */
+  int exports;
+} CustomDataLayerShared;
+
+static struct {
+  size_t bytes_copied;
+  size_t bytes_shared;
+} customdata_memory_stats = {0, 0};
+
+static void customData_free_layer_data(int type, void *data, int totelem)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+
+  if (typeInfo->free) {
+    typeInfo->free(data, totelem, typeInfo->size);
+  }
+
+  MEM_freeN(data);
+}
+
+/**
+ * Remove the user of the shared data from \a layer.
+ *
+ * \return true when this was the last user, the caller is then responsible for the data.
+ */
+static bool customData_layer_shared_release(CustomDataLayer *layer)
+{
+  CustomDataLayerShared *shared = layer->shared;
+  layer->shared = NULL;
+
+  if (atomic_sub_and_fetch_int32(&shared->users, 1) == 0) {
+    MEM_freeN(shared);
+    return true;
+  }
+  return false;
+}
+
+static bool customData_layer_is_referenced(const CustomDataLayer *layer)
+{
+  if (layer->flag & CD_FLAG_NOFREE) {
+    return true;
+  }
+  /* Once other users are gone the data is owned by this layer again. The user count can't be
+   * freed here, the layer may be shared from other threads while it's read. */
+  if (layer->shared == NULL) {
+    return false;
+  }
+  const int exports = atomic_add_and_fetch_int32(&layer->shared->exports, 0);
+  return (atomic_add_and_fetch_int32(&layer->shared->users, 0) - exports) > 1;
+}
+
+static bool customData_layer_is_exported(const CustomDataLayer *layer)
+{
+  return (layer->shared != NULL) && (atomic_add_and_fetch_int32(&layer->shared->exports, 0) > 0);
+}
+
+/* Number of elements of a layer, for functions which don't get it passed. */
+static int customData_layer_alloc_totelem(const CustomDataLayer *layer)
+{
+  if (layer->data == NULL) {
+    return 0;
+  }
+  return (int)(MEM_allocN_len(layer->data) / layerType_getInfo(layer->type)->size);
+}
+
+static size_t customData_layer_data_size(int type, int totelem)
+{
+  return (size_t)totelem * layerType_getInfo(type)->size;
+}
+
+/**
+ * Add a user to the data of \a layer, so it can be used by another layer.
+ * Layers of a mesh used by multiple objects may be shared from multiple threads.
+ */
+static CustomDataLayerShared *customData_layer_share(CustomDataLayer *layer, int totelem)
+{
+  CustomDataLayerShared *shared = layer->shared;
+
+  if (shared == NULL) {
+    CustomDataLayerShared *shared_new = MEM_mallocN(sizeof(*shared_new), __func__);
+    shared_new->users = 1;
+    shared_new->exports = 0;
+    shared = atomic_cas_ptr((void **)&layer->shared, NULL, shared_new);
+    if (shared == NULL) {
+      shared = shared_new;
+    }
+    else {
+      MEM_freeN(shared_new);
+    }
+  }
+
+  atomic_add_and_fetch_int32(&shared->users, 1);
+  atomic_add_and_fetch_z(&customdata_memory_stats.bytes_shared,
+                         customData_layer_data_size(layer->type, totelem));
+  return shared;
+}
+
+/** Give \a layer its own copy of the data, removing its user of the previous data. */
+static void customData_layer_copy_data(CustomDataLayer *layer, const int totelem)
+{
+  /* MEM_dupallocN won't work in case of complex layers, like e.g.
+   * CD_MDEFORMVERT, which has pointers to allocated data...
+   * So in case a custom copy function is defined, use it!
+   */
+  const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
+  void *data_src = layer->data;
+
+  if (typeInfo->copy) {
+    void *dst_data = MEM_malloc_arrayN((size_t)totelem, typeInfo->size, "CD duplicate ref layer");
+    typeInfo->copy(data_src, dst_data, totelem);
+    layer->data = dst_data;
+  }
+  else {
+    layer->data = MEM_dupallocN(data_src);
+  }
+  atomic_add_and_fetch_z(&customdata_memory_stats.bytes_copied,
+                         customData_layer_data_size(layer->type, totelem));
+
+  if (layer->shared && customData_layer_shared_release(layer)) {
+    /* The other users were freed in the meantime. */
+    customData_free_layer_data(layer->type, data_src, totelem);
+  }
+
+  layer->flag &= ~CD_FLAG_NOFREE;
+}
+
+/**
+ * Make \a layer the only owner of its data, copying it when it's referenced or
+ * used by other layers. Exported data is kept, so exports see the changes.
+ */
+static void customData_layer_ensure_owned(CustomDataLayer *layer, const int totelem)
+{
+  if (customData_layer_is_referenced(layer)) {
+    customData_layer_copy_data(layer, totelem);
+  }
+  else if (layer->shared && !customData_layer_is_exported(layer)) {
+    /* All other users are gone. The layer is about to be written to, so it's not shared from
+     * other threads, and no other layer points to the user count anymore. */
+    MEM_freeN(layer->shared);
+    layer->shared = NULL;
+  }
+}
+
+/**
+ * Use the data of a layer outside of custom-data, like the arrays exposed to Python.
+ * The data stays allocated until #CustomData_layer_export_release, also when the layer is
+ * freed or reallocated in the meantime. Until then the layer's changes show in the data.
+ *
+ * \param for_write: Give the layer its own copy first when the data is shared with other layers.
+ * \return The layer data, NULL when the layer has no data (\a r_shared is NULL then).
+ */
+void *CustomData_layer_export(CustomData *data,
+                              const int layer_index,
+                              const int totelem,
+                              const bool for_write,
+                              CustomDataLayerShared **r_shared)
+{
+  CustomDataLayer *layer = &data->layers[layer_index];
+
+  /* Data which isn't owned by any layer could be freed while it's exported. */
+  if (for_write || (layer->flag & CD_FLAG_NOFREE)) {
+    customData_layer_ensure_owned(layer, totelem);
+  }
+
+  if (layer->data == NULL) {
+    *r_shared = NULL;
+    return NULL;
+  }
+
+  /* Zero elements, exports don't count as memory saved by sharing. */
+  CustomDataLayerShared *shared = customData_layer_share(layer, 0);
+  atomic_add_and_fetch_int32(&shared->exports, 1);
+  *r_shared = shared;
+  return layer->data;
+}
+
+/**
+ * Remove an export added by #CustomData_layer_export, freeing the data when the layer
+ * doesn't use it anymore. Arguments are those of the export.
+ */
+void CustomData_layer_export_release(CustomDataLayerShared *shared,
+                                     const int type,
+                                     void *layer_data,
+                                     const int totelem)
+{
+  atomic_sub_and_fetch_int32(&shared->exports, 1);
+  if (atomic_sub_and_fetch_int32(&shared->users, 1) == 0) {
+    MEM_freeN(shared);
+    customData_free_layer_data(type, layer_data, totelem);
+  }
+}
+
+size_t CustomData_get_shared_size(const CustomData *data, const int totelem)
+{
+  size_t size = 0;
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (layer->shared && customData_layer_is_referenced(layer)) {
+      size += customData_layer_data_size(layer->type, totelem);
+    }
+  }
+  return size;
+}
+
+void CustomData_memory_stats_get(size_t *r_bytes_copied, size_t *r_bytes_shared)
+{
+  *r_bytes_copied = atomic_add_and_fetch_z(&customdata_memory_stats.bytes_copied, 0);
+  *r_bytes_shared = atomic_add_and_fetch_z(&customdata_memory_stats.bytes_shared, 0);
+}
+
+/** \} */
+
 bool CustomData_merge(const struct CustomData *source,
                       struct CustomData *dest,
                       CustomDataMask mask,
@@ -1929,6 +2162,21 @@ bool CustomData_merge(const struct CustomData *source,
       newlayer = customData_add_layer__internal(
           dest, type, CD_REFERENCE, data, totelem, layer->name);
     }
+    else if ((alloctype == CD_REFERENCE) && data && !(flag & CD_FLAG_NOFREE)) {
+      /* Share the data of a layer owning it instead of referencing it,
+       * so the source may be freed before 'dest'. */
+      newlayer = customData_add_layer__internal(dest, type, CD_ASSIGN, data, totelem, layer->name);
+      if (newlayer) {
+        newlayer->shared = customData_layer_share((CustomDataLayer *)layer, totelem);
+      }
+    }
+    else if ((alloctype == CD_ASSIGN) && layer->shared) {
+      /* The source gives up its data, its user of the shared data moves along. */
+      newlayer = customData_add_layer__internal(dest, type, CD_ASSIGN, data, totelem, layer->name);
+      if (newlayer) {
+        newlayer->shared = layer->shared;
+      }
+    }
     else {
       newlayer = customData_add_layer__internal(dest, type, alloctype, data, totelem, layer->name);
     }
@@ -1960,6 +2208,13 @@ void CustomData_realloc(CustomData *data, int totelem)
       continue;
     }
     typeInfo = layerType_getInfo(layer->type);
+    if (customData_layer_is_exported(layer)) {
+      /* Exports keep using the current array. */
+      customData_layer_copy_data(layer, customData_layer_alloc_totelem(layer));
+    }
+    else if (layer->shared) {
+      customData_layer_ensure_owned(layer, customData_layer_alloc_totelem(layer));
+    }
     layer->data = MEM_reallocN(layer->data, (size_t)totelem * typeInfo->size);
   }
 }
@@ -1981,18 +2236,13 @@ void CustomData_copy(const struct CustomData *source,
 
 static void customData_free_layer__internal(CustomDataLayer *layer, int totelem)
 {
-  const LayerTypeInfo *typeInfo;
+  if (layer->shared && !customData_layer_shared_release(layer)) {
+    /* Still used by other layers. */
+    return;
+  }
 
   if (!(layer->flag & CD_FLAG_NOFREE) && layer->data) {
-    typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->free) {
-      typeInfo->free(layer->data, totelem, typeInfo->size);
-    }
-
-    if (layer->data) {
-      MEM_freeN(layer->data);
-    }
+    customData_free_layer_data(layer->type, layer->data, totelem);
   }
 }
 
@@ -2352,6 +2602,8 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
     else {
       memcpy(newlayerdata, layerdata, (size_t)totelem * typeInfo->size);
     }
+    atomic_add_and_fetch_z(&customdata_memory_stats.bytes_copied,
+                           (size_t)totelem * typeInfo->size);
   }
   else if (alloctype == CD_DEFAULT) {
     if (typeInfo->set_default) {
@@ -2381,6 +2633,7 @@ static CustomDataLayer *customData_add_layer__internal(CustomData *data,
   data->layers[index].type = type;
   data->layers[index].flag = flag;
   data->layers[index].data = newlayerdata;
+  data->layers[index].shared = NULL;
 
   /* Set default name if none exists. Note we only call DATA_()  once
    * we know there is a default name, to avoid overhead of locale lookups
@@ -2566,25 +2819,7 @@ static void *customData_duplicate_referenced_layer_index(CustomData *data,
 
   layer = &data->layers[layer_index];
 
-  if (layer->flag & CD_FLAG_NOFREE) {
-    /* MEM_dupallocN won't work in case of complex layers, like e.g.
-     * CD_MDEFORMVERT, which has pointers to allocated data...
-     * So in case a custom copy function is defined, use it!
-     */
-    const LayerTypeInfo *typeInfo = layerType_getInfo(layer->type);
-
-    if (typeInfo->copy) {
-      void *dst_data = MEM_malloc_arrayN(
-          (size_t)totelem, typeInfo->size, "CD duplicate ref layer");
-      typeInfo->copy(layer->data, dst_data, totelem);
-      layer->data = dst_data;
-    }
-    else {
-      layer->data = MEM_dupallocN(layer->data);
-    }
-
-    layer->flag &= ~CD_FLAG_NOFREE;
-  }
+  customData_layer_ensure_owned(layer, totelem);
 
   return layer->data;
 }
@@ -2625,6 +2860,13 @@ void *CustomData_duplicate_referenced_layer_named(CustomData *data,
   return customData_duplicate_referenced_layer_index(data, layer_index, totelem);
 }
 
+void CustomData_duplicate_referenced_layers(CustomData *data, const int totelem)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    customData_layer_ensure_owned(&data->layers[i], totelem);
+  }
+}
+
 bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 {
   CustomDataLayer *layer;
@@ -2638,7 +2880,7 @@ bool CustomData_is_referenced_layer(struct CustomData *data, int type)
 
   layer = &data->layers[layer_index];
 
-  return (layer->flag & CD_FLAG_NOFREE) != 0;
+  return customData_layer_is_referenced(layer);
 }
 
 void CustomData_free_temporary(CustomData *data, int totelem)
@@ -2820,13 +3062,18 @@ void CustomData_free_elem(CustomData *data, int index, int count)
   const LayerTypeInfo *typeInfo;
 
   for (i = 0; i < data->totlayer; i++) {
-    if (!(data->layers[i].flag & CD_FLAG_NOFREE)) {
-      typeInfo = layerType_getInfo(data->layers[i].type);
+    CustomDataLayer *layer = &data->layers[i];
+    if (!(layer->flag & CD_FLAG_NOFREE)) {
+      typeInfo = layerType_getInfo(layer->type);
 
       if (typeInfo->free) {
         size_t offset = (size_t)index * typeInfo->size;
 
-        typeInfo->free(POINTER_OFFSET(data->layers[i].data, offset), count, typeInfo->size);
+        /* Elements are about to be replaced, which must not affect other users. */
+        if (layer->shared) {
+          customData_layer_ensure_owned(layer, customData_layer_alloc_totelem(layer));
+        }
+        typeInfo->free(POINTER_OFFSET(layer->data, offset), count, typeInfo->size);
       }
     }
   }
@@ -3063,6 +3310,20 @@ const char *CustomData_get_layer_name(const CustomData *data, int type, int n)
   return (layer_index == -1) ? NULL : data->layers[layer_index].name;
 }
 
+/**
+ * The layer takes over \a ptr, the caller stays responsible for the previous data. That data
+ * must not be shared with other layers, see #CustomData_duplicate_referenced_layer.
+ */
+static void customData_layer_set_data(CustomDataLayer *layer, void *ptr)
+{
+  if (layer->shared) {
+    /* Other users would keep using the previous data, while the caller may free it. */
+    BLI_assert(!customData_layer_is_referenced(layer) && !customData_layer_is_exported(layer));
+    customData_layer_shared_release(layer);
+  }
+  layer->data = ptr;
+}
+
 void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
 {
   /* get the layer index of the first layer of type */
@@ -3072,7 +3333,7 @@ void *CustomData_set_layer(const CustomData *data, int type, void *ptr)
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_layer_set_data(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -3085,7 +3346,7 @@ void *CustomData_set_layer_n(const struct CustomData *data, int type, int n, voi
     return NULL;
   }
 
-  data->layers[layer_index].data = ptr;
+  customData_layer_set_data(&data->layers[layer_index], ptr);
 
   return ptr;
 }
@@ -3702,7 +3963,7 @@ bool CustomData_has_referenced(const struct CustomData *data)
 {
   int i;
   for (i = 0; i < data->totlayer; i++) {
-    if (data->layers[i].flag & CD_FLAG_NOFREE) {
+    if (customData_layer_is_referenced(&data->layers[i])) {
       return true;
     }
   }
@@ -4073,7 +4334,10 @@ void CustomData_file_write_prepare(CustomData *data,
         }
         write_layers_size += chunk_size;
       }
-      write_layers[j++] = *layer;
+      write_layers[j] = *layer;
+      /* Runtime only, also keeps undo from detecting a change when the data gets shared. */
+      write_layers[j].shared = NULL;
+      j++;
     }
   }
   BLI_assert(j == data->totlayer);
@@ -4102,6 +4366,19 @@ bool CustomData_layertype_is_singleton(int type)
   return typeInfo->defaultname == NULL;
 }
 
+/**
+ * \return True if layers of given \a type are plain arrays without references to other memory,
+ * so they can be copied or stored byte by byte.
+ */
+bool CustomData_layertype_is_plain_data(int type)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(type);
+  if (typeInfo == NULL) {
+    return false;
+  }
+  return typeInfo->copy == NULL && typeInfo->free == NULL;
+}
+
 /**
  * \return Maximum number of layers of given \a type, -1 means 'no limit'.
  */
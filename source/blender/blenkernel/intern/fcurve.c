@@ -2243,6 +2243,14 @@ static bool driver_compile_simple_expr(ChannelDriver *driver)
   if (atomic_cas_ptr((void **)&driver->expr_simple, NULL, expr) != NULL) {
     BLI_expr_pylike_free(expr);
   }
+  else if (!BLI_expr_pylike_is_valid(expr)) {
+    /* Use '--log "bke.fcurve" --log-level 1' to list the drivers needing Python. */
+    CLOG_INFO(&LOG,
+              1,
+              "driver '%s' needs Python: %s",
+              driver->expression,
+              BLI_expr_pylike_error_get(expr));
+  }
 
   return true;
 }
@@ -2267,6 +2275,16 @@ bool BKE_driver_has_simple_expression(ChannelDriver *driver)
   return driver_compile_simple_expr(driver) && BLI_expr_pylike_is_valid(driver->expr_simple);
 }
 
+/* Get the reason the expression in the driver needs the full Python interpreter,
+ * NULL if it conforms to the simple subset or isn't a scripted expression. */
+const char *BKE_driver_simple_expression_error_get(ChannelDriver *driver)
+{
+  if (!driver_compile_simple_expr(driver)) {
+    return NULL;
+  }
+  return BLI_expr_pylike_error_get(driver->expr_simple);
+}
+
 /* TODO(sergey): This is somewhat weak, but we don't want neither false-positive
  * time dependencies nor special exceptions in the depsgraph evaluation. */
 static bool python_driver_exression_depends_on_time(const char *expression)
@@ -2665,6 +2683,41 @@ static void berekeny(float f1, float f2, float f3, float f4, float *o, int b)
 
 /* -------------------------- */
 
+/**
+ * Same as #binarysearch_bezt_index_ex, for an 'evaltime' between the first and last keyframe.
+ * Sequential playback mostly evaluates the same keyframe segment as the previous evaluation,
+ * or the next one, so these are checked before searching.
+ */
+static int fcurve_bezt_index_find(
+    FCurve *fcu, BezTriple *bezts, float evaltime, float threshold, bool *r_exact)
+{
+  const int totvert = (int)fcu->totvert;
+  const int last_index = fcu->last_bezt_index;
+
+  for (int a = max_ii(last_index, 0); a <= last_index + 1 && a < totvert; a++) {
+    const float frame = bezts[a].vec[1][0];
+
+    /* Keys within the threshold of each other are left to the search. */
+    if (IS_EQT(evaltime, frame, threshold)) {
+      if ((a == 0 || evaltime - bezts[a - 1].vec[1][0] > threshold) &&
+          (a == totvert - 1 || bezts[a + 1].vec[1][0] - evaltime > threshold)) {
+        *r_exact = true;
+        return a;
+      }
+      break;
+    }
+    if (a > 0 && frame - evaltime > threshold && evaltime - bezts[a - 1].vec[1][0] > threshold) {
+      *r_exact = false;
+      return a;
+    }
+  }
+
+  const int a = binarysearch_bezt_index_ex(bezts, evaltime, totvert, threshold, r_exact);
+  /* Not thread safe, but only used as a hint that is checked above. */
+  fcu->last_bezt_index = a;
+  return a;
+}
+
 /* Calculate F-Curve value for 'evaltime' using BezTriple keyframes */
 static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime)
 {
@@ -2798,7 +2851,7 @@ static float fcurve_eval_keyframes(FCurve *fcu, BezTriple *bezts, float evaltime
      *   Weird errors, like selecting the wrong keyframe range (see T39207), occur.
      *   This lower bound was established in b888a32eee8147b028464336ad2404d8155c64dd.
      */
-    a = binarysearch_bezt_index_ex(bezts, evaltime, fcu->totvert, 0.0001, &exact);
+    a = fcurve_bezt_index_find(fcu, bezts, evaltime, 0.0001f, &exact);
 
     if (exact) {
       /* index returned must be interpreted differently when it sits on top of an existing keyframe
@@ -30,6 +30,8 @@
 #include "BLI_blenlib.h"
 #include "BLI_math_vector.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -56,8 +58,12 @@
 #include "BKE_mesh.h"
 #include "BKE_scene.h"
 
+#include "DEG_depsgraph_query.h"
+
 #include "RNA_access.h"
 
+static void key_sparse_cache_free(Key *key);
+
 static void shapekey_copy_data(Main *UNUSED(bmain),
                                ID *id_dst,
                                const ID *id_src,
@@ -66,6 +72,7 @@ static void shapekey_copy_data(Main *UNUSED(bmain),
   Key *key_dst = (Key *)id_dst;
   const Key *key_src = (const Key *)id_src;
   BLI_duplicatelist(&key_dst->block, &key_src->block);
+  key_dst->sparse_cache = NULL;
 
   KeyBlock *kb_dst, *kb_src;
   for (kb_src = key_src->block.first, kb_dst = key_dst->block.first; kb_dst;
@@ -84,6 +91,8 @@ static void shapekey_free_data(ID *id)
   Key *key = (Key *)id;
   KeyBlock *kb;
 
+  key_sparse_cache_free(key);
+
   while ((kb = BLI_pophead(&key->block))) {
     if (kb->data) {
       MEM_freeN(kb->data);
@@ -133,6 +142,8 @@ void BKE_key_free_nolib(Key *key)
 {
   KeyBlock *kb;
 
+  key_sparse_cache_free(key);
+
   while ((kb = BLI_pophead(&key->block))) {
     if (kb->data) {
       MEM_freeN(kb->data);
@@ -209,6 +220,7 @@ Key *BKE_key_copy_nolib(Key *key)
   keyn = MEM_dupallocN(key);
 
   keyn->adt = NULL;
+  keyn->sparse_cache = NULL;
 
   BLI_duplicatelist(&keyn->block, &key->block);
 
@@ -919,6 +931,296 @@ static void key_evaluate_relative(const int start,
   }
 }
 
+/* Relative key evaluation of coordinates (meshes and lattices).
+ *
+ * Corrective shapes often move only a small part of the mesh, so for evaluated keys the
+ * offsets of each key-block from its relative key are stored sparsely, as sorted element
+ * indices and offsets, converted on first use. Evaluated key-block data only changes by
+ * copy-on-write, which frees these. Blending is done in parallel over ranges of elements,
+ * accumulating only the key-blocks that have an influence. */
+
+/* Key-blocks that move more elements than this fraction are evaluated from their data. */
+#define KEY_SPARSE_MAX_FACTOR 0.5f
+/* Number of elements blended by a single task. */
+#define KEY_EVALUATE_CHUNK_SIZE 4096
+
+typedef struct KeyBlockSparse {
+  /** #KeyBlock.relative and #KeyBlock.totelem at the time of conversion. */
+  int relative;
+  int totelem;
+  /** Number of moved elements, -1 when the key-block is not converted. */
+  int totindex;
+  int *index;
+  float (*offset)[3];
+} KeyBlockSparse;
+
+typedef struct KeySparseCache {
+  int totkey;
+  /** Indexed like #Key.block, NULL when not converted yet. */
+  KeyBlockSparse **blocks;
+} KeySparseCache;
+
+static ThreadMutex key_sparse_lock = BLI_MUTEX_INITIALIZER;
+
+static void key_block_sparse_free(KeyBlockSparse *sparse)
+{
+  MEM_SAFE_FREE(sparse->index);
+  MEM_SAFE_FREE(sparse->offset);
+  MEM_freeN(sparse);
+}
+
+static void key_sparse_cache_free(Key *key)
+{
+  KeySparseCache *cache = key->sparse_cache;
+
+  if (cache == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < cache->totkey; i++) {
+    if (cache->blocks[i]) {
+      key_block_sparse_free(cache->blocks[i]);
+    }
+  }
+  MEM_freeN(cache->blocks);
+  MEM_freeN(cache);
+  key->sparse_cache = NULL;
+}
+
+static KeyBlockSparse *key_block_sparse_create(const KeyBlock *kb, const KeyBlock *refb)
+{
+  KeyBlockSparse *sparse = MEM_callocN(sizeof(*sparse), __func__);
+  const float(*co)[3] = kb->data;
+  const float(*co_ref)[3] = refb->data;
+  const int totelem = kb->totelem;
+  int totindex = 0;
+
+  sparse->relative = kb->relative;
+  sparse->totelem = totelem;
+  sparse->totindex = -1;
+
+  if (refb->totelem != totelem) {
+    return sparse;
+  }
+
+  for (int i = 0; i < totelem; i++) {
+    if (!equals_v3v3(co[i], co_ref[i])) {
+      totindex++;
+    }
+  }
+
+  if (totindex > (int)(totelem * KEY_SPARSE_MAX_FACTOR)) {
+    return sparse;
+  }
+
+  sparse->totindex = totindex;
+  if (totindex != 0) {
+    sparse->index = MEM_mallocN(sizeof(*sparse->index) * totindex, __func__);
+    sparse->offset = MEM_mallocN(sizeof(*sparse->offset) * totindex, __func__);
+
+    for (int i = 0, j = 0; i < totelem; i++) {
+      if (!equals_v3v3(co[i], co_ref[i])) {
+        sparse->index[j] = i;
+        sub_v3_v3v3(sparse->offset[j], co[i], co_ref[i]);
+        j++;
+      }
+    }
+  }
+
+  return sparse;
+}
+
+/**
+ * Get the sparse offsets of a key-block, converting it when needed.
+ * Only evaluated keys are converted, as the data of original keys can be edited at any time.
+ */
+static const KeyBlockSparse *key_block_sparse_ensure(Key *key,
+                                                     const KeyBlock *kb,
+                                                     const int keyblock_index,
+                                                     const KeyBlock *refb)
+{
+  if (!DEG_is_evaluated_id(&key->id)) {
+    return NULL;
+  }
+
+  BLI_mutex_lock(&key_sparse_lock);
+
+  KeySparseCache *cache = key->sparse_cache;
+  if (cache && cache->totkey != key->totkey) {
+    key_sparse_cache_free(key);
+    cache = NULL;
+  }
+  if (cache == NULL) {
+    cache = MEM_callocN(sizeof(*cache), __func__);
+    cache->totkey = key->totkey;
+    cache->blocks = MEM_callocN(sizeof(*cache->blocks) * key->totkey, __func__);
+    key->sparse_cache = cache;
+  }
+
+  KeyBlockSparse *sparse = cache->blocks[keyblock_index];
+  if (sparse && (sparse->relative != kb->relative || sparse->totelem != kb->totelem)) {
+    key_block_sparse_free(sparse);
+    sparse = NULL;
+  }
+  if (sparse == NULL) {
+    sparse = key_block_sparse_create(kb, refb);
+    cache->blocks[keyblock_index] = sparse;
+  }
+
+  BLI_mutex_unlock(&key_sparse_lock);
+
+  return (sparse->totindex != -1) ? sparse : NULL;
+}
+
+/* Key-block with an influence, blended by #key_evaluate_relative_coords. */
+typedef struct KeyEvaluateBlock {
+  /** Sparse offsets, when NULL the offsets are computed from both data arrays. */
+  const KeyBlockSparse *sparse;
+  const float (*co)[3];
+  const float (*co_ref)[3];
+  const float *weights;
+  float influence;
+} KeyEvaluateBlock;
+
+typedef struct KeyEvaluateData {
+  float (*out)[3];
+  const KeyEvaluateBlock *blocks;
+  int totblock;
+  int tot;
+} KeyEvaluateData;
+
+/* Index of the first moved element at or after \a index. */
+static int key_block_sparse_lower_bound(const KeyBlockSparse *sparse, const int index)
+{
+  int low = 0, high = sparse->totindex;
+
+  while (low < high) {
+    const int mid = low + (high - low) / 2;
+    if (sparse->index[mid] < index) {
+      low = mid + 1;
+    }
+    else {
+      high = mid;
+    }
+  }
+
+  return low;
+}
+
+static void key_evaluate_relative_coords_cb(void *__restrict userdata,
+                                            const int chunk,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const KeyEvaluateData *data = userdata;
+  float(*out)[3] = data->out;
+  const int start = chunk * KEY_EVALUATE_CHUNK_SIZE;
+  const int end = min_ii(start + KEY_EVALUATE_CHUNK_SIZE, data->tot);
+
+  /* Blend key-blocks in order, so the result doesn't depend on the number of tasks. */
+  for (int b = 0; b < data->totblock; b++) {
+    const KeyEvaluateBlock *block = &data->blocks[b];
+    const float *weights = block->weights;
+    const float influence = block->influence;
+
+    if (block->sparse) {
+      const KeyBlockSparse *sparse = block->sparse;
+      const int *index = sparse->index;
+      const float(*offset)[3] = sparse->offset;
+
+      for (int i = key_block_sparse_lower_bound(sparse, start);
+           i < sparse->totindex && index[i] < end;
+           i++) {
+        const float weight = weights ? (weights[index[i]] * influence) : influence;
+        madd_v3_v3fl(out[index[i]], offset[i], weight);
+      }
+    }
+    else {
+      const float(*co)[3] = block->co;
+      const float(*co_ref)[3] = block->co_ref;
+
+      for (int i = start; i < end; i++) {
+        const float weight = weights ? (weights[i] * influence) : influence;
+        out[i][0] -= weight * (co_ref[i][0] - co[i][0]);
+        out[i][1] -= weight * (co_ref[i][1] - co[i][1]);
+        out[i][2] -= weight * (co_ref[i][2] - co[i][2]);
+      }
+    }
+  }
+}
+
+/**
+ * Same as #key_evaluate_relative for all elements of meshes and lattices,
+ * see the comment above for how these are evaluated.
+ */
+static void key_evaluate_relative_coords(const int tot,
+                                         char *basispoin,
+                                         Key *key,
+                                         KeyBlock *actkb,
+                                         float **per_keyblock_weights)
+{
+  KeyBlock *kb;
+  int keyblock_index;
+
+  BLI_assert(key->elemsize == sizeof(float[3]));
+
+  /* step 1 init */
+  cp_key(0, tot, tot, basispoin, key, actkb, key->refkey, NULL, KEY_MODE_DUMMY);
+
+  /* step 2: gather the key-blocks with an influence */
+  KeyEvaluateBlock *blocks = MEM_mallocN(sizeof(*blocks) * key->totkey, __func__);
+  char **freedata = MEM_callocN(sizeof(*freedata) * key->totkey, __func__);
+  int totblock = 0;
+
+  for (kb = key->block.first, keyblock_index = 0; kb; kb = kb->next, keyblock_index++) {
+    if (kb == key->refkey || (kb->flag & KEYBLOCK_MUTE) || kb->curval == 0.0f ||
+        kb->totelem != tot) {
+      continue;
+    }
+
+    /* reference now can be any block */
+    KeyBlock *refb = BLI_findlink(&key->block, kb->relative);
+    if (refb == NULL) {
+      continue;
+    }
+
+    KeyEvaluateBlock *block = &blocks[totblock++];
+    block->weights = per_keyblock_weights ? per_keyblock_weights[keyblock_index] : NULL;
+    block->influence = kb->curval;
+    /* For meshes, use the original values instead of the bmesh values to
+     * maintain a constant offset. */
+    block->co_ref = refb->data;
+    block->co = (const float(*)[3])key_block_get_data(key, actkb, kb, &freedata[totblock - 1]);
+    /* Edit-mode coordinates are only valid for this evaluation. */
+    block->sparse = freedata[totblock - 1] ?
+                        NULL :
+                        key_block_sparse_ensure(key, kb, keyblock_index, refb);
+  }
+
+  /* step 3: blend */
+  if (totblock != 0) {
+    KeyEvaluateData data = {
+        .out = (float(*)[3])basispoin,
+        .blocks = blocks,
+        .totblock = totblock,
+        .tot = tot,
+    };
+    const int totchunk = (tot + KEY_EVALUATE_CHUNK_SIZE - 1) / KEY_EVALUATE_CHUNK_SIZE;
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (totchunk > 1);
+    BLI_task_parallel_range(0, totchunk, &data, key_evaluate_relative_coords_cb, &settings);
+  }
+
+  for (int i = 0; i < totblock; i++) {
+    if (freedata[i]) {
+      MEM_freeN(freedata[i]);
+    }
+  }
+  MEM_freeN(freedata);
+  MEM_freeN(blocks);
+}
+
 static void do_key(const int start,
                    int end,
                    const int tot,
@@ -1317,8 +1619,7 @@ static void do_mesh_key(Object *ob, Key *key, char *out, const int tot)
     WeightsArrayCache cache = {0, NULL};
     float **per_keyblock_weights;
     per_keyblock_weights = keyblock_get_per_block_weights(ob, key, &cache);
-    key_evaluate_relative(
-        0, tot, tot, (char *)out, key, actkb, per_keyblock_weights, KEY_MODE_DUMMY);
+    key_evaluate_relative_coords(tot, (char *)out, key, actkb, per_keyblock_weights);
     keyblock_free_per_block_weights(key, per_keyblock_weights, &cache);
   }
   else {
@@ -1410,8 +1711,7 @@ static void do_latt_key(Object *ob, Key *key, char *out, const int tot)
   if (key->type == KEY_RELATIVE) {
     float **per_keyblock_weights;
     per_keyblock_weights = keyblock_get_per_block_weights(ob, key, NULL);
-    key_evaluate_relative(
-        0, tot, tot, (char *)out, key, actkb, per_keyblock_weights, KEY_MODE_DUMMY);
+    key_evaluate_relative_coords(tot, (char *)out, key, actkb, per_keyblock_weights);
     keyblock_free_per_block_weights(key, per_keyblock_weights, NULL);
   }
   else {
@@ -19,8 +19,13 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_bitmap.h"
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_string.h"
+#include "BLI_string_utils.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_ID.h"
@@ -250,3 +255,325 @@ void BKE_main_idmap_destroy(struct IDNameLib_Map *id_map)
 }
 
 /** \} */
+
+/** \name BKE_main_idmap_names API
+ *
+ * Persistent (name -> local ID) mapping stored in #Main.name_map, used to check for name
+ * collisions and to find unused number suffixes without scanning whole ID lists.
+ *
+ * Unlike #IDNameLib_Map above, it is kept up to date when IDs are added, renamed or removed
+ * through the regular BKE API (#BKE_id_new_name_validate, #BKE_id_free_ex, ...). Code moving IDs
+ * between Main databases in bulk (file reading, undo, ...) has to call
+ * #BKE_main_idmap_names_clear, the mapping of each ID type is then rebuilt lazily on next use.
+ *
+ * Linked IDs are not stored, their names only have to be unique within their own library.
+ *
+ * Lookups may happen from multiple threads (e.g. drivers looking up IDs by name), and the
+ * mapping is built or rebuilt by the first lookup needing it, so all accesses are serialized.
+ * \{ */
+
+/* The maximum value up to which we track the actual smallest unused number. Beyond that
+ * value, we only return the first biggest unused number, without trying to 'fill the gaps'
+ * in-between already used numbers... */
+#define MAX_NUMBERS_IN_USE 1024
+
+/** Numbers used as suffix of a given base name ("base.number"). */
+typedef struct MainNameBase {
+  BLI_bitmap numbers_in_use[BLI_BITMAP_SIZE(MAX_NUMBERS_IN_USE) / sizeof(BLI_bitmap)];
+  /** Largest number in use, only valid if `number_max_dirty` is not set. */
+  int number_max;
+  /** Amount of IDs using that base name, the entry is freed when it goes to zero. */
+  int users;
+  /** The ID with the largest number was removed, #number_max has to be recomputed. */
+  bool number_max_dirty;
+} MainNameBase;
+
+typedef struct MainNameTypeMap {
+  /** ID name (without type prefix) -> ID, the name strings are owned by #ids. */
+  GHash *names;
+  /** ID -> name string under which it is stored in #names. */
+  GHash *ids;
+  /** Base name (owned) -> #MainNameBase. */
+  GHash *bases;
+} MainNameTypeMap;
+
+struct MainNameMap {
+  MainNameTypeMap type_maps[INDEX_ID_MAX];
+};
+
+/* Guards #Main.name_map of all Main databases, and the mappings themselves. */
+static ThreadMutex main_idmap_names_lock = BLI_MUTEX_INITIALIZER;
+
+static void main_idmap_names_base_add(MainNameTypeMap *type_map, const char *name)
+{
+  char base_name[MAX_ID_NAME - 2];
+  int number;
+  BLI_split_name_num(base_name, &number, name, '.');
+
+  void **key_p, **base_p;
+  if (!BLI_ghash_ensure_p_ex(type_map->bases, base_name, &key_p, &base_p)) {
+    *key_p = BLI_strdup(base_name);
+    *base_p = MEM_callocN(sizeof(MainNameBase), __func__);
+  }
+  MainNameBase *base = *base_p;
+
+  base->users++;
+  if (number < MAX_NUMBERS_IN_USE) {
+    BLI_BITMAP_ENABLE(base->numbers_in_use, number);
+  }
+  if (number > base->number_max) {
+    base->number_max = number;
+  }
+}
+
+static void main_idmap_names_base_remove(MainNameTypeMap *type_map, const char *name)
+{
+  char base_name[MAX_ID_NAME - 2];
+  int number;
+  BLI_split_name_num(base_name, &number, name, '.');
+
+  MainNameBase *base = BLI_ghash_lookup(type_map->bases, base_name);
+  if (base == NULL) {
+    BLI_assert(0);
+    return;
+  }
+
+  if (--base->users == 0) {
+    BLI_ghash_remove(type_map->bases, base_name, MEM_freeN, MEM_freeN);
+    return;
+  }
+  /* Another ID may use the same number with a different amount of leading zeros
+   * ("Name.5" and "Name.005"), callers have to check the names they build from returned numbers
+   * anyway. */
+  if (number < MAX_NUMBERS_IN_USE) {
+    BLI_BITMAP_DISABLE(base->numbers_in_use, number);
+  }
+  if (number == base->number_max) {
+    base->number_max_dirty = true;
+  }
+}
+
+static bool main_idmap_names_insert(MainNameTypeMap *type_map, ID *id)
+{
+  BLI_assert(!ID_IS_LINKED(id));
+
+  if (BLI_ghash_haskey(type_map->names, id->name + 2)) {
+    /* Should not happen, but local names are not always unique in files from older versions. */
+    return false;
+  }
+  char *name = BLI_strdup(id->name + 2);
+  BLI_ghash_insert(type_map->names, name, id);
+  BLI_ghash_insert(type_map->ids, id, name);
+
+  main_idmap_names_base_add(type_map, name);
+  return true;
+}
+
+static void main_idmap_names_type_map_free(MainNameTypeMap *type_map)
+{
+  if (type_map->names == NULL) {
+    return;
+  }
+  BLI_ghash_free(type_map->names, NULL, NULL);
+  BLI_ghash_free(type_map->ids, NULL, MEM_freeN);
+  BLI_ghash_free(type_map->bases, MEM_freeN, MEM_freeN);
+  type_map->names = NULL;
+  type_map->ids = NULL;
+  type_map->bases = NULL;
+}
+
+/**
+ * Get the mapping of given ID type, building it from the ID list on first use.
+ * Must be called with #main_idmap_names_lock held.
+ */
+static MainNameTypeMap *main_idmap_names_type_map_ensure(Main *bmain, const short id_type)
+{
+  const int index = BKE_idtype_idcode_to_index(id_type);
+  if (UNLIKELY(index < 0)) {
+    BLI_assert(0);
+    return NULL;
+  }
+
+  if (bmain->name_map == NULL) {
+    bmain->name_map = MEM_callocN(sizeof(*bmain->name_map), __func__);
+  }
+  MainNameTypeMap *type_map = &bmain->name_map->type_maps[index];
+
+  if (type_map->names == NULL) {
+    ListBase *lb = which_libbase(bmain, id_type);
+    const uint lb_len = (uint)BLI_listbase_count(lb);
+
+    type_map->names = BLI_ghash_str_new_ex(__func__, lb_len);
+    type_map->ids = BLI_ghash_ptr_new_ex(__func__, lb_len);
+    type_map->bases = BLI_ghash_str_new(__func__);
+
+    LISTBASE_FOREACH (ID *, id, lb) {
+      if (!ID_IS_LINKED(id)) {
+        main_idmap_names_insert(type_map, id);
+      }
+    }
+  }
+
+  return type_map;
+}
+
+/**
+ * Find the local ID of given type named \a name (without the ID type prefix).
+ */
+ID *BKE_main_idmap_names_lookup(Main *bmain, const short id_type, const char *name)
+{
+  BLI_mutex_lock(&main_idmap_names_lock);
+
+  MainNameTypeMap *type_map = main_idmap_names_type_map_ensure(bmain, id_type);
+  ID *id = NULL;
+  if (LIKELY(type_map != NULL)) {
+    id = BLI_ghash_lookup(type_map->names, name);
+    if (id != NULL && UNLIKELY(!STREQ(id->name + 2, name))) {
+      /* The ID has been renamed without going through #BKE_id_new_name_validate, rebuild. */
+      main_idmap_names_type_map_free(type_map);
+      type_map = main_idmap_names_type_map_ensure(bmain, id_type);
+      id = BLI_ghash_lookup(type_map->names, name);
+    }
+  }
+
+  BLI_mutex_unlock(&main_idmap_names_lock);
+  return id;
+}
+
+static int main_idmap_names_number_unused(Main *bmain,
+                                          const short id_type,
+                                          const char *base_name,
+                                          const int number_min)
+{
+  MainNameTypeMap *type_map = main_idmap_names_type_map_ensure(bmain, id_type);
+  MainNameBase *base = type_map ? BLI_ghash_lookup(type_map->bases, base_name) : NULL;
+  if (base == NULL) {
+    return number_min;
+  }
+
+  for (int number = number_min; number < MAX_NUMBERS_IN_USE; number++) {
+    /* Skip fully used blocks at once. */
+    if ((number & _BITMAP_MASK) == 0 && base->numbers_in_use[number >> _BITMAP_POWER] == ~0u) {
+      number += _BITMAP_MASK;
+      continue;
+    }
+    if (!BLI_BITMAP_TEST(base->numbers_in_use, number)) {
+      return number;
+    }
+  }
+
+  if (base->number_max_dirty) {
+    base->number_max = 0;
+    GHashIterator gh_iter;
+    GHASH_ITER (gh_iter, type_map->names) {
+      char base_name_test[MAX_ID_NAME - 2];
+      int number_test;
+      BLI_split_name_num(base_name_test, &number_test, BLI_ghashIterator_getKey(&gh_iter), '.');
+      if (number_test > base->number_max && STREQ(base_name, base_name_test)) {
+        base->number_max = number_test;
+      }
+    }
+    base->number_max_dirty = false;
+  }
+
+  return max_ii(base->number_max + 1, number_min);
+}
+
+/**
+ * Return the smallest number not used as suffix of \a base_name by local IDs of given type,
+ * within [\a number_min .. #MAX_NUMBERS_IN_USE - 1]. If all of those are in use, return the
+ * first number bigger than all used ones (and not smaller than \a number_min).
+ *
+ * \note Names with the same number written differently ("Name.5" and "Name.005") are not
+ * distinguished, callers must check that the final name is actually free.
+ */
+int BKE_main_idmap_names_number_unused(Main *bmain,
+                                       const short id_type,
+                                       const char *base_name,
+                                       const int number_min)
+{
+  BLI_mutex_lock(&main_idmap_names_lock);
+  const int number = main_idmap_names_number_unused(bmain, id_type, base_name, number_min);
+  BLI_mutex_unlock(&main_idmap_names_lock);
+  return number;
+}
+
+static void main_idmap_names_type_map_remove(MainNameTypeMap *type_map, ID *id)
+{
+  char *name = BLI_ghash_popkey(type_map->ids, id, NULL);
+  if (name == NULL) {
+    return;
+  }
+  BLI_ghash_remove(type_map->names, name, NULL, NULL);
+  main_idmap_names_base_remove(type_map, name);
+  MEM_freeN(name);
+}
+
+/**
+ * Register the (new) name of a local ID.
+ */
+void BKE_main_idmap_names_add(Main *bmain, ID *id)
+{
+  if (ID_IS_LINKED(id)) {
+    return;
+  }
+  BLI_mutex_lock(&main_idmap_names_lock);
+
+  MainNameTypeMap *type_map = main_idmap_names_type_map_ensure(bmain, GS(id->name));
+  if (LIKELY(type_map != NULL)) {
+    const char *name = BLI_ghash_lookup(type_map->ids, id);
+    /* Already registered when equal, e.g. when the map was just built from the ID list. */
+    if (name == NULL || !STREQ(name, id->name + 2)) {
+      if (name != NULL) {
+        main_idmap_names_type_map_remove(type_map, id);
+      }
+      main_idmap_names_insert(type_map, id);
+    }
+  }
+
+  BLI_mutex_unlock(&main_idmap_names_lock);
+}
+
+/**
+ * Unregister given ID, to be called when it is removed from \a bmain or before it gets renamed.
+ * Does nothing if the ID is not registered.
+ */
+void BKE_main_idmap_names_remove(Main *bmain, ID *id)
+{
+  if (ID_IS_LINKED(id)) {
+    return;
+  }
+  /* Build the mapping if needed, since the ID would be added to it when it is built from the
+   * list while the ID is still in it (e.g. when renaming). */
+  BLI_mutex_lock(&main_idmap_names_lock);
+
+  MainNameTypeMap *type_map = main_idmap_names_type_map_ensure(bmain, GS(id->name));
+  if (LIKELY(type_map != NULL)) {
+    main_idmap_names_type_map_remove(type_map, id);
+  }
+
+  BLI_mutex_unlock(&main_idmap_names_lock);
+}
+
+/**
+ * Free the whole name mapping of \a bmain, it will be rebuilt from the ID lists when needed.
+ * To be called by code adding or removing IDs to/from Main lists directly.
+ */
+void BKE_main_idmap_names_clear(Main *bmain)
+{
+  BLI_mutex_lock(&main_idmap_names_lock);
+
+  if (bmain->name_map != NULL) {
+    for (int i = 0; i < INDEX_ID_MAX; i++) {
+      main_idmap_names_type_map_free(&bmain->name_map->type_maps[i]);
+    }
+    MEM_freeN(bmain->name_map);
+    bmain->name_map = NULL;
+  }
+
+  BLI_mutex_unlock(&main_idmap_names_lock);
+}
+
+#undef MAX_NUMBERS_IN_USE
+
+/** \} */
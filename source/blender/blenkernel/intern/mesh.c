@@ -572,6 +572,25 @@ void BKE_mesh_update_customdata_pointers(Mesh *me, const bool do_ensure_tess_cd)
   me->mloopuv = CustomData_get_layer(&me->ldata, CD_MLOOPUV);
 }
 
+/**
+ * Give an evaluated mesh its own copy of all geometry arrays it shares with other meshes (see
+ * #LIB_ID_COPY_CD_REFERENCE). Evaluation copies layers before writing to them, this is needed
+ * before handing out pointers to the arrays which may be written to, like the Python API does.
+ * Original meshes are left as they are.
+ */
+void BKE_mesh_eval_ensure_own_geometry(Mesh *me)
+{
+  if ((me->id.tag & (LIB_TAG_COPIED_ON_WRITE | LIB_TAG_NO_MAIN)) == 0) {
+    return;
+  }
+  CustomData_duplicate_referenced_layers(&me->vdata, me->totvert);
+  CustomData_duplicate_referenced_layers(&me->edata, me->totedge);
+  CustomData_duplicate_referenced_layers(&me->fdata, me->totface);
+  CustomData_duplicate_referenced_layers(&me->ldata, me->totloop);
+  CustomData_duplicate_referenced_layers(&me->pdata, me->totpoly);
+  BKE_mesh_update_customdata_pointers(me, false);
+}
+
 bool BKE_mesh_has_custom_loop_normals(Mesh *me)
 {
   if (me->edit_mesh) {
@@ -1314,8 +1333,10 @@ bool BKE_mesh_minmax(const Mesh *me, float r_min[3], float r_max[3])
 void BKE_mesh_transform(Mesh *me, float mat[4][4], bool do_keys)
 {
   int i;
-  MVert *mvert = me->mvert;
-  float(*lnors)[3] = CustomData_get_layer(&me->ldata, CD_NORMAL);
+  /* This will just return the pointer if it wasn't a referenced layer. */
+  MVert *mvert = CustomData_duplicate_referenced_layer(&me->vdata, CD_MVERT, me->totvert);
+  float(*lnors)[3] = CustomData_duplicate_referenced_layer(&me->ldata, CD_NORMAL, me->totloop);
+  me->mvert = mvert;
 
   for (i = 0; i < me->totvert; i++, mvert++) {
     mul_m4_v3(mat, mvert->co);
@@ -1649,7 +1670,7 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
   const float split_angle = (mesh->flag & ME_AUTOSMOOTH) != 0 ? mesh->smoothresh : (float)M_PI;
 
   if (CustomData_has_layer(&mesh->ldata, CD_NORMAL)) {
-    r_loopnors = CustomData_get_layer(&mesh->ldata, CD_NORMAL);
+    r_loopnors = CustomData_duplicate_referenced_layer(&mesh->ldata, CD_NORMAL, mesh->totloop);
     memset(r_loopnors, 0, sizeof(float[3]) * mesh->totloop);
   }
   else {
@@ -1667,6 +1688,11 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
     free_polynors = false;
   }
   else {
+    const bool only_face_normals = BKE_mesh_vert_normals_shared_are_valid(mesh);
+    if (!only_face_normals) {
+      /* This will just return the pointer if it wasn't a referenced layer. */
+      mesh->mvert = CustomData_duplicate_referenced_layer(&mesh->vdata, CD_MVERT, mesh->totvert);
+    }
     polynors = MEM_malloc_arrayN(mesh->totpoly, sizeof(float[3]), __func__);
     BKE_mesh_calc_normals_poly(mesh->mvert,
                                NULL,
@@ -1676,7 +1702,7 @@ void BKE_mesh_calc_normals_split_ex(Mesh *mesh, MLoopNorSpaceArray *r_lnors_spac
                                mesh->totloop,
                                mesh->totpoly,
                                polynors,
-                               false);
+                               only_face_normals);
     free_polynors = true;
   }
 
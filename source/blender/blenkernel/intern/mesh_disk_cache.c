@@ -0,0 +1,883 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup bke
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "MEM_guardedalloc.h"
+
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+#include "DNA_space_types.h" /* for FILE_MAX. */
+#include "DNA_userdef_types.h"
+
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_hash_mm2a.h"
+#include "BLI_listbase.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_system.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+#include BLI_SYSTEM_PID_H
+
+#include "BKE_blender_version.h"
+#include "BKE_customdata.h"
+#include "BKE_global.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+#include "BKE_mesh_disk_cache.h"
+#include "BKE_modifier.h"
+
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_query.h"
+
+#include "atomic_ops.h"
+
+/**
+ * Mesh Disk Cache Design Notes
+ * ============================
+ *
+ * The result of a modifier stack is written to a file named after a hash of everything the
+ * evaluation depends on: the input mesh, settings of the enabled modifiers, vertex group names of
+ * the object, simplify settings of the scene, the requested custom data masks and the version of
+ * Blender. A following evaluation of the same stack, after the file was reloaded or in another
+ * session, reads the mesh from that file instead of applying the modifiers again.
+ *
+ * Only stacks whose result depends on nothing but this data are cached. Modifiers referencing
+ * other data-blocks, depending on time or owning data outside of their DNA struct (bind data,
+ * simulation caches) are not supported, neither are meshes with shape keys. Stacks without any
+ * costly modifier are not worth the hashing and file access and are skipped as well.
+ *
+ * Each file starts with a #MeshDiskCacheHeader followed by the custom data layers of the mesh.
+ * The header stores the full #MeshDiskCacheKey, including element counts of the input mesh and
+ * the types of the modifiers, so a file whose name collides with the key of another stack is
+ * recognized and left alone. Files with a matching header whose layers fail validation are
+ * truncated or otherwise damaged, and are deleted.
+ *
+ * Files are only written by evaluations which are not interactive: final renders and Blender
+ * running in background mode. Interactive sessions read files, but don't write a new one for
+ * every step of a tweaked modifier setting.
+ *
+ * Files which were used least recently are deleted when the size of all files exceeds the limit
+ * from the user preferences. The limit is enforced per process: files are gathered from the
+ * directory once, so files written by other instances of Blender sharing the directory later on
+ * are not accounted for.
+ */
+
+#define MDCACHE_CURRENT_VERSION 2
+#define MDCACHE_SUBDIR "meshes"
+#define MDCACHE_FNAME_FORMAT "%08x%08x.mdc"
+
+typedef enum eMeshDiskCacheDomain {
+  MDCACHE_DOMAIN_VERT = 0,
+  MDCACHE_DOMAIN_EDGE = 1,
+  MDCACHE_DOMAIN_LOOP = 2,
+  MDCACHE_DOMAIN_POLY = 3,
+} eMeshDiskCacheDomain;
+#define MDCACHE_DOMAIN_NUM 4
+
+typedef struct MeshDiskCacheHeader {
+  char magic[4];
+  int version;
+  int blender_version;
+  int blender_subversion;
+  MeshDiskCacheKey key;
+  int totvert, totedge, totloop, totpoly;
+  int totlayer;
+  char endian;
+  char deformed_only;
+  char _pad[2];
+  int64_t cd_dirty_vert, cd_dirty_edge, cd_dirty_loop, cd_dirty_poly;
+} MeshDiskCacheHeader;
+
+typedef struct MeshDiskCacheLayer {
+  int domain; /* eMeshDiskCacheDomain */
+  int type;
+  int flag;
+  int active, active_rnd, active_clone, active_mask;
+  int uid;
+  char name[64];
+} MeshDiskCacheLayer;
+
+typedef struct MeshDiskCacheFile {
+  struct MeshDiskCacheFile *next, *prev;
+  char path[FILE_MAX];
+  size_t size;
+  int64_t mtime;
+} MeshDiskCacheFile;
+
+typedef struct MeshDiskCache {
+  /** Directory #files were gathered from, empty when not gathered yet. */
+  char dir[FILE_MAX];
+  ListBase files;
+  size_t size_total;
+} MeshDiskCache;
+
+static ThreadMutex mesh_disk_cache_mutex = BLI_MUTEX_INITIALIZER;
+static MeshDiskCache mesh_disk_cache = {{0}};
+
+/* -------------------------------------------------------------------- */
+/** \name Files Management
+ *
+ * Functions working with #mesh_disk_cache expect #mesh_disk_cache_mutex to be locked.
+ * \{ */
+
+static size_t mesh_disk_cache_size_limit(void)
+{
+  return (size_t)U.mesh_disk_cache_size_limit * 1024 * 1024;
+}
+
+static void mesh_disk_cache_get_dir(char *dir, size_t dir_len)
+{
+  BLI_strncpy(dir, U.mesh_disk_cache_dir, dir_len);
+  BLI_path_append(dir, dir_len, MDCACHE_SUBDIR);
+  BLI_add_slash(dir);
+}
+
+static void mesh_disk_cache_get_file_path(const MeshDiskCacheKey *key, char *path, size_t path_len)
+{
+  char filename[FILE_MAXFILE];
+  BLI_snprintf(filename, sizeof(filename), MDCACHE_FNAME_FORMAT, key->hash[0], key->hash[1]);
+  mesh_disk_cache_get_dir(path, path_len);
+  BLI_path_append(path, path_len, filename);
+}
+
+static void mesh_disk_cache_files_free(void)
+{
+  BLI_freelistN(&mesh_disk_cache.files);
+  mesh_disk_cache.size_total = 0;
+  mesh_disk_cache.dir[0] = '\0';
+}
+
+/* Gather files of the cache directory, if not done yet or the directory changed. */
+static void mesh_disk_cache_files_ensure(void)
+{
+  char dir[FILE_MAX];
+  mesh_disk_cache_get_dir(dir, sizeof(dir));
+  if (STREQ(dir, mesh_disk_cache.dir)) {
+    return;
+  }
+  mesh_disk_cache_files_free();
+  BLI_strncpy(mesh_disk_cache.dir, dir, sizeof(mesh_disk_cache.dir));
+
+  if (!BLI_is_dir(dir)) {
+    return;
+  }
+
+  struct direntry *filelist;
+  const uint totfile = BLI_filelist_dir_contents(dir, &filelist);
+  for (uint i = 0; i < totfile; i++) {
+    const struct direntry *fl = &filelist[i];
+    if (BLI_is_dir(fl->path) || !BLI_path_extension_check(fl->path, ".mdc")) {
+      continue;
+    }
+    MeshDiskCacheFile *cache_file = MEM_callocN(sizeof(MeshDiskCacheFile), __func__);
+    BLI_strncpy(cache_file->path, fl->path, sizeof(cache_file->path));
+    cache_file->size = (size_t)fl->s.st_size;
+    cache_file->mtime = (int64_t)fl->s.st_mtime;
+    BLI_addtail(&mesh_disk_cache.files, cache_file);
+    mesh_disk_cache.size_total += cache_file->size;
+  }
+  BLI_filelist_free(filelist, totfile);
+}
+
+static MeshDiskCacheFile *mesh_disk_cache_file_find(const char *path)
+{
+  LISTBASE_FOREACH (MeshDiskCacheFile *, cache_file, &mesh_disk_cache.files) {
+    if (STREQ(cache_file->path, path)) {
+      return cache_file;
+    }
+  }
+  return NULL;
+}
+
+static void mesh_disk_cache_file_delete(MeshDiskCacheFile *cache_file)
+{
+  BLI_delete(cache_file->path, false, false);
+  mesh_disk_cache.size_total -= cache_file->size;
+  BLI_freelinkN(&mesh_disk_cache.files, cache_file);
+}
+
+static void mesh_disk_cache_enforce_limit(void)
+{
+  const size_t size_limit = mesh_disk_cache_size_limit();
+  while (mesh_disk_cache.size_total > size_limit) {
+    MeshDiskCacheFile *oldest_file = mesh_disk_cache.files.first;
+    if (oldest_file == NULL) {
+      break;
+    }
+    LISTBASE_FOREACH (MeshDiskCacheFile *, cache_file, &mesh_disk_cache.files) {
+      if (cache_file->mtime < oldest_file->mtime) {
+        oldest_file = cache_file;
+      }
+    }
+    mesh_disk_cache_file_delete(oldest_file);
+  }
+}
+
+static void mesh_disk_cache_file_add(const char *path, size_t size)
+{
+  mesh_disk_cache_files_ensure();
+  MeshDiskCacheFile *cache_file = mesh_disk_cache_file_find(path);
+  if (cache_file == NULL) {
+    cache_file = MEM_callocN(sizeof(MeshDiskCacheFile), __func__);
+    BLI_strncpy(cache_file->path, path, sizeof(cache_file->path));
+    BLI_addtail(&mesh_disk_cache.files, cache_file);
+  }
+  else {
+    mesh_disk_cache.size_total -= cache_file->size;
+  }
+  cache_file->size = size;
+  cache_file->mtime = (int64_t)time(NULL);
+  mesh_disk_cache.size_total += size;
+  mesh_disk_cache_enforce_limit();
+}
+
+/* Mark the file as used, so it is deleted after files which were not used for longer. */
+static void mesh_disk_cache_file_touch(const char *path)
+{
+  mesh_disk_cache_files_ensure();
+  MeshDiskCacheFile *cache_file = mesh_disk_cache_file_find(path);
+  if (cache_file != NULL) {
+    cache_file->mtime = (int64_t)time(NULL);
+  }
+  BLI_file_touch(path);
+}
+
+static void mesh_disk_cache_file_remove(const char *path)
+{
+  mesh_disk_cache_files_ensure();
+  MeshDiskCacheFile *cache_file = mesh_disk_cache_file_find(path);
+  if (cache_file != NULL) {
+    mesh_disk_cache_file_delete(cache_file);
+  }
+  else {
+    BLI_delete(path, false, false);
+  }
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Key
+ * \{ */
+
+typedef struct MeshDiskCacheHash {
+  BLI_HashMurmur2A mm2[2];
+} MeshDiskCacheHash;
+
+static void mesh_disk_cache_hash_init(MeshDiskCacheHash *hash)
+{
+  BLI_hash_mm2a_init(&hash->mm2[0], 0);
+  BLI_hash_mm2a_init(&hash->mm2[1], 0x9e3779b9);
+}
+
+static void mesh_disk_cache_hash_add(MeshDiskCacheHash *hash, const void *data, size_t len)
+{
+  BLI_hash_mm2a_add(&hash->mm2[0], data, len);
+  BLI_hash_mm2a_add(&hash->mm2[1], data, len);
+}
+
+static void mesh_disk_cache_hash_add_int(MeshDiskCacheHash *hash, int value)
+{
+  BLI_hash_mm2a_add_int(&hash->mm2[0], value);
+  BLI_hash_mm2a_add_int(&hash->mm2[1], value);
+}
+
+static void mesh_disk_cache_hash_add_string(MeshDiskCacheHash *hash, const char *str)
+{
+  mesh_disk_cache_hash_add(hash, str, strlen(str) + 1);
+}
+
+static void mesh_disk_cache_hash_end(MeshDiskCacheHash *hash, MeshDiskCacheKey *r_key)
+{
+  r_key->hash[0] = BLI_hash_mm2a_end(&hash->mm2[0]);
+  r_key->hash[1] = BLI_hash_mm2a_end(&hash->mm2[1]);
+}
+
+static void modifier_has_id_link_cb(void *user_data,
+                                    Object *UNUSED(ob),
+                                    ID **idpoin,
+                                    int UNUSED(cb_flag))
+{
+  if (*idpoin != NULL) {
+    *(bool *)user_data = true;
+  }
+}
+
+static bool modifier_has_id_links(const Object *ob, ModifierData *md)
+{
+  const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+  bool has_id_links = false;
+  if (mti->foreachIDLink) {
+    mti->foreachIDLink(md, (Object *)ob, modifier_has_id_link_cb, &has_id_links);
+  }
+  else if (mti->foreachObjectLink) {
+    mti->foreachObjectLink(
+        md, (Object *)ob, (ObjectWalkFunc)modifier_has_id_link_cb, &has_id_links);
+  }
+  return has_id_links;
+}
+
+/**
+ * Modifiers whose result only depends on the input mesh and settings stored in their own DNA.
+ * Pointers in the DNA of these modifiers are either ID pointers, which are required to be unset,
+ * or runtime data which is cleared when hashing the settings.
+ */
+static bool modifier_is_supported(const Object *ob, ModifierData *md, bool *r_is_costly)
+{
+  switch ((ModifierType)md->type) {
+    case eModifierType_Subsurf:
+    case eModifierType_Decimate:
+    case eModifierType_Remesh:
+    case eModifierType_Skin:
+    case eModifierType_Weld:
+    case eModifierType_Solidify:
+    case eModifierType_Wireframe:
+    case eModifierType_Array:
+    case eModifierType_Screw:
+      *r_is_costly = true;
+      break;
+    case eModifierType_Bevel:
+      if (((BevelModifierData *)md)->flags & MOD_BEVEL_CUSTOM_PROFILE) {
+        return false;
+      }
+      *r_is_costly = true;
+      break;
+    case eModifierType_Mirror:
+    case eModifierType_Triangulate:
+    case eModifierType_WeightedNormal:
+    case eModifierType_EdgeSplit:
+    case eModifierType_Smooth:
+    case eModifierType_Cast:
+    case eModifierType_SimpleDeform:
+    case eModifierType_Displace:
+      break;
+    default:
+      return false;
+  }
+  return !modifier_has_id_links(ob, md);
+}
+
+static void mesh_disk_cache_hash_modifier(MeshDiskCacheHash *hash, ModifierData *md)
+{
+  const ModifierTypeInfo *mti = modifierType_getInfo(md->type);
+  char *settings = MEM_mallocN(mti->structSize, __func__);
+  memcpy(settings, md, mti->structSize);
+  /* Name, flags and list pointers of the modifier do not affect the result. */
+  memset(settings, 0, sizeof(ModifierData));
+  switch ((ModifierType)md->type) {
+    case eModifierType_Subsurf: {
+      SubsurfModifierData *smd = (SubsurfModifierData *)settings;
+      smd->emCache = NULL;
+      smd->mCache = NULL;
+      break;
+    }
+    case eModifierType_Bevel:
+      ((BevelModifierData *)settings)->custom_profile = NULL;
+      break;
+    default:
+      break;
+  }
+  mesh_disk_cache_hash_add_int(hash, md->type);
+  mesh_disk_cache_hash_add(hash, settings, mti->structSize);
+  MEM_freeN(settings);
+}
+
+static bool mesh_disk_cache_hash_customdata(MeshDiskCacheHash *hash,
+                                            const CustomData *data,
+                                            const int totelem)
+{
+  mesh_disk_cache_hash_add_int(hash, data->totlayer);
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    mesh_disk_cache_hash_add_int(hash, layer->type);
+    mesh_disk_cache_hash_add_int(hash, layer->flag & ~CD_FLAG_NOFREE);
+    mesh_disk_cache_hash_add_int(hash, layer->active);
+    mesh_disk_cache_hash_add_int(hash, layer->active_rnd);
+    mesh_disk_cache_hash_add_int(hash, layer->active_clone);
+    mesh_disk_cache_hash_add_int(hash, layer->active_mask);
+    mesh_disk_cache_hash_add_int(hash, layer->uid);
+    mesh_disk_cache_hash_add_string(hash, layer->name);
+    if (layer->data == NULL) {
+      continue;
+    }
+    if (layer->type == CD_MDEFORMVERT) {
+      const MDeformVert *dvert = layer->data;
+      for (int j = 0; j < totelem; j++) {
+        mesh_disk_cache_hash_add_int(hash, dvert[j].totweight);
+        if (dvert[j].dw != NULL) {
+          mesh_disk_cache_hash_add(hash, dvert[j].dw, sizeof(MDeformWeight) * dvert[j].totweight);
+        }
+      }
+    }
+    else if (CustomData_layertype_is_plain_data(layer->type)) {
+      mesh_disk_cache_hash_add(
+          hash, layer->data, (size_t)CustomData_sizeof(layer->type) * (size_t)totelem);
+    }
+    else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BKE_mesh_disk_cache_is_enabled(void)
+{
+  return (U.mesh_disk_cache_flag & USER_MESH_DISK_CACHE_ENABLE) &&
+         U.mesh_disk_cache_dir[0] != '\0' && U.mesh_disk_cache_size_limit > 0;
+}
+
+/**
+ * Compute the key of a modifier stack evaluation, from everything its result depends on.
+ *
+ * \return false when the result of the stack can not be cached.
+ */
+bool BKE_mesh_disk_cache_key(const Scene *scene,
+                             const Object *ob,
+                             const Mesh *mesh_input,
+                             ModifierData *firstmd,
+                             const int required_mode,
+                             const int use_deform,
+                             const CustomData_MeshMasks *final_datamask,
+                             MeshDiskCacheKey *r_key)
+{
+  if (!BKE_mesh_disk_cache_is_enabled()) {
+    return false;
+  }
+  /* Shape keys are applied by a virtual modifier from data of another data-block. */
+  if (mesh_input->key != NULL) {
+    return false;
+  }
+
+  memset(r_key, 0, sizeof(*r_key));
+
+  bool has_costly_modifier = false;
+  for (ModifierData *md = firstmd; md; md = md->next) {
+    if (!modifier_isEnabled(scene, md, required_mode)) {
+      continue;
+    }
+    if (r_key->totmodifier == MESH_DISK_CACHE_MAX_MODIFIERS ||
+        !modifier_is_supported(ob, md, &has_costly_modifier)) {
+      return false;
+    }
+    r_key->modifier_types[r_key->totmodifier++] = md->type;
+  }
+  if (!has_costly_modifier) {
+    return false;
+  }
+
+  r_key->totvert = mesh_input->totvert;
+  r_key->totedge = mesh_input->totedge;
+  r_key->totloop = mesh_input->totloop;
+  r_key->totpoly = mesh_input->totpoly;
+
+  MeshDiskCacheHash hash;
+  mesh_disk_cache_hash_init(&hash);
+  mesh_disk_cache_hash_add_int(&hash, MDCACHE_CURRENT_VERSION);
+  /* Different versions of Blender sharing a directory use different files. */
+  mesh_disk_cache_hash_add_int(&hash, BLENDER_VERSION);
+  mesh_disk_cache_hash_add_int(&hash, BLENDER_SUBVERSION);
+  mesh_disk_cache_hash_add_int(&hash, required_mode);
+  mesh_disk_cache_hash_add_int(&hash, use_deform);
+  mesh_disk_cache_hash_add(&hash, final_datamask, sizeof(*final_datamask));
+
+  /* Subdivision levels are limited by the scene simplify settings. */
+  mesh_disk_cache_hash_add_int(&hash, (scene->r.mode & R_SIMPLIFY) != 0);
+  mesh_disk_cache_hash_add_int(&hash, scene->r.simplify_subsurf);
+  mesh_disk_cache_hash_add_int(&hash, scene->r.simplify_subsurf_render);
+
+  /* Vertex groups are referenced by name from modifiers. */
+  mesh_disk_cache_hash_add_int(&hash, ob->totcol);
+  LISTBASE_FOREACH (const bDeformGroup *, dg, &ob->defbase) {
+    mesh_disk_cache_hash_add_string(&hash, dg->name);
+  }
+
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->totvert);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->totedge);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->totloop);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->totpoly);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->totcol);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->flag);
+  mesh_disk_cache_hash_add_int(&hash, mesh_input->cd_flag);
+  mesh_disk_cache_hash_add(&hash, &mesh_input->smoothresh, sizeof(mesh_input->smoothresh));
+  if (!mesh_disk_cache_hash_customdata(&hash, &mesh_input->vdata, mesh_input->totvert) ||
+      !mesh_disk_cache_hash_customdata(&hash, &mesh_input->edata, mesh_input->totedge) ||
+      !mesh_disk_cache_hash_customdata(&hash, &mesh_input->ldata, mesh_input->totloop) ||
+      !mesh_disk_cache_hash_customdata(&hash, &mesh_input->pdata, mesh_input->totpoly)) {
+    return false;
+  }
+
+  for (ModifierData *md = firstmd; md; md = md->next) {
+    if (modifier_isEnabled(scene, md, required_mode)) {
+      mesh_disk_cache_hash_modifier(&hash, md);
+    }
+  }
+
+  mesh_disk_cache_hash_end(&hash, r_key);
+  return true;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Reading and Writing
+ * \{ */
+
+static CustomData *mesh_disk_cache_domain_data(Mesh *mesh, int domain, int *r_totelem)
+{
+  switch ((eMeshDiskCacheDomain)domain) {
+    case MDCACHE_DOMAIN_VERT:
+      *r_totelem = mesh->totvert;
+      return &mesh->vdata;
+    case MDCACHE_DOMAIN_EDGE:
+      *r_totelem = mesh->totedge;
+      return &mesh->edata;
+    case MDCACHE_DOMAIN_LOOP:
+      *r_totelem = mesh->totloop;
+      return &mesh->ldata;
+    case MDCACHE_DOMAIN_POLY:
+      *r_totelem = mesh->totpoly;
+      return &mesh->pdata;
+  }
+  *r_totelem = 0;
+  return NULL;
+}
+
+/* Whether the file was written for the same key, by the same version of Blender. */
+static bool mesh_disk_cache_header_matches(const MeshDiskCacheHeader *header,
+                                           const MeshDiskCacheKey *key)
+{
+  return (memcmp(header->magic, "BMDC", 4) == 0 && header->version == MDCACHE_CURRENT_VERSION &&
+          header->blender_version == BLENDER_VERSION &&
+          header->blender_subversion == BLENDER_SUBVERSION && header->endian == ENDIAN_ORDER &&
+          memcmp(&header->key, key, sizeof(*key)) == 0);
+}
+
+static bool mesh_disk_cache_header_is_valid(const MeshDiskCacheHeader *header)
+{
+  return (header->totvert >= 0 && header->totedge >= 0 && header->totloop >= 0 &&
+          header->totpoly >= 0 && header->totlayer >= 0);
+}
+
+static bool mesh_disk_cache_layer_is_valid(const CustomData *data, const CustomDataLayer *layer)
+{
+  const int totlayer_type = CustomData_number_of_layers(data, layer->type);
+  return (layer->active >= 0 && layer->active < totlayer_type && layer->active_rnd >= 0 &&
+          layer->active_rnd < totlayer_type && layer->active_clone >= 0 &&
+          layer->active_clone < totlayer_type && layer->active_mask >= 0 &&
+          layer->active_mask < totlayer_type);
+}
+
+/**
+ * \param r_is_damaged: Set when the file was written for this key but can not be read, as opposed
+ * to a file written for another key or by another version of Blender.
+ */
+static Mesh *mesh_disk_cache_read_file(FILE *file,
+                                       const MeshDiskCacheKey *key,
+                                       const Mesh *mesh_input,
+                                       bool *r_is_damaged)
+{
+  MeshDiskCacheHeader header;
+  *r_is_damaged = false;
+  if (fread(&header, sizeof(header), 1, file) != 1) {
+    *r_is_damaged = true;
+    return NULL;
+  }
+  if (!mesh_disk_cache_header_matches(&header, key)) {
+    return NULL;
+  }
+  if (!mesh_disk_cache_header_is_valid(&header)) {
+    *r_is_damaged = true;
+    return NULL;
+  }
+
+  const CustomData_MeshMasks no_mask = {0};
+  Mesh *mesh = BKE_mesh_new_nomain_from_template_ex(
+      mesh_input, header.totvert, header.totedge, 0, header.totloop, header.totpoly, no_mask);
+
+  bool is_valid = true;
+  for (int i = 0; i < header.totlayer && is_valid; i++) {
+    MeshDiskCacheLayer layer_info;
+    if (fread(&layer_info, sizeof(layer_info), 1, file) != 1 ||
+        !CustomData_layertype_is_plain_data(layer_info.type)) {
+      is_valid = false;
+      break;
+    }
+    int totelem;
+    CustomData *data = mesh_disk_cache_domain_data(mesh, layer_info.domain, &totelem);
+    if (data == NULL) {
+      is_valid = false;
+      break;
+    }
+    layer_info.name[sizeof(layer_info.name) - 1] = '\0';
+
+    /* Primary layers are already created with the mesh. */
+    void *layer_data = NULL;
+    if (CustomData_layertype_is_singleton(layer_info.type)) {
+      layer_data = CustomData_get_layer(data, layer_info.type);
+    }
+    if (layer_data == NULL) {
+      layer_data = CustomData_add_layer_named(
+          data, layer_info.type, CD_CALLOC, NULL, totelem, layer_info.name);
+    }
+    const size_t size = (size_t)CustomData_sizeof(layer_info.type) * (size_t)totelem;
+    if (size != 0 && (layer_data == NULL || fread(layer_data, size, 1, file) != 1)) {
+      is_valid = false;
+      break;
+    }
+
+    for (int j = 0; j < data->totlayer; j++) {
+      CustomDataLayer *layer = &data->layers[j];
+      if (layer->data == layer_data) {
+        layer->flag = layer_info.flag & ~CD_FLAG_NOFREE;
+        layer->active = layer_info.active;
+        layer->active_rnd = layer_info.active_rnd;
+        layer->active_clone = layer_info.active_clone;
+        layer->active_mask = layer_info.active_mask;
+        layer->uid = layer_info.uid;
+        BLI_strncpy(layer->name, layer_info.name, sizeof(layer->name));
+        break;
+      }
+    }
+  }
+
+  /* All data is read, nothing is expected to follow. */
+  if (is_valid && fgetc(file) != EOF) {
+    is_valid = false;
+  }
+
+  for (int domain = 0; domain < MDCACHE_DOMAIN_NUM && is_valid; domain++) {
+    int totelem;
+    const CustomData *data = mesh_disk_cache_domain_data(mesh, domain, &totelem);
+    for (int i = 0; i < data->totlayer; i++) {
+      if (!mesh_disk_cache_layer_is_valid(data, &data->layers[i])) {
+        is_valid = false;
+        break;
+      }
+    }
+  }
+
+  if (!is_valid) {
+    BKE_id_free(NULL, mesh);
+    *r_is_damaged = true;
+    return NULL;
+  }
+
+  mesh->runtime.deformed_only = header.deformed_only;
+  mesh->runtime.cd_dirty_vert = header.cd_dirty_vert;
+  mesh->runtime.cd_dirty_edge = header.cd_dirty_edge;
+  mesh->runtime.cd_dirty_loop = header.cd_dirty_loop;
+  mesh->runtime.cd_dirty_poly = header.cd_dirty_poly;
+  BKE_mesh_update_customdata_pointers(mesh, false);
+  return mesh;
+}
+
+/**
+ * Read the mesh stored for the given key, using \a mesh_input for settings which are not affected
+ * by modifiers (materials, texture space and such).
+ *
+ * \return NULL when there is no valid file for the key.
+ */
+Mesh *BKE_mesh_disk_cache_read(const MeshDiskCacheKey *key, const Mesh *mesh_input)
+{
+  char path[FILE_MAX];
+  mesh_disk_cache_get_file_path(key, path, sizeof(path));
+
+  FILE *file = BLI_fopen(path, "rb");
+  if (file == NULL) {
+    return NULL;
+  }
+  bool is_damaged;
+  Mesh *mesh = mesh_disk_cache_read_file(file, key, mesh_input, &is_damaged);
+  fclose(file);
+
+  if (mesh != NULL || is_damaged) {
+    BLI_mutex_lock(&mesh_disk_cache_mutex);
+    if (mesh != NULL) {
+      mesh_disk_cache_file_touch(path);
+    }
+    else {
+      /* Truncated, so it would never be written again. */
+      mesh_disk_cache_file_remove(path);
+    }
+    BLI_mutex_unlock(&mesh_disk_cache_mutex);
+  }
+
+  return mesh;
+}
+
+static bool mesh_disk_cache_write_file(FILE *file, const MeshDiskCacheKey *key, Mesh *mesh)
+{
+  MeshDiskCacheHeader header = {{0}};
+  memcpy(header.magic, "BMDC", 4);
+  header.version = MDCACHE_CURRENT_VERSION;
+  header.blender_version = BLENDER_VERSION;
+  header.blender_subversion = BLENDER_SUBVERSION;
+  header.key = *key;
+  header.totvert = mesh->totvert;
+  header.totedge = mesh->totedge;
+  header.totloop = mesh->totloop;
+  header.totpoly = mesh->totpoly;
+  header.endian = ENDIAN_ORDER;
+  header.deformed_only = mesh->runtime.deformed_only;
+  header.cd_dirty_vert = mesh->runtime.cd_dirty_vert;
+  header.cd_dirty_edge = mesh->runtime.cd_dirty_edge;
+  header.cd_dirty_loop = mesh->runtime.cd_dirty_loop;
+  header.cd_dirty_poly = mesh->runtime.cd_dirty_poly;
+  for (int domain = 0; domain < MDCACHE_DOMAIN_NUM; domain++) {
+    int totelem;
+    header.totlayer += mesh_disk_cache_domain_data(mesh, domain, &totelem)->totlayer;
+  }
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    return false;
+  }
+
+  for (int domain = 0; domain < MDCACHE_DOMAIN_NUM; domain++) {
+    int totelem;
+    const CustomData *data = mesh_disk_cache_domain_data(mesh, domain, &totelem);
+    for (int i = 0; i < data->totlayer; i++) {
+      const CustomDataLayer *layer = &data->layers[i];
+      MeshDiskCacheLayer layer_info = {0};
+      layer_info.domain = domain;
+      layer_info.type = layer->type;
+      layer_info.flag = layer->flag;
+      layer_info.active = layer->active;
+      layer_info.active_rnd = layer->active_rnd;
+      layer_info.active_clone = layer->active_clone;
+      layer_info.active_mask = layer->active_mask;
+      layer_info.uid = layer->uid;
+      BLI_strncpy(layer_info.name, layer->name, sizeof(layer_info.name));
+      if (fwrite(&layer_info, sizeof(layer_info), 1, file) != 1) {
+        return false;
+      }
+      const size_t size = (size_t)CustomData_sizeof(layer->type) * (size_t)totelem;
+      if (size != 0 && fwrite(layer->data, size, 1, file) != 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* Size of the file the mesh is stored in, zero if the mesh can not be stored. */
+static size_t mesh_disk_cache_file_size(Mesh *mesh)
+{
+  /* Tessellated faces are not stored, they are not expected after modifiers anyway. */
+  if (mesh->totface != 0) {
+    return 0;
+  }
+  size_t size = sizeof(MeshDiskCacheHeader);
+  for (int domain = 0; domain < MDCACHE_DOMAIN_NUM; domain++) {
+    int totelem;
+    const CustomData *data = mesh_disk_cache_domain_data(mesh, domain, &totelem);
+    for (int i = 0; i < data->totlayer; i++) {
+      const CustomDataLayer *layer = &data->layers[i];
+      if (layer->data == NULL || !CustomData_layertype_is_plain_data(layer->type)) {
+        return 0;
+      }
+      size += sizeof(MeshDiskCacheLayer);
+      size += (size_t)CustomData_sizeof(layer->type) * (size_t)totelem;
+    }
+  }
+  return size;
+}
+
+/**
+ * Whether evaluations of the depsgraph store their results. Interactive viewport evaluations only
+ * read, to not write a file on the evaluation thread for every step of a changing setting.
+ */
+bool BKE_mesh_disk_cache_write_is_allowed(const Depsgraph *depsgraph)
+{
+  return G.background || DEG_get_mode(depsgraph) == DAG_EVAL_RENDER;
+}
+
+/**
+ * Store result of the modifier stack evaluation. Does nothing if the mesh has data which can not
+ * be stored, or it does not fit into the cache.
+ */
+void BKE_mesh_disk_cache_write(const MeshDiskCacheKey *key, const Object *ob, const Mesh *mesh)
+{
+  /* Errors are set on modifiers during evaluation, they would be lost when reading. */
+  LISTBASE_FOREACH (const ModifierData *, md, &ob->modifiers) {
+    if (md->error != NULL) {
+      return;
+    }
+  }
+
+  const size_t size = mesh_disk_cache_file_size((Mesh *)mesh);
+  if (size == 0 || size > mesh_disk_cache_size_limit()) {
+    return;
+  }
+
+  char path[FILE_MAX];
+  mesh_disk_cache_get_file_path(key, path, sizeof(path));
+  if (BLI_exists(path)) {
+    /* Written by another object with the same stack, another instance of Blender, or for another
+     * stack whose key has the same hash. */
+    return;
+  }
+
+  /* Write to a temporary file first, so incomplete files are never read. The name is unique
+   * across threads of this process and across processes sharing the directory. */
+  static unsigned int temp_counter = 0;
+  char path_temp[FILE_MAX];
+  BLI_snprintf(path_temp,
+               sizeof(path_temp),
+               "%s.%d.%u.tmp",
+               path,
+               abs(getpid()),
+               atomic_add_and_fetch_u(&temp_counter, 1));
+  BLI_make_existing_file(path_temp);
+  FILE *file = BLI_fopen(path_temp, "wb");
+  if (file == NULL) {
+    return;
+  }
+  const bool success = mesh_disk_cache_write_file(file, key, (Mesh *)mesh);
+  fclose(file);
+  if (!success || BLI_rename(path_temp, path) != 0) {
+    BLI_delete(path_temp, false, false);
+    return;
+  }
+
+  BLI_mutex_lock(&mesh_disk_cache_mutex);
+  mesh_disk_cache_file_add(path, size);
+  BLI_mutex_unlock(&mesh_disk_cache_mutex);
+}
+
+/** \} */
+
+void BKE_mesh_disk_cache_exit(void)
+{
+  BLI_mutex_lock(&mesh_disk_cache_mutex);
+  mesh_disk_cache_files_free();
+  BLI_mutex_unlock(&mesh_disk_cache_mutex);
+}
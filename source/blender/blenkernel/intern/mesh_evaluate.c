@@ -402,6 +402,10 @@ void BKE_mesh_ensure_normals_for_display(Mesh *mesh)
 
   if (do_vert_normals || do_poly_normals) {
     const bool do_add_poly_nors_cddata = (poly_nors == NULL);
+    if (do_vert_normals) {
+      /* This will just return the pointer if it wasn't a referenced layer. */
+      mesh->mvert = CustomData_duplicate_referenced_layer(&mesh->vdata, CD_MVERT, mesh->totvert);
+    }
     if (do_add_poly_nors_cddata) {
       poly_nors = MEM_malloc_arrayN((size_t)mesh->totpoly, sizeof(*poly_nors), __func__);
     }
@@ -426,13 +430,30 @@ void BKE_mesh_ensure_normals_for_display(Mesh *mesh)
   }
 }
 
+/**
+ * Vertex normals of a vertex layer shared with other meshes are up to date unless tagged dirty,
+ * so there is no need to copy the layer just to write the same values. Only evaluated meshes are
+ * known to tag such changes, tools may write coordinates of original meshes in-place.
+ */
+bool BKE_mesh_vert_normals_shared_are_valid(const Mesh *mesh)
+{
+  return (mesh->id.tag & (LIB_TAG_COPIED_ON_WRITE | LIB_TAG_NO_MAIN)) != 0 &&
+         (mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) == 0 &&
+         CustomData_is_referenced_layer((CustomData *)&mesh->vdata, CD_MVERT);
+}
+
 /* Note that this does not update the CD_NORMAL layer,
  * but does update the normals in the CD_MVERT layer. */
 void BKE_mesh_calc_normals(Mesh *mesh)
 {
+  if (BKE_mesh_vert_normals_shared_are_valid(mesh)) {
+    return;
+  }
 #ifdef DEBUG_TIME
   TIMEIT_START_AVERAGED(BKE_mesh_calc_normals);
 #endif
+  /* This will just return the pointer if it wasn't a referenced layer. */
+  mesh->mvert = CustomData_duplicate_referenced_layer(&mesh->vdata, CD_MVERT, mesh->totvert);
   BKE_mesh_calc_normals_poly(mesh->mvert,
                              NULL,
                              mesh->totvert,
@@ -32,6 +32,7 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
@@ -46,6 +47,10 @@
 #include "BKE_mesh_remesh_voxel.h" /* own include */
 #include "BKE_mesh_runtime.h"
 
+#include "CLG_log.h"
+
+#include "PIL_time.h"
+
 #include "bmesh_tools.h"
 
 #ifdef WITH_OPENVDB
@@ -56,57 +61,224 @@
 #  include "quadriflow_capi.hpp"
 #endif
 
-#ifdef WITH_OPENVDB
-struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
-    Mesh *mesh, struct OpenVDBTransform *transform)
+#if defined(WITH_OPENVDB) || defined(WITH_QUADRIFLOW)
+
+static CLG_LogRef LOG = {"bke.remesh"};
+
+/* -------------------------------------------------------------------- */
+/** \name Remesh Stages
+ *
+ * The remeshers run as a sequence of stages. Before every stage the progress is passed to the
+ * update callback, which can cancel the remesher, and the time spent in every stage is logged.
+ * \{ */
+
+typedef void (*RemeshUpdateFn)(void *data, float progress, int *cancel);
+
+typedef struct RemeshStages {
+  RemeshUpdateFn update_cb;
+  void *update_cb_data;
+  const char *remesher;
+  /* Stage which is running, NULL when no stage is. */
+  const char *stage;
+  float stage_progress;
+  double stage_start;
+} RemeshStages;
+
+static void remesh_stages_init(RemeshStages *stages,
+                               const char *remesher,
+                               void *update_cb,
+                               void *update_cb_data)
+{
+  stages->update_cb = (RemeshUpdateFn)update_cb;
+  stages->update_cb_data = update_cb_data;
+  stages->remesher = remesher;
+  stages->stage = NULL;
+  stages->stage_progress = 0.0f;
+  stages->stage_start = 0.0;
+}
+
+static void remesh_stage_end(RemeshStages *stages)
+{
+  if (stages->stage == NULL) {
+    return;
+  }
+  CLOG_INFO(&LOG,
+            1,
+            "%s: %s took %.3f s",
+            stages->remesher,
+            stages->stage,
+            PIL_check_seconds_timer() - stages->stage_start);
+  stages->stage = NULL;
+}
+
+/* Finish the running stage and start the next one.
+ * Returns false if the remesher has been cancelled. */
+static bool remesh_stage_begin(RemeshStages *stages, const char *stage, float progress)
+{
+  remesh_stage_end(stages);
+
+  if (stages->update_cb != NULL) {
+    int cancel = 0;
+    stages->update_cb(stages->update_cb_data, progress, &cancel);
+    if (cancel) {
+      CLOG_INFO(&LOG, 1, "%s: cancelled before %s", stages->remesher, stage);
+      return false;
+    }
+  }
+
+  stages->stage = stage;
+  stages->stage_progress = progress;
+  stages->stage_start = PIL_check_seconds_timer();
+  return true;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Triangulated Input
+ * \{ */
+
+typedef struct RemeshInputData {
+  const MVert *mvert;
+  const MLoop *mloop;
+  const MLoopTri *looptri;
+  float *verts;
+  unsigned int *faces;
+} RemeshInputData;
+
+static void remesh_input_verts_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshInputData *data = userdata;
+  copy_v3_v3(&data->verts[i * 3], data->mvert[i].co);
+}
+
+static void remesh_input_faces_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshInputData *data = userdata;
+  const MLoopTri *lt = &data->looptri[i];
+  data->faces[i * 3] = data->mloop[lt->tri[0]].v;
+  data->faces[i * 3 + 1] = data->mloop[lt->tri[1]].v;
+  data->faces[i * 3 + 2] = data->mloop[lt->tri[2]].v;
+}
+
+/* Flat arrays of the vertex coordinates and of the vertex indices of the triangles of the mesh,
+ * as the remeshing libraries take them. */
+static void remesh_input_from_mesh(Mesh *mesh,
+                                   float **r_verts,
+                                   unsigned int **r_faces,
+                                   unsigned int *r_totverts,
+                                   unsigned int *r_totfaces)
 {
+  /* Ensure that the triangulated mesh data is up to date. */
   BKE_mesh_runtime_looptri_recalc(mesh);
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(mesh);
-  MVertTri *verttri = MEM_callocN(sizeof(*verttri) * BKE_mesh_runtime_looptri_len(mesh),
-                                  "remesh_looptri");
-  BKE_mesh_runtime_verttri_from_looptri(
-      verttri, mesh->mloop, looptri, BKE_mesh_runtime_looptri_len(mesh));
 
-  unsigned int totfaces = BKE_mesh_runtime_looptri_len(mesh);
-  unsigned int totverts = mesh->totvert;
-  float *verts = (float *)MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts");
-  unsigned int *faces = (unsigned int *)MEM_malloc_arrayN(
-      totfaces * 3, sizeof(unsigned int), "remesh_intput_faces");
+  const unsigned int totfaces = BKE_mesh_runtime_looptri_len(mesh);
+  const unsigned int totverts = mesh->totvert;
 
-  for (unsigned int i = 0; i < totverts; i++) {
-    MVert *mvert = &mesh->mvert[i];
-    verts[i * 3] = mvert->co[0];
-    verts[i * 3 + 1] = mvert->co[1];
-    verts[i * 3 + 2] = mvert->co[2];
-  }
+  RemeshInputData data = {
+      .mvert = mesh->mvert,
+      .mloop = mesh->mloop,
+      .looptri = looptri,
+      .verts = MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts"),
+      .faces = MEM_malloc_arrayN(totfaces * 3, sizeof(unsigned int), "remesh_intput_faces"),
+  };
 
-  for (unsigned int i = 0; i < totfaces; i++) {
-    MVertTri *vt = &verttri[i];
-    faces[i * 3] = vt->tri[0];
-    faces[i * 3 + 1] = vt->tri[1];
-    faces[i * 3 + 2] = vt->tri[2];
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4096;
+  BLI_task_parallel_range(0, totverts, &data, remesh_input_verts_cb, &settings);
+  BLI_task_parallel_range(0, totfaces, &data, remesh_input_faces_cb, &settings);
+
+  *r_verts = data.verts;
+  *r_faces = data.faces;
+  *r_totverts = totverts;
+  *r_totfaces = totfaces;
+}
+
+/** \} */
+
+#endif
+
+#ifdef WITH_OPENVDB
+struct OpenVDBLevelSet *BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(
+    Mesh *mesh, struct OpenVDBTransform *transform)
+{
+  float *verts;
+  unsigned int *faces;
+  unsigned int totverts, totfaces;
+  remesh_input_from_mesh(mesh, &verts, &faces, &totverts, &totfaces);
 
   struct OpenVDBLevelSet *level_set = OpenVDBLevelSet_create(false, NULL);
   OpenVDBLevelSet_mesh_to_level_set(level_set, verts, faces, totverts, totfaces, transform);
 
   MEM_freeN(verts);
   MEM_freeN(faces);
-  MEM_freeN(verttri);
 
   return level_set;
 }
 
+typedef struct RemeshOutputData {
+  const struct OpenVDBVolumeToMeshData *output_mesh;
+  Mesh *mesh;
+} RemeshOutputData;
+
+static void remesh_output_verts_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshOutputData *data = userdata;
+  copy_v3_v3(data->mesh->mvert[i].co, &data->output_mesh->vertices[i * 3]);
+}
+
+static void remesh_output_quads_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshOutputData *data = userdata;
+  const unsigned int *quad = &data->output_mesh->quads[i * 4];
+  MPoly *mp = &data->mesh->mpoly[i];
+  MLoop *ml = &data->mesh->mloop[i * 4];
+
+  mp->loopstart = i * 4;
+  mp->totloop = 4;
+
+  ml[0].v = quad[3];
+  ml[1].v = quad[2];
+  ml[2].v = quad[1];
+  ml[3].v = quad[0];
+}
+
+static void remesh_output_triangles_cb(void *__restrict userdata,
+                                       const int i,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshOutputData *data = userdata;
+  const int totquads = data->output_mesh->totquads;
+  const unsigned int *tri = &data->output_mesh->triangles[i * 3];
+  MPoly *mp = &data->mesh->mpoly[totquads + i];
+  MLoop *ml = &data->mesh->mloop[totquads * 4 + i * 3];
+
+  mp->loopstart = totquads * 4 + i * 3;
+  mp->totloop = 3;
+
+  ml[0].v = tri[2];
+  ml[1].v = tri[1];
+  ml[2].v = tri[0];
+}
+
 Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *level_set,
                                                        double isovalue,
                                                        double adaptivity,
                                                        bool relax_disoriented_triangles)
 {
-#  ifdef WITH_OPENVDB
   struct OpenVDBVolumeToMeshData output_mesh;
   OpenVDBLevelSet_volume_to_mesh(
       level_set, &output_mesh, isovalue, adaptivity, relax_disoriented_triangles);
-#  endif
 
   Mesh *mesh = BKE_mesh_new_nomain(output_mesh.totvertices,
                                    0,
@@ -114,30 +286,18 @@ Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *l
                                    (output_mesh.totquads * 4) + (output_mesh.tottriangles * 3),
                                    output_mesh.totquads + output_mesh.tottriangles);
 
-  for (int i = 0; i < output_mesh.totvertices; i++) {
-    copy_v3_v3(mesh->mvert[i].co, &output_mesh.vertices[i * 3]);
-  }
-
-  MPoly *mp = mesh->mpoly;
-  MLoop *ml = mesh->mloop;
-  for (int i = 0; i < output_mesh.totquads; i++, mp++, ml += 4) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 4;
-
-    ml[0].v = output_mesh.quads[i * 4 + 3];
-    ml[1].v = output_mesh.quads[i * 4 + 2];
-    ml[2].v = output_mesh.quads[i * 4 + 1];
-    ml[3].v = output_mesh.quads[i * 4];
-  }
-
-  for (int i = 0; i < output_mesh.tottriangles; i++, mp++, ml += 3) {
-    mp->loopstart = (int)(ml - mesh->mloop);
-    mp->totloop = 3;
+  RemeshOutputData data = {
+      .output_mesh = &output_mesh,
+      .mesh = mesh,
+  };
 
-    ml[0].v = output_mesh.triangles[i * 3 + 2];
-    ml[1].v = output_mesh.triangles[i * 3 + 1];
-    ml[2].v = output_mesh.triangles[i * 3];
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 4096;
+  BLI_task_parallel_range(0, output_mesh.totvertices, &data, remesh_output_verts_cb, &settings);
+  BLI_task_parallel_range(0, output_mesh.totquads, &data, remesh_output_quads_cb, &settings);
+  BLI_task_parallel_range(
+      0, output_mesh.tottriangles, &data, remesh_output_triangles_cb, &settings);
 
   BKE_mesh_calc_edges(mesh, false, false);
   BKE_mesh_calc_normals(mesh);
@@ -154,6 +314,38 @@ Mesh *BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(struct OpenVDBLevelSet *l
 #endif
 
 #ifdef WITH_QUADRIFLOW
+
+/* Name of the QuadriFlow stage which starts at the given progress, as reported by
+ * QFLOW_quadriflow_remesh(). */
+static const char *quadriflow_stage_name(float progress)
+{
+  if (progress < 0.05f) {
+    return "input";
+  }
+  if (progress < 0.15f) {
+    return "hierarchy";
+  }
+  if (progress < 0.25f) {
+    return "orientation field";
+  }
+  if (progress < 0.35f) {
+    return "slope";
+  }
+  if (progress < 0.45f) {
+    return "position field";
+  }
+  if (progress < 0.85f) {
+    return "index map";
+  }
+  return "output";
+}
+
+static void quadriflow_stage_update(void *customdata, float progress, int *cancel)
+{
+  RemeshStages *stages = customdata;
+  *cancel = !remesh_stage_begin(stages, quadriflow_stage_name(progress), progress);
+}
+
 static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
                                         int target_faces,
                                         int seed,
@@ -163,35 +355,14 @@ static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
                                         void *update_cb,
                                         void *update_cb_data)
 {
-  /* Ensure that the triangulated mesh data is up to data */
-  BKE_mesh_runtime_looptri_recalc(input_mesh);
-  const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(input_mesh);
+  RemeshStages stages;
+  remesh_stages_init(&stages, "QuadriFlow", update_cb, update_cb_data);
 
   /* Gather the required data for export to the internal quadiflow mesh format */
-  MVertTri *verttri = MEM_callocN(sizeof(*verttri) * BKE_mesh_runtime_looptri_len(input_mesh),
-                                  "remesh_looptri");
-  BKE_mesh_runtime_verttri_from_looptri(
-      verttri, input_mesh->mloop, looptri, BKE_mesh_runtime_looptri_len(input_mesh));
-
-  unsigned int totfaces = BKE_mesh_runtime_looptri_len(input_mesh);
-  unsigned int totverts = input_mesh->totvert;
-  float *verts = (float *)MEM_malloc_arrayN(totverts * 3, sizeof(float), "remesh_input_verts");
-  unsigned int *faces = (unsigned int *)MEM_malloc_arrayN(
-      totfaces * 3, sizeof(unsigned int), "remesh_intput_faces");
-
-  for (unsigned int i = 0; i < totverts; i++) {
-    MVert *mvert = &input_mesh->mvert[i];
-    verts[i * 3] = mvert->co[0];
-    verts[i * 3 + 1] = mvert->co[1];
-    verts[i * 3 + 2] = mvert->co[2];
-  }
-
-  for (unsigned int i = 0; i < totfaces; i++) {
-    MVertTri *vt = &verttri[i];
-    faces[i * 3] = vt->tri[0];
-    faces[i * 3 + 1] = vt->tri[1];
-    faces[i * 3 + 2] = vt->tri[2];
-  }
+  float *verts;
+  unsigned int *faces;
+  unsigned int totverts, totfaces;
+  remesh_input_from_mesh(input_mesh, &verts, &faces, &totverts, &totfaces);
 
   /* Fill out the required input data */
   QuadriflowRemeshData qrd;
@@ -212,11 +383,10 @@ static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
   qrd.out_faces = NULL;
 
   /* Run the remesher */
-  QFLOW_quadriflow_remesh(&qrd, update_cb, update_cb_data);
+  QFLOW_quadriflow_remesh(&qrd, quadriflow_stage_update, &stages);
 
   MEM_freeN(verts);
   MEM_freeN(faces);
-  MEM_freeN(verttri);
 
   if (qrd.out_faces == NULL) {
     /* The remeshing was canceled */
@@ -225,6 +395,13 @@ static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
 
   if (qrd.out_totfaces == 0) {
     /* Meshing failed */
+    remesh_stage_end(&stages);
+    MEM_freeN(qrd.out_faces);
+    MEM_freeN(qrd.out_verts);
+    return NULL;
+  }
+
+  if (!remesh_stage_begin(&stages, "build mesh", 0.95f)) {
     MEM_freeN(qrd.out_faces);
     MEM_freeN(qrd.out_verts);
     return NULL;
@@ -256,6 +433,8 @@ static Mesh *BKE_mesh_remesh_quadriflow(Mesh *input_mesh,
   MEM_freeN(qrd.out_faces);
   MEM_freeN(qrd.out_verts);
 
+  remesh_stage_end(&stages);
+
   return mesh;
 }
 #endif
@@ -298,24 +477,95 @@ Mesh *BKE_mesh_remesh_quadriflow_to_mesh_nomain(Mesh *mesh,
 Mesh *BKE_mesh_remesh_voxel_to_mesh_nomain(Mesh *mesh,
                                            float voxel_size,
                                            float adaptivity,
-                                           float isovalue)
+                                           float isovalue,
+                                           void *update_cb,
+                                           void *update_cb_data)
 {
   Mesh *new_mesh = NULL;
 #ifdef WITH_OPENVDB
+  RemeshStages stages;
+  remesh_stages_init(&stages, "Voxel", update_cb, update_cb_data);
+
+  if (!remesh_stage_begin(&stages, "mesh to volume", 0.0f)) {
+    return NULL;
+  }
   struct OpenVDBLevelSet *level_set;
   struct OpenVDBTransform *xform = OpenVDBTransform_create();
   OpenVDBTransform_create_linear_transform(xform, (double)voxel_size);
   level_set = BKE_mesh_remesh_voxel_ovdb_mesh_to_level_set_create(mesh, xform);
-  new_mesh = BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(
-      level_set, (double)isovalue, (double)adaptivity, false);
+
+  if (remesh_stage_begin(&stages, "volume to mesh", 0.5f)) {
+    new_mesh = BKE_mesh_remesh_voxel_ovdb_volume_to_mesh_nomain(
+        level_set, (double)isovalue, (double)adaptivity, false);
+    remesh_stage_end(&stages);
+  }
+
   OpenVDBLevelSet_free(level_set);
   OpenVDBTransform_free(xform);
 #else
-  UNUSED_VARS(mesh, voxel_size, adaptivity, isovalue);
+  UNUSED_VARS(mesh, voxel_size, adaptivity, isovalue, update_cb, update_cb_data);
 #endif
   return new_mesh;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Data Reprojection
+ * \{ */
+
+typedef struct RemeshReprojectData {
+  BVHTreeFromMesh *bvhtree;
+  const MVert *target_verts;
+  const MPoly *target_polys;
+  const MLoop *target_loops;
+  const MLoopTri *source_looptri;
+  void *target_data;
+  const void *source_data;
+} RemeshReprojectData;
+
+static void remesh_reproject_paint_mask_cb(void *__restrict userdata,
+                                           const int i,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+  float *target_mask = data->target_data;
+  const float *source_mask = data->source_data;
+
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  BLI_bvhtree_find_nearest(
+      bvhtree->tree, data->target_verts[i].co, &nearest, bvhtree->nearest_callback, bvhtree);
+  if (nearest.index != -1) {
+    target_mask[i] = source_mask[nearest.index];
+  }
+}
+
+static void remesh_reproject_sculpt_face_sets_cb(void *__restrict userdata,
+                                                 const int i,
+                                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RemeshReprojectData *data = userdata;
+  BVHTreeFromMesh *bvhtree = data->bvhtree;
+  int *target_face_sets = data->target_data;
+  const int *source_face_sets = data->source_data;
+
+  float from_co[3];
+  BVHTreeNearest nearest;
+  nearest.index = -1;
+  nearest.dist_sq = FLT_MAX;
+  const MPoly *mpoly = &data->target_polys[i];
+  BKE_mesh_calc_poly_center(
+      mpoly, &data->target_loops[mpoly->loopstart], data->target_verts, from_co);
+  BLI_bvhtree_find_nearest(bvhtree->tree, from_co, &nearest, bvhtree->nearest_callback, bvhtree);
+  if (nearest.index != -1) {
+    target_face_sets[i] = source_face_sets[data->source_looptri[nearest.index].poly];
+  }
+  else {
+    target_face_sets[i] = 1;
+  }
+}
+
 void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
 {
   BVHTreeFromMesh bvhtree = {
@@ -342,17 +592,18 @@ void BKE_mesh_remesh_reproject_paint_mask(Mesh *target, Mesh *source)
         &source->vdata, CD_PAINT_MASK, CD_CALLOC, NULL, source->totvert);
   }
 
-  for (int i = 0; i < target->totvert; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    copy_v3_v3(from_co, target_verts[i].co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_mask[i] = source_mask[nearest.index];
-    }
-  }
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = target_verts,
+      .target_data = target_mask,
+      .source_data = source_mask,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, target->totvert, &data, remesh_reproject_paint_mask_cb, &settings);
+
   free_bvhtree_from_mesh(&bvhtree);
 }
 
@@ -387,24 +638,27 @@ void BKE_remesh_reproject_sculpt_face_sets(Mesh *target, Mesh *source)
   const MLoopTri *looptri = BKE_mesh_runtime_looptri_ensure(source);
   BKE_bvhtree_from_mesh_get(&bvhtree, source, BVHTREE_FROM_LOOPTRI, 2);
 
-  for (int i = 0; i < target->totpoly; i++) {
-    float from_co[3];
-    BVHTreeNearest nearest;
-    nearest.index = -1;
-    nearest.dist_sq = FLT_MAX;
-    const MPoly *mpoly = &target_polys[i];
-    BKE_mesh_calc_poly_center(mpoly, &target_loops[mpoly->loopstart], target_verts, from_co);
-    BLI_bvhtree_find_nearest(bvhtree.tree, from_co, &nearest, bvhtree.nearest_callback, &bvhtree);
-    if (nearest.index != -1) {
-      target_face_sets[i] = source_face_sets[looptri[nearest.index].poly];
-    }
-    else {
-      target_face_sets[i] = 1;
-    }
-  }
+  RemeshReprojectData data = {
+      .bvhtree = &bvhtree,
+      .target_verts = target_verts,
+      .target_polys = target_polys,
+      .target_loops = target_loops,
+      .source_looptri = looptri,
+      .target_data = target_face_sets,
+      .source_data = source_face_sets,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(
+      0, target->totpoly, &data, remesh_reproject_sculpt_face_sets_cb, &settings);
+
   free_bvhtree_from_mesh(&bvhtree);
 }
 
+/** \} */
+
 struct Mesh *BKE_mesh_remesh_voxel_fix_poles(struct Mesh *mesh)
 {
   const BMAllocTemplate allocsize = BMALLOC_TEMPLATE_FROM_ME(mesh);
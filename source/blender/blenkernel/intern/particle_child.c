@@ -77,6 +77,31 @@ typedef struct ParticlePathModifier {
 
 /* ------------------------------------------------------------------------- */
 
+/* Modifier settings which are the same for every key of a child strand. */
+typedef struct ChildModifierParams {
+  CurveMapping *clumpcurve;
+  CurveMapping *roughcurve;
+  float kink_amp;
+  float kink_freq;
+  float rough1;
+  float rough2;
+  float rough_end;
+  bool smooth_start;
+  bool use_clump_noise;
+  /* Offset of the clump noise center, valid when use_clump_noise is set. */
+  float clump_noise_offset[3];
+  /* Random vector of the child used by rough2 and rough_end. */
+  float rough_vec[3];
+} ChildModifierParams;
+
+static void child_modifier_params_init(const ParticleChildModifierContext *modifier_ctx,
+                                       ChildModifierParams *params);
+static void do_child_modifiers_ex(const ParticleChildModifierContext *modifier_ctx,
+                                  const ChildModifierParams *params,
+                                  float mat[4][4],
+                                  ParticleKey *state,
+                                  float t);
+
 static void do_kink_spiral_deform(ParticleKey *state,
                                   const float dir[3],
                                   const float kink[3],
@@ -219,8 +244,12 @@ static void do_kink_spiral(ParticleThreadContext *ctx,
   modifier_ctx.ptex = ptex;
   modifier_ctx.cpa = cpa;
   modifier_ctx.orco = orco;
+  modifier_ctx.par_orco = parent_orco;
   modifier_ctx.parent_keys = parent_keys;
 
+  ChildModifierParams modifier_params;
+  child_modifier_params_init(&modifier_ctx, &modifier_params);
+
   for (k = 0, key = keys; k < end_index; k++, key++) {
     float par_time;
     float *par_co, *par_vel, *par_rot;
@@ -272,10 +301,10 @@ static void do_kink_spiral(ParticleThreadContext *ctx,
     modifier_ctx.par_co = par_co;
     modifier_ctx.par_vel = par_vel;
     modifier_ctx.par_rot = par_rot;
-    modifier_ctx.par_orco = parent_orco;
 
     /* Apply different deformations to the child path/ */
-    do_child_modifiers(&modifier_ctx, hairmat, (ParticleKey *)key, par_time);
+    do_child_modifiers_ex(
+        &modifier_ctx, &modifier_params, hairmat, (ParticleKey *)key, par_time);
   }
 
   totlen = 0.0f;
@@ -349,8 +378,12 @@ void psys_apply_child_modifiers(ParticleThreadContext *ctx,
     modifier_ctx.ptex = ptex;
     modifier_ctx.cpa = cpa;
     modifier_ctx.orco = orco;
+    modifier_ctx.par_orco = parent_orco;
     modifier_ctx.parent_keys = parent_keys;
 
+    ChildModifierParams modifier_params;
+    child_modifier_params_init(&modifier_ctx, &modifier_params);
+
     totkeys = ctx->segments + 1;
     max_length = ptex->length;
 
@@ -364,10 +397,10 @@ void psys_apply_child_modifiers(ParticleThreadContext *ctx,
       modifier_ctx.par_co = par->co;
       modifier_ctx.par_vel = par->vel;
       modifier_ctx.par_rot = iter.parent_rotation;
-      modifier_ctx.par_orco = parent_orco;
 
       /* Apply different deformations to the child path. */
-      do_child_modifiers(&modifier_ctx, hairmat, (ParticleKey *)key, iter.time);
+      do_child_modifiers_ex(
+          &modifier_ctx, &modifier_params, hairmat, (ParticleKey *)key, iter.time);
     }
   }
 
@@ -625,6 +658,45 @@ static float do_clump_level(float result[3],
   return clump;
 }
 
+/* Offset of the clump noise center from the parent path, it only depends on the child
+ * so it is the same for every key of the strand. */
+static void do_clump_noise_offset(const float orco_offset[3],
+                                  float clump_noise_size,
+                                  float r_offset[3])
+{
+  float noisevec[3];
+  float da[4], pa[12];
+
+  mul_v3_v3fl(noisevec, orco_offset, 1.0f / clump_noise_size);
+  voronoi(noisevec[0], noisevec[1], noisevec[2], da, pa, 1.0f, 0);
+  mul_v3_v3fl(r_offset, &pa[0], clump_noise_size);
+}
+
+static float do_clump_ex(ParticleKey *state,
+                         const float par_co[3],
+                         float time,
+                         const float noise_offset[3],
+                         float clumpfac,
+                         float clumppow,
+                         float pa_clump,
+                         CurveMapping *clumpcurve)
+{
+  float clump;
+
+  if (noise_offset) {
+    float center[3];
+
+    add_v3_v3v3(center, par_co, noise_offset);
+
+    do_clump_level(state->co, state->co, center, time, clumpfac, clumppow, pa_clump, clumpcurve);
+  }
+
+  clump = do_clump_level(
+      state->co, state->co, par_co, time, clumpfac, clumppow, pa_clump, clumpcurve);
+
+  return clump;
+}
+
 float do_clump(ParticleKey *state,
                const float par_co[3],
                float time,
@@ -636,24 +708,16 @@ float do_clump(ParticleKey *state,
                float clump_noise_size,
                CurveMapping *clumpcurve)
 {
-  float clump;
-
   if (use_clump_noise && clump_noise_size != 0.0f) {
-    float center[3], noisevec[3];
-    float da[4], pa[12];
+    float noise_offset[3];
 
-    mul_v3_v3fl(noisevec, orco_offset, 1.0f / clump_noise_size);
-    voronoi(noisevec[0], noisevec[1], noisevec[2], da, pa, 1.0f, 0);
-    mul_v3_fl(&pa[0], clump_noise_size);
-    add_v3_v3v3(center, par_co, &pa[0]);
+    do_clump_noise_offset(orco_offset, clump_noise_size, noise_offset);
 
-    do_clump_level(state->co, state->co, center, time, clumpfac, clumppow, pa_clump, clumpcurve);
+    return do_clump_ex(
+        state, par_co, time, noise_offset, clumpfac, clumppow, pa_clump, clumpcurve);
   }
 
-  clump = do_clump_level(
-      state->co, state->co, par_co, time, clumpfac, clumppow, pa_clump, clumpcurve);
-
-  return clump;
+  return do_clump_ex(state, par_co, time, NULL, clumpfac, clumppow, pa_clump, clumpcurve);
 }
 
 static void do_rough(const float loc[3],
@@ -817,43 +881,68 @@ static void do_twist(const ParticleChildModifierContext *modifier_ctx,
   add_v3_v3(state->co, modifier_ctx->par_co);
 }
 
-void do_child_modifiers(const ParticleChildModifierContext *modifier_ctx,
-                        float mat[4][4],
-                        ParticleKey *state,
-                        float t)
+/* Evaluate the per-child part of the modifiers once, so applying them to the keys of the
+ * strand only does the per-key work.
+ * Needs orco and par_orco of the modifier context to be set. */
+static void child_modifier_params_init(const ParticleChildModifierContext *modifier_ctx,
+                                       ChildModifierParams *params)
 {
   ParticleThreadContext *ctx = modifier_ctx->thread_ctx;
   ParticleSimulationData *sim = modifier_ctx->sim;
   ParticleTexture *ptex = modifier_ctx->ptex;
   ChildParticle *cpa = modifier_ctx->cpa;
   ParticleSettings *part = sim->psys->part;
-  CurveMapping *clumpcurve = NULL, *roughcurve = NULL;
   int i = cpa - sim->psys->child;
-  int guided = 0;
 
+  params->clumpcurve = NULL;
+  params->roughcurve = NULL;
   if (part->child_flag & PART_CHILD_USE_CLUMP_CURVE) {
-    clumpcurve = (ctx != NULL) ? ctx->clumpcurve : part->clumpcurve;
+    params->clumpcurve = (ctx != NULL) ? ctx->clumpcurve : part->clumpcurve;
   }
   if (part->child_flag & PART_CHILD_USE_ROUGH_CURVE) {
-    roughcurve = (ctx != NULL) ? ctx->roughcurve : part->roughcurve;
+    params->roughcurve = (ctx != NULL) ? ctx->roughcurve : part->roughcurve;
   }
 
-  float kink_amp = part->kink_amp;
-  float kink_amp_clump = part->kink_amp_clump;
-  float kink_freq = part->kink_freq;
-  float rough1 = part->rough1;
-  float rough2 = part->rough2;
-  float rough_end = part->rough_end;
-  const bool smooth_start = (sim->psys->part->childtype == PART_CHILD_FACES);
+  params->kink_amp = part->kink_amp;
+  params->kink_freq = part->kink_freq;
+  params->rough1 = part->rough1;
+  params->rough2 = part->rough2;
+  params->rough_end = part->rough_end;
+  params->smooth_start = (sim->psys->part->childtype == PART_CHILD_FACES);
 
   if (ptex) {
-    kink_amp *= ptex->kink_amp;
-    kink_freq *= ptex->kink_freq;
-    rough1 *= ptex->rough1;
-    rough2 *= ptex->rough2;
-    rough_end *= ptex->roughe;
+    params->kink_amp *= ptex->kink_amp;
+    params->kink_freq *= ptex->kink_freq;
+    params->rough1 *= ptex->rough1;
+    params->rough2 *= ptex->rough2;
+    params->rough_end *= ptex->roughe;
   }
 
+  params->use_clump_noise = (part->child_flag & PART_CHILD_USE_CLUMP_NOISE) &&
+                            part->clump_noise_size != 0.0f;
+  if (params->use_clump_noise) {
+    float orco_offset[3];
+    sub_v3_v3v3(orco_offset, modifier_ctx->orco, modifier_ctx->par_orco);
+    do_clump_noise_offset(orco_offset, part->clump_noise_size, params->clump_noise_offset);
+  }
+
+  if (params->roughcurve == NULL && (params->rough2 > 0.f || params->rough_end > 0.f)) {
+    psys_frand_vec(sim->psys, i + 27, params->rough_vec);
+  }
+}
+
+static void do_child_modifiers_ex(const ParticleChildModifierContext *modifier_ctx,
+                                  const ChildModifierParams *params,
+                                  float mat[4][4],
+                                  ParticleKey *state,
+                                  float t)
+{
+  ParticleSimulationData *sim = modifier_ctx->sim;
+  ParticleTexture *ptex = modifier_ctx->ptex;
+  ChildParticle *cpa = modifier_ctx->cpa;
+  ParticleSettings *part = sim->psys->part;
+  int guided = 0;
+
   do_twist(modifier_ctx, state, t);
 
   if (part->flag & PART_CHILD_EFFECT) {
@@ -867,58 +956,66 @@ void do_child_modifiers(const ParticleChildModifierContext *modifier_ctx,
   }
 
   if (guided == 0) {
-    float orco_offset[3];
-    float clump;
-
-    sub_v3_v3v3(orco_offset, modifier_ctx->orco, modifier_ctx->par_orco);
-    clump = do_clump(state,
-                     modifier_ctx->par_co,
-                     t,
-                     orco_offset,
-                     part->clumpfac,
-                     part->clumppow,
-                     ptex ? ptex->clump : 1.0f,
-                     part->child_flag & PART_CHILD_USE_CLUMP_NOISE,
-                     part->clump_noise_size,
-                     clumpcurve);
-
-    if (kink_freq != 0.f) {
-      kink_amp *= (1.f - kink_amp_clump * clump);
+    float clump = do_clump_ex(state,
+                              modifier_ctx->par_co,
+                              t,
+                              params->use_clump_noise ? params->clump_noise_offset : NULL,
+                              part->clumpfac,
+                              part->clumppow,
+                              ptex ? ptex->clump : 1.0f,
+                              params->clumpcurve);
+
+    if (params->kink_freq != 0.f) {
+      float kink_amp = params->kink_amp * (1.f - part->kink_amp_clump * clump);
 
       do_kink(state,
               modifier_ctx->par_co,
               modifier_ctx->par_vel,
               modifier_ctx->par_rot,
               t,
-              kink_freq,
+              params->kink_freq,
               part->kink_shape,
               kink_amp,
               part->kink_flat,
               part->kink,
               part->kink_axis,
               sim->ob->obmat,
-              smooth_start);
+              params->smooth_start);
     }
   }
 
-  if (roughcurve) {
-    do_rough_curve(modifier_ctx->orco, mat, t, rough1, part->rough1_size, roughcurve, state);
+  if (params->roughcurve) {
+    do_rough_curve(
+        modifier_ctx->orco, mat, t, params->rough1, part->rough1_size, params->roughcurve, state);
   }
   else {
-    if (rough1 > 0.f) {
-      do_rough(modifier_ctx->orco, mat, t, rough1, part->rough1_size, 0.0, state);
+    if (params->rough1 > 0.f) {
+      do_rough(modifier_ctx->orco, mat, t, params->rough1, part->rough1_size, 0.0, state);
     }
 
-    if (rough2 > 0.f) {
-      float vec[3];
-      psys_frand_vec(sim->psys, i + 27, vec);
-      do_rough(vec, mat, t, rough2, part->rough2_size, part->rough2_thres, state);
+    if (params->rough2 > 0.f) {
+      do_rough(params->rough_vec,
+               mat,
+               t,
+               params->rough2,
+               part->rough2_size,
+               part->rough2_thres,
+               state);
     }
 
-    if (rough_end > 0.f) {
-      float vec[3];
-      psys_frand_vec(sim->psys, i + 27, vec);
-      do_rough_end(vec, mat, t, rough_end, part->rough_end_shape, state);
+    if (params->rough_end > 0.f) {
+      do_rough_end(params->rough_vec, mat, t, params->rough_end, part->rough_end_shape, state);
     }
   }
 }
+
+void do_child_modifiers(const ParticleChildModifierContext *modifier_ctx,
+                        float mat[4][4],
+                        ParticleKey *state,
+                        float t)
+{
+  ChildModifierParams params;
+
+  child_modifier_params_init(modifier_ctx, &params);
+  do_child_modifiers_ex(modifier_ctx, &params, mat, state, t);
+}
@@ -25,6 +25,8 @@
 #include "BLI_heap_simple.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_DerivedMesh.h"
@@ -59,6 +61,13 @@
 #  endif
 #endif
 
+/**
+ * Update the topology of PBVH nodes in parallel. Edges that can be split or collapsed without
+ * touching elements used by other nodes are updated by one thread per node, edges along node
+ * boundaries are updated serially afterwards.
+ */
+#define USE_EDGEQUEUE_THREADED
+
 // #define USE_VERIFY
 
 #ifdef USE_VERIFY
@@ -752,8 +761,29 @@ typedef struct {
   int cd_vert_mask_offset;
   int cd_vert_node_offset;
   int cd_face_node_offset;
+
+  /* Node being updated in parallel with other nodes, DYNTOPO_NODE_NONE when updating serially.
+   * Edges not local to the node are added to 'deferred' instead of the queue. */
+  int node_index;
+  HeapSimple *deferred;
+  /* Guards creating and removing BMesh elements, which is not thread-safe. */
+  ThreadMutex *bm_lock;
 } EdgeQueueContext;
 
+BLI_INLINE void edge_queue_bm_lock(EdgeQueueContext *eq_ctx)
+{
+  if (eq_ctx->bm_lock) {
+    BLI_mutex_lock(eq_ctx->bm_lock);
+  }
+}
+
+BLI_INLINE void edge_queue_bm_unlock(EdgeQueueContext *eq_ctx)
+{
+  if (eq_ctx->bm_lock) {
+    BLI_mutex_unlock(eq_ctx->bm_lock);
+  }
+}
+
 /* only tag'd edges are in the queue */
 #ifdef USE_EDGEQUEUE_TAG
 #  define EDGE_QUEUE_TEST(e) (BM_elem_flag_test((CHECK_TYPE_INLINE(e, BMEdge *), e), BM_ELEM_TAG))
@@ -832,6 +862,132 @@ static bool check_mask(EdgeQueueContext *eq_ctx, BMVert *v)
   return BM_ELEM_CD_GET_FLOAT(v, eq_ctx->cd_vert_mask_offset) < 1.0f;
 }
 
+#ifdef USE_EDGEQUEUE_THREADED
+BLI_INLINE bool edge_queue_face_is_node_local(EdgeQueueContext *eq_ctx, BMFace *f)
+{
+  return BM_ELEM_CD_GET_INT(f, eq_ctx->cd_face_node_offset) == eq_ctx->node_index;
+}
+
+/* Return true if all faces using the edge are in the node. */
+static bool edge_queue_edge_is_node_local(EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  BMLoop *l_iter, *l_first;
+
+  if ((l_first = e->l) == NULL) {
+    return false;
+  }
+
+  l_iter = l_first;
+  do {
+    if (!edge_queue_face_is_node_local(eq_ctx, l_iter->f)) {
+      return false;
+    }
+  } while ((l_iter = l_iter->radial_next) != l_first);
+
+  return true;
+}
+
+/* Return true if the vertex is owned by the node and all faces using it are in the node,
+ * meaning no other node can modify it or the elements around it. */
+static bool edge_queue_vert_is_node_local(EdgeQueueContext *eq_ctx, BMVert *v)
+{
+  BMFace *f;
+
+  if (BM_ELEM_CD_GET_INT(v, eq_ctx->cd_vert_node_offset) != eq_ctx->node_index) {
+    return false;
+  }
+
+  BM_FACES_OF_VERT_ITER_BEGIN (f, v) {
+    if (!edge_queue_face_is_node_local(eq_ctx, f)) {
+      return false;
+    }
+  }
+  BM_FACES_OF_VERT_ITER_END;
+
+  return true;
+}
+
+BLI_INLINE bool edge_queue_tri_verts_are_node_local(EdgeQueueContext *eq_ctx, BMLoop *l)
+{
+  return (edge_queue_vert_is_node_local(eq_ctx, l->v) &&
+          edge_queue_vert_is_node_local(eq_ctx, l->next->v) &&
+          edge_queue_vert_is_node_local(eq_ctx, l->prev->v));
+}
+
+/**
+ * Return true if splitting the edge only modifies elements of the node:
+ * all vertices of the faces using the edge must be local to the node.
+ *
+ * \param check_longer: Also require that no other edge of these faces needs splitting and is
+ * longer. These are split first when updating serially, queued longer edges of the node are
+ * popped first too, so this only happens for long edges that were deferred. Splitting the
+ * shorter edges around them would keep creating skinny faces that need subdivision.
+ */
+static bool edge_queue_edge_split_is_node_local(EdgeQueueContext *eq_ctx,
+                                                BMEdge *e,
+                                                const bool check_longer)
+{
+  if (!edge_queue_edge_is_node_local(eq_ctx, e)) {
+    return false;
+  }
+
+  const float len_sq = check_longer ? BM_edge_calc_length_squared(e) : 0.0f;
+  BMLoop *l_iter = e->l;
+  do {
+    if (!edge_queue_tri_verts_are_node_local(eq_ctx, l_iter)) {
+      return false;
+    }
+
+    if (check_longer) {
+      BMEdge *e_other[2] = {l_iter->next->e, l_iter->prev->e};
+      for (int i = 0; i < ARRAY_SIZE(e_other); i++) {
+        const float len_sq_other = BM_edge_calc_length_squared(e_other[i]);
+        if ((len_sq_other > len_sq) && (len_sq_other > eq_ctx->q->limit_len_squared)) {
+          return false;
+        }
+      }
+    }
+  } while ((l_iter = l_iter->radial_next) != e->l);
+
+  return true;
+}
+
+/**
+ * Return true if collapsing the edge only modifies elements of the node:
+ * all vertices of the faces using either vertex of the edge must be local to the node.
+ */
+static bool edge_queue_edge_collapse_is_node_local(EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  BMLoop *l;
+
+  /* Ensures both vertices use faces of this node, so reading their faces is safe. */
+  if (!edge_queue_edge_is_node_local(eq_ctx, e)) {
+    return false;
+  }
+
+  BMVert *v_pair[2] = {e->v1, e->v2};
+  for (int i = 0; i < 2; i++) {
+    BM_LOOPS_OF_VERT_ITER_BEGIN (l, v_pair[i]) {
+      if (!edge_queue_tri_verts_are_node_local(eq_ctx, l)) {
+        return false;
+      }
+    }
+    BM_LOOPS_OF_VERT_ITER_END;
+  }
+
+  return true;
+}
+
+/* Add the edge to be updated serially after all nodes have been updated in parallel. */
+static void edge_queue_defer(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
+{
+  BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
+  pair[0] = e->v1;
+  pair[1] = e->v2;
+  BLI_heapsimple_insert(eq_ctx->deferred, priority, pair);
+}
+#endif /* USE_EDGEQUEUE_THREADED */
+
 static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
 {
   /* Don't let topology update affect fully masked vertices. This used to
@@ -844,6 +1000,13 @@ static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priorit
        (check_mask(eq_ctx, e->v1) || check_mask(eq_ctx, e->v2))) &&
       !(BM_elem_flag_test_bool(e->v1, BM_ELEM_HIDDEN) ||
         BM_elem_flag_test_bool(e->v2, BM_ELEM_HIDDEN))) {
+#ifdef USE_EDGEQUEUE_THREADED
+    /* The tags of edges used by other nodes may be accessed from their threads. */
+    if ((eq_ctx->node_index != DYNTOPO_NODE_NONE) && !edge_queue_edge_is_node_local(eq_ctx, e)) {
+      edge_queue_defer(eq_ctx, e, priority);
+      return;
+    }
+#endif
     BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
     pair[0] = e->v1;
     pair[1] = e->v2;
@@ -909,6 +1072,13 @@ static void long_edge_queue_edge_add_recursive(
 
     BMLoop *l_iter = l_edge;
     do {
+#  ifdef USE_EDGEQUEUE_THREADED
+      /* Don't walk into faces of other nodes, their threads may be modifying them. */
+      if ((eq_ctx->node_index != DYNTOPO_NODE_NONE) &&
+          !edge_queue_face_is_node_local(eq_ctx, l_iter->f)) {
+        continue;
+      }
+#  endif
       BMLoop *l_adjacent[2] = {l_iter->next, l_iter->prev};
       for (int i = 0; i < ARRAY_SIZE(l_adjacent); i++) {
         float len_sq_other = BM_edge_calc_length_squared(l_adjacent[i]->e);
@@ -1129,8 +1299,10 @@ static void pbvh_bmesh_split_edge(EdgeQueueContext *eq_ctx,
   normalize_v3(no_mid);
 
   int node_index = BM_ELEM_CD_GET_INT(e->v1, eq_ctx->cd_vert_node_offset);
+  edge_queue_bm_lock(eq_ctx);
   BMVert *v_new = pbvh_bmesh_vert_create(
       bvh, node_index, co_mid, no_mid, eq_ctx->cd_vert_mask_offset);
+  edge_queue_bm_unlock(eq_ctx);
 
   /* update paint mask */
   if (eq_ctx->cd_vert_mask_offset != -1) {
@@ -1196,22 +1368,28 @@ static void pbvh_bmesh_split_edge(EdgeQueueContext *eq_ctx,
     v_tri[0] = v1;
     v_tri[1] = v_new;
     v_tri[2] = v_opp;
+    edge_queue_bm_lock(eq_ctx);
     bm_edges_from_tri(bvh->bm, v_tri, e_tri);
     f_new = pbvh_bmesh_face_create(bvh, ni, v_tri, e_tri, f_adj);
+    edge_queue_bm_unlock(eq_ctx);
     long_edge_queue_face_add(eq_ctx, f_new);
 
     v_tri[0] = v_new;
     v_tri[1] = v2;
     /* v_tri[2] = v_opp; */ /* unchanged */
+    edge_queue_bm_lock(eq_ctx);
     e_tri[0] = BM_edge_create(bvh->bm, v_tri[0], v_tri[1], NULL, BM_CREATE_NO_DOUBLE);
     e_tri[2] = e_tri[1]; /* switched */
     e_tri[1] = BM_edge_create(bvh->bm, v_tri[1], v_tri[2], NULL, BM_CREATE_NO_DOUBLE);
     f_new = pbvh_bmesh_face_create(bvh, ni, v_tri, e_tri, f_adj);
+    edge_queue_bm_unlock(eq_ctx);
     long_edge_queue_face_add(eq_ctx, f_new);
 
     /* Delete original */
+    edge_queue_bm_lock(eq_ctx);
     pbvh_bmesh_face_remove(bvh, f_adj);
     BM_face_kill(bvh->bm, f_adj);
+    edge_queue_bm_unlock(eq_ctx);
 
     /* Ensure new vertex is in the node */
     if (!BLI_gset_haskey(bvh->nodes[ni].bm_unique_verts, v_new)) {
@@ -1228,7 +1406,9 @@ static void pbvh_bmesh_split_edge(EdgeQueueContext *eq_ctx,
     }
   }
 
+  edge_queue_bm_lock(eq_ctx);
   BM_edge_kill(bvh->bm, e);
+  edge_queue_bm_unlock(eq_ctx);
 }
 
 static bool pbvh_bmesh_subdivide_long_edges(EdgeQueueContext *eq_ctx,
@@ -1272,13 +1452,24 @@ static bool pbvh_bmesh_subdivide_long_edges(EdgeQueueContext *eq_ctx,
       continue;
     }
 
+#ifdef USE_EDGEQUEUE_THREADED
+    if ((eq_ctx->node_index != DYNTOPO_NODE_NONE) &&
+        !edge_queue_edge_split_is_node_local(eq_ctx, e, true)) {
+      edge_queue_defer(eq_ctx, e, -len_squared_v3v3(v1->co, v2->co));
+      continue;
+    }
+#endif
+
     any_subdivided = true;
 
     pbvh_bmesh_split_edge(eq_ctx, bvh, e, edge_loops);
   }
 
 #ifdef USE_EDGEQUEUE_TAG_VERIFY
-  pbvh_bmesh_edge_tag_verify(bvh);
+  /* Edges left for the serial update are still tagged. */
+  if (eq_ctx->node_index == DYNTOPO_NODE_NONE) {
+    pbvh_bmesh_edge_tag_verify(bvh);
+  }
 #endif
 
   return any_subdivided;
@@ -1309,6 +1500,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
   pbvh_bmesh_vert_remove(bvh, v_del);
 
   /* Remove all faces adjacent to the edge */
+  edge_queue_bm_lock(eq_ctx);
   BMLoop *l_adj;
   while ((l_adj = e->l)) {
     BMFace *f_adj = l_adj->f;
@@ -1320,6 +1512,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
   /* Kill the edge */
   BLI_assert(BM_edge_is_wire(e));
   BM_edge_kill(bvh->bm, e);
+  edge_queue_bm_unlock(eq_ctx);
 
   /* For all remaining faces of v_del, create a new face that is the
    * same except it uses v_conn instead of v_del */
@@ -1366,8 +1559,10 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
       BMEdge *e_tri[3];
       PBVHNode *n = pbvh_bmesh_node_from_face(bvh, f);
       int ni = n - bvh->nodes;
+      edge_queue_bm_lock(eq_ctx);
       bm_edges_from_tri(bvh->bm, v_tri, e_tri);
       pbvh_bmesh_face_create(bvh, ni, v_tri, e_tri, f);
+      edge_queue_bm_unlock(eq_ctx);
 
       /* Ensure that v_conn is in the new face's node */
       if (!BLI_gset_haskey(n->bm_unique_verts, v_conn)) {
@@ -1398,6 +1593,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
     e_tri[2] = l_iter->e;
 
     /* Remove the face */
+    edge_queue_bm_lock(eq_ctx);
     pbvh_bmesh_face_remove(bvh, f_del);
     BM_face_kill(bvh->bm, f_del);
 
@@ -1408,6 +1604,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
         BM_edge_kill(bvh->bm, e_tri[j]);
       }
     }
+    edge_queue_bm_unlock(eq_ctx);
 
     /* Check if any of the face's vertices are now unused, if so
      * remove them from the PBVH */
@@ -1421,7 +1618,9 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
           v_conn = NULL;
         }
         BLI_ghash_insert(deleted_verts, v_tri[j], NULL);
+        edge_queue_bm_lock(eq_ctx);
         BM_vert_kill(bvh->bm, v_tri[j]);
+        edge_queue_bm_unlock(eq_ctx);
       }
     }
   }
@@ -1448,17 +1647,22 @@ static void pbvh_bmesh_collapse_edge(PBVH *bvh,
   BM_log_vert_removed(bvh->bm_log, v_del, eq_ctx->cd_vert_mask_offset);
   /* v_conn == NULL is OK */
   BLI_ghash_insert(deleted_verts, v_del, v_conn);
+  edge_queue_bm_lock(eq_ctx);
   BM_vert_kill(bvh->bm, v_del);
+  edge_queue_bm_unlock(eq_ctx);
 }
 
+/**
+ * \param deleted_verts: Deleted verts point to vertices they were merged into,
+ * or NULL when removed.
+ */
 static bool pbvh_bmesh_collapse_short_edges(EdgeQueueContext *eq_ctx,
                                             PBVH *bvh,
+                                            GHash *deleted_verts,
                                             BLI_Buffer *deleted_faces)
 {
   const float min_len_squared = bvh->bm_min_edge_len * bvh->bm_min_edge_len;
   bool any_collapsed = false;
-  /* deleted verts point to vertices they were merged into, or NULL when removed. */
-  GHash *deleted_verts = BLI_ghash_ptr_new("deleted_verts");
 
   while (!BLI_heapsimple_is_empty(eq_ctx->q->heap)) {
     BMVert **pair = BLI_heapsimple_pop_min(eq_ctx->q->heap);
@@ -1494,16 +1698,210 @@ static bool pbvh_bmesh_collapse_short_edges(EdgeQueueContext *eq_ctx,
       continue;
     }
 
+#ifdef USE_EDGEQUEUE_THREADED
+    if ((eq_ctx->node_index != DYNTOPO_NODE_NONE) &&
+        !edge_queue_edge_collapse_is_node_local(eq_ctx, e)) {
+      edge_queue_defer(eq_ctx, e, len_squared_v3v3(v1->co, v2->co));
+      continue;
+    }
+#endif
+
     any_collapsed = true;
 
     pbvh_bmesh_collapse_edge(bvh, e, v1, v2, deleted_verts, deleted_faces, eq_ctx);
   }
 
-  BLI_ghash_free(deleted_verts, NULL, NULL);
-
   return any_collapsed;
 }
 
+#ifdef USE_EDGEQUEUE_THREADED
+
+/* Edges of a single node, updated in parallel with other nodes. */
+typedef struct EdgeQueueNode {
+  EdgeQueue q;
+  EdgeQueueContext eq_ctx;
+  /* Only for collapsing, vertices deleted by this node. */
+  GHash *deleted_verts;
+  bool modified;
+} EdgeQueueNode;
+
+typedef struct EdgeQueueThreadData {
+  PBVH *bvh;
+  PBVHTopologyUpdateMode mode;
+  EdgeQueueNode **queue_nodes;
+} EdgeQueueThreadData;
+
+static void pbvh_bmesh_update_topology_node_task_cb(void *__restrict userdata,
+                                                    const int n,
+                                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  EdgeQueueThreadData *data = userdata;
+  EdgeQueueNode *queue_node = data->queue_nodes[n];
+
+  if (data->mode == PBVH_Subdivide) {
+    BLI_buffer_declare_static(BMLoop *, edge_loops, BLI_BUFFER_NOP, 2);
+    queue_node->modified = pbvh_bmesh_subdivide_long_edges(
+        &queue_node->eq_ctx, data->bvh, &edge_loops);
+    BLI_buffer_free(&edge_loops);
+  }
+  else {
+    BLI_buffer_declare_static(BMFace *, deleted_faces, BLI_BUFFER_NOP, 32);
+    queue_node->modified = pbvh_bmesh_collapse_short_edges(
+        &queue_node->eq_ctx, data->bvh, queue_node->deleted_verts, &deleted_faces);
+    BLI_buffer_free(&deleted_faces);
+  }
+}
+
+static EdgeQueueNode *edge_queue_node_create(EdgeQueueContext *eq_ctx,
+                                             const int node_index,
+                                             const PBVHTopologyUpdateMode mode,
+                                             ThreadMutex *bm_lock)
+{
+  EdgeQueueNode *queue_node = MEM_callocN(sizeof(*queue_node), __func__);
+
+  queue_node->q = *eq_ctx->q;
+  queue_node->q.heap = BLI_heapsimple_new();
+
+  queue_node->eq_ctx = *eq_ctx;
+  queue_node->eq_ctx.q = &queue_node->q;
+  queue_node->eq_ctx.pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
+  queue_node->eq_ctx.node_index = node_index;
+  queue_node->eq_ctx.deferred = BLI_heapsimple_new();
+  queue_node->eq_ctx.bm_lock = bm_lock;
+
+  if (mode == PBVH_Collapse) {
+    queue_node->deleted_verts = BLI_ghash_ptr_new(__func__);
+  }
+
+  return queue_node;
+}
+
+/* Move all entries of 'heap_src' to 'heap_dst', reallocating the vertex pairs. */
+static void edge_queue_heap_move(HeapSimple *heap_dst,
+                                 BLI_mempool *pool_dst,
+                                 HeapSimple *heap_src,
+                                 BLI_mempool *pool_src)
+{
+  while (!BLI_heapsimple_is_empty(heap_src)) {
+    const float priority = BLI_heapsimple_top_value(heap_src);
+    BMVert **pair_src = BLI_heapsimple_pop_min(heap_src);
+    BMVert **pair_dst = BLI_mempool_alloc(pool_dst);
+    pair_dst[0] = pair_src[0];
+    pair_dst[1] = pair_src[1];
+    BLI_mempool_free(pool_src, pair_src);
+    BLI_heapsimple_insert(heap_dst, priority, pair_dst);
+  }
+}
+
+/**
+ * Split or collapse the queued edges that are local to a single node, with one thread per node.
+ *
+ * An edge is local when all faces using the vertices it modifies are in the same node,
+ * updating it then only modifies elements no other node uses, and the only shared state
+ * left is BMesh element allocation (guarded by a lock) and the #BMLog (which is thread-safe).
+ * Edges along node boundaries, as well as the ones the threads could not update locally,
+ * are left in the queue of \a eq_ctx to be updated serially afterwards.
+ *
+ * \param deleted_verts: Only for collapsing, receives vertices deleted by the threads.
+ */
+static bool pbvh_bmesh_update_topology_threaded(EdgeQueueContext *eq_ctx,
+                                                PBVH *bvh,
+                                                const PBVHTopologyUpdateMode mode,
+                                                GHash *deleted_verts)
+{
+  EdgeQueueNode **node_queues = MEM_callocN(sizeof(*node_queues) * bvh->totnode, __func__);
+  EdgeQueueNode **queue_nodes = MEM_mallocN(sizeof(*queue_nodes) * bvh->totnode, __func__);
+  HeapSimple *heap_boundary = BLI_heapsimple_new();
+  int totqueue = 0;
+  bool modified = false;
+
+  ThreadMutex bm_lock;
+  BLI_mutex_init(&bm_lock);
+
+  /* Distribute the edges over the nodes, keeping their priority. */
+  while (!BLI_heapsimple_is_empty(eq_ctx->q->heap)) {
+    const float priority = BLI_heapsimple_top_value(eq_ctx->q->heap);
+    BMVert **pair = BLI_heapsimple_pop_min(eq_ctx->q->heap);
+    BMEdge *e = BM_edge_exists(pair[0], pair[1]);
+    bool is_local = false;
+
+    if (e && e->l) {
+      eq_ctx->node_index = BM_ELEM_CD_GET_INT(e->l->f, eq_ctx->cd_face_node_offset);
+      is_local = (mode == PBVH_Subdivide) ?
+                     edge_queue_edge_split_is_node_local(eq_ctx, e, false) :
+                     edge_queue_edge_collapse_is_node_local(eq_ctx, e);
+    }
+
+    if (!is_local) {
+      BLI_heapsimple_insert(heap_boundary, priority, pair);
+      continue;
+    }
+
+    EdgeQueueNode *queue_node = node_queues[eq_ctx->node_index];
+    if (queue_node == NULL) {
+      queue_node = edge_queue_node_create(eq_ctx, eq_ctx->node_index, mode, &bm_lock);
+      node_queues[eq_ctx->node_index] = queue_node;
+      queue_nodes[totqueue++] = queue_node;
+    }
+
+    BMVert **pair_node = BLI_mempool_alloc(queue_node->eq_ctx.pool);
+    pair_node[0] = pair[0];
+    pair_node[1] = pair[1];
+    BLI_mempool_free(eq_ctx->pool, pair);
+    BLI_heapsimple_insert(queue_node->q.heap, priority, pair_node);
+  }
+  eq_ctx->node_index = DYNTOPO_NODE_NONE;
+
+  BLI_heapsimple_free(eq_ctx->q->heap, NULL);
+  eq_ctx->q->heap = heap_boundary;
+
+  if (totqueue != 0) {
+    EdgeQueueThreadData data = {
+        .bvh = bvh,
+        .mode = mode,
+        .queue_nodes = queue_nodes,
+    };
+
+    PBVHParallelSettings settings;
+    BKE_pbvh_parallel_range_settings(&settings, true, totqueue);
+    BKE_pbvh_parallel_range(
+        0, totqueue, &data, pbvh_bmesh_update_topology_node_task_cb, &settings);
+  }
+
+  for (int i = 0; i < totqueue; i++) {
+    EdgeQueueNode *queue_node = queue_nodes[i];
+    EdgeQueueContext *node_eq_ctx = &queue_node->eq_ctx;
+
+    edge_queue_heap_move(
+        eq_ctx->q->heap, eq_ctx->pool, node_eq_ctx->deferred, node_eq_ctx->pool);
+
+    if (queue_node->deleted_verts) {
+      GHashIterator gh_iter;
+      GHASH_ITER (gh_iter, queue_node->deleted_verts) {
+        BLI_ghash_insert(deleted_verts,
+                         BLI_ghashIterator_getKey(&gh_iter),
+                         BLI_ghashIterator_getValue(&gh_iter));
+      }
+      BLI_ghash_free(queue_node->deleted_verts, NULL, NULL);
+    }
+
+    modified |= queue_node->modified;
+
+    BLI_assert(BLI_heapsimple_is_empty(queue_node->q.heap));
+    BLI_heapsimple_free(queue_node->q.heap, NULL);
+    BLI_heapsimple_free(node_eq_ctx->deferred, NULL);
+    BLI_mempool_destroy(node_eq_ctx->pool);
+    MEM_freeN(queue_node);
+  }
+
+  BLI_mutex_end(&bm_lock);
+  MEM_freeN(node_queues);
+  MEM_freeN(queue_nodes);
+
+  return modified;
+}
+#endif /* USE_EDGEQUEUE_THREADED */
+
 /************************* Called from pbvh.c *************************/
 
 bool pbvh_bmesh_node_raycast(PBVHNode *node,
@@ -1985,13 +2383,21 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *bvh,
         cd_vert_mask_offset,
         cd_vert_node_offset,
         cd_face_node_offset,
+        DYNTOPO_NODE_NONE,
+        NULL,
+        NULL,
     };
+    GHash *deleted_verts = BLI_ghash_ptr_new("deleted_verts");
 
     short_edge_queue_create(
         &eq_ctx, bvh, center, view_normal, radius, use_frontface, use_projected);
-    modified |= pbvh_bmesh_collapse_short_edges(&eq_ctx, bvh, &deleted_faces);
+#ifdef USE_EDGEQUEUE_THREADED
+    modified |= pbvh_bmesh_update_topology_threaded(&eq_ctx, bvh, PBVH_Collapse, deleted_verts);
+#endif
+    modified |= pbvh_bmesh_collapse_short_edges(&eq_ctx, bvh, deleted_verts, &deleted_faces);
     BLI_heapsimple_free(q.heap, NULL);
     BLI_mempool_destroy(queue_pool);
+    BLI_ghash_free(deleted_verts, NULL, NULL);
   }
 
   if (mode & PBVH_Subdivide) {
@@ -2004,10 +2410,16 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *bvh,
         cd_vert_mask_offset,
         cd_vert_node_offset,
         cd_face_node_offset,
+        DYNTOPO_NODE_NONE,
+        NULL,
+        NULL,
     };
 
     long_edge_queue_create(
         &eq_ctx, bvh, center, view_normal, radius, use_frontface, use_projected);
+#ifdef USE_EDGEQUEUE_THREADED
+    modified |= pbvh_bmesh_update_topology_threaded(&eq_ctx, bvh, PBVH_Subdivide, NULL);
+#endif
     modified |= pbvh_bmesh_subdivide_long_edges(&eq_ctx, bvh, &edge_loops);
     BLI_heapsimple_free(q.heap, NULL);
     BLI_mempool_destroy(queue_pool);
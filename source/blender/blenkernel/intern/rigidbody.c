@@ -35,6 +35,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
@@ -1541,6 +1542,35 @@ static void rigidbody_update_ob_array(RigidBodyWorld *rbw)
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+typedef struct RigidBodyParallelRangeData {
+  void *userdata;
+  void (*func)(void *userdata, int index);
+} RigidBodyParallelRangeData;
+
+static void rigidbody_parallel_range_cb(void *__restrict userdata,
+                                        const int index,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodyParallelRangeData *data = userdata;
+  data->func(data->userdata, index);
+}
+
+/* Lets the physics engine run its parallel loops on Blender's task scheduler. */
+static void rigidbody_parallel_range(void *userdata,
+                                     int num,
+                                     void (*func)(void *userdata, int index))
+{
+  RigidBodyParallelRangeData data = {
+      .userdata = userdata,
+      .func = func,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num, &data, rigidbody_parallel_range_cb, &settings);
+}
+
 static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
 {
   float adj_gravity[3];
@@ -1558,6 +1588,10 @@ static void rigidbody_update_sim_world(Scene *scene, RigidBodyWorld *rbw)
   /* update gravity, since this RNA setting is not part of RigidBody settings */
   RB_dworld_set_gravity(rbw->shared->physics_world, adj_gravity);
 
+  RB_dworld_set_parallel_range(
+      rbw->shared->physics_world,
+      (rbw->flag & RBW_FLAG_USE_MULTITHREADING) ? rigidbody_parallel_range : NULL);
+
   /* update object array in case there are changes */
   rigidbody_update_ob_array(rbw);
 }
@@ -1824,6 +1858,34 @@ static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBod
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+static void rigidbody_update_cache_transform_cb(void *__restrict userdata,
+                                                const int index,
+                                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodyWorld *rbw = userdata;
+  Object *ob = rbw->objects[index];
+  RigidBodyOb *rbo = ob ? ob->rigidbody_object : NULL;
+
+  if (rbo && rbo->type == RBO_TYPE_ACTIVE && rbo->shared->physics_object) {
+    RB_body_get_position(rbo->shared->physics_object, rbo->pos);
+    RB_body_get_orientation(rbo->shared->physics_object, rbo->orn);
+  }
+}
+
+/* Fetch the transforms of all simulated objects in one pass before writing them to the cache. */
+static void rigidbody_update_cache_transforms(RigidBodyWorld *rbw)
+{
+  if (rbw->objects == NULL) {
+    return;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(
+      0, rbw->numbodies, rbw, rigidbody_update_cache_transform_cb, &settings);
+}
+
 bool BKE_rigidbody_check_sim_running(RigidBodyWorld *rbw, float ctime)
 {
   return (rbw && (rbw->flag & RBW_FLAG_MUTED) == 0 && ctime > rbw->shared->pointcache->startframe);
@@ -2026,6 +2088,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
   if (compare_ff_relative(ctime, rbw->ltime + 1, FLT_EPSILON, 64)) {
     /* write cache for first frame when on second frame */
     if (rbw->ltime == startframe && (cache->flag & PTCACHE_OUTDATED || cache->last_exact == 0)) {
+      rigidbody_update_cache_transforms(rbw);
       BKE_ptcache_write(&pid, startframe);
     }
 
@@ -2044,6 +2107,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
     rigidbody_update_simulation_post_step(depsgraph, rbw);
 
     /* write cache for current frame */
+    rigidbody_update_cache_transforms(rbw);
     BKE_ptcache_validate(cache, (int)ctime);
     BKE_ptcache_write(&pid, (unsigned int)ctime);
 
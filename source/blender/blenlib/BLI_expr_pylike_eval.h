@@ -46,6 +46,7 @@ void BLI_expr_pylike_free(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_valid(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_constant(struct ExprPyLike_Parsed *expr);
 bool BLI_expr_pylike_is_using_param(struct ExprPyLike_Parsed *expr, int index);
+const char *BLI_expr_pylike_error_get(struct ExprPyLike_Parsed *expr);
 ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
                                          const char **param_names,
                                          int param_names_len);
@@ -54,6 +55,9 @@ eExprPyLike_EvalStatus BLI_expr_pylike_eval(struct ExprPyLike_Parsed *expr,
                                             int param_values_len,
                                             double *r_result);
 
+bool BLI_expr_pylike_register_function(const char *name, int args_len, void *funcptr);
+void BLI_expr_pylike_unregister_function(const char *name);
+
 #ifdef __cplusplus
 }
 #endif
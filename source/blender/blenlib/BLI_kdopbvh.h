@@ -173,6 +173,12 @@ BVHTreeOverlap *BLI_bvhtree_overlap(const BVHTree *tree1,
                                     unsigned int *r_overlap_tot,
                                     BVHTree_OverlapCallback callback,
                                     void *userdata);
+unsigned int BLI_bvhtree_overlap_buffer(const BVHTree *tree1,
+                                        const BVHTree *tree2,
+                                        BVHTreeOverlap *overlap,
+                                        const unsigned int overlap_len,
+                                        BVHTree_OverlapCallback callback,
+                                        void *userdata);
 
 int BLI_bvhtree_get_len(const BVHTree *tree);
 int BLI_bvhtree_get_tree_type(const BVHTree *tree);
@@ -42,6 +42,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "BLI_alloca.h"
 #include "BLI_heap_simple.h"
 #include "BLI_kdopbvh.h"
@@ -117,6 +119,12 @@ typedef struct BVHOverlapData_Shared {
   /* use for callbacks */
   BVHTree_OverlapCallback callback;
   void *userdata;
+
+  /* Caller owned result buffer, used when threads have no result stack.
+   * Threads reserve slots with an atomic counter, overflowing results are only counted. */
+  BVHTreeOverlap *buffer;
+  uint buffer_len;
+  uint buffer_tot;
 } BVHOverlapData_Shared;
 
 typedef struct BVHOverlapData_Thread {
@@ -1096,6 +1104,28 @@ static bool tree_overlap_test(const BVHNode *node1,
   return 1;
 }
 
+BLI_INLINE void tree_overlap_push(BVHOverlapData_Thread *data_thread,
+                                  const BVHNode *node1,
+                                  const BVHNode *node2)
+{
+  BVHOverlapData_Shared *data = data_thread->shared;
+  BVHTreeOverlap *overlap;
+
+  if (data_thread->overlap) {
+    overlap = BLI_stack_push_r(data_thread->overlap);
+  }
+  else {
+    const uint index = atomic_fetch_and_add_uint32(&data->buffer_tot, 1);
+    if (index >= data->buffer_len) {
+      return;
+    }
+    overlap = &data->buffer[index];
+  }
+
+  overlap->indexA = node1->index;
+  overlap->indexB = node2->index;
+}
+
 static void tree_overlap_traverse(BVHOverlapData_Thread *data_thread,
                                   const BVHNode *node1,
                                   const BVHNode *node2)
@@ -1108,16 +1138,12 @@ static void tree_overlap_traverse(BVHOverlapData_Thread *data_thread,
     if (!node1->totnode) {
       /* check if node2 is a leaf */
       if (!node2->totnode) {
-        BVHTreeOverlap *overlap;
-
         if (UNLIKELY(node1 == node2)) {
           return;
         }
 
         /* both leafs, insert overlap! */
-        overlap = BLI_stack_push_r(data_thread->overlap);
-        overlap->indexA = node1->index;
-        overlap->indexB = node2->index;
+        tree_overlap_push(data_thread, node1, node2);
       }
       else {
         for (j = 0; j < data->tree2->tree_type; j++) {
@@ -1152,8 +1178,6 @@ static void tree_overlap_traverse_cb(BVHOverlapData_Thread *data_thread,
     if (!node1->totnode) {
       /* check if node2 is a leaf */
       if (!node2->totnode) {
-        BVHTreeOverlap *overlap;
-
         if (UNLIKELY(node1 == node2)) {
           return;
         }
@@ -1161,9 +1185,7 @@ static void tree_overlap_traverse_cb(BVHOverlapData_Thread *data_thread,
         /* only difference to tree_overlap_traverse! */
         if (data->callback(data->userdata, node1->index, node2->index, data_thread->thread)) {
           /* both leafs, insert overlap! */
-          overlap = BLI_stack_push_r(data_thread->overlap);
-          overlap->indexA = node1->index;
-          overlap->indexB = node2->index;
+          tree_overlap_push(data_thread, node1, node2);
         }
       }
       else {
@@ -1184,6 +1206,54 @@ static void tree_overlap_traverse_cb(BVHOverlapData_Thread *data_thread,
   }
 }
 
+/**
+ * A version of #tree_overlap_traverse_cb for overlapping a tree with itself,
+ * each unordered pair of leaves is visited once and passed with the lower index first.
+ */
+static void tree_overlap_traverse_self_cb(BVHOverlapData_Thread *data_thread,
+                                          const BVHNode *node1,
+                                          const BVHNode *node2)
+{
+  BVHOverlapData_Shared *data = data_thread->shared;
+  int i, j;
+
+  if (node1 == node2) {
+    /* pairs within the node, a leaf doesn't overlap itself */
+    for (i = 0; i < node1->totnode; i++) {
+      for (j = i; j < node1->totnode; j++) {
+        tree_overlap_traverse_self_cb(data_thread, node1->children[i], node1->children[j]);
+      }
+    }
+  }
+  else if (tree_overlap_test(node1, node2, data->start_axis, data->stop_axis)) {
+    /* check if node1 is a leaf */
+    if (!node1->totnode) {
+      /* check if node2 is a leaf */
+      if (!node2->totnode) {
+        if (node1->index > node2->index) {
+          SWAP(const BVHNode *, node1, node2);
+        }
+
+        if (!data->callback ||
+            data->callback(data->userdata, node1->index, node2->index, data_thread->thread)) {
+          /* both leafs, insert overlap! */
+          tree_overlap_push(data_thread, node1, node2);
+        }
+      }
+      else {
+        for (j = 0; j < node2->totnode; j++) {
+          tree_overlap_traverse_self_cb(data_thread, node1, node2->children[j]);
+        }
+      }
+    }
+    else {
+      for (j = 0; j < node1->totnode; j++) {
+        tree_overlap_traverse_self_cb(data_thread, node1->children[j], node2);
+      }
+    }
+  }
+}
+
 /**
  * a version of #tree_overlap_traverse_cb that that break on first true return.
  */
@@ -1271,6 +1341,88 @@ static void bvhtree_overlap_task_cb(void *__restrict userdata,
   }
 }
 
+static void bvhtree_overlap_self_task_cb(void *__restrict userdata,
+                                         const int i,
+                                         const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BVHOverlapData_Thread *data = &((BVHOverlapData_Thread *)userdata)[i];
+  const BVHTree *tree = data->shared->tree1;
+  const BVHNode *root = tree->nodes[tree->totleaf];
+
+  for (int j = i; j < root->totnode; j++) {
+    tree_overlap_traverse_self_cb(data, root->children[i], root->children[j]);
+  }
+}
+
+/**
+ * Initialize the data shared by all threads of an overlap query.
+ * Returns false when the trees can't overlap at all.
+ */
+static bool bvhtree_overlap_shared_init(BVHOverlapData_Shared *data_shared,
+                                        const BVHTree *tree1,
+                                        const BVHTree *tree2,
+                                        BVHTree_OverlapCallback callback,
+                                        void *userdata)
+{
+  /* check for compatibility of both trees (can't compare 14-DOP with 18-DOP) */
+  if (UNLIKELY((tree1->axis != tree2->axis) && (tree1->axis == 14 || tree2->axis == 14) &&
+               (tree1->axis == 18 || tree2->axis == 18))) {
+    BLI_assert(0);
+    return false;
+  }
+
+  const BVHNode *root1 = tree1->nodes[tree1->totleaf];
+  const BVHNode *root2 = tree2->nodes[tree2->totleaf];
+
+  const axis_t start_axis = min_axis(tree1->start_axis, tree2->start_axis);
+  const axis_t stop_axis = min_axis(tree1->stop_axis, tree2->stop_axis);
+
+  /* fast check root nodes for collision before doing big splitting + traversal */
+  if (!tree_overlap_test(root1, root2, start_axis, stop_axis)) {
+    return false;
+  }
+
+  memset(data_shared, 0, sizeof(*data_shared));
+  data_shared->tree1 = tree1;
+  data_shared->tree2 = tree2;
+  data_shared->start_axis = start_axis;
+  data_shared->stop_axis = stop_axis;
+
+  /* can be NULL */
+  data_shared->callback = callback;
+  data_shared->userdata = userdata;
+
+  return true;
+}
+
+static void bvhtree_overlap_traverse_threads(BVHOverlapData_Thread *data,
+                                             const int root_node_len,
+                                             const bool use_threading)
+{
+  BVHOverlapData_Shared *data_shared = data->shared;
+
+  if (use_threading) {
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1;
+    BLI_task_parallel_range(0, root_node_len, data, bvhtree_overlap_task_cb, &settings);
+  }
+  else {
+    const BVHNode *root1 = data_shared->tree1->nodes[data_shared->tree1->totleaf];
+    const BVHNode *root2 = data_shared->tree2->nodes[data_shared->tree2->totleaf];
+
+    if (data->max_interactions) {
+      tree_overlap_traverse_num(data, root1, root2);
+    }
+    else if (data_shared->callback) {
+      tree_overlap_traverse_cb(data, root1, root2);
+    }
+    else {
+      tree_overlap_traverse(data, root1, root2);
+    }
+  }
+}
+
 BVHTreeOverlap *BLI_bvhtree_overlap_ex(
     const BVHTree *tree1,
     const BVHTree *tree2,
@@ -1295,35 +1447,11 @@ BVHTreeOverlap *BLI_bvhtree_overlap_ex(
   BVHTreeOverlap *overlap = NULL, *to = NULL;
   BVHOverlapData_Shared data_shared;
   BVHOverlapData_Thread *data = BLI_array_alloca(data, (size_t)thread_num);
-  axis_t start_axis, stop_axis;
-
-  /* check for compatibility of both trees (can't compare 14-DOP with 18-DOP) */
-  if (UNLIKELY((tree1->axis != tree2->axis) && (tree1->axis == 14 || tree2->axis == 14) &&
-               (tree1->axis == 18 || tree2->axis == 18))) {
-    BLI_assert(0);
-    return NULL;
-  }
 
-  const BVHNode *root1 = tree1->nodes[tree1->totleaf];
-  const BVHNode *root2 = tree2->nodes[tree2->totleaf];
-
-  start_axis = min_axis(tree1->start_axis, tree2->start_axis);
-  stop_axis = min_axis(tree1->stop_axis, tree2->stop_axis);
-
-  /* fast check root nodes for collision before doing big splitting + traversal */
-  if (!tree_overlap_test(root1, root2, start_axis, stop_axis)) {
+  if (!bvhtree_overlap_shared_init(&data_shared, tree1, tree2, callback, userdata)) {
     return NULL;
   }
 
-  data_shared.tree1 = tree1;
-  data_shared.tree2 = tree2;
-  data_shared.start_axis = start_axis;
-  data_shared.stop_axis = stop_axis;
-
-  /* can be NULL */
-  data_shared.callback = callback;
-  data_shared.userdata = userdata;
-
   for (j = 0; j < thread_num; j++) {
     /* init BVHOverlapData_Thread */
     data[j].shared = &data_shared;
@@ -1334,23 +1462,7 @@ BVHTreeOverlap *BLI_bvhtree_overlap_ex(
     data[j].thread = j;
   }
 
-  if (use_threading) {
-    TaskParallelSettings settings;
-    BLI_parallel_range_settings_defaults(&settings);
-    settings.min_iter_per_thread = 1;
-    BLI_task_parallel_range(0, root_node_len, data, bvhtree_overlap_task_cb, &settings);
-  }
-  else {
-    if (max_interactions) {
-      tree_overlap_traverse_num(data, root1, root2);
-    }
-    else if (callback) {
-      tree_overlap_traverse_cb(data, root1, root2);
-    }
-    else {
-      tree_overlap_traverse(data, root1, root2);
-    }
-  }
+  bvhtree_overlap_traverse_threads(data, root_node_len, use_threading);
 
   if (overlap_pairs) {
     for (j = 0; j < thread_num; j++) {
@@ -1371,6 +1483,70 @@ BVHTreeOverlap *BLI_bvhtree_overlap_ex(
   return overlap;
 }
 
+/**
+ * Overlap query writing into a caller owned buffer, for callers which run the same query
+ * repeatedly and want to avoid allocating and merging per thread results each time.
+ *
+ * Threads append to the buffer through an atomic counter, so the order of the results is
+ * not deterministic when threading is used.
+ *
+ * When \a tree1 and \a tree2 are the same tree, each pair of leaves is only reported once,
+ * with the lower index as \a indexA.
+ *
+ * \return The total number of overlaps. When this is larger than \a overlap_len only
+ * the first \a overlap_len results are stored, and the caller should grow the buffer
+ * and run the query again.
+ */
+uint BLI_bvhtree_overlap_buffer(
+    const BVHTree *tree1,
+    const BVHTree *tree2,
+    BVHTreeOverlap *overlap,
+    const uint overlap_len,
+    /* optional callback to test the overlap before adding (must be thread-safe!) */
+    BVHTree_OverlapCallback callback,
+    void *userdata)
+{
+  const bool use_threading = (tree1->totleaf > KDOPBVH_THREAD_LEAF_THRESHOLD);
+  const int root_node_len = BLI_bvhtree_overlap_thread_num(tree1);
+  const int thread_num = use_threading ? root_node_len : 1;
+  BVHOverlapData_Shared data_shared;
+  BVHOverlapData_Thread *data = BLI_array_alloca(data, (size_t)thread_num);
+
+  if (!bvhtree_overlap_shared_init(&data_shared, tree1, tree2, callback, userdata)) {
+    return 0;
+  }
+
+  data_shared.buffer = overlap;
+  data_shared.buffer_len = overlap_len;
+  data_shared.buffer_tot = 0;
+
+  for (int j = 0; j < thread_num; j++) {
+    /* No result stack, write into the shared buffer. */
+    data[j].shared = &data_shared;
+    data[j].overlap = NULL;
+    data[j].max_interactions = 0;
+    data[j].thread = j;
+  }
+
+  if (tree1 == tree2) {
+    if (use_threading) {
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.min_iter_per_thread = 1;
+      BLI_task_parallel_range(0, root_node_len, data, bvhtree_overlap_self_task_cb, &settings);
+    }
+    else {
+      const BVHNode *root = tree1->nodes[tree1->totleaf];
+      tree_overlap_traverse_self_cb(data, root, root);
+    }
+  }
+  else {
+    bvhtree_overlap_traverse_threads(data, root_node_len, use_threading);
+  }
+
+  return data_shared.buffer_tot;
+}
+
 BVHTreeOverlap *BLI_bvhtree_overlap(
     const BVHTree *tree1,
     const BVHTree *tree2,
@@ -32,19 +32,25 @@
  *      pi, True, False
  *  - Operators:
  *      +, -, *, /, ==, !=, <, <=, >, >=, and, or, not, ternary if
+ *  - Tuple and list indexing:
+ *      (a, b, c)[i], [a, b, c][i]
  *  - Functions:
  *      min, max, radians, degrees,
- *      abs, fabs, floor, ceil, trunc, int,
+ *      abs, fabs, floor, ceil, trunc, int, round, float, bool,
  *      sin, cos, tan, asin, acos, atan, atan2,
- *      exp, log, sqrt, pow, fmod
+ *      exp, log, sqrt, pow, fmod,
+ *      clamp, lerp, inverse_lerp, smoothstep
+ *  - Native functions added with #BLI_expr_pylike_register_function.
  *
- * The implementation has no global state and can be used multi-threaded.
+ * Apart from the registry of native functions, which is guarded by a lock, the implementation
+ * has no global state and can be used multi-threaded.
  */
 
 #include <ctype.h>
 #include <fenv.h>
 #include <float.h>
 #include <math.h>
+#include <stdarg.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -55,6 +61,8 @@
 #include "BLI_alloca.h"
 #include "BLI_expr_pylike_eval.h"
 #include "BLI_math_base.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #ifdef _MSC_VER
@@ -72,12 +80,16 @@ typedef enum eOpCode {
   OPCODE_FUNC1,
   /* 2 argument function call: (a b -> func2(a,b)) */
   OPCODE_FUNC2,
+  /* 3 argument function call: (a b c -> func3(a,b,c)) */
+  OPCODE_FUNC3,
   /* Parameter access: (-> params[ival]) */
   OPCODE_PARAMETER,
   /* Minimum of multiple inputs: (a b c... -> min); ival = arg count */
   OPCODE_MIN,
   /* Maximum of multiple inputs: (a b c... -> max); ival = arg count */
   OPCODE_MAX,
+  /* Tuple indexing: (a b c... i -> (a, b, c...)[i]); ival = item count */
+  OPCODE_SELECT,
   /* Jump (pc += jmp_offset) */
   OPCODE_JMP,
   /* Pop and jump if zero: (a -> ); JUMP IF NOT a */
@@ -92,6 +104,7 @@ typedef enum eOpCode {
 
 typedef double (*UnaryOpFunc)(double);
 typedef double (*BinaryOpFunc)(double, double);
+typedef double (*TernaryOpFunc)(double, double, double);
 
 typedef struct ExprOp {
   eOpCode opcode;
@@ -104,6 +117,7 @@ typedef struct ExprOp {
     void *ptr;
     UnaryOpFunc func1;
     BinaryOpFunc func2;
+    TernaryOpFunc func3;
   } arg;
 } ExprOp;
 
@@ -111,6 +125,9 @@ struct ExprPyLike_Parsed {
   int ops_count;
   int max_stack;
 
+  /* Reason the expression couldn't be parsed, empty on success. */
+  char error[128];
+
   ExprOp ops[];
 };
 
@@ -134,6 +151,21 @@ bool BLI_expr_pylike_is_valid(ExprPyLike_Parsed *expr)
   return expr != NULL && expr->ops_count > 0;
 }
 
+/**
+ * Get the reason the expression couldn't be parsed, i.e. why it needs full Python.
+ * Returns NULL if the parsing result is valid.
+ */
+const char *BLI_expr_pylike_error_get(ExprPyLike_Parsed *expr)
+{
+  if (expr == NULL) {
+    return "no expression";
+  }
+  if (BLI_expr_pylike_is_valid(expr)) {
+    return NULL;
+  }
+  return expr->error[0] ? expr->error : "invalid expression";
+}
+
 /** Check if the parsed expression always evaluates to the same value. */
 bool BLI_expr_pylike_is_constant(ExprPyLike_Parsed *expr)
 {
@@ -216,6 +248,11 @@ eExprPyLike_EvalStatus BLI_expr_pylike_eval(ExprPyLike_Parsed *expr,
         stack[sp - 2] = ops[pc].arg.func2(stack[sp - 2], stack[sp - 1]);
         sp--;
         break;
+      case OPCODE_FUNC3:
+        FAIL_IF(sp < 3);
+        stack[sp - 3] = ops[pc].arg.func3(stack[sp - 3], stack[sp - 2], stack[sp - 1]);
+        sp -= 2;
+        break;
       case OPCODE_MIN:
         FAIL_IF(sp < ops[pc].arg.ival);
         for (int j = 1; j < ops[pc].arg.ival; j++, sp--) {
@@ -228,6 +265,22 @@ eExprPyLike_EvalStatus BLI_expr_pylike_eval(ExprPyLike_Parsed *expr,
           CLAMP_MIN(stack[sp - 2], stack[sp - 1]);
         }
         break;
+      case OPCODE_SELECT: {
+        const int count = ops[pc].arg.ival;
+        FAIL_IF(sp < count + 1);
+        const double index = stack[--sp];
+        sp -= count;
+        /* Like Python, allow negative indices; non-integer or out of range is an error. */
+        if (index == floor(index) && index >= -count && index < count) {
+          stack[sp] = stack[sp + (int)index + ((index < 0) ? count : 0)];
+        }
+        else {
+          stack[sp] = NAN;
+          feraiseexcept(FE_INVALID);
+        }
+        sp++;
+        break;
+      }
 
       /* Jumps */
       case OPCODE_JMP:
@@ -326,6 +379,49 @@ static double op_degrees(double arg)
   return arg * 180.0 / M_PI;
 }
 
+static double op_round(double arg)
+{
+  /* Python 3 rounds halfway cases to the nearest even number. */
+  double result = round(arg);
+  if (fabs(arg - trunc(arg)) == 0.5) {
+    result = 2.0 * round(arg * 0.5);
+  }
+  return result;
+}
+
+static double op_float(double arg)
+{
+  return arg;
+}
+
+static double op_bool(double arg)
+{
+  return arg ? 1.0 : 0.0;
+}
+
+static double op_lerp(double a, double b, double t)
+{
+  return a + (b - a) * t;
+}
+
+static double op_inverse_lerp(double a, double b, double x)
+{
+  return (x - a) / (b - a);
+}
+
+static double op_clamp(double arg, double min, double max)
+{
+  CLAMP(arg, min, max);
+  return arg;
+}
+
+static double op_smoothstep(double a, double b, double x)
+{
+  double t = op_inverse_lerp(a, b, x);
+  CLAMP(t, 0.0, 1.0);
+  return t * t * (3.0 - 2.0 * t);
+}
+
 static double op_not(double a)
 {
   return a ? 0.0 : 1.0;
@@ -391,6 +487,9 @@ static BuiltinOpDef builtin_ops[] = {
     {"ceil", OPCODE_FUNC1, ceil},
     {"trunc", OPCODE_FUNC1, trunc},
     {"int", OPCODE_FUNC1, trunc},
+    {"round", OPCODE_FUNC1, op_round},
+    {"float", OPCODE_FUNC1, op_float},
+    {"bool", OPCODE_FUNC1, op_bool},
     {"sin", OPCODE_FUNC1, sin},
     {"cos", OPCODE_FUNC1, cos},
     {"tan", OPCODE_FUNC1, tan},
@@ -403,11 +502,120 @@ static BuiltinOpDef builtin_ops[] = {
     {"sqrt", OPCODE_FUNC1, sqrt},
     {"pow", OPCODE_FUNC2, pow},
     {"fmod", OPCODE_FUNC2, fmod},
+    {"lerp", OPCODE_FUNC3, op_lerp},
+    {"inverse_lerp", OPCODE_FUNC3, op_inverse_lerp},
+    {"smoothstep", OPCODE_FUNC3, op_smoothstep},
     {NULL, OPCODE_CONST, NULL},
 };
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Native Function Registry
+ * \{ */
+
+#define MAX_REGISTERED_FUNCTIONS 64
+
+typedef struct RegisteredOpDef {
+  char name[64];
+  eOpCode op;
+  void *funcptr;
+} RegisteredOpDef;
+
+/* Expressions are parsed from drivers evaluated in parallel, while add-ons may (un)register
+ * functions from the main thread. */
+static ThreadRWMutex registered_ops_lock = BLI_RWLOCK_INITIALIZER;
+static RegisteredOpDef registered_ops[MAX_REGISTERED_FUNCTIONS];
+static int registered_ops_len = 0;
+
+static const BuiltinOpDef *builtin_op_find(const char *name)
+{
+  for (int i = 0; builtin_ops[i].name; i++) {
+    if (STREQ(name, builtin_ops[i].name)) {
+      return &builtin_ops[i];
+    }
+  }
+  return NULL;
+}
+
+/* Lock must be held by the caller. */
+static RegisteredOpDef *registered_op_find(const char *name)
+{
+  for (int i = 0; i < registered_ops_len; i++) {
+    if (STREQ(name, registered_ops[i].name)) {
+      return &registered_ops[i];
+    }
+  }
+  return NULL;
+}
+
+/* Copy the definition, so it stays valid while the call is parsed even if it's unregistered. */
+static bool registered_op_lookup(const char *name, RegisteredOpDef *r_def)
+{
+  BLI_rw_mutex_lock(&registered_ops_lock, THREAD_LOCK_READ);
+  const RegisteredOpDef *def = registered_op_find(name);
+  if (def != NULL) {
+    *r_def = *def;
+  }
+  BLI_rw_mutex_unlock(&registered_ops_lock);
+
+  return def != NULL;
+}
+
+/**
+ * Make a pure native function taking 1 to 3 doubles available to expressions parsed afterwards,
+ * so drivers calling it don't need Python. Registering an existing name replaces the function.
+ *
+ * \return false if the name is invalid or taken by a built-in, or the registry is full.
+ */
+bool BLI_expr_pylike_register_function(const char *name, int args_len, void *funcptr)
+{
+  if (args_len < 1 || args_len > 3 || funcptr == NULL || name[0] == '\0' ||
+      strlen(name) >= sizeof(registered_ops[0].name) || builtin_op_find(name) ||
+      STR_ELEM(name, "min", "max", "clamp")) {
+    return false;
+  }
+
+  bool success = true;
+
+  BLI_rw_mutex_lock(&registered_ops_lock, THREAD_LOCK_WRITE);
+  RegisteredOpDef *def = registered_op_find(name);
+
+  if (def == NULL && registered_ops_len < MAX_REGISTERED_FUNCTIONS) {
+    def = &registered_ops[registered_ops_len++];
+    BLI_strncpy(def->name, name, sizeof(def->name));
+  }
+
+  if (def != NULL) {
+    const eOpCode ops[3] = {OPCODE_FUNC1, OPCODE_FUNC2, OPCODE_FUNC3};
+    def->op = ops[args_len - 1];
+    def->funcptr = funcptr;
+  }
+  else {
+    success = false;
+  }
+  BLI_rw_mutex_unlock(&registered_ops_lock);
+
+  return success;
+}
+
+/**
+ * Remove a function added with #BLI_expr_pylike_register_function,
+ * expressions which were already parsed keep calling it.
+ */
+void BLI_expr_pylike_unregister_function(const char *name)
+{
+  BLI_rw_mutex_lock(&registered_ops_lock, THREAD_LOCK_WRITE);
+  RegisteredOpDef *def = registered_op_find(name);
+
+  if (def != NULL) {
+    *def = registered_ops[--registered_ops_len];
+  }
+  BLI_rw_mutex_unlock(&registered_ops_lock);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Expression Parser State
  * \{ */
@@ -470,8 +678,25 @@ typedef struct ExprParseState {
 
   /* Stack space requirement tracking */
   int stack_ptr, max_stack;
+
+  /* Reason of the first parse failure, for diagnostics */
+  char error[128];
 } ExprParseState;
 
+/* Record the reason parsing failed, unless one is already known; always returns false. */
+static bool parse_error(ExprParseState *state, const char *format, ...)
+    ATTR_PRINTF_FORMAT(2, 3);
+static bool parse_error(ExprParseState *state, const char *format, ...)
+{
+  if (state->error[0] == '\0') {
+    va_list args;
+    va_start(args, format);
+    BLI_vsnprintf(state->error, sizeof(state->error), format, args);
+    va_end(args);
+  }
+  return false;
+}
+
 /* Reserve space for the specified number of operations in the buffer. */
 static ExprOp *parse_alloc_ops(ExprParseState *state, int count)
 {
@@ -560,6 +785,27 @@ static bool parse_add_func(ExprParseState *state, eOpCode code, int args, void *
       }
       break;
 
+    case OPCODE_FUNC3:
+      CHECK_ERROR(args == 3);
+
+      if (jmp_gap >= 3 && prev_ops[-3].opcode == OPCODE_CONST &&
+          prev_ops[-2].opcode == OPCODE_CONST && prev_ops[-1].opcode == OPCODE_CONST) {
+        TernaryOpFunc func = funcptr;
+
+        /* volatile because some compilers overly aggressive optimize this call out.
+         * see D6012 for details. */
+        volatile double result = func(
+            prev_ops[-3].arg.dval, prev_ops[-2].arg.dval, prev_ops[-1].arg.dval);
+
+        if (fetestexcept(FE_DIVBYZERO | FE_INVALID) == 0) {
+          prev_ops[-3].arg.dval = result;
+          state->ops_count -= 2;
+          state->stack_ptr -= 2;
+          return true;
+        }
+      }
+      break;
+
     default:
       BLI_assert(false);
       return false;
@@ -711,6 +957,67 @@ static int parse_function_args(ExprParseState *state)
   }
 }
 
+static int parse_func_args_count(eOpCode code)
+{
+  switch (code) {
+    case OPCODE_FUNC1:
+      return 1;
+    case OPCODE_FUNC2:
+      return 2;
+    case OPCODE_FUNC3:
+      return 3;
+    default:
+      BLI_assert(false);
+      return -1;
+  }
+}
+
+/* Parse the arguments of a call to a fixed argument count function. */
+static bool parse_call(ExprParseState *state, const char *name, eOpCode code, void *funcptr)
+{
+  const int args = parse_function_args(state);
+  const int args_expected = parse_func_args_count(code);
+
+  if (args < 0) {
+    return parse_error(state, "invalid call to '%s'", name);
+  }
+  if (args != args_expected) {
+    return parse_error(
+        state, "'%s' takes %d argument(s) (%d given)", name, args_expected, args);
+  }
+
+  return parse_add_func(state, code, args, funcptr);
+}
+
+/* Parse the rest of a tuple or list with a subscript, the first item is already parsed. */
+static bool parse_subscript(ExprParseState *state, short end_token)
+{
+  int count = 1;
+
+  while (state->token == ',') {
+    CHECK_ERROR(parse_next_token(state));
+
+    /* Trailing comma. */
+    if (state->token == end_token) {
+      break;
+    }
+
+    CHECK_ERROR(parse_expr(state));
+    count++;
+  }
+
+  CHECK_ERROR(state->token == end_token && parse_next_token(state));
+
+  if (state->token != '[') {
+    return parse_error(state, "tuples and lists are only supported when indexed");
+  }
+
+  CHECK_ERROR(parse_next_token(state) && parse_expr(state) && state->token == ']');
+
+  parse_add_op(state, OPCODE_SELECT, -count)->arg.ival = count;
+  return parse_next_token(state);
+}
+
 static bool parse_unary(ExprParseState *state)
 {
   int i;
@@ -725,8 +1032,21 @@ static bool parse_unary(ExprParseState *state)
       return true;
 
     case '(':
-      return parse_next_token(state) && parse_expr(state) && state->token == ')' &&
-             parse_next_token(state);
+      CHECK_ERROR(parse_next_token(state) && parse_expr(state));
+
+      if (state->token == ',') {
+        return parse_subscript(state, ')');
+      }
+
+      return state->token == ')' && parse_next_token(state);
+
+    case '[':
+      CHECK_ERROR(parse_next_token(state) && parse_expr(state));
+      return parse_subscript(state, ']');
+
+    case '"':
+    case '\'':
+      return parse_error(state, "string literals are not supported");
 
     case TOKEN_NUMBER:
       parse_add_op(state, OPCODE_CONST, 1)->arg.dval = state->tokenval;
@@ -738,7 +1058,15 @@ static bool parse_unary(ExprParseState *state)
       for (i = state->param_names_len - 1; i >= 0; i--) {
         if (STREQ(state->tokenbuf, state->param_names[i])) {
           parse_add_op(state, OPCODE_PARAMETER, 1)->arg.ival = i;
-          return parse_next_token(state);
+          CHECK_ERROR(parse_next_token(state));
+
+          if (ELEM(state->token, '.', '[', '(')) {
+            return parse_error(state,
+                               "variable '%s' is a number, attribute access, indexing "
+                               "and calls are not supported",
+                               state->param_names[i]);
+          }
+          return true;
         }
       }
 
@@ -751,12 +1079,15 @@ static bool parse_unary(ExprParseState *state)
       }
 
       /* Ordinary builtin functions. */
-      for (i = 0; builtin_ops[i].name; i++) {
-        if (STREQ(state->tokenbuf, builtin_ops[i].name)) {
-          int args = parse_function_args(state);
+      const BuiltinOpDef *builtin_op = builtin_op_find(state->tokenbuf);
+      if (builtin_op) {
+        return parse_call(state, builtin_op->name, builtin_op->op, builtin_op->funcptr);
+      }
 
-          return parse_add_func(state, builtin_ops[i].op, args, builtin_ops[i].funcptr);
-        }
+      /* Registered native functions. */
+      RegisteredOpDef registered_op;
+      if (registered_op_lookup(state->tokenbuf, &registered_op)) {
+        return parse_call(state, registered_op.name, registered_op.op, registered_op.funcptr);
       }
 
       /* Specially supported functions. */
@@ -776,7 +1107,23 @@ static bool parse_unary(ExprParseState *state)
         return true;
       }
 
-      return false;
+      /* Clamp to 0..1 by default, like the common driver namespace helper. */
+      if (STREQ(state->tokenbuf, "clamp")) {
+        int cnt = parse_function_args(state);
+
+        if (cnt == 1) {
+          parse_add_op(state, OPCODE_CONST, 1)->arg.dval = 0.0;
+          parse_add_op(state, OPCODE_CONST, 1)->arg.dval = 1.0;
+          cnt = 3;
+        }
+        else if (cnt != 3) {
+          return parse_error(state, "'clamp' takes 1 or 3 arguments");
+        }
+
+        return parse_add_func(state, OPCODE_FUNC3, cnt, op_clamp);
+      }
+
+      return parse_error(state, "unknown name '%s'", state->tokenbuf);
 
     default:
       return false;
@@ -1008,7 +1355,8 @@ ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
   /* Parse the expression. */
   ExprPyLike_Parsed *expr;
 
-  if (parse_next_token(&state) && parse_expr(&state) && state.token == 0) {
+  if (parse_next_token(&state) && parse_expr(&state) && state.token == 0 &&
+      state.error[0] == '\0') {
     BLI_assert(state.stack_ptr == 1);
 
     int bytesize = sizeof(ExprPyLike_Parsed) + state.ops_count * sizeof(ExprOp);
@@ -1016,12 +1364,18 @@ ExprPyLike_Parsed *BLI_expr_pylike_parse(const char *expression,
     expr = MEM_mallocN(bytesize, "ExprPyLike_Parsed");
     expr->ops_count = state.ops_count;
     expr->max_stack = state.max_stack;
+    expr->error[0] = '\0';
 
     memcpy(expr->ops, state.ops, state.ops_count * sizeof(ExprOp));
   }
   else {
     /* Always return a non-NULL object so that parse failure can be cached. */
     expr = MEM_callocN(sizeof(ExprPyLike_Parsed), "ExprPyLike_Parsed(empty)");
+
+    if (state.error[0] == '\0') {
+      parse_error(&state, "syntax error at column %d", (int)(state.cur - state.expr) + 1);
+    }
+    BLI_strncpy(expr->error, state.error, sizeof(expr->error));
   }
 
   MEM_freeN(state.tokenbuf);
@@ -530,6 +530,7 @@ void blo_join_main(ListBase *mainlist)
     BLI_remlink(mainlist, tojoin);
     BKE_main_free(tojoin);
   }
+  BKE_main_idmap_names_clear(mainl);
 }
 
 static void split_libdata(ListBase *lb_src, Main **lib_main_array, const uint lib_main_array_len)
@@ -2293,6 +2294,8 @@ void blo_make_old_idmap_from_main(FileData *fd, Main *bmain)
     BKE_main_idmap_destroy(fd->old_idmap);
   }
   fd->old_idmap = BKE_main_idmap_create(bmain, false, NULL, MAIN_IDMAP_TYPE_UUID);
+  /* IDs may be moved from old Main to the new one when re-using them during undo. */
+  BKE_main_idmap_names_clear(bmain);
 }
 
 /** \} */
@@ -3210,6 +3213,9 @@ static void direct_link_fcurves(FileData *fd, ListBase *list)
      */
     fcu->flag &= ~FCURVE_DISABLED;
 
+    /* Runtime hint, files written before it was cleared on write may store one. */
+    fcu->last_bezt_index = 0;
+
     /* driver */
     fcu->driver = newdataadr(fd, fcu->driver);
     if (fcu->driver) {
@@ -3432,6 +3438,7 @@ static void direct_link_animdata(FileData *fd, AnimData *adt)
   link_list(fd, &adt->drivers);
   direct_link_fcurves(fd, &adt->drivers);
   adt->driver_array = NULL;
+  adt->eval_cache = NULL;
 
   /* link overrides */
   // TODO...
@@ -4132,6 +4139,7 @@ static void direct_link_key(FileData *fd, Key *key)
   direct_link_animdata(fd, key->adt);
 
   key->refkey = newdataadr(fd, key->refkey);
+  key->sparse_cache = NULL;
 
   for (kb = key->block.first; kb; kb = kb->next) {
     kb->data = newdataadr(fd, kb->data);
@@ -4958,6 +4966,7 @@ static void direct_link_customdata(FileData *fd, CustomData *data, int count)
     }
 
     layer->flag &= ~CD_FLAG_NOFREE;
+    layer->shared = NULL;
 
     if (CustomData_verify_versions(data, i)) {
       layer->data = newdataadr(fd, layer->data);
@@ -750,6 +750,9 @@ void BLO_version_defaults_userpref_blend(Main *bmain, UserDef *userdef)
    */
   {
     /* Keep this block, even when empty. */
+    if (userdef->mesh_disk_cache_size_limit == 0) {
+      userdef->mesh_disk_cache_size_limit = U_default.mesh_disk_cache_size_limit;
+    }
   }
 
   if (userdef->pixelsize == 0.0f) {
@@ -821,7 +821,13 @@ static void write_fcurves(WriteData *wd, ListBase *fcurves)
 {
   FCurve *fcu;
 
-  writelist(wd, DATA, FCurve, fcurves);
+  for (fcu = fcurves->first; fcu; fcu = fcu->next) {
+    /* Runtime hint, changing on every evaluation, keep it from showing up as a change in
+     * undo steps. */
+    FCurve fcu_flat = *fcu;
+    fcu_flat.last_bezt_index = 0;
+    writestruct_at_address(wd, DATA, FCurve, 1, fcu, &fcu_flat);
+  }
   for (fcu = fcurves->first; fcu; fcu = fcu->next) {
     /* curve data */
     if (fcu->bezt) {
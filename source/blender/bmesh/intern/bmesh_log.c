@@ -27,6 +27,9 @@
  * - Moving vertices
  * - Setting vertex paint-mask values
  * - Setting vertex hflags
+ *
+ * Changes can be logged from multiple threads, as long as they are not
+ * logging the same element (dynamic topology updates PBVH nodes in parallel).
  */
 
 #include "MEM_guardedalloc.h"
@@ -35,6 +38,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_mempool.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
@@ -105,6 +109,10 @@ struct BMLog {
    * entries have been applied (i.e. there is nothing left to redo.)
    */
   BMLogEntry *current_entry;
+
+  /* Serializes logging of element changes, which may happen from
+   * multiple threads. */
+  ThreadMutex lock;
 };
 
 typedef struct {
@@ -479,6 +487,7 @@ BMLog *BM_log_create(BMesh *bm)
   log->unused_ids = range_tree_uint_alloc(0, (uint)-1);
   log->id_to_elem = BLI_ghash_new_ex(logkey_hash, logkey_cmp, __func__, reserve_num);
   log->elem_to_id = BLI_ghash_ptr_new_ex(__func__, reserve_num);
+  BLI_mutex_init(&log->lock);
 
   /* Assign IDs to all existing vertices and faces */
   bm_log_assign_ids(bm, log);
@@ -574,6 +583,8 @@ void BM_log_free(BMLog *log)
     BLI_ghash_free(log->elem_to_id, NULL, NULL);
   }
 
+  BLI_mutex_end(&log->lock);
+
   /* Clear the BMLog references within each entry, but do not free
    * the entries themselves */
   for (entry = log->entries.first; entry; entry = entry->next) {
@@ -841,9 +852,12 @@ void BM_log_vert_before_modified(BMLog *log, BMVert *v, const int cd_vert_mask_o
 {
   BMLogEntry *entry = log->current_entry;
   BMLogVert *lv;
+  void **val_p;
+
+  BLI_mutex_lock(&log->lock);
+
   uint v_id = bm_log_vert_id_get(log, v);
   void *key = POINTER_FROM_UINT(v_id);
-  void **val_p;
 
   /* Find or create the BMLogVert entry */
   if ((lv = BLI_ghash_lookup(entry->added_verts, key))) {
@@ -853,6 +867,8 @@ void BM_log_vert_before_modified(BMLog *log, BMVert *v, const int cd_vert_mask_o
     lv = bm_log_vert_alloc(log, v, cd_vert_mask_offset);
     *val_p = lv;
   }
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log a new vertex as added to the BMesh
@@ -864,12 +880,17 @@ void BM_log_vert_before_modified(BMLog *log, BMVert *v, const int cd_vert_mask_o
 void BM_log_vert_added(BMLog *log, BMVert *v, const int cd_vert_mask_offset)
 {
   BMLogVert *lv;
+
+  BLI_mutex_lock(&log->lock);
+
   uint v_id = range_tree_uint_take_any(log->unused_ids);
   void *key = POINTER_FROM_UINT(v_id);
 
   bm_log_vert_id_set(log, v, v_id);
   lv = bm_log_vert_alloc(log, v, cd_vert_mask_offset);
   BLI_ghash_insert(log->current_entry->added_verts, key, lv);
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log a face before it is modified
@@ -880,11 +901,16 @@ void BM_log_vert_added(BMLog *log, BMVert *v, const int cd_vert_mask_offset)
 void BM_log_face_modified(BMLog *log, BMFace *f)
 {
   BMLogFace *lf;
+
+  BLI_mutex_lock(&log->lock);
+
   uint f_id = bm_log_face_id_get(log, f);
   void *key = POINTER_FROM_UINT(f_id);
 
   lf = bm_log_face_alloc(log, f);
   BLI_ghash_insert(log->current_entry->modified_faces, key, lf);
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log a new face as added to the BMesh
@@ -896,15 +922,20 @@ void BM_log_face_modified(BMLog *log, BMFace *f)
 void BM_log_face_added(BMLog *log, BMFace *f)
 {
   BMLogFace *lf;
-  uint f_id = range_tree_uint_take_any(log->unused_ids);
-  void *key = POINTER_FROM_UINT(f_id);
 
   /* Only triangles are supported for now */
   BLI_assert(f->len == 3);
 
+  BLI_mutex_lock(&log->lock);
+
+  uint f_id = range_tree_uint_take_any(log->unused_ids);
+  void *key = POINTER_FROM_UINT(f_id);
+
   bm_log_face_id_set(log, f, f_id);
   lf = bm_log_face_alloc(log, f);
   BLI_ghash_insert(log->current_entry->added_faces, key, lf);
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log a vertex as removed from the BMesh
@@ -926,6 +957,9 @@ void BM_log_face_added(BMLog *log, BMFace *f)
 void BM_log_vert_removed(BMLog *log, BMVert *v, const int cd_vert_mask_offset)
 {
   BMLogEntry *entry = log->current_entry;
+
+  BLI_mutex_lock(&log->lock);
+
   uint v_id = bm_log_vert_id_get(log, v);
   void *key = POINTER_FROM_UINT(v_id);
 
@@ -949,6 +983,8 @@ void BM_log_vert_removed(BMLog *log, BMVert *v, const int cd_vert_mask_offset)
       BLI_ghash_remove(entry->modified_verts, key, NULL, NULL);
     }
   }
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log a face as removed from the BMesh
@@ -967,6 +1003,9 @@ void BM_log_vert_removed(BMLog *log, BMVert *v, const int cd_vert_mask_offset)
 void BM_log_face_removed(BMLog *log, BMFace *f)
 {
   BMLogEntry *entry = log->current_entry;
+
+  BLI_mutex_lock(&log->lock);
+
   uint f_id = bm_log_face_id_get(log, f);
   void *key = POINTER_FROM_UINT(f_id);
 
@@ -983,6 +1022,8 @@ void BM_log_face_removed(BMLog *log, BMFace *f)
     lf = bm_log_face_alloc(log, f);
     BLI_ghash_insert(entry->deleted_faces, key, lf);
   }
+
+  BLI_mutex_unlock(&log->lock);
 }
 
 /* Log all vertices/faces in the BMesh as added */
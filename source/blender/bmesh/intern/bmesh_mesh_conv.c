@@ -574,20 +574,19 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   const int cd_shape_keyindex_offset = CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX);
 
   MVert *oldverts = NULL;
+  CustomData oldvdata;
   const int ototvert = me->totvert;
 
+  CustomData_reset(&oldvdata);
+
   if (me->key && (cd_shape_keyindex_offset != -1)) {
-    /* Keep the old verts in case we are working on* a key, which is done at the end. */
-
-    /* Use the array in-place instead of duplicating the array. */
-#if 0
-  oldverts = MEM_dupallocN(me->mvert);
-#else
-    oldverts = me->mvert;
-    me->mvert = NULL;
-    CustomData_update_typemap(&me->vdata);
-    CustomData_set_layer(&me->vdata, CD_MVERT, NULL);
-#endif
+    /* Keep the old verts in case we are working on* a key, which is done at the end.
+     *
+     * Referencing shares the array instead of duplicating it. Unlike taking the array out of
+     * the layer, other users of the data keep it too, like evaluated copies of the mesh or
+     * arrays exported to Python. */
+    CustomData_copy(&me->vdata, &oldvdata, CD_MASK_MVERT, CD_REFERENCE, me->totvert);
+    oldverts = CustomData_get_layer(&oldvdata, CD_MVERT);
   }
 
   /* Free custom data. */
@@ -968,9 +967,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
     }
   }
 
-  if (oldverts != NULL) {
-    MEM_freeN(oldverts);
-  }
+  CustomData_free(&oldvdata, ototvert);
 
   /* Topology could be changed, ensure mdisps are ok. */
   multires_topology_changed(me);
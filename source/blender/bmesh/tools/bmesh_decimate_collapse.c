@@ -32,6 +32,7 @@
 #include "BLI_polyfill_2d.h"
 #include "BLI_polyfill_2d_beautify.h"
 #include "BLI_quadric.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 #include "BKE_customdata.h"
@@ -237,12 +238,17 @@ static float bm_decim_build_edge_cost_single__topology(BMEdge *e)
 
 #endif /* USE_TOPOLOGY_FALLBACK */
 
-static void bm_decim_build_edge_cost_single(BMEdge *e,
-                                            const Quadric *vquadrics,
-                                            const float *vweights,
-                                            const float vweight_factor,
-                                            Heap *eheap,
-                                            HeapNode **eheap_table)
+/**
+ * Calculate the collapse cost of an edge, this only reads from the mesh
+ * so it's safe to call from multiple threads.
+ *
+ * \return false when the edge can't be collapsed.
+ */
+static bool bm_decim_calc_edge_cost(BMEdge *e,
+                                    const Quadric *vquadrics,
+                                    const float *vweights,
+                                    const float vweight_factor,
+                                    float *r_cost)
 {
   float cost;
 
@@ -324,14 +330,31 @@ static void bm_decim_build_edge_cost_single(BMEdge *e,
     }
   }
 
-  BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
-  return;
+  *r_cost = cost;
+  return true;
 
 clear:
-  if (eheap_table[BM_elem_index_get(e)]) {
-    BLI_heap_remove(eheap, eheap_table[BM_elem_index_get(e)]);
+  return false;
+}
+
+static void bm_decim_build_edge_cost_single(BMEdge *e,
+                                            const Quadric *vquadrics,
+                                            const float *vweights,
+                                            const float vweight_factor,
+                                            Heap *eheap,
+                                            HeapNode **eheap_table)
+{
+  float cost;
+
+  if (bm_decim_calc_edge_cost(e, vquadrics, vweights, vweight_factor, &cost)) {
+    BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
+  }
+  else {
+    if (eheap_table[BM_elem_index_get(e)]) {
+      BLI_heap_remove(eheap, eheap_table[BM_elem_index_get(e)]);
+    }
+    eheap_table[BM_elem_index_get(e)] = NULL;
   }
-  eheap_table[BM_elem_index_get(e)] = NULL;
 }
 
 /* use this for degenerate cases - add back to the heap with an invalid cost,
@@ -342,6 +365,26 @@ static void bm_decim_invalid_edge_cost_single(BMEdge *e, Heap *eheap, HeapNode *
   eheap_table[BM_elem_index_get(e)] = BLI_heap_insert(eheap, COST_INVALID, e);
 }
 
+struct EdgeCostData {
+  BMEdge **etable;
+  const Quadric *vquadrics;
+  const float *vweights;
+  float vweight_factor;
+
+  /* Edge aligned output. */
+  float *ecosts;
+  bool *ecosts_valid;
+};
+
+static void bm_decim_build_edge_cost_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct EdgeCostData *data = userdata;
+  data->ecosts_valid[i] = bm_decim_calc_edge_cost(
+      data->etable[i], data->vquadrics, data->vweights, data->vweight_factor, &data->ecosts[i]);
+}
+
 static void bm_decim_build_edge_cost(BMesh *bm,
                                      const Quadric *vquadrics,
                                      const float *vweights,
@@ -353,11 +396,31 @@ static void bm_decim_build_edge_cost(BMesh *bm,
   BMEdge *e;
   uint i;
 
+  /* Calculating the cost is the expensive part, do this for all edges in parallel,
+   * then fill the heap in edge order so the result matches a single threaded build. */
+  BM_mesh_elem_table_ensure(bm, BM_EDGE);
+
+  struct EdgeCostData data = {
+      .etable = bm->etable,
+      .vquadrics = vquadrics,
+      .vweights = vweights,
+      .vweight_factor = vweight_factor,
+      .ecosts = MEM_mallocN(sizeof(*data.ecosts) * (size_t)bm->totedge, __func__),
+      .ecosts_valid = MEM_mallocN(sizeof(*data.ecosts_valid) * (size_t)bm->totedge, __func__),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (bm->totedge > 1024);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, bm->totedge, &data, bm_decim_build_edge_cost_cb, &settings);
+
   BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
-    /* keep sanity check happy */
-    eheap_table[i] = NULL;
-    bm_decim_build_edge_cost_single(e, vquadrics, vweights, vweight_factor, eheap, eheap_table);
+    eheap_table[i] = data.ecosts_valid[i] ? BLI_heap_insert(eheap, data.ecosts[i], e) : NULL;
   }
+
+  MEM_freeN(data.ecosts);
+  MEM_freeN(data.ecosts_valid);
 }
 
 #ifdef USE_SYMMETRY
@@ -404,20 +467,59 @@ static bool bm_edge_symmetry_check_cb(void *user_data,
   return false;
 }
 
-static int *bm_edge_symmetry_map(BMesh *bm, uint symmetry_axis, float limit)
+struct EdgeSymmetryData {
+  KDTree_3d *tree;
+  BMEdge **etable;
+  uint symmetry_axis;
+  float limit;
+  float limit_sq;
+
+  /* Edge aligned output, the closest mirrored edge or -1. */
+  int *edge_found;
+};
+
+static void bm_edge_symmetry_find_cb(void *__restrict userdata,
+                                     const int i,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  const struct EdgeSymmetryData *data = userdata;
+  const uint symmetry_axis = data->symmetry_axis;
+  BMEdge *e = data->etable[i];
   struct KD_Symmetry_Data sym_data;
+  float co[3];
+
+  sym_data.etable = data->etable;
+  sym_data.limit_sq = data->limit_sq;
+
+  mid_v3_v3v3(co, e->v1->co, e->v2->co);
+  co[symmetry_axis] *= -1.0f;
+
+  copy_v3_v3(sym_data.e_v1_co, e->v1->co);
+  copy_v3_v3(sym_data.e_v2_co, e->v2->co);
+  sym_data.e_v1_co[symmetry_axis] *= -1.0f;
+  sym_data.e_v2_co[symmetry_axis] *= -1.0f;
+  sub_v3_v3v3(sym_data.e_dir, sym_data.e_v2_co, sym_data.e_v1_co);
+  sym_data.e_found_index = -1;
+
+  BLI_kdtree_3d_range_search_cb(data->tree, co, data->limit, bm_edge_symmetry_check_cb, &sym_data);
+
+  data->edge_found[i] = sym_data.e_found_index;
+}
+
+static int *bm_edge_symmetry_map(BMesh *bm, uint symmetry_axis, float limit)
+{
   BMIter iter;
   BMEdge *e, **etable;
   uint i;
   int *edge_symmetry_map;
-  const float limit_sq = square_f(limit);
+  int *edge_found;
   KDTree_3d *tree;
 
   tree = BLI_kdtree_3d_new(bm->totedge);
 
   etable = MEM_mallocN(sizeof(*etable) * bm->totedge, __func__);
   edge_symmetry_map = MEM_mallocN(sizeof(*edge_symmetry_map) * bm->totedge, __func__);
+  edge_found = MEM_mallocN(sizeof(*edge_found) * bm->totedge, __func__);
 
   BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
     float co[3];
@@ -429,32 +531,36 @@ static int *bm_edge_symmetry_map(BMesh *bm, uint symmetry_axis, float limit)
 
   BLI_kdtree_3d_balance(tree);
 
-  sym_data.etable = etable;
-  sym_data.limit_sq = limit_sq;
+  /* The tree lookups don't depend on each other, run them in parallel,
+   * then pair up the edges in order (first edge found wins). */
+  {
+    struct EdgeSymmetryData data = {
+        .tree = tree,
+        .etable = etable,
+        .symmetry_axis = symmetry_axis,
+        .limit = limit,
+        .limit_sq = square_f(limit),
+        .edge_found = edge_found,
+    };
+
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.use_threading = (bm->totedge > 1024);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, bm->totedge, &data, bm_edge_symmetry_find_cb, &settings);
+  }
 
-  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+  for (i = 0; i < (uint)bm->totedge; i++) {
     if (edge_symmetry_map[i] == -1) {
-      float co[3];
-      mid_v3_v3v3(co, e->v1->co, e->v2->co);
-      co[symmetry_axis] *= -1.0f;
-
-      copy_v3_v3(sym_data.e_v1_co, e->v1->co);
-      copy_v3_v3(sym_data.e_v2_co, e->v2->co);
-      sym_data.e_v1_co[symmetry_axis] *= -1.0f;
-      sym_data.e_v2_co[symmetry_axis] *= -1.0f;
-      sub_v3_v3v3(sym_data.e_dir, sym_data.e_v2_co, sym_data.e_v1_co);
-      sym_data.e_found_index = -1;
-
-      BLI_kdtree_3d_range_search_cb(tree, co, limit, bm_edge_symmetry_check_cb, &sym_data);
-
-      if (sym_data.e_found_index != -1) {
-        const int i_other = sym_data.e_found_index;
+      if (edge_found[i] != -1) {
+        const int i_other = edge_found[i];
         edge_symmetry_map[i] = i_other;
-        edge_symmetry_map[i_other] = i;
+        edge_symmetry_map[i_other] = (int)i;
       }
     }
   }
 
+  MEM_freeN(edge_found);
   MEM_freeN(etable);
   BLI_kdtree_3d_free(tree);
 
@@ -37,6 +37,7 @@
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_sort_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLI_linklist_stack.h"
@@ -940,6 +941,95 @@ static int isect_bvhtree_point_v3(BVHTree *tree, const float **looptris, const f
   return num_isect;
 }
 
+/**
+ * Overlap callback, run from multiple threads while traversing the trees.
+ *
+ * Skip triangle pairs where one triangle lies entirely on one side of the other's plane,
+ * further away than any of the epsilon tests in #bm_isect_tri_tri use,
+ * these pairs never add any intersections so the result is unchanged.
+ */
+struct OverlapFilterData {
+  BMLoop *(*looptris)[3];
+  float margin;
+};
+
+static bool bm_isect_tri_plane_separated(const float *t_a_cos[3],
+                                         const float *t_b_cos[3],
+                                         const float margin)
+{
+  float t_b_nor[3];
+  float side[3];
+
+  /* Degenerate triangles have a zero normal, these are never separated. */
+  normal_tri_v3(t_b_nor, UNPACK3(t_b_cos));
+
+  for (uint i = 0; i < 3; i++) {
+    float dir[3];
+    sub_v3_v3v3(dir, t_a_cos[i], t_b_cos[0]);
+    side[i] = dot_v3v3(dir, t_b_nor);
+  }
+
+  return ((min_fff(UNPACK3(side)) > margin) || (max_fff(UNPACK3(side)) < -margin));
+}
+
+static bool bm_isect_overlap_filter_cb(void *userdata,
+                                       int index_a,
+                                       int index_b,
+                                       int UNUSED(thread))
+{
+  const struct OverlapFilterData *data = userdata;
+  BMLoop **l_a = data->looptris[index_a];
+  BMLoop **l_b = data->looptris[index_b];
+  const float *t_a_cos[3] = {UNPACK3_EX(, l_a, ->v->co)};
+  const float *t_b_cos[3] = {UNPACK3_EX(, l_b, ->v->co)};
+
+  return !(bm_isect_tri_plane_separated(t_a_cos, t_b_cos, data->margin) ||
+           bm_isect_tri_plane_separated(t_b_cos, t_a_cos, data->margin));
+}
+
+/**
+ * Inside/outside test for each face-group, these only read from the mesh and the trees
+ * so all groups are tested in parallel, removing and flipping faces is done afterwards.
+ */
+struct BooleanGroupTestData {
+  BMFace **ftable;
+  const int *groups_array;
+  const int (*group_index)[2];
+  BVHTree **tree_pair;
+  const float **looptri_coords;
+  int (*test_fn)(BMFace *f, void *user_data);
+  void *user_data;
+
+  /* Output, -1 side for skipped groups. */
+  int *group_side;
+  int *group_hits;
+};
+
+static void bm_isect_boolean_group_test_cb(void *__restrict userdata,
+                                           const int i,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const struct BooleanGroupTestData *data = userdata;
+
+  /* for now assyme this is an OK face to test with (not degenerate!) */
+  BMFace *f = data->ftable[data->groups_array[data->group_index[i][0]]];
+  float co[3];
+  int side = data->test_fn(f, data->user_data);
+
+  if (side == -1) {
+    data->group_side[i] = -1;
+    return;
+  }
+  BLI_assert(ELEM(side, 0, 1));
+  side = !side;
+
+  // BM_face_calc_center_median(f, co);
+  BM_face_calc_point_in_face(f, co);
+
+  data->group_side[i] = side;
+  data->group_hits[i] = isect_bvhtree_point_v3(data->tree_pair[side], data->looptri_coords, co);
+}
+
 #endif /* USE_BVH */
 
 /**
@@ -1090,7 +1180,23 @@ bool BM_mesh_intersect(BMesh *bm,
     flag &= ~BVH_OVERLAP_USE_THREADING;
   }
 #  endif
-  overlap = BLI_bvhtree_overlap_ex(tree_b, tree_a, &tree_overlap_tot, NULL, NULL, 0, flag);
+  {
+    /* Margin for the plane test, all intersection tests use a distance below 'eps_margin',
+     * add some more to account for float precision at the scale of the mesh. */
+    BMIter iter;
+    BMVert *v;
+    float co_max = 0.0f;
+    BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
+      co_max = max_ff(co_max, max_fff(fabsf(v->co[0]), fabsf(v->co[1]), fabsf(v->co[2])));
+    }
+
+    struct OverlapFilterData filter_data = {
+        .looptris = looptris,
+        .margin = (s.epsilon.eps_margin * 4.0f) + (co_max * FLT_EPSILON * 64.0f),
+    };
+    overlap = BLI_bvhtree_overlap_ex(
+        tree_b, tree_a, &tree_overlap_tot, bm_isect_overlap_filter_cb, &filter_data, 0, flag);
+  }
 
   if (overlap) {
     uint i;
@@ -1523,43 +1629,50 @@ bool BM_mesh_intersect(BMesh *bm,
 #endif
 
     /* Check if island is inside/outside */
+    int *group_side = MEM_mallocN(sizeof(*group_side) * (size_t)group_tot, __func__);
+    int *group_hits = MEM_mallocN(sizeof(*group_hits) * (size_t)group_tot, __func__);
+    {
+      struct BooleanGroupTestData data = {
+          .ftable = ftable,
+          .groups_array = groups_array,
+          .group_index = (const int(*)[2])group_index,
+          .tree_pair = tree_pair,
+          .looptri_coords = looptri_coords,
+          .test_fn = test_fn,
+          .user_data = user_data,
+          .group_side = group_side,
+          .group_hits = group_hits,
+      };
+      TaskParallelSettings settings;
+      BLI_parallel_range_settings_defaults(&settings);
+      settings.use_threading = (group_tot > 8);
+      BLI_task_parallel_range(0, group_tot, &data, bm_isect_boolean_group_test_cb, &settings);
+    }
+
     for (i = 0; i < group_tot; i++) {
       int fg = group_index[i][0];
       int fg_end = group_index[i][1] + fg;
-      bool do_remove, do_flip;
+      const int side = group_side[i];
+      const int hits = group_hits[i];
+      bool do_remove = false, do_flip = false;
 
-      {
-        /* for now assyme this is an OK face to test with (not degenerate!) */
-        BMFace *f = ftable[groups_array[fg]];
-        float co[3];
-        int hits;
-        int side = test_fn(f, user_data);
-
-        if (side == -1) {
-          continue;
-        }
-        BLI_assert(ELEM(side, 0, 1));
-        side = !side;
-
-        // BM_face_calc_center_median(f, co);
-        BM_face_calc_point_in_face(f, co);
-
-        hits = isect_bvhtree_point_v3(tree_pair[side], looptri_coords, co);
+      if (side == -1) {
+        continue;
+      }
 
-        switch (boolean_mode) {
-          case BMESH_ISECT_BOOLEAN_ISECT:
-            do_remove = ((hits & 1) != 1);
-            do_flip = false;
-            break;
-          case BMESH_ISECT_BOOLEAN_UNION:
-            do_remove = ((hits & 1) == 1);
-            do_flip = false;
-            break;
-          case BMESH_ISECT_BOOLEAN_DIFFERENCE:
-            do_remove = ((hits & 1) == 1) == side;
-            do_flip = (side == 0);
-            break;
-        }
+      switch (boolean_mode) {
+        case BMESH_ISECT_BOOLEAN_ISECT:
+          do_remove = ((hits & 1) != 1);
+          do_flip = false;
+          break;
+        case BMESH_ISECT_BOOLEAN_UNION:
+          do_remove = ((hits & 1) == 1);
+          do_flip = false;
+          break;
+        case BMESH_ISECT_BOOLEAN_DIFFERENCE:
+          do_remove = ((hits & 1) == 1) == side;
+          do_flip = (side == 0);
+          break;
       }
 
       if (do_remove) {
@@ -1578,6 +1691,9 @@ bool BM_mesh_intersect(BMesh *bm,
       has_edit_boolean |= (do_flip || do_remove);
     }
 
+    MEM_freeN(group_side);
+    MEM_freeN(group_hits);
+
     MEM_freeN(groups_array);
     MEM_freeN(group_index);
 
@@ -93,6 +93,10 @@ void DEG_graph_relations_update(struct Depsgraph *graph,
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update. Is cheaper than DEG_relations_tag_update() when only
+ * dependencies of a single ID are changed, such as when modifiers or constraints are edited. */
+void DEG_relations_tag_update_id(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /* Handle for components to define their dependencies from callbacks.
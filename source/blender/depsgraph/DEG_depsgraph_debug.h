@@ -53,6 +53,18 @@ void DEG_stats_simple(const struct Depsgraph *graph,
                       size_t *r_operations,
                       size_t *r_relations);
 
+void DEG_stats_customdata(const struct Depsgraph *graph,
+                          size_t *r_bytes_copied,
+                          size_t *r_bytes_shared);
+
+void DEG_stats_copy_on_write(const struct Depsgraph *graph, size_t *r_bytes_shared);
+
+void DEG_stats_build(const struct Depsgraph *graph,
+                     double *r_build_time,
+                     bool *r_is_incremental,
+                     int *r_num_full_builds,
+                     int *r_num_incremental_builds);
+
 /* ************************************************ */
 /* Diagram-Based Graph Debugging */
 
@@ -0,0 +1,528 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Incremental update of the dependency graph relations.
+ *
+ * Nodes of the IDs tagged with DEG_relations_tag_update_id() are removed from the graph together
+ * with all their relations, and are built again by the regular builders, which consider all the
+ * other IDs of the graph as already built.
+ *
+ * Relations are considered to be owned by the ID they lead to: builders create relations from the
+ * dependencies of the ID they are building to the operations of that ID. This means relations
+ * leading to a rebuilt ID are re-created by its build, while the relations leading from it to the
+ * kept IDs are to be re-created here.
+ *
+ * Some operations of an ID are created by builders of other IDs, like the ID property operation
+ * a driver of another object reads. The build of the rebuilt ID doesn't re-create those, so when
+ * a relation to a kept ID leads from such an operation the graph is fully rebuilt instead.
+ */
+
+#include "intern/builder/deg_builder_incremental.h"
+
+#include <algorithm>
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_ghash.h"
+#include "BLI_listbase.h"
+#include "BLI_utildefines.h"
+
+extern "C" {
+#include "DNA_layer_types.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_force_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "BKE_collision.h"
+#include "BKE_effect.h"
+} /* extern "C" */
+
+#include "DEG_depsgraph_physics.h"
+
+#include "intern/builder/deg_builder_cache.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/depsgraph_type.h"
+#include "intern/eval/deg_eval_copy_on_write.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace DEG {
+
+namespace {
+
+/* Object which nodes are being rebuilt. */
+struct RebuildObject {
+  Object *object;
+  /* Base of the object in the view layer of the graph, and its index as used by the builders. */
+  Base *base;
+  int base_index;
+  /* Special evaluation flags and CustomData masks can be requested by builders of other IDs, so
+   * they are accumulated with the ones from the previous build. */
+  uint32_t eval_flags;
+  DEGCustomDataMeshMasks customdata_masks;
+};
+
+/* Relation from an operation of a rebuilt ID to a node of a kept ID. The operation is addressed by
+ * its key, since the node itself is re-created. */
+struct KeptRelation {
+  ID *id;
+  NodeType component_type;
+  string component_name;
+  OperationCode opcode;
+  string operation_name;
+  int operation_name_tag;
+  Node *to;
+  const char *description;
+  int flag;
+};
+
+IDNode *node_owner_id_node(const Node *node)
+{
+  if (node->type != NodeType::OPERATION) {
+    return nullptr;
+  }
+  return static_cast<const OperationNode *>(node)->owner->owner;
+}
+
+bool is_rebuilt_node(const set<IDNode *> &rebuilt_id_nodes, const Node *node)
+{
+  IDNode *id_node = node_owner_id_node(node);
+  return id_node != nullptr && rebuilt_id_nodes.find(id_node) != rebuilt_id_nodes.end();
+}
+
+KeptRelation kept_relation_from(const Relation *rel)
+{
+  const OperationNode *op_from = static_cast<const OperationNode *>(rel->from);
+  const ComponentNode *comp_from = op_from->owner;
+  KeptRelation kept_relation;
+  kept_relation.id = comp_from->owner->id_orig;
+  kept_relation.component_type = comp_from->type;
+  kept_relation.component_name = comp_from->name;
+  kept_relation.opcode = op_from->opcode;
+  kept_relation.operation_name = op_from->name;
+  kept_relation.operation_name_tag = op_from->name_tag;
+  kept_relation.to = rel->to;
+  kept_relation.description = rel->name;
+  kept_relation.flag = rel->flag & ~RELATION_FLAG_CYCLIC;
+  return kept_relation;
+}
+
+/* Objects which take part in simulations affect relations of other objects through the cached
+ * effector and collision lists, so changing them requires full rebuild. */
+bool object_has_physics(const Object *object)
+{
+  if (object->pd != nullptr && object->pd->forcefield != PFIELD_NULL) {
+    return true;
+  }
+  if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr) {
+    return true;
+  }
+  if (object->soft != nullptr || object->particlesystem.first != nullptr) {
+    return true;
+  }
+  LISTBASE_FOREACH (ModifierData *, md, &object->modifiers) {
+    if (ELEM(md->type,
+             eModifierType_Softbody,
+             eModifierType_ParticleSystem,
+             eModifierType_Cloth,
+             eModifierType_Collision,
+             eModifierType_Surface,
+             eModifierType_DynamicPaint,
+             eModifierType_Fluid)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool physics_relations_use_object(const Depsgraph *graph, const Object *object)
+{
+  for (int i = 0; i < DEG_PHYSICS_RELATIONS_NUM; i++) {
+    if (graph->physics_relations[i] == nullptr) {
+      continue;
+    }
+    GHASH_FOREACH_BEGIN (ListBase *, relations, graph->physics_relations[i]) {
+      if (relations == nullptr) {
+        continue;
+      }
+      if (i == DEG_PHYSICS_EFFECTOR) {
+        LISTBASE_FOREACH (EffectorRelation *, relation, relations) {
+          if (relation->ob == object) {
+            return true;
+          }
+        }
+      }
+      else {
+        LISTBASE_FOREACH (CollisionRelation *, relation, relations) {
+          if (relation->ob == object) {
+            return true;
+          }
+        }
+      }
+    }
+    GHASH_FOREACH_END();
+  }
+  return false;
+}
+
+/* Check whether nodes of the given ID can be rebuilt without affecting any other ID. */
+bool id_node_can_be_rebuilt(const Depsgraph *graph, const IDNode *id_node)
+{
+  /* TODO(sergey): Support other ID types, starting with the object data. */
+  if (id_node->id_type != ID_OB) {
+    return false;
+  }
+  /* Objects which come from bases are in the graph regardless of the other IDs. */
+  if (!id_node->has_base || id_node->linked_state != DEG_ID_LINKED_DIRECTLY) {
+    return false;
+  }
+  const Object *object = reinterpret_cast<const Object *>(id_node->id_orig);
+  if (object->proxy != nullptr || object->proxy_from != nullptr ||
+      object->proxy_group != nullptr) {
+    return false;
+  }
+  /* Speakers are handled by the scene audio builder. */
+  if (object->type == OB_SPEAKER) {
+    return false;
+  }
+  if (object_has_physics(object) || physics_relations_use_object(graph, object)) {
+    return false;
+  }
+  return true;
+}
+
+/* Remove nodes of the given IDs from the graph, together with all relations they are part of. */
+void remove_id_nodes(Depsgraph *graph, const set<IDNode *> &id_nodes)
+{
+  vector<Relation *> &unused_noop_relations = graph->unused_noop_relations;
+  unused_noop_relations.erase(
+      std::remove_if(unused_noop_relations.begin(),
+                     unused_noop_relations.end(),
+                     [&id_nodes](Relation *rel) {
+                       if (is_rebuilt_node(id_nodes, rel->from) ||
+                           is_rebuilt_node(id_nodes, rel->to)) {
+                         OBJECT_GUARDED_DELETE(rel, Relation);
+                         return true;
+                       }
+                       return false;
+                     }),
+      unused_noop_relations.end());
+  graph->operations.erase(std::remove_if(graph->operations.begin(),
+                                         graph->operations.end(),
+                                         [&id_nodes](OperationNode *op_node) {
+                                           return is_rebuilt_node(id_nodes, op_node);
+                                         }),
+                          graph->operations.end());
+  for (IDNode *id_node : id_nodes) {
+    GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components) {
+      for (OperationNode *op_node : comp_node->operations) {
+        BLI_gset_remove(graph->entry_tags, op_node, nullptr);
+        while (!op_node->outlinks.empty()) {
+          Relation *rel = op_node->outlinks.back();
+          rel->unlink();
+          OBJECT_GUARDED_DELETE(rel, Relation);
+        }
+        while (!op_node->inlinks.empty()) {
+          Relation *rel = op_node->inlinks.back();
+          rel->unlink();
+          OBJECT_GUARDED_DELETE(rel, Relation);
+        }
+      }
+    }
+    GHASH_FOREACH_END();
+    BLI_ghash_remove(graph->id_hash, id_node->id_orig, nullptr, nullptr);
+    graph->id_nodes.erase(std::remove(graph->id_nodes.begin(), graph->id_nodes.end(), id_node),
+                          graph->id_nodes.end());
+    OBJECT_GUARDED_DELETE(id_node, IDNode);
+  }
+}
+
+class DepsgraphIncrementalNodeBuilder : public DepsgraphNodeBuilder {
+ public:
+  DepsgraphIncrementalNodeBuilder(Main *bmain, Depsgraph *graph, DepsgraphBuilderCache *cache)
+      : DepsgraphNodeBuilder(bmain, graph, cache)
+  {
+    scene_ = graph->scene;
+    view_layer_ = graph->view_layer;
+    /* NOTE: Same as in build_view_layer(), after scene CoW there is only one view layer. */
+    view_layer_index_ = 0;
+  }
+
+  /* Find base of the object, and its index as it is passed by build_view_layer(). */
+  bool find_base(Object *object, Base **r_base, int *r_base_index)
+  {
+    int base_index = 0;
+    LISTBASE_FOREACH (Base *, base, &view_layer_->object_bases) {
+      if (!need_pull_base_into_graph(base)) {
+        continue;
+      }
+      if (base->object == object) {
+        *r_base = base;
+        *r_base_index = base_index;
+        return true;
+      }
+      base_index++;
+    }
+    return false;
+  }
+
+  /* Replacement of begin_build() which keeps the graph. Copy-on-write datablocks and entry tags
+   * of the nodes which are about to be removed are stored, so they are re-used by the new
+   * nodes. */
+  void begin_build_incremental(const set<IDNode *> &rebuilt_id_nodes)
+  {
+    id_info_hash_ = BLI_ghash_ptr_new("Depsgraph id hash");
+    for (IDNode *id_node : rebuilt_id_nodes) {
+      IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
+      if (deg_copy_on_write_is_expanded(id_node->id_cow) && id_node->id_orig != id_node->id_cow) {
+        id_info->id_cow = id_node->id_cow;
+      }
+      else {
+        id_info->id_cow = nullptr;
+      }
+      id_info->previously_visible_components_mask = id_node->visible_components_mask;
+      id_info->previous_eval_flags = id_node->eval_flags;
+      id_info->previous_customdata_masks = id_node->customdata_masks;
+      BLI_ghash_insert(id_info_hash_, id_node->id_orig, id_info);
+      id_node->id_cow = nullptr;
+
+      GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components) {
+        for (OperationNode *op_node : comp_node->operations) {
+          if (!BLI_gset_haskey(graph_->entry_tags, op_node)) {
+            continue;
+          }
+          SavedEntryTag entry_tag;
+          entry_tag.id_orig = id_node->id_orig;
+          entry_tag.component_type = comp_node->type;
+          entry_tag.opcode = op_node->opcode;
+          entry_tag.name = op_node->name;
+          entry_tag.name_tag = op_node->name_tag;
+          saved_entry_tags_.push_back(entry_tag);
+        }
+      }
+      GHASH_FOREACH_END();
+    }
+  }
+
+  /* Consider all IDs which are in the graph as built. */
+  void tag_id_nodes_built()
+  {
+    for (IDNode *id_node : graph_->id_nodes) {
+      built_map_.tagBuild(id_node->id_orig);
+    }
+  }
+};
+
+class DepsgraphIncrementalRelationBuilder : public DepsgraphRelationBuilder {
+ public:
+  DepsgraphIncrementalRelationBuilder(Main *bmain,
+                                      Depsgraph *graph,
+                                      DepsgraphBuilderCache *cache)
+      : DepsgraphRelationBuilder(bmain, graph, cache)
+  {
+    scene_ = graph->scene;
+  }
+
+  /* Consider all IDs which are in the graph as built, except of the given ones. */
+  void tag_id_nodes_built(const set<IDNode *> &new_id_nodes)
+  {
+    for (IDNode *id_node : graph_->id_nodes) {
+      if (new_id_nodes.find(id_node) == new_id_nodes.end()) {
+        built_map_.tagBuild(id_node->id_orig);
+      }
+    }
+  }
+};
+
+}  // namespace
+
+bool deg_graph_build_incremental(Main *bmain, Depsgraph *graph)
+{
+  DepsgraphBuilderCache builder_cache;
+  DepsgraphIncrementalNodeBuilder node_builder(bmain, graph, &builder_cache);
+  /* Gather objects to be rebuilt. */
+  vector<RebuildObject> rebuild_objects;
+  set<IDNode *> rebuilt_id_nodes;
+  for (ID *id : graph->need_update_ids) {
+    IDNode *id_node = graph->find_id_node(id);
+    if (id_node == nullptr) {
+      /* ID is not used by this graph, so its relations do not matter. */
+      continue;
+    }
+    if (!id_node_can_be_rebuilt(graph, id_node)) {
+      return false;
+    }
+    RebuildObject rebuild_object;
+    rebuild_object.object = reinterpret_cast<Object *>(id);
+    if (!node_builder.find_base(
+            rebuild_object.object, &rebuild_object.base, &rebuild_object.base_index)) {
+      return false;
+    }
+    rebuild_object.eval_flags = id_node->eval_flags;
+    rebuild_object.customdata_masks = id_node->customdata_masks;
+    rebuild_objects.push_back(rebuild_object);
+    rebuilt_id_nodes.insert(id_node);
+  }
+  if (rebuild_objects.empty()) {
+    return true;
+  }
+  /* Store relations which are not re-created by the builders of the rebuilt IDs, and IDs the
+   * rebuilt ones did depend on. */
+  vector<KeptRelation> kept_relations;
+  set<IDNode *> dependencies;
+  for (IDNode *id_node : rebuilt_id_nodes) {
+    GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->outlinks) {
+          if (!is_rebuilt_node(rebuilt_id_nodes, rel->to)) {
+            kept_relations.push_back(kept_relation_from(rel));
+          }
+        }
+        for (Relation *rel : op_node->inlinks) {
+          IDNode *from_id_node = node_owner_id_node(rel->from);
+          if (from_id_node != nullptr && !is_rebuilt_node(rebuilt_id_nodes, rel->from)) {
+            dependencies.insert(from_id_node);
+          }
+        }
+      }
+    }
+    GHASH_FOREACH_END();
+  }
+  for (Relation *rel : graph->unused_noop_relations) {
+    const bool is_from_rebuilt = is_rebuilt_node(rebuilt_id_nodes, rel->from);
+    const bool is_to_rebuilt = is_rebuilt_node(rebuilt_id_nodes, rel->to);
+    if (is_from_rebuilt && !is_to_rebuilt) {
+      kept_relations.push_back(kept_relation_from(rel));
+    }
+    else if (is_to_rebuilt && !is_from_rebuilt && node_owner_id_node(rel->from) != nullptr) {
+      dependencies.insert(node_owner_id_node(rel->from));
+    }
+  }
+  /* Remove the old nodes. */
+  node_builder.begin_build_incremental(rebuilt_id_nodes);
+  remove_id_nodes(graph, rebuilt_id_nodes);
+  rebuilt_id_nodes.clear();
+  node_builder.tag_id_nodes_built();
+  /* Build new nodes. */
+  const size_t num_kept_id_nodes = graph->id_nodes.size();
+  const size_t num_kept_operations = graph->operations.size();
+  for (const RebuildObject &rebuild_object : rebuild_objects) {
+    node_builder.build_object(
+        rebuild_object.base_index, rebuild_object.object, DEG_ID_LINKED_DIRECTLY, true);
+  }
+  node_builder.end_build();
+  set<IDNode *> new_id_nodes(graph->id_nodes.begin() + num_kept_id_nodes, graph->id_nodes.end());
+  for (size_t i = num_kept_operations; i < graph->operations.size(); i++) {
+    if (new_id_nodes.find(graph->operations[i]->owner->owner) == new_id_nodes.end()) {
+      /* Kept ID got new operations, which are not covered by its copy-on-write relations. */
+      return false;
+    }
+  }
+  /* Build relations. */
+  DepsgraphIncrementalRelationBuilder relation_builder(bmain, graph, &builder_cache);
+  relation_builder.tag_id_nodes_built(new_id_nodes);
+  for (const RebuildObject &rebuild_object : rebuild_objects) {
+    relation_builder.build_object(rebuild_object.base, rebuild_object.object);
+  }
+  for (const KeptRelation &kept_relation : kept_relations) {
+    IDNode *id_node = graph->find_id_node(kept_relation.id);
+    if (id_node == nullptr) {
+      return false;
+    }
+    ComponentNode *comp_node = id_node->find_component(kept_relation.component_type,
+                                                       kept_relation.component_name.c_str());
+    if (comp_node == nullptr) {
+      return false;
+    }
+    OperationNode *op_node = comp_node->find_operation(kept_relation.opcode,
+                                                       kept_relation.operation_name.c_str(),
+                                                       kept_relation.operation_name_tag);
+    if (op_node == nullptr) {
+      /* Operation was created by the builder of another ID, like the ID property a driver of a
+       * kept object reads, and that builder is not run again. The relation can't be re-created
+       * without it, so the graph is to be fully rebuilt. */
+      return false;
+    }
+    if (graph->check_nodes_connected(op_node, kept_relation.to, kept_relation.description)) {
+      continue;
+    }
+    graph->add_new_relation(
+        op_node, kept_relation.to, kept_relation.description, kept_relation.flag);
+  }
+  for (IDNode *id_node : new_id_nodes) {
+    relation_builder.build_copy_on_write_relations(id_node);
+  }
+  for (IDNode *id_node : new_id_nodes) {
+    relation_builder.build_driver_relations(id_node);
+  }
+  /* IDs which are no longer used by the rebuilt ones might have been pulled into the graph or made
+   * visible by them, which is only detected by the full build. */
+  for (const RebuildObject &rebuild_object : rebuild_objects) {
+    IDNode *id_node = graph->find_id_node(&rebuild_object.object->id);
+    id_node->eval_flags |= rebuild_object.eval_flags;
+    id_node->customdata_masks |= rebuild_object.customdata_masks;
+    GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components) {
+      GHASH_FOREACH_BEGIN (OperationNode *, op_node, comp_node->operations_map) {
+        for (Relation *rel : op_node->inlinks) {
+          dependencies.erase(node_owner_id_node(rel->from));
+        }
+      }
+      GHASH_FOREACH_END();
+    }
+    GHASH_FOREACH_END();
+  }
+  for (IDNode *id_node : dependencies) {
+    if (!id_node->has_base) {
+      return false;
+    }
+  }
+  /* Prepare the graph for finalization, which is done for the whole graph. */
+  for (Relation *rel : graph->unused_noop_relations) {
+    rel->from->outlinks.push_back(rel);
+    rel->to->inlinks.push_back(rel);
+  }
+  graph->unused_noop_relations.clear();
+  for (OperationNode *op_node : graph->operations) {
+    for (Relation *rel : op_node->inlinks) {
+      rel->flag &= ~RELATION_FLAG_CYCLIC;
+    }
+  }
+  for (size_t i = 0; i < num_kept_id_nodes; i++) {
+    IDNode *id_node = graph->id_nodes[i];
+    id_node->previously_visible_components_mask = id_node->visible_components_mask;
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+    GHASH_FOREACH_BEGIN (ComponentNode *, comp_node, id_node->components) {
+      comp_node->affects_directly_visible = false;
+    }
+    GHASH_FOREACH_END();
+  }
+  return true;
+}
+
+}  // namespace DEG
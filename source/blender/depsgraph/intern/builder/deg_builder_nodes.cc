@@ -174,13 +174,15 @@ IDNode *DepsgraphNodeBuilder::add_id_node(ID *id)
     id_info->id_cow = nullptr;
   }
   id_node = graph_->add_id_node(id, id_cow);
-  id_node->previously_visible_components_mask = previously_visible_components_mask;
-  id_node->previous_eval_flags = previous_eval_flags;
-  id_node->previous_customdata_masks = previous_customdata_masks;
   /* Currently all ID nodes are supposed to have copy-on-write logic.
    *
    * NOTE: Zero number of components indicates that ID node was just created. */
   if (BLI_ghash_len(id_node->components) == 0) {
+    /* NOTE: Only initialize state of the new nodes, nodes which are kept by an incremental build
+     * have no ID info but do know their previous state. */
+    id_node->previously_visible_components_mask = previously_visible_components_mask;
+    id_node->previous_eval_flags = previous_eval_flags;
+    id_node->previous_customdata_masks = previous_customdata_masks;
     ComponentNode *comp_cow = id_node->add_component(NodeType::COPY_ON_WRITE);
     OperationNode *op_cow = comp_cow->add_operation(
         function_bind(deg_evaluate_copy_on_write, _1, id_node),
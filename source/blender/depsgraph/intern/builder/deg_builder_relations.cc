@@ -33,6 +33,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 extern "C" {
@@ -2559,10 +2560,38 @@ void DepsgraphRelationBuilder::build_scene_speakers(Scene * /*scene*/, ViewLayer
   }
 }
 
+namespace {
+
+struct CopyOnWriteRelationsData {
+  DepsgraphRelationBuilder *builder;
+  Depsgraph *graph;
+};
+
+void build_copy_on_write_component_relations_func(void *__restrict data_v,
+                                                  const int i,
+                                                  const TaskParallelTLS *__restrict /*tls*/)
+{
+  CopyOnWriteRelationsData *data = (CopyOnWriteRelationsData *)data_v;
+  data->builder->build_copy_on_write_component_relations(data->graph->id_nodes[i]);
+}
+
+}  // namespace
+
 void DepsgraphRelationBuilder::build_copy_on_write_relations()
 {
+  /* Relations between operations of the same ID only touch nodes of that ID, so IDs are handled
+   * in parallel. Relations to other IDs are added afterwards in the order of ID nodes, which keeps
+   * the resulting graph independent from threads scheduling. */
+  CopyOnWriteRelationsData data;
+  data.builder = this;
+  data.graph = graph_;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(
+      0, graph_->id_nodes.size(), &data, build_copy_on_write_component_relations_func, &settings);
   for (IDNode *id_node : graph_->id_nodes) {
-    build_copy_on_write_relations(id_node);
+    build_copy_on_write_dependency_relations(id_node);
   }
 }
 
@@ -2596,6 +2625,12 @@ void DepsgraphRelationBuilder::build_nested_shapekey(ID *owner, Key *key)
 }
 
 void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
+{
+  build_copy_on_write_component_relations(id_node);
+  build_copy_on_write_dependency_relations(id_node);
+}
+
+void DepsgraphRelationBuilder::build_copy_on_write_component_relations(IDNode *id_node)
 {
   ID *id_orig = id_node->id_orig;
   const ID_Type id_type = GS(id_orig->name);
@@ -2687,6 +2722,12 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * to Mesh copy-on-write already. */
   }
   GHASH_FOREACH_END();
+}
+
+void DepsgraphRelationBuilder::build_copy_on_write_dependency_relations(IDNode *id_node)
+{
+  ID *id_orig = id_node->id_orig;
+  OperationKey copy_on_write_key(id_orig, NodeType::COPY_ON_WRITE, OperationCode::COPY_ON_WRITE);
   /* TODO(sergey): This solves crash for now, but causes too many
    * updates potentially. */
   if (GS(id_orig->name) == ID_OB) {
@@ -301,8 +301,16 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
                                          bool add_absorption,
                                          const char *name);
 
+  /* NOTE: Copy-on-write relations are the only relations built in parallel. Builders of objects
+   * and other IDs share the built map, the RNA node query and builder caches and the lazily built
+   * physics relations, and add relations to nodes of other IDs, so they are run serially. */
   virtual void build_copy_on_write_relations();
   virtual void build_copy_on_write_relations(IDNode *id_node);
+  /* Relations from the copy-on-write operation to other operations of the same ID. Only modifies
+   * nodes of the given ID, so can be called for different IDs from multiple threads. */
+  void build_copy_on_write_component_relations(IDNode *id_node);
+  /* Relations to copy-on-write operations of other IDs. */
+  void build_copy_on_write_dependency_relations(IDNode *id_node);
   virtual void build_driver_relations();
   virtual void build_driver_relations(IDNode *id_node);
 
@@ -358,6 +366,7 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   static void constraint_walk(bConstraint *con, ID **idpoin, bool is_reference, void *user_data);
 
+ protected:
   /* State which demotes currently built entities. */
   Scene *scene_;
 
@@ -65,9 +65,9 @@ void deg_graph_remove_unused_noops(Depsgraph *graph)
       Relation *rel_in = to_remove->inlinks[0];
       Node *dependency = rel_in->from;
 
-      /* Remove the relation. */
+      /* Remove the relation. It is not freed yet, see Depsgraph::unused_noop_relations. */
       rel_in->unlink();
-      OBJECT_GUARDED_DELETE(rel_in, Relation);
+      graph->unused_noop_relations.push_back(rel_in);
       num_removed_relations++;
 
       /* Queue parent no-op node that has now become unused. */
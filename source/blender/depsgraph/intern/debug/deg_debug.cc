@@ -30,12 +30,23 @@
 
 #include "PIL_time_utildefines.h"
 
+#include "BKE_customdata.h"
 #include "BKE_global.h"
 
 namespace DEG {
 
 DepsgraphDebug::DepsgraphDebug()
-    : flags(G.debug), is_ever_evaluated(false), graph_evaluation_start_time_(0)
+    : flags(G.debug),
+      is_ever_evaluated(false),
+      customdata_bytes_copied(0),
+      customdata_bytes_shared(0),
+      build_time(0.0),
+      is_build_incremental(false),
+      num_full_builds(0),
+      num_incremental_builds(0),
+      graph_evaluation_start_time_(0),
+      customdata_bytes_copied_start_(0),
+      customdata_bytes_shared_start_(0)
 {
 }
 
@@ -46,6 +57,8 @@ bool DepsgraphDebug::do_time_debug() const
 
 void DepsgraphDebug::begin_graph_evaluation()
 {
+  CustomData_memory_stats_get(&customdata_bytes_copied_start_, &customdata_bytes_shared_start_);
+
   if (!do_time_debug()) {
     return;
   }
@@ -61,6 +74,10 @@ void DepsgraphDebug::begin_graph_evaluation()
 
 void DepsgraphDebug::end_graph_evaluation()
 {
+  CustomData_memory_stats_get(&customdata_bytes_copied, &customdata_bytes_shared);
+  customdata_bytes_copied -= customdata_bytes_copied_start_;
+  customdata_bytes_shared -= customdata_bytes_shared_start_;
+
   if (!do_time_debug()) {
     return;
   }
@@ -68,6 +85,9 @@ void DepsgraphDebug::end_graph_evaluation()
   const double graph_eval_end_time = PIL_check_seconds_timer();
   printf("Depsgraph updated in %f seconds.\n", graph_eval_end_time - graph_evaluation_start_time_);
   printf("Depsgraph evaluation FPS: %f\n", 1.0f / fps_samples_.get_averaged());
+  printf("Depsgraph CustomData: %zu bytes copied, %zu bytes shared\n",
+         customdata_bytes_copied,
+         customdata_bytes_shared);
 
   is_ever_evaluated = true;
 }
@@ -52,6 +52,18 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* CustomData layer memory copied and shared (instead of copied) during the last evaluation.
+   * NOTE: Other dependency graphs evaluated at the same time are counted too. */
+  size_t customdata_bytes_copied;
+  size_t customdata_bytes_shared;
+
+  /* Time spent on the last build or update of the relations, and whether it was incremental. */
+  double build_time;
+  bool is_build_incremental;
+  /* Number of full and incremental relations builds done for this dependency graph. */
+  int num_full_builds;
+  int num_incremental_builds;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
@@ -61,6 +73,10 @@ class DepsgraphDebug {
    */
   double graph_evaluation_start_time_;
 
+  /* Totals of #CustomData_memory_stats_get when the last graph evaluation began. */
+  size_t customdata_bytes_copied_start_;
+  size_t customdata_bytes_shared_start_;
+
   AveragedTimeSampler<MAX_FPS_COUNTERS> fps_samples_;
 };
 
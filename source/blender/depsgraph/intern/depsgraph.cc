@@ -172,6 +172,11 @@ void Depsgraph::clear_id_nodes()
   /* Clear containers. */
   BLI_ghash_clear(id_hash, nullptr, nullptr);
   id_nodes.clear();
+  /* Relations removed from no-op nodes are not referenced by any node. */
+  for (Relation *rel : unused_noop_relations) {
+    OBJECT_GUARDED_DELETE(rel, Relation);
+  }
+  unused_noop_relations.clear();
   /* Clear physics relation caches. */
   clear_physics_relations(this);
 }
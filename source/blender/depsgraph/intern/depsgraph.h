@@ -110,6 +110,11 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* Original IDs which nodes and relations are to be rebuilt on the next relations update, while
+   * the rest of the graph is kept as-is. Is ignored when need_update is set, since the whole graph
+   * is rebuilt then. */
+  set<ID *> need_update_ids;
+
   /* Indicates which ID types were updated. */
   char id_type_updated[MAX_LIBARRAY];
 
@@ -131,6 +136,11 @@ struct Depsgraph {
   /* All operation nodes, sorted in order of single-thread traversal order. */
   OperationNodes operations;
 
+  /* Relations which were removed from the graph by deg_graph_remove_unused_noops(). They are
+   * owned by the graph, so that incremental relations update can bring them back when the no-op
+   * becomes used again. */
+  vector<Relation *> unused_noop_relations;
+
   /* Spin lock for threading-critical operations.
    * Mainly used by graph evaluation. */
   SpinLock lock;
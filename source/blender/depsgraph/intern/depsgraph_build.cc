@@ -44,10 +44,12 @@ extern "C" {
 #include "DEG_depsgraph.h"
 #include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_debug.h"
+#include "DEG_depsgraph_query.h"
 
 #include "builder/deg_builder.h"
 #include "builder/deg_builder_cache.h"
 #include "builder/deg_builder_cycle.h"
+#include "builder/deg_builder_incremental.h"
 #include "builder/deg_builder_nodes.h"
 #include "builder/deg_builder_relations.h"
 #include "builder/deg_builder_transitive.h"
@@ -223,6 +225,27 @@ static void graph_build_finalize_common(DEG::Depsgraph *deg_graph, Main *bmain)
 #endif
   /* Relations are up to date. */
   deg_graph->need_update = false;
+  deg_graph->need_update_ids.clear();
+}
+
+static void graph_build_statistics_store(DEG::Depsgraph *deg_graph,
+                                         const double start_time,
+                                         const bool is_incremental)
+{
+  DEG::DepsgraphDebug &debug = deg_graph->debug;
+  debug.build_time = PIL_check_seconds_timer() - start_time;
+  debug.is_build_incremental = is_incremental;
+  if (is_incremental) {
+    debug.num_incremental_builds++;
+  }
+  else {
+    debug.num_full_builds++;
+  }
+  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+    printf("Depsgraph %s in %f seconds.\n",
+           is_incremental ? "updated incrementally" : "built",
+           debug.build_time);
+  }
 }
 
 /* Build depsgraph for the given scene layer, and dump results in given graph container. */
@@ -231,10 +254,7 @@ void DEG_graph_build_from_view_layer(Depsgraph *graph,
                                      Scene *scene,
                                      ViewLayer *view_layer)
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = PIL_check_seconds_timer();
-  }
+  const double start_time = PIL_check_seconds_timer();
   DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
   /* Perform sanity checks. */
   BLI_assert(BLI_findindex(&scene->view_layers, view_layer) != -1);
@@ -255,9 +275,7 @@ void DEG_graph_build_from_view_layer(Depsgraph *graph,
   /* Finalize building. */
   graph_build_finalize_common(deg_graph, bmain);
   /* Finish statistics. */
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
-  }
+  graph_build_statistics_store(deg_graph, start_time, false);
 }
 
 void DEG_graph_build_for_render_pipeline(Depsgraph *graph,
@@ -265,10 +283,7 @@ void DEG_graph_build_for_render_pipeline(Depsgraph *graph,
                                          Scene *scene,
                                          ViewLayer *view_layer)
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = PIL_check_seconds_timer();
-  }
+  const double start_time = PIL_check_seconds_timer();
   DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
   /* Perform sanity checks. */
   BLI_assert(deg_graph->scene == scene);
@@ -289,18 +304,13 @@ void DEG_graph_build_for_render_pipeline(Depsgraph *graph,
   /* Finalize building. */
   graph_build_finalize_common(deg_graph, bmain);
   /* Finish statistics. */
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
-  }
+  graph_build_statistics_store(deg_graph, start_time, false);
 }
 
 void DEG_graph_build_for_compositor_preview(
     Depsgraph *graph, Main *bmain, Scene *scene, struct ViewLayer *view_layer, bNodeTree *nodetree)
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = PIL_check_seconds_timer();
-  }
+  const double start_time = PIL_check_seconds_timer();
   DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
   /* Perform sanity checks. */
   BLI_assert(deg_graph->scene == scene);
@@ -323,9 +333,7 @@ void DEG_graph_build_for_compositor_preview(
   /* Finalize building. */
   graph_build_finalize_common(deg_graph, bmain);
   /* Finish statistics. */
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
-  }
+  graph_build_statistics_store(deg_graph, start_time, false);
 }
 
 /* Optimized builders for dependency graph built from a given set of IDs.
@@ -434,10 +442,7 @@ void DEG_graph_build_from_ids(Depsgraph *graph,
                               ID **ids,
                               const int num_ids)
 {
-  double start_time = 0.0;
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    start_time = PIL_check_seconds_timer();
-  }
+  const double start_time = PIL_check_seconds_timer();
   DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
   /* Perform sanity checks. */
   BLI_assert(BLI_findindex(&scene->view_layers, view_layer) != -1);
@@ -465,9 +470,7 @@ void DEG_graph_build_from_ids(Depsgraph *graph,
   /* Finalize building. */
   graph_build_finalize_common(deg_graph, bmain);
   /* Finish statistics. */
-  if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
-    printf("Depsgraph built in %f seconds.\n", PIL_check_seconds_timer() - start_time);
-  }
+  graph_build_statistics_store(deg_graph, start_time, false);
 }
 
 /* Tag graph relations for update. */
@@ -488,13 +491,69 @@ void DEG_graph_tag_relations_update(Depsgraph *graph)
   }
 }
 
+/* Rebuild relations of the IDs tagged with DEG_relations_tag_update_id(), keeping the rest of the
+ * graph. Returns false if the graph is to be fully rebuilt instead. */
+static bool graph_build_incremental(DEG::Depsgraph *deg_graph, Main *bmain)
+{
+  if (deg_graph->is_render_pipeline_depsgraph) {
+    return false;
+  }
+  /* Transitive reduction removes relations which the incremental update relies on. */
+  if (G.debug_value == 799) {
+    return false;
+  }
+  const double start_time = PIL_check_seconds_timer();
+  if (!DEG::deg_graph_build_incremental(bmain, deg_graph)) {
+    DEG_DEBUG_PRINTF(reinterpret_cast<Depsgraph *>(deg_graph),
+                     BUILD,
+                     "Incremental relations update is not possible, doing full rebuild.\n");
+    return false;
+  }
+  graph_build_finalize_common(deg_graph, bmain);
+  graph_build_statistics_store(deg_graph, start_time, true);
+  return true;
+}
+
+/* Compare relations updated incrementally with a full build of a temporary graph. */
+static bool graph_build_incremental_validate(Depsgraph *graph,
+                                             Main *bmain,
+                                             Scene *scene,
+                                             ViewLayer *view_layer)
+{
+  Depsgraph *temp_depsgraph = DEG_graph_new(bmain, scene, view_layer, DEG_get_mode(graph));
+  DEG_graph_build_from_view_layer(temp_depsgraph, bmain, scene, view_layer);
+  const bool valid = DEG_debug_compare(temp_depsgraph, graph);
+  DEG_graph_free(temp_depsgraph);
+  if (!valid) {
+    fprintf(stderr,
+            "ERROR! Incremental relations update differs from full build, rebuilding the "
+            "dependency graph.\n");
+    BLI_assert(!"Incremental relations update differs from full build");
+  }
+  return valid;
+}
+
 /* Create or update relations in the specified graph. */
 void DEG_graph_relations_update(Depsgraph *graph, Main *bmain, Scene *scene, ViewLayer *view_layer)
 {
   DEG::Depsgraph *deg_graph = (DEG::Depsgraph *)graph;
   if (!deg_graph->need_update) {
-    /* Graph is up to date, nothing to do. */
-    return;
+    if (deg_graph->need_update_ids.empty()) {
+      /* Graph is up to date, nothing to do. */
+      return;
+    }
+    if (graph_build_incremental(deg_graph, bmain)) {
+#ifdef NDEBUG
+      if ((G.debug & G_DEBUG_DEPSGRAPH_BUILD) == 0) {
+        return;
+      }
+#endif
+      /* Make sure the result is the same as a full build would give, fall back to the full build
+       * otherwise. */
+      if (graph_build_incremental_validate(graph, bmain, scene, view_layer)) {
+        return;
+      }
+    }
   }
   DEG_graph_build_from_view_layer(graph, bmain, scene, view_layer);
 }
@@ -507,3 +566,18 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+/* Tag relations of the given ID for update. Only nodes and relations of this ID are rebuilt on the
+ * next relations update, unless the whole graph is tagged for update as well. */
+void DEG_relations_tag_update_id(Main *bmain, ID *id)
+{
+  DEG_GLOBAL_DEBUG_PRINTF(TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  for (DEG::Depsgraph *depsgraph : DEG::get_all_registered_graphs(bmain)) {
+    if (depsgraph->find_id_node(id) == nullptr) {
+      continue;
+    }
+    /* NOTE: Unlike DEG_graph_tag_relations_update() the scene is not tagged, since bases are not
+     * changed. The ID itself is tagged by the caller, same as after full relations update. */
+    depsgraph->need_update_ids.insert(id);
+  }
+}
@@ -23,7 +23,12 @@
  * Implementation of tools for debugging the depsgraph
  */
 
+#include <algorithm>
+#include <iterator>
+#include <set>
+
 #include "BLI_ghash.h"
+#include "BLI_string.h"
 #include "BLI_utildefines.h"
 
 extern "C" {
@@ -41,8 +46,10 @@ extern "C" {
 #include "intern/depsgraph.h"
 #include "intern/depsgraph_relation.h"
 #include "intern/depsgraph_type.h"
+#include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 #include "intern/node/deg_node_time.h"
 
 void DEG_debug_flags_set(Depsgraph *depsgraph, int flags)
@@ -69,22 +76,111 @@ const char *DEG_debug_name_get(struct Depsgraph *depsgraph)
   return deg_graph->debug.name.c_str();
 }
 
+namespace DEG {
+namespace {
+
+/* Identifier of a node which does not depend on the node pointer, so nodes of different graphs
+ * can be compared. */
+string node_compare_key(const Node *node)
+{
+  if (node->type == NodeType::TIMESOURCE) {
+    return node->name;
+  }
+  if (node->type != NodeType::OPERATION) {
+    return node->identifier();
+  }
+  const OperationNode *op_node = static_cast<const OperationNode *>(node);
+  const ComponentNode *comp_node = op_node->owner;
+  char id_ptr[24];
+  BLI_snprintf(id_ptr, sizeof(id_ptr), "%p", comp_node->owner->id_orig);
+  return string(id_ptr) + " " + comp_node->owner->name + " / " +
+         nodeTypeAsString(comp_node->type) + " " + comp_node->name + " / " +
+         operationCodeAsString(op_node->opcode) + " " + op_node->name + " " +
+         std::to_string(op_node->name_tag);
+}
+
+std::multiset<string> relations_compare_keys(const Depsgraph *graph)
+{
+  std::multiset<string> keys;
+  for (const OperationNode *op_node : graph->operations) {
+    for (const Relation *rel : op_node->inlinks) {
+      keys.insert(node_compare_key(rel->from) + " -> " + node_compare_key(rel->to) + " (" +
+                  rel->name + ", " + std::to_string(rel->flag & ~RELATION_FLAG_CYCLIC) + ")");
+    }
+  }
+  return keys;
+}
+
+std::multiset<string> id_nodes_compare_keys(const Depsgraph *graph)
+{
+  std::multiset<string> keys;
+  for (const IDNode *id_node : graph->id_nodes) {
+    char id_ptr[24];
+    BLI_snprintf(id_ptr, sizeof(id_ptr), "%p", id_node->id_orig);
+    keys.insert(string(id_ptr) + " " + id_node->name + " (linked_state " +
+                std::to_string(id_node->linked_state) + ", has_base " +
+                std::to_string(id_node->has_base) + ", is_directly_visible " +
+                std::to_string(id_node->is_directly_visible) + ")");
+  }
+  return keys;
+}
+
+/* Print the first difference between the given sets, returns true if there are no differences. */
+bool compare_keys_report(const char *what,
+                         const std::multiset<string> &keys1,
+                         const std::multiset<string> &keys2)
+{
+  vector<string> only_in_first, only_in_second;
+  std::set_difference(keys1.begin(),
+                      keys1.end(),
+                      keys2.begin(),
+                      keys2.end(),
+                      std::back_inserter(only_in_first));
+  std::set_difference(keys2.begin(),
+                      keys2.end(),
+                      keys1.begin(),
+                      keys1.end(),
+                      std::back_inserter(only_in_second));
+  if (only_in_first.empty() && only_in_second.empty()) {
+    return true;
+  }
+  if (!only_in_first.empty()) {
+    fprintf(stderr,
+            "%d %s only exist in the first graph, first one is %s\n",
+            (int)only_in_first.size(),
+            what,
+            only_in_first.front().c_str());
+  }
+  if (!only_in_second.empty()) {
+    fprintf(stderr,
+            "%d %s only exist in the second graph, first one is %s\n",
+            (int)only_in_second.size(),
+            what,
+            only_in_second.front().c_str());
+  }
+  return false;
+}
+
+}  // namespace
+}  // namespace DEG
+
 bool DEG_debug_compare(const struct Depsgraph *graph1, const struct Depsgraph *graph2)
 {
   BLI_assert(graph1 != nullptr);
   BLI_assert(graph2 != nullptr);
   const DEG::Depsgraph *deg_graph1 = reinterpret_cast<const DEG::Depsgraph *>(graph1);
   const DEG::Depsgraph *deg_graph2 = reinterpret_cast<const DEG::Depsgraph *>(graph2);
-  if (deg_graph1->operations.size() != deg_graph2->operations.size()) {
-    return false;
-  }
-  /* TODO(sergey): Currently we only do real stupid check,
-   * which is fast but which isn't 100% reliable.
-   *
-   * Would be cool to make it more robust, but it's good enough
-   * for now. Also, proper graph check is actually NP-complex
-   * problem. */
-  return true;
+  /* NOTE: Nodes are compared by their keys, which is enough for the graphs built from the same
+   * state of the main database. Relations between the same nodes are compared by their names and
+   * flags only, order of the relations is not taken into account. */
+  bool is_equal = true;
+  is_equal &= DEG::compare_keys_report("ID nodes",
+                                       DEG::id_nodes_compare_keys(deg_graph1),
+                                       DEG::id_nodes_compare_keys(deg_graph2));
+  is_equal &= DEG::compare_keys_report("relations",
+                                       DEG::relations_compare_keys(deg_graph1),
+                                       DEG::relations_compare_keys(deg_graph2));
+  return is_equal;
 }
 
 bool DEG_debug_graph_relations_validate(Depsgraph *graph,
@@ -247,6 +343,60 @@ void DEG_stats_simple(const Depsgraph *graph,
   }
 }
 
+/**
+ * Obtain the amount of CustomData copied and shared by the last evaluation of the depsgraph.
+ * \param[out] r_bytes_copied  Bytes of layer data which had to be duplicated
+ * \param[out] r_bytes_shared  Bytes of layer data which were shared with the original instead
+ */
+void DEG_stats_customdata(const Depsgraph *graph, size_t *r_bytes_copied, size_t *r_bytes_shared)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+  if (r_bytes_copied) {
+    *r_bytes_copied = deg_graph->debug.customdata_bytes_copied;
+  }
+  if (r_bytes_shared) {
+    *r_bytes_shared = deg_graph->debug.customdata_bytes_shared;
+  }
+}
+
+/**
+ * Obtain the amount of geometry data which copy-on-write datablocks of the depsgraph share with
+ * the original datablocks instead of having their own copy.
+ */
+void DEG_stats_copy_on_write(const Depsgraph *graph, size_t *r_bytes_shared)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+  size_t bytes_shared = 0;
+  for (const DEG::IDNode *id_node : deg_graph->id_nodes) {
+    if (id_node->id_cow == nullptr || id_node->id_cow == id_node->id_orig) {
+      continue;
+    }
+    bytes_shared += DEG::deg_copy_on_write_shared_memory_size(id_node->id_cow);
+  }
+  *r_bytes_shared = bytes_shared;
+}
+
+void DEG_stats_build(const Depsgraph *graph,
+                     double *r_build_time,
+                     bool *r_is_incremental,
+                     int *r_num_full_builds,
+                     int *r_num_incremental_builds)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+  if (r_build_time) {
+    *r_build_time = deg_graph->debug.build_time;
+  }
+  if (r_is_incremental) {
+    *r_is_incremental = deg_graph->debug.is_build_incremental;
+  }
+  if (r_num_full_builds) {
+    *r_num_full_builds = deg_graph->debug.num_full_builds;
+  }
+  if (r_num_incremental_builds) {
+    *r_num_incremental_builds = deg_graph->debug.num_incremental_builds;
+  }
+}
+
 static DEG::string depsgraph_name_for_logging(struct Depsgraph *depsgraph)
 {
   const char *name = DEG_debug_name_get(depsgraph);
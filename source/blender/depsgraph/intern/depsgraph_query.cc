@@ -51,6 +51,12 @@ extern "C" {
 #include "intern/eval/deg_eval_copy_on_write.h"
 #include "intern/node/deg_node_id.h"
 
+struct Main *DEG_get_bmain(const Depsgraph *graph)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
+  return deg_graph->bmain;
+}
+
 struct Scene *DEG_get_input_scene(const Depsgraph *graph)
 {
   const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(graph);
@@ -315,7 +321,7 @@ bool DEG_is_fully_evaluated(const struct Depsgraph *depsgraph)
 {
   const DEG::Depsgraph *deg_graph = (const DEG::Depsgraph *)depsgraph;
   /* Check whether relations are up to date. */
-  if (deg_graph->need_update) {
+  if (deg_graph->need_update || !deg_graph->need_update_ids.empty()) {
     return false;
   }
   /* Check whether IDs are up to date. */
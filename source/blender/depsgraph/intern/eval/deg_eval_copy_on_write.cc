@@ -41,6 +41,7 @@
 #include "BLI_utildefines.h"
 
 #include "BKE_curve.h"
+#include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_gpencil.h"
 #include "BKE_idprop.h"
@@ -57,10 +58,12 @@ extern "C" {
 #include "DNA_ID.h"
 #include "DNA_anim_types.h"
 #include "DNA_armature_types.h"
+#include "DNA_hair_types.h"
 #include "DNA_mesh_types.h"
 #include "DNA_modifier_types.h"
 #include "DNA_object_types.h"
 #include "DNA_particle_types.h"
+#include "DNA_pointcloud_types.h"
 #include "DNA_rigidbody_types.h"
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
@@ -278,7 +281,7 @@ struct ValidateData {
 
 /* Similar to generic BKE_id_copy() but does not require main and assumes pointer
  * is already allocated. */
-bool id_copy_inplace_no_main(const ID *id, ID *newid)
+bool id_copy_inplace_no_main(const ID *id, ID *newid, const int extra_flag = 0)
 {
   const ID *id_for_copy = id;
 
@@ -288,7 +291,10 @@ bool id_copy_inplace_no_main(const ID *id, ID *newid)
 #endif
 
   bool result = BKE_id_copy_ex(
-      nullptr, (ID *)id_for_copy, &newid, (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE));
+      nullptr,
+      (ID *)id_for_copy,
+      &newid,
+      (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE | extra_flag));
 
 #ifdef NESTED_ID_NASTY_WORKAROUND
   if (result) {
@@ -322,6 +328,17 @@ bool scene_copy_inplace_no_main(const Scene *scene, Scene *new_scene)
   return result;
 }
 
+/* Whether geometry arrays of the copied datablocks can be shared with the original ones.
+ *
+ * Evaluation only writes to the shared CustomData layers after making its own copy of them, but
+ * the original ones are written to in-place by tools. This is fine for the graphs which are
+ * evaluated from the main thread, but not for the ones which are used by render jobs while the
+ * interface is not locked. */
+bool copy_on_write_share_geometry(const Depsgraph *depsgraph)
+{
+  return depsgraph->mode == DAG_EVAL_VIEWPORT && !depsgraph->is_render_pipeline_depsgraph;
+}
+
 /* For the given scene get view layer which corresponds to an original for the
  * scene's evaluated one. This depends on how the scene is pulled into the
  * dependency  graph. */
@@ -814,6 +831,7 @@ void update_id_after_copy(const Depsgraph *depsgraph,
   }
   update_edit_mode_pointers(depsgraph, id_orig, id_cow);
   BKE_animsys_update_driver_array(id_cow);
+  BKE_animsys_eval_cache_invalidate_all();
 }
 
 /* This callback is used to validate that all nested ID data-blocks are
@@ -861,8 +879,6 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
   }
   // BLI_assert(check_datablock_expanded(id_cow) == false);
   /* Copy data from original ID to a copied version. */
-  /* TODO(sergey): Avoid doing full ID copy somehow, make Mesh to reference
-   * original geometry arrays for until those are modified. */
   /* TODO(sergey): We do some trickery with temp bmain and extra ID pointer
    * just to be able to use existing API. Ideally we need to replace this with
    * in-place copy from existing datablock to a prepared memory.
@@ -885,9 +901,14 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
       }
       break;
     }
-    case ID_ME: {
-      /* TODO(sergey): Ideally we want to handle meshes in a special
-       * manner here to avoid initial copy of all the geometry arrays. */
+    case ID_ME:
+    case ID_PT:
+    case ID_HA: {
+      /* Avoid initial copy of all the geometry arrays, CustomData layers are shared with the
+       * original and only copied when evaluation writes to them. */
+      if (copy_on_write_share_geometry(depsgraph)) {
+        done = id_copy_inplace_no_main(id_orig, id_cow, LIB_ID_COPY_CD_REFERENCE);
+      }
       break;
     }
     default:
@@ -1113,6 +1134,35 @@ bool deg_copy_on_write_is_expanded(const ID *id_cow)
   return check_datablock_expanded(id_cow);
 }
 
+size_t deg_copy_on_write_shared_memory_size(const ID *id_cow)
+{
+  if (!check_datablock_expanded(id_cow)) {
+    return 0;
+  }
+  switch (GS(id_cow->name)) {
+    case ID_ME: {
+      const Mesh *mesh = (const Mesh *)id_cow;
+      return CustomData_get_shared_size(&mesh->vdata, mesh->totvert) +
+             CustomData_get_shared_size(&mesh->edata, mesh->totedge) +
+             CustomData_get_shared_size(&mesh->fdata, mesh->totface) +
+             CustomData_get_shared_size(&mesh->ldata, mesh->totloop) +
+             CustomData_get_shared_size(&mesh->pdata, mesh->totpoly);
+    }
+    case ID_PT: {
+      const PointCloud *pointcloud = (const PointCloud *)id_cow;
+      return CustomData_get_shared_size(&pointcloud->pdata, pointcloud->totpoint);
+    }
+    case ID_HA: {
+      const Hair *hair = (const Hair *)id_cow;
+      return CustomData_get_shared_size(&hair->pdata, hair->totpoint) +
+             CustomData_get_shared_size(&hair->cdata, hair->totcurve);
+    }
+    default:
+      break;
+  }
+  return 0;
+}
+
 bool deg_copy_on_write_is_needed(const ID *id_orig)
 {
   const ID_Type id_type = GS(id_orig->name);
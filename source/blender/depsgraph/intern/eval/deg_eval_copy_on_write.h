@@ -88,6 +88,10 @@ void deg_tag_copy_on_write_id(struct ID *id_cow, const struct ID *id_orig);
  */
 bool deg_copy_on_write_is_expanded(const struct ID *id_cow);
 
+/* Bytes of geometry data which the copy-on-write datablock shares instead of having its own
+ * copy. Is used for statistics. */
+size_t deg_copy_on_write_shared_memory_size(const struct ID *id_cow);
+
 /* Check whether copy-on-write datablock is needed for given ID.
  *
  * There are some exceptions on data-blocks which are covered by dependency graph
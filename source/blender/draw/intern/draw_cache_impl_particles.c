@@ -30,6 +30,7 @@
 #include "BLI_ghash.h"
 #include "BLI_math_vector.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_customdata_types.h"
@@ -605,36 +606,92 @@ static int particle_batch_cache_fill_segments(ParticleSystem *psys,
   return curr_point;
 }
 
-static void particle_batch_cache_fill_segments_proc_pos(ParticleCacheKey **path_cache,
-                                                        const int num_path_keys,
-                                                        GPUVertBufRaw *attr_step)
+typedef struct ParticleProcPosFillData {
+  ParticleCacheKey **path_cache;
+  /* First point of every path in the vertex buffer, -1 for paths which are not drawn. */
+  const int *path_point_offset;
+  unsigned char *data;
+  uint stride;
+} ParticleProcPosFillData;
+
+static void particle_batch_cache_fill_segments_proc_pos_cb(void *__restrict userdata,
+                                                           const int i,
+                                                           const TaskParallelTLS *__restrict
+                                                               UNUSED(tls))
 {
+  const ParticleProcPosFillData *data = userdata;
+  ParticleCacheKey *path = data->path_cache[i];
+  if (data->path_point_offset[i] == -1) {
+    return;
+  }
+  unsigned char *seg_data_first = data->data + data->stride * data->path_point_offset[i];
+  float total_len = 0.0f;
+  float *co_prev = NULL;
+  unsigned char *seg_data_raw = seg_data_first;
+  for (int j = 0; j <= path->segments; j++, seg_data_raw += data->stride) {
+    float *seg_data = (float *)seg_data_raw;
+    copy_v3_v3(seg_data, path[j].co);
+    if (co_prev) {
+      total_len += len_v3v3(co_prev, path[j].co);
+    }
+    seg_data[3] = total_len;
+    co_prev = path[j].co;
+  }
+  if (total_len > 0.0f) {
+    /* Divide by total length to have a [0-1] number. */
+    seg_data_raw = seg_data_first;
+    for (int j = 0; j <= path->segments; j++, seg_data_raw += data->stride) {
+      ((float *)seg_data_raw)[3] /= total_len;
+    }
+  }
+}
+
+/* Fill the procedural hair point buffer (position and normalized length along the strand).
+ *
+ * The paths stay in their #ParticleCacheKey arrays, there is no separate strand layout on the
+ * CPU side. Paths are written straight to their place in the vertex buffer, so they can be filled
+ * in parallel, only the offsets have to be found in order. */
+void particle_batch_cache_fill_segments_proc_pos(ParticleCacheKey **path_cache,
+                                                 const int num_path_keys,
+                                                 GPUVertBufRaw *attr_step)
+{
+  if (num_path_keys <= 0) {
+    return;
+  }
+
+  int *path_point_offset = MEM_mallocN(sizeof(int) * num_path_keys, __func__);
+  int point_len = 0;
   for (int i = 0; i < num_path_keys; i++) {
     ParticleCacheKey *path = path_cache[i];
     if (path->segments <= 0) {
+      path_point_offset[i] = -1;
       continue;
     }
-    float total_len = 0.0f;
-    float *co_prev = NULL, *seg_data_first;
-    for (int j = 0; j <= path->segments; j++) {
-      float *seg_data = (float *)GPU_vertbuf_raw_step(attr_step);
-      copy_v3_v3(seg_data, path[j].co);
-      if (co_prev) {
-        total_len += len_v3v3(co_prev, path[j].co);
-      }
-      else {
-        seg_data_first = seg_data;
-      }
-      seg_data[3] = total_len;
-      co_prev = path[j].co;
-    }
-    if (total_len > 0.0f) {
-      /* Divide by total length to have a [0-1] number. */
-      for (int j = 0; j <= path->segments; j++, seg_data_first += 4) {
-        seg_data_first[3] /= total_len;
-      }
-    }
+    path_point_offset[i] = point_len;
+    point_len += path->segments + 1;
   }
+
+  ParticleProcPosFillData data = {
+      .path_cache = path_cache,
+      .path_point_offset = path_point_offset,
+      .data = attr_step->data,
+      .stride = attr_step->stride,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  settings.use_threading = (num_path_keys > settings.min_iter_per_thread);
+  BLI_task_parallel_range(
+      0, num_path_keys, &data, particle_batch_cache_fill_segments_proc_pos_cb, &settings);
+
+  /* Advance the step past the written points, as if they were added one by one. */
+  attr_step->data += attr_step->stride * point_len;
+#if TRUST_NO_ONE
+  assert(attr_step->data <= attr_step->_data_end);
+#endif
+
+  MEM_freeN(path_point_offset);
 }
 
 static float particle_key_weight(const ParticleData *particle, int strand, float t)
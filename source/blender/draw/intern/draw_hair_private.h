@@ -29,8 +29,10 @@
 #define MAX_THICKRES 2    /* see eHairType */
 #define MAX_HAIR_SUBDIV 4 /* see hair_subdiv rna */
 
+struct GPUVertBufRaw;
 struct ModifierData;
 struct Object;
+struct ParticleCacheKey;
 struct ParticleHairCache;
 struct ParticleSystem;
 
@@ -80,6 +82,9 @@ typedef struct ParticleHairCache {
 } ParticleHairCache;
 
 void particle_batch_cache_clear_hair(struct ParticleHairCache *hair_cache);
+void particle_batch_cache_fill_segments_proc_pos(struct ParticleCacheKey **path_cache,
+                                                 const int num_path_keys,
+                                                 struct GPUVertBufRaw *attr_step);
 
 bool particles_ensure_procedural_data(struct Object *object,
                                       struct ParticleSystem *psys,
@@ -1355,7 +1355,7 @@ void ED_object_constraint_dependency_update(Main *bmain, Object *ob)
   if (ob->pose) {
     object_pose_tag_update(bmain, ob);
   }
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 }
 
 void ED_object_constraint_tag_update(Main *bmain, Object *ob, bConstraint *con)
@@ -1388,7 +1388,7 @@ void ED_object_constraint_dependency_tag_update(Main *bmain, Object *ob, bConstr
   if (ob->pose) {
     object_pose_tag_update(bmain, ob);
   }
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 }
 
 static bool constraint_poll(bContext *C)
@@ -1419,7 +1419,7 @@ static int constraint_delete_exec(bContext *C, wmOperator *UNUSED(op))
     ED_object_constraint_update(bmain, ob);
 
     /* relations */
-    DEG_relations_tag_update(CTX_data_main(C));
+    DEG_relations_tag_update_id(bmain, &ob->id);
 
     /* notifiers */
     WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_REMOVED, ob);
@@ -1610,12 +1610,11 @@ static int object_constraints_clear_exec(bContext *C, wmOperator *UNUSED(op))
   CTX_DATA_BEGIN (C, Object *, ob, selected_editable_objects) {
     BKE_constraints_free(&ob->constraints);
     DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+    /* force depsgraph to get recalculated since relationships removed */
+    DEG_relations_tag_update_id(bmain, &ob->id);
   }
   CTX_DATA_END;
 
-  /* force depsgraph to get recalculated since relationships removed */
-  DEG_relations_tag_update(bmain);
-
   /* do updates */
   WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_REMOVED, NULL);
 
@@ -1716,13 +1715,12 @@ static int object_constraint_copy_exec(bContext *C, wmOperator *UNUSED(op))
     if (obact != ob) {
       BKE_constraints_copy(&ob->constraints, &obact->constraints, true);
       DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY | ID_RECALC_TRANSFORM);
+      /* force depsgraph to get recalculated since new relationships added */
+      DEG_relations_tag_update_id(bmain, &ob->id);
     }
   }
   CTX_DATA_END;
 
-  /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
-
   /* notifiers for updates */
   WM_event_add_notifier(C, NC_OBJECT | ND_CONSTRAINT | NA_ADDED, NULL);
 
@@ -1990,7 +1988,7 @@ static int constraint_add_exec(
   }
 
   /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 
   if ((ob->type == OB_ARMATURE) && (pchan)) {
     BKE_pose_tag_recalc(bmain, ob->pose); /* sort pose channels */
@@ -229,7 +229,7 @@ ModifierData *ED_object_modifier_add(
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 
   return new_md;
 }
@@ -400,7 +400,7 @@ bool ED_object_modifier_remove(ReportList *reports, Main *bmain, Object *ob, Mod
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 
   return 1;
 }
@@ -425,7 +425,7 @@ void ED_object_modifier_clear(Main *bmain, Object *ob)
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
 }
 
 int ED_object_modifier_move_up(ReportList *reports, Object *ob, ModifierData *md)
@@ -1221,7 +1221,7 @@ static int modifier_apply_exec(bContext *C, wmOperator *op)
   }
 
   DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
-  DEG_relations_tag_update(bmain);
+  DEG_relations_tag_update_id(bmain, &ob->id);
   WM_event_add_notifier(C, NC_OBJECT | ND_MODIFIER, ob);
 
   return OPERATOR_FINISHED;
@@ -46,7 +46,6 @@
 #include "BKE_mesh.h"
 #include "BKE_mesh_mirror.h"
 #include "BKE_mesh_remesh_voxel.h"
-#include "BKE_mesh_runtime.h"
 #include "BKE_modifier.h"
 #include "BKE_object.h"
 #include "BKE_paint.h"
@@ -104,45 +103,134 @@ static bool object_remesh_poll(bContext *C)
   return ED_operator_object_active_editable_mesh(C);
 }
 
-static int voxel_remesh_exec(bContext *C, wmOperator *op)
+/* Replace the mesh of the object with a remesh result, taking ownership of it. Remesh jobs only
+ * build the result, the original mesh is replaced on the main thread since it may be drawn while
+ * the job runs. */
+static void remesh_result_apply(Object *ob,
+                                Mesh *new_mesh,
+                                const char *undo_name,
+                                const bool smooth_normals)
 {
-  Object *ob = CTX_data_active_object(C);
-
   Mesh *mesh = ob->data;
-  Mesh *new_mesh;
 
-  if (mesh->remesh_voxel_size <= 0.0f) {
-    BKE_report(op->reports, RPT_ERROR, "Voxel remesher cannot run with a voxel size of 0.0");
-    return OPERATOR_CANCELLED;
+  if (ob->mode == OB_MODE_SCULPT) {
+    ED_sculpt_undo_geometry_begin(ob, undo_name);
+  }
+
+  BKE_mesh_nomain_to_mesh(new_mesh, mesh, ob, &CD_MASK_MESH, true);
+
+  if (smooth_normals) {
+    BKE_mesh_smooth_flag_set(ob->data, true);
+  }
+
+  if (ob->mode == OB_MODE_SCULPT) {
+    ED_sculpt_undo_geometry_end(ob);
+  }
+
+  BKE_mesh_batch_cache_dirty_tag(ob->data, BKE_MESH_BATCH_DIRTY_ALL);
+}
+
+/****************** voxel remesh operator *********************/
+
+typedef struct VoxelRemeshJob {
+  /* from wmJob */
+  struct Object *owner;
+  short *stop, *do_update;
+  float *progress;
+
+  /* Copy of the object's mesh, the job doesn't access the original mesh. */
+  Mesh *mesh_source;
+  /* Set by the job, applied to the object by the end callback. */
+  Mesh *mesh_result;
+
+  const char *undo_name;
+
+  int success;
+  bool is_nonblocking_job;
+} VoxelRemeshJob;
+
+static void voxel_remesh_free_job(void *customdata)
+{
+  VoxelRemeshJob *vj = customdata;
+  if (vj->mesh_source) {
+    BKE_id_free(NULL, vj->mesh_source);
+  }
+  if (vj->mesh_result) {
+    BKE_id_free(NULL, vj->mesh_result);
+  }
+  MEM_freeN(vj);
+}
+
+/* Called by the voxel remesher between its stages. */
+static void voxel_remesh_update_job(void *customdata, float progress, int *cancel)
+{
+  VoxelRemeshJob *vj = customdata;
+
+  /* Same as QuadriFlow, reuse the render break. */
+  if (G.is_break) {
+    vj->success = -1;
+    *cancel = 1;
+  }
+  else {
+    *cancel = 0;
+  }
+
+  /* The remesher itself takes the larger part of the time, leave the rest for the
+   * reprojection of the data onto the new mesh. */
+  *(vj->do_update) = true;
+  *(vj->progress) = progress * 0.8f;
+}
+
+static void voxel_remesh_start_job(void *customdata,
+                                   short *stop,
+                                   short *do_update,
+                                   float *progress)
+{
+  VoxelRemeshJob *vj = customdata;
+
+  vj->stop = stop;
+  vj->do_update = do_update;
+  vj->progress = progress;
+  vj->success = 1;
+
+  if (vj->is_nonblocking_job) {
+    G.is_break = false; /* XXX shared with render - replace with job 'stop' switch */
   }
 
+  Object *ob = vj->owner;
+  Mesh *mesh = vj->mesh_source;
+  Mesh *new_mesh;
+
   float isovalue = 0.0f;
   if (mesh->flag & ME_REMESH_REPROJECT_VOLUME) {
     isovalue = mesh->remesh_voxel_size * 0.3f;
   }
 
-  new_mesh = BKE_mesh_remesh_voxel_to_mesh_nomain(
-      mesh, mesh->remesh_voxel_size, mesh->remesh_voxel_adaptivity, isovalue);
+  new_mesh = BKE_mesh_remesh_voxel_to_mesh_nomain(mesh,
+                                                  mesh->remesh_voxel_size,
+                                                  mesh->remesh_voxel_adaptivity,
+                                                  isovalue,
+                                                  voxel_remesh_update_job,
+                                                  (void *)vj);
 
   if (!new_mesh) {
-    BKE_report(op->reports, RPT_ERROR, "Voxel remesher failed to create mesh");
-    return OPERATOR_CANCELLED;
+    *do_update = true;
+    *stop = 0;
+    if (vj->success == 1) {
+      /* This is not a user cancellation event. */
+      vj->success = 0;
+    }
+    return;
   }
 
-  if (ob->mode == OB_MODE_SCULPT) {
-    ED_sculpt_undo_geometry_begin(ob, op->type->name);
-  }
+  *do_update = true;
+  *progress = 0.8f;
 
   if (mesh->flag & ME_REMESH_FIX_POLES && mesh->remesh_voxel_adaptivity <= 0.0f) {
     new_mesh = BKE_mesh_remesh_voxel_fix_poles(new_mesh);
     BKE_mesh_calc_normals(new_mesh);
   }
 
-  if (mesh->flag & ME_REMESH_REPROJECT_VOLUME || mesh->flag & ME_REMESH_REPROJECT_PAINT_MASK ||
-      mesh->flag & ME_REMESH_REPROJECT_SCULPT_FACE_SETS) {
-    BKE_mesh_runtime_clear_geometry(mesh);
-  }
-
   if (mesh->flag & ME_REMESH_REPROJECT_VOLUME) {
     BKE_shrinkwrap_remesh_target_project(new_mesh, mesh, ob);
   }
@@ -155,23 +243,129 @@ static int voxel_remesh_exec(bContext *C, wmOperator *op)
     BKE_remesh_reproject_sculpt_face_sets(new_mesh, mesh);
   }
 
-  BKE_mesh_nomain_to_mesh(new_mesh, mesh, ob, &CD_MASK_MESH, true);
+  vj->mesh_result = new_mesh;
 
-  if (mesh->flag & ME_REMESH_SMOOTH_NORMALS) {
-    BKE_mesh_smooth_flag_set(ob->data, true);
+  *do_update = true;
+  *progress = 1.0f;
+  *stop = 0;
+}
+
+static void voxel_remesh_end_job(void *customdata)
+{
+  VoxelRemeshJob *vj = customdata;
+
+  Object *ob = vj->owner;
+
+  if (vj->is_nonblocking_job) {
+    WM_set_locked_interface(G_MAIN->wm.first, false);
   }
 
-  if (ob->mode == OB_MODE_SCULPT) {
-    ED_sculpt_undo_geometry_end(ob);
+  switch (vj->success) {
+    case 1:
+      remesh_result_apply(ob,
+                          vj->mesh_result,
+                          vj->undo_name,
+                          (vj->mesh_source->flag & ME_REMESH_SMOOTH_NORMALS) != 0);
+      vj->mesh_result = NULL;
+      DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+      break;
+    case 0:
+      WM_report(RPT_ERROR, "Voxel remesher failed to create mesh");
+      break;
+    case -1:
+      WM_report(RPT_WARNING, "Voxel remesh cancelled");
+      break;
   }
+}
 
-  BKE_mesh_batch_cache_dirty_tag(ob->data, BKE_MESH_BATCH_DIRTY_ALL);
-  DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
+static VoxelRemeshJob *voxel_remesh_job_create(wmOperator *op, Object *ob)
+{
+  Mesh *mesh = ob->data;
+
+  if (mesh->remesh_voxel_size <= 0.0f) {
+    BKE_report(op->reports, RPT_ERROR, "Voxel remesher cannot run with a voxel size of 0.0");
+    return NULL;
+  }
+
+  VoxelRemeshJob *job = MEM_callocN(sizeof(VoxelRemeshJob), "VoxelRemeshJob");
+  job->owner = ob;
+  job->mesh_source = BKE_mesh_copy_for_eval(mesh, false);
+  job->undo_name = op->type->name;
+  return job;
+}
+
+static int voxel_remesh_exec(bContext *C, wmOperator *op)
+{
+  Object *ob = CTX_data_active_object(C);
+
+  VoxelRemeshJob *job = voxel_remesh_job_create(op, ob);
+  if (job == NULL) {
+    return OPERATOR_CANCELLED;
+  }
+
+  /* Blocking call, for Python and redo. */
+  job->is_nonblocking_job = false;
+  short stop = 0, do_update = true;
+  float progress;
+  voxel_remesh_start_job(job, &stop, &do_update, &progress);
+  const bool success = (job->success == 1);
+  voxel_remesh_end_job(job);
+  voxel_remesh_free_job(job);
+
+  if (!success) {
+    return OPERATOR_CANCELLED;
+  }
   WM_event_add_notifier(C, NC_GEOM | ND_DATA, ob->data);
 
   return OPERATOR_FINISHED;
 }
 
+static int voxel_remesh_invoke(bContext *C, wmOperator *op, const wmEvent *UNUSED(event))
+{
+  wmWindowManager *wm = CTX_wm_manager(C);
+  Scene *scene = CTX_data_scene(C);
+
+  if (WM_jobs_test(wm, scene, WM_JOB_TYPE_VOXEL_REMESH)) {
+    return OPERATOR_CANCELLED;
+  }
+
+  VoxelRemeshJob *job = voxel_remesh_job_create(op, CTX_data_active_object(C));
+  if (job == NULL) {
+    return OPERATOR_CANCELLED;
+  }
+
+  /* Non blocking call, for when the operator has been called from the gui. The operator stays
+   * modal until the job ended, so the undo step is pushed once the mesh is replaced. */
+  job->is_nonblocking_job = true;
+
+  wmJob *wm_job = WM_jobs_get(
+      wm, CTX_wm_window(C), scene, "Voxel Remesh", WM_JOB_PROGRESS, WM_JOB_TYPE_VOXEL_REMESH);
+
+  WM_jobs_customdata_set(wm_job, job, voxel_remesh_free_job);
+  WM_jobs_timer(wm_job, 0.1, NC_GEOM | ND_DATA, NC_GEOM | ND_DATA);
+  WM_jobs_callbacks(wm_job, voxel_remesh_start_job, NULL, NULL, voxel_remesh_end_job);
+
+  WM_set_locked_interface(wm, true);
+
+  WM_jobs_start(wm, wm_job);
+
+  WM_event_add_modal_handler(C, op);
+  return OPERATOR_RUNNING_MODAL;
+}
+
+static int voxel_remesh_modal(bContext *C, wmOperator *UNUSED(op), const wmEvent *event)
+{
+  if (!WM_jobs_test(CTX_wm_manager(C), CTX_data_scene(C), WM_JOB_TYPE_VOXEL_REMESH)) {
+    return OPERATOR_FINISHED | OPERATOR_PASS_THROUGH;
+  }
+
+  if (event->type == EVT_ESCKEY) {
+    G.is_break = true;
+    return OPERATOR_RUNNING_MODAL;
+  }
+  return OPERATOR_PASS_THROUGH;
+}
+
 void OBJECT_OT_voxel_remesh(wmOperatorType *ot)
 {
   /* identifiers */
@@ -183,6 +377,8 @@ void OBJECT_OT_voxel_remesh(wmOperatorType *ot)
 
   /* api callbacks */
   ot->poll = object_remesh_poll;
+  ot->invoke = voxel_remesh_invoke;
+  ot->modal = voxel_remesh_modal;
   ot->exec = voxel_remesh_exec;
 
   ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO;
@@ -222,6 +418,11 @@ typedef struct QuadriFlowJob {
   bool preserve_paint_mask;
   bool smooth_normals;
 
+  /* Copy of the object's mesh, the job doesn't access the original mesh. */
+  Mesh *mesh_source;
+  /* Set by the job, applied to the object by the end callback. */
+  Mesh *mesh_result;
+
   int success;
   bool is_nonblocking_job;
 } QuadriFlowJob;
@@ -280,6 +481,12 @@ static bool mesh_is_manifold_consistent(Mesh *mesh)
 static void quadriflow_free_job(void *customdata)
 {
   QuadriFlowJob *qj = customdata;
+  if (qj->mesh_source) {
+    BKE_id_free(NULL, qj->mesh_source);
+  }
+  if (qj->mesh_result) {
+    BKE_id_free(NULL, qj->mesh_result);
+  }
   MEM_freeN(qj);
 }
 
@@ -391,8 +598,7 @@ static void quadriflow_start_job(void *customdata, short *stop, short *do_update
     G.is_break = false; /* XXX shared with render - replace with job 'stop' switch */
   }
 
-  Object *ob = qj->owner;
-  Mesh *mesh = ob->data;
+  Mesh *mesh = qj->mesh_source;
   Mesh *new_mesh;
   Mesh *bisect_mesh;
 
@@ -438,29 +644,15 @@ static void quadriflow_start_job(void *customdata, short *stop, short *do_update
   /* Mirror the Quadriflow result to build the final mesh */
   new_mesh = remesh_symmetry_mirror(qj->owner, new_mesh, qj->symmetry_axes);
 
-  if (ob->mode == OB_MODE_SCULPT) {
-    ED_sculpt_undo_geometry_begin(ob, "QuadriFlow Remesh");
-  }
-
   if (qj->preserve_paint_mask) {
-    BKE_mesh_runtime_clear_geometry(mesh);
     BKE_mesh_remesh_reproject_paint_mask(new_mesh, mesh);
   }
 
-  BKE_mesh_nomain_to_mesh(new_mesh, mesh, ob, &CD_MASK_MESH, true);
-
-  if (qj->smooth_normals) {
-    if (qj->use_paint_symmetry) {
-      BKE_mesh_calc_normals(ob->data);
-    }
-    BKE_mesh_smooth_flag_set(ob->data, true);
-  }
-
-  if (ob->mode == OB_MODE_SCULPT) {
-    ED_sculpt_undo_geometry_end(ob);
+  if (qj->smooth_normals && qj->use_paint_symmetry) {
+    BKE_mesh_calc_normals(new_mesh);
   }
 
-  BKE_mesh_batch_cache_dirty_tag(ob->data, BKE_MESH_BATCH_DIRTY_ALL);
+  qj->mesh_result = new_mesh;
 
   *do_update = true;
   *stop = 0;
@@ -478,6 +670,8 @@ static void quadriflow_end_job(void *customdata)
 
   switch (qj->success) {
     case 1:
+      remesh_result_apply(ob, qj->mesh_result, "QuadriFlow Remesh", qj->smooth_normals);
+      qj->mesh_result = NULL;
       DEG_id_tag_update(&ob->id, ID_RECALC_GEOMETRY);
       WM_reportf(RPT_INFO, "QuadriFlow: Remeshing completed");
       break;
@@ -497,9 +691,10 @@ static void quadriflow_end_job(void *customdata)
 
 static int quadriflow_remesh_exec(bContext *C, wmOperator *op)
 {
-  QuadriFlowJob *job = MEM_mallocN(sizeof(QuadriFlowJob), "QuadriFlowJob");
+  QuadriFlowJob *job = MEM_callocN(sizeof(QuadriFlowJob), "QuadriFlowJob");
 
   job->owner = CTX_data_active_object(C);
+  job->mesh_source = BKE_mesh_copy_for_eval(job->owner->data, false);
 
   job->target_faces = RNA_int_get(op->ptr, "target_faces");
   job->seed = RNA_int_get(op->ptr, "seed");
@@ -66,6 +66,7 @@
 #include "BKE_lib_id.h"
 #include "BKE_light.h"
 #include "BKE_main.h"
+#include "BKE_main_idmap.h"
 #include "BKE_material.h"
 #include "BKE_node.h"
 #include "BKE_scene.h"
@@ -972,11 +973,13 @@ static void shader_preview_free(void *customdata)
   if (sp->matcopy) {
     main_id_copy = (ID *)sp->matcopy;
     BLI_remlink(&pr_main->materials, sp->matcopy);
+    BKE_main_idmap_names_remove(pr_main, (ID *)sp->matcopy);
   }
   if (sp->texcopy) {
     BLI_assert(main_id_copy == NULL);
     main_id_copy = (ID *)sp->texcopy;
     BLI_remlink(&pr_main->textures, sp->texcopy);
+    BKE_main_idmap_names_remove(pr_main, (ID *)sp->texcopy);
   }
   if (sp->worldcopy) {
     /* worldcopy is also created for material with `Preview World` enabled */
@@ -987,11 +990,13 @@ static void shader_preview_free(void *customdata)
       main_id_copy = (ID *)sp->worldcopy;
     }
     BLI_remlink(&pr_main->worlds, sp->worldcopy);
+    BKE_main_idmap_names_remove(pr_main, (ID *)sp->worldcopy);
   }
   if (sp->lampcopy) {
     BLI_assert(main_id_copy == NULL);
     main_id_copy = (ID *)sp->lampcopy;
     BLI_remlink(&pr_main->lights, sp->lampcopy);
+    BKE_main_idmap_names_remove(pr_main, (ID *)sp->lampcopy);
   }
   if (main_id_copy || sp->id_copy) {
     /* node previews */
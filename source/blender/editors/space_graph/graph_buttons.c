@@ -994,6 +994,11 @@ static void graph_draw_driver_settings_panel(uiLayout *layout,
       }
       else {
         uiItemL(col, TIP_("Slow Python expression"), ICON_INFO);
+
+        const char *error = BKE_driver_simple_expression_error_get(driver);
+        if (error) {
+          uiItemL(col, error, ICON_BLANK1);
+        }
       }
     }
 
@@ -110,6 +110,9 @@ AbcArchiveHandle *ABC_create_handle(struct Main *bmain,
 
 void ABC_free_handle(AbcArchiveHandle *handle);
 
+/* Number of mesh samples found in, and missing from, the cache of samples read ahead. */
+void ABC_get_prefetch_stats(AbcArchiveHandle *handle, int *r_hits, int *r_misses);
+
 void ABC_get_transform(struct CacheReader *reader,
                        float r_mat_world[4][4],
                        float time,
@@ -45,6 +45,8 @@ extern "C" {
 #include "DNA_space_types.h" /* for FILE_MAX */
 
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
 
 #ifdef WIN32
 /* needed for MSCV because of snprintf from BLI_string */
@@ -191,12 +193,18 @@ AbcExporter::AbcExporter(Main *bmain, const char *filename, ExportSettings &sett
       m_filename(filename),
       m_trans_sampling_index(0),
       m_shape_sampling_index(0),
-      m_writer(NULL)
+      m_writer(NULL),
+      m_write_pool(NULL)
 {
 }
 
 AbcExporter::~AbcExporter()
 {
+  /* Wait for background writes, an error may have interrupted the export. */
+  if (m_write_pool) {
+    BLI_task_pool_free(m_write_pool);
+  }
+
   /* Free xforms map */
   m_xforms_type::iterator it_x, e_x;
   for (it_x = m_xforms.begin(), e_x = m_xforms.end(); it_x != e_x; ++it_x) {
@@ -305,6 +313,8 @@ void AbcExporter::operator()(short *do_update, float *progress, bool *was_cancel
   createTransformWritersHierarchy();
   createShapeWriters();
 
+  m_write_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), this);
+
   /* Make a list of frames to export. */
 
   std::set<double> xform_frames;
@@ -325,6 +335,9 @@ void AbcExporter::operator()(short *do_update, float *progress, bool *was_cancel
   const float size = static_cast<float>(frames.size());
   size_t i = 0;
 
+  std::vector<AbcObjectWriter *> prepared_shapes, unprepared_shapes;
+  bool is_first_shape_frame = true;
+
   for (; begin != end; ++begin) {
     *progress = (++i / size);
     *do_update = 1;
@@ -336,33 +349,135 @@ void AbcExporter::operator()(short *do_update, float *progress, bool *was_cancel
 
     const double frame = *begin;
 
-    /* 'frame' is offset by start frame, so need to cancel the offset. */
+    /* 'frame' is offset by start frame, so need to cancel the offset.
+     * Meanwhile the shapes of the previous frame are written in the background. */
     setCurrentFrame(m_bmain, frame);
+    waitForWrites();
+
+    const bool is_shape_frame = shape_frames.count(frame) != 0;
+
+    if (is_shape_frame) {
+      prepareShapes(prepared_shapes, unprepared_shapes);
+
+      /* These read the evaluated data while writing. */
+      for (int i = 0, e = unprepared_shapes.size(); i != e; i++) {
+        unprepared_shapes[i]->write();
+      }
+    }
+
+    if (xform_frames.count(frame) != 0) {
+      m_xforms_type::iterator xit, xe;
+      for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
+        xit->second->write();
+      }
+
+      /* Save the archive 's bounding box. */
+      Imath::Box3d bounds;
 
-    if (shape_frames.count(frame) != 0) {
-      for (int i = 0, e = m_shapes.size(); i != e; i++) {
-        m_shapes[i]->write();
+      for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
+        Imath::Box3d box = xit->second->bounds();
+        bounds.extendBy(box);
       }
+
+      archive_bounds_prop.set(bounds);
     }
 
-    if (xform_frames.count(frame) == 0) {
+    if (!is_shape_frame) {
       continue;
     }
 
-    m_xforms_type::iterator xit, xe;
-    for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
-      xit->second->write();
+    if (is_first_shape_frame) {
+      /* The first sample also writes custom data read from the evaluated meshes, so it has to be
+       * written before the next frame is evaluated. */
+      for (int i = 0, e = prepared_shapes.size(); i != e; i++) {
+        prepared_shapes[i]->write();
+      }
+      is_first_shape_frame = false;
+    }
+    else if (!prepared_shapes.empty()) {
+      m_write_queue.swap(prepared_shapes);
+      BLI_task_pool_push(m_write_pool, write_shapes_task, NULL, false, TASK_PRIORITY_HIGH);
     }
+  }
+
+  waitForWrites();
+}
 
-    /* Save the archive 's bounding box. */
-    Imath::Box3d bounds;
+void AbcExporter::prepareShapes(std::vector<AbcObjectWriter *> &r_prepared,
+                                std::vector<AbcObjectWriter *> &r_unprepared)
+{
+  /* Writers of the same object (instanced more than once) share its evaluated data, so they
+   * are prepared one after the other in the same task. */
+  std::map<Object *, std::vector<AbcObjectWriter *>> writers_by_object;
+
+  r_prepared.clear();
+  r_unprepared.clear();
+
+  for (int i = 0, e = m_shapes.size(); i != e; i++) {
+    AbcObjectWriter *writer = m_shapes[i];
 
-    for (xit = m_xforms.begin(), xe = m_xforms.end(); xit != xe; ++xit) {
-      Imath::Box3d box = xit->second->bounds();
-      bounds.extendBy(box);
+    if (writer->fetchSample()) {
+      writers_by_object[writer->object()].push_back(writer);
+      r_prepared.push_back(writer);
+    }
+    else {
+      r_unprepared.push_back(writer);
     }
+  }
+
+  if (writers_by_object.empty()) {
+    return;
+  }
+
+  TaskPool *task_pool = BLI_task_pool_create(BLI_task_scheduler_get(), NULL);
+
+  std::map<Object *, std::vector<AbcObjectWriter *>>::iterator iter;
+  for (iter = writers_by_object.begin(); iter != writers_by_object.end(); ++iter) {
+    BLI_task_pool_push(task_pool, prepare_shapes_task, &iter->second, false, TASK_PRIORITY_HIGH);
+  }
+
+  BLI_task_pool_work_and_wait(task_pool);
+  BLI_task_pool_free(task_pool);
+}
 
-    archive_bounds_prop.set(bounds);
+void AbcExporter::waitForWrites()
+{
+  BLI_task_pool_work_and_wait(m_write_pool);
+  m_write_queue.clear();
+
+  if (m_write_error) {
+    std::exception_ptr error = m_write_error;
+    m_write_error = std::exception_ptr();
+    std::rethrow_exception(error);
+  }
+}
+
+void AbcExporter::prepare_shapes_task(TaskPool *__restrict UNUSED(pool),
+                                      void *taskdata,
+                                      int UNUSED(threadid))
+{
+  std::vector<AbcObjectWriter *> *writers = static_cast<std::vector<AbcObjectWriter *> *>(
+      taskdata);
+
+  for (int i = 0, e = writers->size(); i != e; i++) {
+    (*writers)[i]->prepareSample();
+  }
+}
+
+void AbcExporter::write_shapes_task(TaskPool *__restrict pool,
+                                    void *UNUSED(taskdata),
+                                    int UNUSED(threadid))
+{
+  AbcExporter *exporter = static_cast<AbcExporter *>(BLI_task_pool_userdata(pool));
+
+  /* Errors are passed on to the main thread, see waitForWrites(). */
+  try {
+    for (int i = 0, e = exporter->m_write_queue.size(); i != e; i++) {
+      exporter->m_write_queue[i]->write();
+    }
+  }
+  catch (...) {
+    exporter->m_write_error = std::current_exception();
   }
 }
 
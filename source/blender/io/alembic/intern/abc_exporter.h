@@ -22,6 +22,7 @@
 #define __ABC_EXPORTER_H__
 
 #include <Alembic/Abc/All.h>
+#include <exception>
 #include <map>
 #include <set>
 #include <vector>
@@ -37,6 +38,7 @@ struct Depsgraph;
 struct Main;
 struct Object;
 struct Scene;
+struct TaskPool;
 struct ViewLayer;
 
 struct ExportSettings {
@@ -97,6 +99,12 @@ class AbcExporter {
 
   std::vector<AbcObjectWriter *> m_shapes;
 
+  /* Prepared shape samples of the last frame, written in the background while the next frame is
+   * evaluated. */
+  TaskPool *m_write_pool;
+  std::vector<AbcObjectWriter *> m_write_queue;
+  std::exception_ptr m_write_error;
+
  public:
   AbcExporter(Main *bmain, const char *filename, ExportSettings &settings);
   ~AbcExporter();
@@ -122,6 +130,13 @@ class AbcExporter {
 
   AbcTransformWriter *getXForm(const std::string &name);
 
+  void prepareShapes(std::vector<AbcObjectWriter *> &r_prepared,
+                     std::vector<AbcObjectWriter *> &r_unprepared);
+  void waitForWrites();
+
+  static void prepare_shapes_task(TaskPool *__restrict pool, void *taskdata, int threadid);
+  static void write_shapes_task(TaskPool *__restrict pool, void *taskdata, int threadid);
+
   void setCurrentFrame(Main *bmain, double t);
 };
 
@@ -104,26 +104,37 @@ ArchiveReader::ArchiveReader(struct Main *bmain, const char *filename)
   BLI_strncpy(abs_filename, filename, FILE_MAX);
   BLI_path_abs(abs_filename, BKE_main_blendfile_path(bmain));
 
+  for (int i = 0; i < ARCHIVE_READER_STREAMS; i++) {
+    std::ifstream &infile = m_infiles[i];
 #ifdef WIN32
-  UTF16_ENCODE(abs_filename);
-  std::wstring wstr(abs_filename_16);
-  m_infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
-  UTF16_UN_ENCODE(abs_filename);
+    UTF16_ENCODE(abs_filename);
+    std::wstring wstr(abs_filename_16);
+    infile.open(wstr.c_str(), std::ios::in | std::ios::binary);
+    UTF16_UN_ENCODE(abs_filename);
 #else
-  m_infile.open(abs_filename, std::ios::in | std::ios::binary);
+    infile.open(abs_filename, std::ios::in | std::ios::binary);
 #endif
 
-  m_streams.push_back(&m_infile);
+    m_streams.push_back(&infile);
+  }
 
   m_archive = open_archive(abs_filename, m_streams, m_is_hdf5);
 
   /* We can't open an HDF5 file from a stream, so close it. */
   if (m_is_hdf5) {
-    m_infile.close();
+    for (int i = 0; i < ARCHIVE_READER_STREAMS; i++) {
+      m_infiles[i].close();
+    }
     m_streams.clear();
   }
 }
 
+ArchiveReader::~ArchiveReader()
+{
+  /* Background reads use the streams, finish them before those are closed. */
+  m_prefetch_cache.cancel();
+}
+
 bool ArchiveReader::is_hdf5() const
 {
   return m_is_hdf5;
@@ -138,3 +149,8 @@ Alembic::Abc::IObject ArchiveReader::getTop()
 {
   return m_archive.getTop();
 }
+
+AbcPrefetchCache *ArchiveReader::prefetch_cache()
+{
+  return &m_prefetch_cache;
+}
@@ -34,6 +34,8 @@
 
 #include <fstream>
 
+#include "abc_reader_prefetch.h"
+
 struct Main;
 struct Scene;
 
@@ -42,14 +44,20 @@ struct Scene;
  * the stream objects remain valid as long as the archives are open.
  */
 
+/* Number of streams opened on the file, so that multiple threads can read from it at once. */
+#define ARCHIVE_READER_STREAMS 4
+
 class ArchiveReader {
   Alembic::Abc::IArchive m_archive;
-  std::ifstream m_infile;
+  std::ifstream m_infiles[ARCHIVE_READER_STREAMS];
   std::vector<std::istream *> m_streams;
   bool m_is_hdf5;
 
+  AbcPrefetchCache m_prefetch_cache;
+
  public:
   ArchiveReader(struct Main *bmain, const char *filename);
+  ~ArchiveReader();
 
   bool valid() const;
 
@@ -62,6 +70,8 @@ class ArchiveReader {
   bool is_hdf5() const;
 
   Alembic::Abc::IObject getTop();
+
+  AbcPrefetchCache *prefetch_cache();
 };
 
 #endif /* __ABC_READER_ARCHIVE_H__ */
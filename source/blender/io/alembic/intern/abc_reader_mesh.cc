@@ -126,6 +126,9 @@ struct AbcMeshData {
   P3fArraySamplePtr positions;
   P3fArraySamplePtr ceil_positions;
 
+  /* Positions already converted to Blender's coordinate system, may be NULL. */
+  const float (*zup_positions)[3];
+
   V2fArraySamplePtr uvs;
   UInt32ArraySamplePtr uvs_indices;
 };
@@ -159,6 +162,14 @@ static void read_mverts(CDStreamConfig &config, const AbcMeshData &mesh_data)
     return;
   }
 
+  if (mesh_data.zup_positions) {
+    for (int i = 0; i < positions->size(); i++) {
+      copy_v3_v3(mverts[i].co, mesh_data.zup_positions[i]);
+      mverts[i].bweight = 0;
+    }
+    return;
+  }
+
   read_mverts(mverts, positions, nullptr);
 }
 
@@ -396,21 +407,40 @@ static void read_mesh_sample(const std::string &iobject_full_name,
                              ImportSettings *settings,
                              const IPolyMeshSchema &schema,
                              const ISampleSelector &selector,
+                             const AbcPrefetchedMesh &prefetched,
+                             AbcPrefetchCache *prefetch_cache,
                              CDStreamConfig &config)
 {
-  const IPolyMeshSchema::Sample sample = schema.getValue(selector);
+  const IPolyMeshSchema::Sample &sample = prefetched.sample;
 
   AbcMeshData abc_mesh_data;
   abc_mesh_data.face_counts = sample.getFaceCounts();
   abc_mesh_data.face_indices = sample.getFaceIndices();
   abc_mesh_data.positions = sample.getPositions();
+  abc_mesh_data.zup_positions = NULL;
+
+  if (!prefetched.positions.empty() &&
+      prefetched.positions.size() == abc_mesh_data.positions->size() * 3) {
+    abc_mesh_data.zup_positions = reinterpret_cast<const float(*)[3]>(
+        prefetched.positions.data());
+  }
 
   get_weight_and_index(config, schema.getTimeSampling(), schema.getNumSamples());
 
   if (config.weight != 0.0f) {
-    Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
-    schema.get(ceil_sample, Alembic::Abc::ISampleSelector(config.ceil_index));
-    abc_mesh_data.ceil_positions = ceil_sample.getPositions();
+    AbcPrefetchedMeshPtr ceil_prefetched;
+    if (prefetch_cache) {
+      ceil_prefetched = prefetch_cache->find(iobject_full_name, config.ceil_index);
+    }
+
+    if (ceil_prefetched) {
+      abc_mesh_data.ceil_positions = ceil_prefetched->sample.getPositions();
+    }
+    else {
+      Alembic::AbcGeom::IPolyMeshSchema::Sample ceil_sample;
+      schema.get(ceil_sample, Alembic::Abc::ISampleSelector(config.ceil_index));
+      abc_mesh_data.ceil_positions = ceil_sample.getPositions();
+    }
   }
 
   if ((settings->read_flag & MOD_MESHSEQ_READ_UV) != 0) {
@@ -514,22 +544,31 @@ bool AbcMeshReader::accepts_object_type(
   return true;
 }
 
-bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector &sample_sel)
+/* Get the sample from the prefetch cache when possible, and schedule
+ * reading the samples of the next frames in the background. */
+AbcPrefetchedMeshPtr AbcMeshReader::read_sample(const ISampleSelector &sample_sel)
 {
-  IPolyMeshSchema::Sample sample;
-  try {
-    sample = m_schema.getValue(sample_sel);
+  const Alembic::AbcGeom::index_t index = sample_sel.getIndex(m_schema.getTimeSampling(),
+                                                               m_schema.getNumSamples());
+  AbcPrefetchedMeshPtr prefetched;
+
+  if (m_prefetch_cache && !m_schema.isConstant()) {
+    const std::string &name = m_iobject.getFullName();
+    prefetched = m_prefetch_cache->find(name, index);
+    m_prefetch_cache->prefetch(m_schema, name, index + 1, ABC_PREFETCH_SAMPLES);
   }
-  catch (Alembic::Util::Exception &ex) {
-    printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
-           m_iobject.getFullName().c_str(),
-           m_schema.getName().c_str(),
-           sample_sel.getRequestedTime(),
-           ex.what());
-    // A similar error in read_mesh() would just return existing_mesh.
-    return false;
+
+  if (!prefetched) {
+    /* Positions are read directly from the sample into the mesh, no need to convert them. */
+    prefetched = AbcPrefetchCache::read(m_schema, index, false);
   }
 
+  return prefetched;
+}
+
+static bool sample_topology_changed(const Mesh *existing_mesh,
+                                    const IPolyMeshSchema::Sample &sample)
+{
   const P3fArraySamplePtr &positions = sample.getPositions();
   const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
   const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
@@ -539,27 +578,31 @@ bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector
          face_indices->size() != existing_mesh->totloop;
 }
 
+bool AbcMeshReader::topology_changed(Mesh *existing_mesh, const ISampleSelector &sample_sel)
+{
+  AbcPrefetchedMeshPtr prefetched = read_sample(sample_sel);
+  if (!prefetched) {
+    /* A similar error in read_mesh() would just return existing_mesh. */
+    return false;
+  }
+
+  return sample_topology_changed(existing_mesh, prefetched->sample);
+}
+
 Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
                                const ISampleSelector &sample_sel,
                                int read_flag,
                                const char **err_str)
 {
-  IPolyMeshSchema::Sample sample;
-  try {
-    sample = m_schema.getValue(sample_sel);
-  }
-  catch (Alembic::Util::Exception &ex) {
+  AbcPrefetchedMeshPtr prefetched = read_sample(sample_sel);
+  if (!prefetched) {
     if (err_str != nullptr) {
       *err_str = "Error reading mesh sample; more detail on the console";
     }
-    printf("Alembic: error reading mesh sample for '%s/%s' at time %f: %s\n",
-           m_iobject.getFullName().c_str(),
-           m_schema.getName().c_str(),
-           sample_sel.getRequestedTime(),
-           ex.what());
     return existing_mesh;
   }
 
+  const IPolyMeshSchema::Sample &sample = prefetched->sample;
   const P3fArraySamplePtr &positions = sample.getPositions();
   const Alembic::Abc::Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
   const Alembic::Abc::Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
@@ -585,7 +628,7 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   ImportSettings settings;
   settings.read_flag |= read_flag;
 
-  if (topology_changed(existing_mesh, sample_sel)) {
+  if (sample_topology_changed(existing_mesh, sample)) {
     new_mesh = BKE_mesh_new_nomain_from_template(
         existing_mesh, positions->size(), 0, 0, face_indices->size(), face_counts->size());
 
@@ -610,7 +653,13 @@ Mesh *AbcMeshReader::read_mesh(Mesh *existing_mesh,
   CDStreamConfig config = get_config(new_mesh ? new_mesh : existing_mesh);
   config.time = sample_sel.getRequestedTime();
 
-  read_mesh_sample(m_iobject.getFullName(), &settings, m_schema, sample_sel, config);
+  read_mesh_sample(m_iobject.getFullName(),
+                   &settings,
+                   m_schema,
+                   sample_sel,
+                   *prefetched,
+                   m_prefetch_cache,
+                   config);
 
   if (new_mesh) {
     /* Here we assume that the number of materials doesn't change, i.e. that
@@ -711,6 +760,7 @@ static void read_subd_sample(const std::string &iobject_full_name,
   abc_mesh_data.face_counts = sample.getFaceCounts();
   abc_mesh_data.face_indices = sample.getFaceIndices();
   abc_mesh_data.positions = sample.getPositions();
+  abc_mesh_data.zup_positions = NULL;
 
   get_weight_and_index(config, schema.getTimeSampling(), schema.getNumSamples());
 
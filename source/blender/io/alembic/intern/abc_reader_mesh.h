@@ -23,6 +23,7 @@
 
 #include "abc_customdata.h"
 #include "abc_reader_object.h"
+#include "abc_reader_prefetch.h"
 
 struct Mesh;
 
@@ -48,6 +49,8 @@ class AbcMeshReader : public AbcObjectReader {
                         const Alembic::Abc::ISampleSelector &sample_sel) override;
 
  private:
+  AbcPrefetchedMeshPtr read_sample(const Alembic::Abc::ISampleSelector &sample_sel);
+
   void readFaceSetsSample(Main *bmain,
                           Mesh *mesh,
                           const Alembic::AbcGeom::ISampleSelector &sample_sel);
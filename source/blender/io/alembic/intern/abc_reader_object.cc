@@ -52,6 +52,7 @@ AbcObjectReader::AbcObjectReader(const IObject &object, ImportSettings &settings
       m_min_time(std::numeric_limits<chrono_t>::max()),
       m_max_time(std::numeric_limits<chrono_t>::min()),
       m_refcount(0),
+      m_prefetch_cache(NULL),
       parent_reader(NULL)
 {
   m_name = object.getFullName();
@@ -331,3 +332,8 @@ void AbcObjectReader::decref()
   m_refcount--;
   BLI_assert(m_refcount >= 0);
 }
+
+void AbcObjectReader::prefetch_cache(AbcPrefetchCache *prefetch_cache)
+{
+  m_prefetch_cache = prefetch_cache;
+}
@@ -28,6 +28,8 @@ extern "C" {
 #include "DNA_ID.h"
 }
 
+class AbcPrefetchCache;
+
 struct CacheFile;
 struct Main;
 struct Mesh;
@@ -96,6 +98,9 @@ class AbcObjectReader {
 
   bool m_inherits_xform;
 
+  /* Samples of upcoming frames read in the background, owned by the archive. */
+  AbcPrefetchCache *m_prefetch_cache;
+
  public:
   AbcObjectReader *parent_reader;
 
@@ -160,6 +165,8 @@ class AbcObjectReader {
   void incref();
   void decref();
 
+  void prefetch_cache(AbcPrefetchCache *prefetch_cache);
+
   void read_matrix(float r_mat[4][4], const float time, const float scale, bool &is_constant);
 
  protected:
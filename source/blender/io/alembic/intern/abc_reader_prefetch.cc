@@ -0,0 +1,231 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software  Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#include "abc_reader_prefetch.h"
+#include "abc_util.h"
+
+#include <algorithm>
+#include <iostream>
+
+extern "C" {
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+}
+
+using Alembic::Abc::Int32ArraySamplePtr;
+using Alembic::Abc::P3fArraySamplePtr;
+
+using Alembic::AbcGeom::index_t;
+using Alembic::AbcGeom::IPolyMeshSchema;
+using Alembic::AbcGeom::ISampleSelector;
+
+/* Memory used by prefetched samples of one archive, older samples are evicted beyond that. */
+#define PREFETCH_MEMORY_LIMIT (512 * 1024 * 1024)
+
+size_t AbcPrefetchedMesh::memory_size() const
+{
+  size_t size = sizeof(*this) + positions.size() * sizeof(float);
+
+  const Int32ArraySamplePtr &face_indices = sample.getFaceIndices();
+  const Int32ArraySamplePtr &face_counts = sample.getFaceCounts();
+  const P3fArraySamplePtr &sample_positions = sample.getPositions();
+
+  if (face_indices) {
+    size += face_indices->size() * sizeof(int32_t);
+  }
+  if (face_counts) {
+    size += face_counts->size() * sizeof(int32_t);
+  }
+  if (sample_positions) {
+    size += sample_positions->size() * sizeof(Imath::V3f);
+  }
+
+  return size;
+}
+
+/* Data of one background read. */
+struct AbcPrefetchTask {
+  AbcPrefetchCache *cache;
+  IPolyMeshSchema schema;
+  AbcPrefetchCache::Key key;
+};
+
+AbcPrefetchCache::AbcPrefetchCache()
+    : m_memory_used(0),
+      m_memory_limit(PREFETCH_MEMORY_LIMIT),
+      m_use_counter(0),
+      m_hits(0),
+      m_misses(0)
+{
+  BLI_mutex_init(&m_mutex);
+  m_task_pool = BLI_task_pool_create_background(BLI_task_scheduler_get(), this);
+}
+
+AbcPrefetchCache::~AbcPrefetchCache()
+{
+  BLI_task_pool_free(m_task_pool);
+  BLI_mutex_end(&m_mutex);
+}
+
+AbcPrefetchedMeshPtr AbcPrefetchCache::read(const IPolyMeshSchema &schema,
+                                             index_t index,
+                                             bool convert_positions)
+{
+  std::shared_ptr<AbcPrefetchedMesh> mesh = std::make_shared<AbcPrefetchedMesh>();
+
+  try {
+    schema.get(mesh->sample, ISampleSelector(index));
+  }
+  catch (Alembic::Util::Exception &ex) {
+    std::cerr << "Alembic: error prefetching mesh sample " << index << " for '"
+              << schema.getObject().getFullName() << "': " << ex.what() << std::endl;
+    return AbcPrefetchedMeshPtr();
+  }
+
+  const P3fArraySamplePtr &positions = mesh->sample.getPositions();
+  if (convert_positions && positions) {
+    const size_t totvert = positions->size();
+    mesh->positions.resize(totvert * 3);
+
+    for (size_t i = 0; i < totvert; i++) {
+      copy_zup_from_yup(&mesh->positions[i * 3], (*positions)[i].getValue());
+    }
+  }
+
+  return mesh;
+}
+
+AbcPrefetchedMeshPtr AbcPrefetchCache::find(const std::string &object_name, index_t index)
+{
+  AbcPrefetchedMeshPtr mesh;
+
+  BLI_mutex_lock(&m_mutex);
+  std::map<Key, Entry>::iterator iter = m_entries.find(Key(object_name, index));
+  if (iter != m_entries.end()) {
+    iter->second.last_used = ++m_use_counter;
+    mesh = iter->second.mesh;
+    m_hits++;
+  }
+  else {
+    m_misses++;
+  }
+  BLI_mutex_unlock(&m_mutex);
+
+  return mesh;
+}
+
+void AbcPrefetchCache::prefetch(const IPolyMeshSchema &schema,
+                                const std::string &object_name,
+                                index_t first,
+                                int count)
+{
+  const index_t last = std::min(first + count, (index_t)schema.getNumSamples());
+
+  BLI_mutex_lock(&m_mutex);
+  for (index_t index = first; index < last; index++) {
+    const Key key(object_name, index);
+
+    if (m_entries.find(key) != m_entries.end() || !m_pending.insert(key).second) {
+      continue;
+    }
+
+    AbcPrefetchTask *task = new AbcPrefetchTask;
+    task->cache = this;
+    task->schema = schema;
+    task->key = key;
+    BLI_task_pool_push_ex(
+        m_task_pool, prefetch_task, task, true, prefetch_task_free, TASK_PRIORITY_LOW);
+  }
+  BLI_mutex_unlock(&m_mutex);
+}
+
+void AbcPrefetchCache::wait()
+{
+  BLI_task_pool_work_and_wait(m_task_pool);
+}
+
+void AbcPrefetchCache::cancel()
+{
+  BLI_task_pool_cancel(m_task_pool);
+
+  BLI_mutex_lock(&m_mutex);
+  m_pending.clear();
+  BLI_mutex_unlock(&m_mutex);
+}
+
+void AbcPrefetchCache::stats(int *r_hits, int *r_misses)
+{
+  BLI_mutex_lock(&m_mutex);
+  *r_hits = m_hits;
+  *r_misses = m_misses;
+  BLI_mutex_unlock(&m_mutex);
+}
+
+void AbcPrefetchCache::insert(const Key &key, AbcPrefetchedMeshPtr mesh)
+{
+  BLI_mutex_lock(&m_mutex);
+  m_pending.erase(key);
+
+  if (mesh) {
+    Entry &entry = m_entries[key];
+    if (entry.mesh) {
+      m_memory_used -= entry.mesh->memory_size();
+    }
+    entry.mesh = mesh;
+    entry.last_used = ++m_use_counter;
+    m_memory_used += mesh->memory_size();
+
+    /* Evict the least recently used samples, never the one just read. */
+    while (m_memory_used > m_memory_limit && m_entries.size() > 1) {
+      std::map<Key, Entry>::iterator oldest = m_entries.end();
+      for (std::map<Key, Entry>::iterator iter = m_entries.begin(); iter != m_entries.end();
+           ++iter) {
+        if (iter->first != key &&
+            (oldest == m_entries.end() || iter->second.last_used < oldest->second.last_used)) {
+          oldest = iter;
+        }
+      }
+
+      m_memory_used -= oldest->second.mesh->memory_size();
+      m_entries.erase(oldest);
+    }
+  }
+  BLI_mutex_unlock(&m_mutex);
+}
+
+void AbcPrefetchCache::prefetch_task(TaskPool *__restrict pool,
+                                     void *taskdata,
+                                     int UNUSED(threadid))
+{
+  AbcPrefetchTask *task = static_cast<AbcPrefetchTask *>(taskdata);
+
+  if (BLI_task_pool_canceled(pool)) {
+    return;
+  }
+
+  task->cache->insert(task->key, read(task->schema, task->key.second, true));
+}
+
+void AbcPrefetchCache::prefetch_task_free(TaskPool *__restrict UNUSED(pool),
+                                          void *taskdata,
+                                          int UNUSED(threadid))
+{
+  delete static_cast<AbcPrefetchTask *>(taskdata);
+}
@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software  Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup balembic
+ */
+
+#ifndef __ABC_READER_PREFETCH_H__
+#define __ABC_READER_PREFETCH_H__
+
+#include <Alembic/AbcGeom/All.h>
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "BLI_threads.h"
+}
+
+struct TaskPool;
+
+/* Number of samples after the current one read ahead during playback. */
+#define ABC_PREFETCH_SAMPLES 8
+
+/* A mesh sample read and decoded ahead of time. Samples read in the background also have the
+ * positions converted to Blender's coordinate system, so they only need to be copied into the
+ * mesh. */
+struct AbcPrefetchedMesh {
+  Alembic::AbcGeom::IPolyMeshSchema::Sample sample;
+  std::vector<float> positions;
+
+  size_t memory_size() const;
+};
+
+typedef std::shared_ptr<const AbcPrefetchedMesh> AbcPrefetchedMeshPtr;
+
+/**
+ * Reads mesh samples of upcoming frames in background tasks, in parallel across objects,
+ * into a cache bounded in memory. There is one cache per archive, so per CacheFile.
+ */
+class AbcPrefetchCache {
+ public:
+  /* Key of a sample: full name of the Alembic object and sample index. */
+  typedef std::pair<std::string, Alembic::AbcGeom::index_t> Key;
+
+ private:
+  struct Entry {
+    AbcPrefetchedMeshPtr mesh;
+    /* For least recently used eviction. */
+    uint64_t last_used;
+  };
+
+  ThreadMutex m_mutex;
+  TaskPool *m_task_pool;
+
+  std::map<Key, Entry> m_entries;
+  /* Samples being read by a task. */
+  std::set<Key> m_pending;
+
+  size_t m_memory_used;
+  size_t m_memory_limit;
+  uint64_t m_use_counter;
+
+  int m_hits;
+  int m_misses;
+
+ public:
+  AbcPrefetchCache();
+  ~AbcPrefetchCache();
+
+  /**
+   * Get the sample prepared in the background, counting a hit or a miss.
+   * Returns an empty pointer on a miss, the caller then reads the sample itself.
+   */
+  AbcPrefetchedMeshPtr find(const std::string &object_name, Alembic::AbcGeom::index_t index);
+
+  /* Read samples [first, first + count) of the schema in the background if not cached yet. */
+  void prefetch(const Alembic::AbcGeom::IPolyMeshSchema &schema,
+                const std::string &object_name,
+                Alembic::AbcGeom::index_t first,
+                int count);
+
+  /* Wait for all pending reads to finish. */
+  void wait();
+
+  /* Cancel all pending reads, must be called before the archive is closed. */
+  void cancel();
+
+  void stats(int *r_hits, int *r_misses);
+
+  /* Read a sample synchronously, converting the positions only when asked to. */
+  static AbcPrefetchedMeshPtr read(const Alembic::AbcGeom::IPolyMeshSchema &schema,
+                                   Alembic::AbcGeom::index_t index,
+                                   bool convert_positions);
+
+ private:
+  static void prefetch_task(TaskPool *__restrict pool, void *taskdata, int threadid);
+  static void prefetch_task_free(TaskPool *__restrict pool, void *taskdata, int threadid);
+
+  void insert(const Key &key, AbcPrefetchedMeshPtr mesh);
+};
+
+#endif /* __ABC_READER_PREFETCH_H__ */
@@ -47,6 +47,9 @@ AbcMBallWriter::AbcMBallWriter(Main *bmain,
 
 AbcMBallWriter::~AbcMBallWriter()
 {
+  /* The temporary mesh is part of Main, free it while freeEvaluatedMesh() still resolves to
+   * this class. */
+  freeSampleMeshes();
 }
 
 bool AbcMBallWriter::isAnimated() const
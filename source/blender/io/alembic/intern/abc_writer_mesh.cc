@@ -160,6 +160,42 @@ static void get_loop_normals(struct Mesh *mesh,
   }
 }
 
+static Mesh *triangulate_mesh(struct Mesh *mesh, const ExportSettings &settings)
+{
+  const bool tag_only = false;
+  const int quad_method = settings.quad_method;
+  const int ngon_method = settings.ngon_method;
+
+  struct BMeshCreateParams bmcp = {false};
+  struct BMeshFromMeshParams bmfmp = {true, false, false, 0};
+  BMesh *bm = BKE_mesh_to_bmesh_ex(mesh, &bmcp, &bmfmp);
+
+  BM_mesh_triangulate(bm, quad_method, ngon_method, 4, tag_only, NULL, NULL, NULL);
+
+  Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, NULL, mesh);
+  BM_mesh_free(bm);
+
+  return result;
+}
+
+void AbcMeshSample::clear()
+{
+  points.clear();
+  normals.clear();
+  velocities.clear();
+  poly_verts.clear();
+  loop_counts.clear();
+  crease_indices.clear();
+  crease_lengths.clear();
+  crease_sharpness.clear();
+  geo_groups.clear();
+  uv_sample.uvs.clear();
+  uv_sample.indices.clear();
+  uv_name.clear();
+  bounds.makeEmpty();
+  has_flat_shaded_poly = false;
+}
+
 /* *************** Modifiers *************** */
 
 /* check if the mesh is a subsurf, ignoring disabled modifiers and
@@ -216,6 +252,10 @@ AbcGenericMeshWriter::AbcGenericMeshWriter(Object *ob,
   m_is_animated = isAnimated();
   m_subsurf_mod = NULL;
   m_is_subd = false;
+  m_eval_mesh = NULL;
+  m_eval_mesh_needsfree = false;
+  m_export_mesh = NULL;
+  m_sample_prepared = false;
 
   /* If the object is static, use the default static time sampling. */
   if (!m_is_animated) {
@@ -249,6 +289,8 @@ AbcGenericMeshWriter::AbcGenericMeshWriter(Object *ob,
 
 AbcGenericMeshWriter::~AbcGenericMeshWriter()
 {
+  freeSampleMeshes();
+
   if (m_subsurf_mod) {
     m_subsurf_mod->mode &= ~eModifierMode_DisableTemporary;
   }
@@ -282,34 +324,112 @@ void AbcGenericMeshWriter::setIsAnimated(bool is_animated)
   m_is_animated = is_animated;
 }
 
-void AbcGenericMeshWriter::do_write()
+bool AbcGenericMeshWriter::fetchSample()
 {
   /* We have already stored a sample for this object. */
   if (!m_first_frame && !m_is_animated) {
-    return;
+    return false;
   }
 
-  bool needsfree;
-  struct Mesh *mesh = getFinalMesh(needsfree);
+  freeSampleMeshes();
 
-  try {
-    if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
-      writeSubD(mesh);
+  m_eval_mesh = getFinalMesh(m_eval_mesh_needsfree);
+  m_export_mesh = m_eval_mesh;
+
+  m_sample.clear();
+  m_sample.bounds = bounds();
+  m_sample_prepared = false;
+
+  return true;
+}
+
+void AbcGenericMeshWriter::prepareSample()
+{
+  const bool is_subd = m_settings.use_subdiv_schema && m_subdiv_schema.valid();
+
+  if (m_settings.triangulate) {
+    m_export_mesh = triangulate_mesh(m_eval_mesh, m_settings);
+  }
+
+  struct Mesh *mesh = m_export_mesh;
+
+  m_custom_data_config.pack_uvs = m_settings.pack_uv;
+  m_custom_data_config.mpoly = mesh->mpoly;
+  m_custom_data_config.mloop = mesh->mloop;
+  m_custom_data_config.totpoly = mesh->totpoly;
+  m_custom_data_config.totloop = mesh->totloop;
+  m_custom_data_config.totvert = mesh->totvert;
+
+  get_vertices(mesh, m_sample.points);
+  get_topology(mesh, m_sample.poly_verts, m_sample.loop_counts, m_sample.has_flat_shaded_poly);
+
+  if (is_subd) {
+    get_creases(mesh, m_sample.crease_indices, m_sample.crease_lengths, m_sample.crease_sharpness);
+  }
+  else {
+    if (m_settings.export_normals) {
+      get_loop_normals(mesh, m_sample.normals, m_sample.has_flat_shaded_poly);
     }
-    else {
-      writeMesh(mesh);
+    if (m_is_liquid) {
+      getVelocities(mesh, m_sample.velocities);
     }
+  }
 
-    if (needsfree) {
-      freeEvaluatedMesh(mesh);
+  if (m_first_frame) {
+    if (m_settings.export_face_sets) {
+      getGeoGroups(mesh, m_sample.geo_groups);
     }
-  }
-  catch (...) {
-    if (needsfree) {
-      freeEvaluatedMesh(mesh);
+    if (m_settings.export_uvs) {
+      m_sample.uv_name = get_uv_sample(m_sample.uv_sample, m_custom_data_config, &mesh->ldata);
     }
-    throw;
   }
+
+  m_sample_prepared = true;
+}
+
+void AbcGenericMeshWriter::do_write()
+{
+  /* We have already stored a sample for this object. */
+  if (!m_first_frame && !m_is_animated) {
+    return;
+  }
+
+  if (!m_sample_prepared) {
+    fetchSample();
+    prepareSample();
+  }
+  m_sample_prepared = false;
+
+  /* Only the first frame reads custom data from the mesh, later frames may be written while the
+   * next frame is evaluated, when the evaluated mesh can no longer be accessed. */
+  struct Mesh *mesh = m_export_mesh;
+
+  if (m_settings.use_subdiv_schema && m_subdiv_schema.valid()) {
+    writeSubD(mesh);
+  }
+  else {
+    writeMesh(mesh);
+  }
+
+  /* A triangulated copy is owned by this writer and not needed anymore. */
+  if (m_export_mesh != m_eval_mesh) {
+    BKE_id_free(NULL, m_export_mesh);
+  }
+  m_export_mesh = NULL;
+}
+
+void AbcGenericMeshWriter::freeSampleMeshes()
+{
+  if (m_export_mesh != NULL && m_export_mesh != m_eval_mesh) {
+    BKE_id_free(NULL, m_export_mesh);
+  }
+  if (m_eval_mesh != NULL && m_eval_mesh_needsfree) {
+    freeEvaluatedMesh(m_eval_mesh);
+  }
+
+  m_eval_mesh = NULL;
+  m_eval_mesh_needsfree = false;
+  m_export_mesh = NULL;
 }
 
 void AbcGenericMeshWriter::freeEvaluatedMesh(struct Mesh *mesh)
@@ -319,24 +439,16 @@ void AbcGenericMeshWriter::freeEvaluatedMesh(struct Mesh *mesh)
 
 void AbcGenericMeshWriter::writeMesh(struct Mesh *mesh)
 {
-  std::vector<Imath::V3f> points, normals;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<Imath::V3f> velocities;
-  bool has_flat_shaded_poly = false;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_shaded_poly);
-
   if (m_first_frame && m_settings.export_face_sets) {
-    writeFaceSets(mesh, m_mesh_schema);
+    writeFaceSets(m_mesh_schema);
   }
 
-  m_mesh_sample = OPolyMeshSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
+  m_mesh_sample = OPolyMeshSchema::Sample(V3fArraySample(m_sample.points),
+                                          Int32ArraySample(m_sample.poly_verts),
+                                          Int32ArraySample(m_sample.loop_counts));
 
-  UVSample sample;
   if (m_first_frame && m_settings.export_uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->ldata);
+    const UVSample &sample = m_sample.uv_sample;
 
     if (!sample.indices.empty() && !sample.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
@@ -344,7 +456,7 @@ void AbcGenericMeshWriter::writeMesh(struct Mesh *mesh)
       uv_sample.setIndices(UInt32ArraySample(sample.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      m_mesh_schema.setUVSourceName(name);
+      m_mesh_schema.setUVSourceName(m_sample.uv_name);
       m_mesh_sample.setUVs(uv_sample);
     }
 
@@ -353,23 +465,20 @@ void AbcGenericMeshWriter::writeMesh(struct Mesh *mesh)
   }
 
   if (m_settings.export_normals) {
-    get_loop_normals(mesh, normals, has_flat_shaded_poly);
-
     ON3fGeomParam::Sample normals_sample;
-    if (!normals.empty()) {
+    if (!m_sample.normals.empty()) {
       normals_sample.setScope(kFacevaryingScope);
-      normals_sample.setVals(V3fArraySample(normals));
+      normals_sample.setVals(V3fArraySample(m_sample.normals));
     }
 
     m_mesh_sample.setNormals(normals_sample);
   }
 
   if (m_is_liquid) {
-    getVelocities(mesh, velocities);
-    m_mesh_sample.setVelocities(V3fArraySample(velocities));
+    m_mesh_sample.setVelocities(V3fArraySample(m_sample.velocities));
   }
 
-  m_mesh_sample.setSelfBounds(bounds());
+  m_mesh_sample.setSelfBounds(m_sample.bounds);
 
   m_mesh_schema.set(m_mesh_sample);
 
@@ -378,26 +487,16 @@ void AbcGenericMeshWriter::writeMesh(struct Mesh *mesh)
 
 void AbcGenericMeshWriter::writeSubD(struct Mesh *mesh)
 {
-  std::vector<float> crease_sharpness;
-  std::vector<Imath::V3f> points;
-  std::vector<int32_t> poly_verts, loop_counts;
-  std::vector<int32_t> crease_indices, crease_lengths;
-  bool has_flat_poly = false;
-
-  get_vertices(mesh, points);
-  get_topology(mesh, poly_verts, loop_counts, has_flat_poly);
-  get_creases(mesh, crease_indices, crease_lengths, crease_sharpness);
-
   if (m_first_frame && m_settings.export_face_sets) {
-    writeFaceSets(mesh, m_subdiv_schema);
+    writeFaceSets(m_subdiv_schema);
   }
 
-  m_subdiv_sample = OSubDSchema::Sample(
-      V3fArraySample(points), Int32ArraySample(poly_verts), Int32ArraySample(loop_counts));
+  m_subdiv_sample = OSubDSchema::Sample(V3fArraySample(m_sample.points),
+                                        Int32ArraySample(m_sample.poly_verts),
+                                        Int32ArraySample(m_sample.loop_counts));
 
-  UVSample sample;
   if (m_first_frame && m_settings.export_uvs) {
-    const char *name = get_uv_sample(sample, m_custom_data_config, &mesh->ldata);
+    const UVSample &sample = m_sample.uv_sample;
 
     if (!sample.indices.empty() && !sample.uvs.empty()) {
       OV2fGeomParam::Sample uv_sample;
@@ -405,7 +504,7 @@ void AbcGenericMeshWriter::writeSubD(struct Mesh *mesh)
       uv_sample.setIndices(UInt32ArraySample(sample.indices));
       uv_sample.setScope(kFacevaryingScope);
 
-      m_subdiv_schema.setUVSourceName(name);
+      m_subdiv_schema.setUVSourceName(m_sample.uv_name);
       m_subdiv_sample.setUVs(uv_sample);
     }
 
@@ -413,24 +512,23 @@ void AbcGenericMeshWriter::writeSubD(struct Mesh *mesh)
         m_subdiv_schema.getArbGeomParams(), m_custom_data_config, &mesh->ldata, CD_MLOOPUV);
   }
 
-  if (!crease_indices.empty()) {
-    m_subdiv_sample.setCreaseIndices(Int32ArraySample(crease_indices));
-    m_subdiv_sample.setCreaseLengths(Int32ArraySample(crease_lengths));
-    m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(crease_sharpness));
+  if (!m_sample.crease_indices.empty()) {
+    m_subdiv_sample.setCreaseIndices(Int32ArraySample(m_sample.crease_indices));
+    m_subdiv_sample.setCreaseLengths(Int32ArraySample(m_sample.crease_lengths));
+    m_subdiv_sample.setCreaseSharpnesses(FloatArraySample(m_sample.crease_sharpness));
   }
 
-  m_subdiv_sample.setSelfBounds(bounds());
+  m_subdiv_sample.setSelfBounds(m_sample.bounds);
   m_subdiv_schema.set(m_subdiv_sample);
 
   writeArbGeoParams(mesh);
 }
 
-template<typename Schema> void AbcGenericMeshWriter::writeFaceSets(struct Mesh *me, Schema &schema)
+template<typename Schema> void AbcGenericMeshWriter::writeFaceSets(Schema &schema)
 {
-  std::map<std::string, std::vector<int32_t>> geo_groups;
-  getGeoGroups(me, geo_groups);
+  const std::map<std::string, std::vector<int32_t>> &geo_groups = m_sample.geo_groups;
 
-  std::map<std::string, std::vector<int32_t>>::iterator it;
+  std::map<std::string, std::vector<int32_t>>::const_iterator it;
   for (it = geo_groups.begin(); it != geo_groups.end(); ++it) {
     OFaceSet face_set = schema.createFaceSet(it->first);
     OFaceSetSchema::Sample samp;
@@ -456,35 +554,6 @@ Mesh *AbcGenericMeshWriter::getFinalMesh(bool &r_needsfree)
     m_subsurf_mod->mode &= ~eModifierMode_DisableTemporary;
   }
 
-  if (m_settings.triangulate) {
-    const bool tag_only = false;
-    const int quad_method = m_settings.quad_method;
-    const int ngon_method = m_settings.ngon_method;
-
-    struct BMeshCreateParams bmcp = {false};
-    struct BMeshFromMeshParams bmfmp = {true, false, false, 0};
-    BMesh *bm = BKE_mesh_to_bmesh_ex(mesh, &bmcp, &bmfmp);
-
-    BM_mesh_triangulate(bm, quad_method, ngon_method, 4, tag_only, NULL, NULL, NULL);
-
-    Mesh *result = BKE_mesh_from_bmesh_for_eval_nomain(bm, NULL, mesh);
-    BM_mesh_free(bm);
-
-    if (r_needsfree) {
-      BKE_id_free(NULL, mesh);
-    }
-
-    mesh = result;
-    r_needsfree = true;
-  }
-
-  m_custom_data_config.pack_uvs = m_settings.pack_uv;
-  m_custom_data_config.mpoly = mesh->mpoly;
-  m_custom_data_config.mloop = mesh->mloop;
-  m_custom_data_config.totpoly = mesh->totpoly;
-  m_custom_data_config.totloop = mesh->totloop;
-  m_custom_data_config.totvert = mesh->totvert;
-
   return mesh;
 }
 
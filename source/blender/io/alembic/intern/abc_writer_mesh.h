@@ -27,6 +27,30 @@
 struct Mesh;
 struct ModifierData;
 
+/* Arrays converted from an evaluated mesh, ready to be stored in the archive. */
+struct AbcMeshSample {
+  std::vector<Imath::V3f> points;
+  std::vector<Imath::V3f> normals;
+  std::vector<Imath::V3f> velocities;
+  std::vector<int32_t> poly_verts;
+  std::vector<int32_t> loop_counts;
+
+  /* Subdivision surfaces only. */
+  std::vector<int32_t> crease_indices;
+  std::vector<int32_t> crease_lengths;
+  std::vector<float> crease_sharpness;
+
+  /* Only needed for the first frame. */
+  std::map<std::string, std::vector<int32_t>> geo_groups;
+  UVSample uv_sample;
+  std::string uv_name;
+
+  Imath::Box3d bounds;
+  bool has_flat_shaded_poly;
+
+  void clear();
+};
+
 /* Writer for Alembic meshes. Does not assume the object is a mesh object. */
 class AbcGenericMeshWriter : public AbcObjectWriter {
  protected:
@@ -46,6 +70,15 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   bool m_is_liquid;
   bool m_is_subd;
 
+  /* Mesh gathered by fetchSample(), owned by the writer when m_eval_mesh_needsfree is set. */
+  struct Mesh *m_eval_mesh;
+  bool m_eval_mesh_needsfree;
+  /* Mesh the sample is converted from, a triangulated copy of m_eval_mesh when triangulating. */
+  struct Mesh *m_export_mesh;
+
+  AbcMeshSample m_sample;
+  bool m_sample_prepared;
+
  public:
   AbcGenericMeshWriter(Object *ob,
                        AbcTransformWriter *parent,
@@ -55,6 +88,9 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   ~AbcGenericMeshWriter();
   void setIsAnimated(bool is_animated);
 
+  virtual bool fetchSample() override;
+  virtual void prepareSample() override;
+
  protected:
   virtual void do_write();
   virtual bool isAnimated() const;
@@ -62,6 +98,7 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   virtual void freeEvaluatedMesh(struct Mesh *mesh);
 
   Mesh *getFinalMesh(bool &r_needsfree);
+  void freeSampleMeshes();
 
   void writeMesh(struct Mesh *mesh);
   void writeSubD(struct Mesh *mesh);
@@ -72,7 +109,7 @@ class AbcGenericMeshWriter : public AbcObjectWriter {
   /* fluid surfaces support */
   void getVelocities(struct Mesh *mesh, std::vector<Imath::V3f> &vels);
 
-  template<typename Schema> void writeFaceSets(struct Mesh *mesh, Schema &schema);
+  template<typename Schema> void writeFaceSets(Schema &schema);
 };
 
 class AbcMeshWriter : public AbcGenericMeshWriter {
@@ -72,6 +72,20 @@ Imath::Box3d AbcObjectWriter::bounds()
   return this->m_bounds;
 }
 
+Object *AbcObjectWriter::object() const
+{
+  return m_object;
+}
+
+bool AbcObjectWriter::fetchSample()
+{
+  return false;
+}
+
+void AbcObjectWriter::prepareSample()
+{
+}
+
 void AbcObjectWriter::write()
 {
   do_write();
@@ -62,6 +62,20 @@ class AbcObjectWriter {
 
   virtual Imath::Box3d bounds();
 
+  Object *object() const;
+
+  /**
+   * Exporting a frame happens in stages. fetchSample() gathers the evaluated data on the main
+   * thread and returns whether there is anything to convert. prepareSample() then converts that
+   * data into Alembic arrays, and may run on a worker thread concurrently with the writers of
+   * other objects. write() finally stores the sample in the archive, which is never done by more
+   * than one thread at a time.
+   *
+   * Writers without a conversion stage read the evaluated data in write() itself.
+   */
+  virtual bool fetchSample();
+  virtual void prepareSample();
+
   void write();
 
  private:
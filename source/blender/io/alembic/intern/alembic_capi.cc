@@ -202,6 +202,11 @@ void ABC_free_handle(AbcArchiveHandle *handle)
   delete archive_from_handle(handle);
 }
 
+void ABC_get_prefetch_stats(AbcArchiveHandle *handle, int *r_hits, int *r_misses)
+{
+  archive_from_handle(handle)->prefetch_cache()->stats(r_hits, r_misses);
+}
+
 int ABC_get_version()
 {
   return ALEMBIC_LIBRARY_VERSION;
@@ -1065,6 +1070,7 @@ CacheReader *CacheReader_open_alembic_object(AbcArchiveHandle *handle,
     return NULL;
   }
   abc_reader->object(object);
+  abc_reader->prefetch_cache(archive->prefetch_cache());
   abc_reader->incref();
 
   return reinterpret_cast<CacheReader *>(abc_reader);
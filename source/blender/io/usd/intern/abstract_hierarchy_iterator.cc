@@ -32,6 +32,8 @@ extern "C" {
 #include "BLI_assert.h"
 #include "BLI_listbase.h"
 #include "BLI_math_matrix.h"
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
 
 #include "DNA_ID.h"
 #include "DNA_layer_types.h"
@@ -79,6 +81,15 @@ AbstractHierarchyWriter::~AbstractHierarchyWriter()
 {
 }
 
+bool AbstractHierarchyWriter::fetch_data(HierarchyContext & /*context*/)
+{
+  return false;
+}
+
+void AbstractHierarchyWriter::prepare_data()
+{
+}
+
 bool AbstractHierarchyWriter::check_is_animated(const HierarchyContext &context) const
 {
   const Object *object = context.object;
@@ -121,6 +132,7 @@ void AbstractHierarchyIterator::iterate_and_write()
   determine_export_paths(HierarchyContext::root());
   determine_duplication_references(HierarchyContext::root(), "");
   make_writers(HierarchyContext::root());
+  write_deferred_data();
   export_graph_clear();
 }
 
@@ -531,7 +543,41 @@ void AbstractHierarchyIterator::make_writer_object_data(const HierarchyContext *
     return;
   }
 
-  data_writer->write(data_context);
+  /* Written after all transforms, so that the data of all objects can be prepared in parallel. */
+  deferred_data_writes_.push_back(std::make_pair(data_writer, data_context));
+}
+
+static void prepare_data_task(TaskPool *__restrict UNUSED(pool),
+                              void *taskdata,
+                              int UNUSED(threadid))
+{
+  AbstractHierarchyWriter *writer = static_cast<AbstractHierarchyWriter *>(taskdata);
+  writer->prepare_data();
+}
+
+void AbstractHierarchyIterator::write_deferred_data()
+{
+  std::vector<AbstractHierarchyWriter *> writers_to_prepare;
+  for (DeferredWrites::value_type &item : deferred_data_writes_) {
+    if (item.first->fetch_data(item.second)) {
+      writers_to_prepare.push_back(item.first);
+    }
+  }
+
+  if (!writers_to_prepare.empty()) {
+    TaskPool *task_pool = BLI_task_pool_create(BLI_task_scheduler_get(), nullptr);
+    for (AbstractHierarchyWriter *writer : writers_to_prepare) {
+      BLI_task_pool_push(task_pool, prepare_data_task, writer, false, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_work_and_wait(task_pool);
+    BLI_task_pool_free(task_pool);
+  }
+
+  /* The file is written by one thread only, in the order the hierarchy was visited. */
+  for (DeferredWrites::value_type &item : deferred_data_writes_) {
+    item.first->write(item.second);
+  }
+  deferred_data_writes_.clear();
 }
 
 void AbstractHierarchyIterator::make_writers_particle_systems(
@@ -39,6 +39,8 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
+#include <vector>
 
 struct Base;
 struct Depsgraph;
@@ -112,6 +114,13 @@ class AbstractHierarchyWriter {
  public:
   virtual ~AbstractHierarchyWriter();
   virtual void write(HierarchyContext &context) = 0;
+
+  /* Optional conversion stage, so that the data of all object data writers of a frame can be
+   * converted in parallel. fetch_data() is called on the main thread and returns whether
+   * prepare_data() has any work to do. prepare_data() may run on a worker thread, concurrently
+   * with other writers. write() is then called on the main thread, in hierarchy order. */
+  virtual bool fetch_data(HierarchyContext &context);
+  virtual void prepare_data();
   // TODO(Sybren): add function like absent() that's called when a writer was previously created,
   // but wasn't used while exporting the current frame (for example, a particle-instanced mesh of
   // which the particle is no longer alive).
@@ -141,12 +150,15 @@ class AbstractHierarchyIterator {
   /* Mapping from ID to its export path. This is used for instancing; given an
    * instanced datablock, the export path of the original can be looked up. */
   typedef std::map<ID *, std::string> ExportPathMap;
+  /* Object data writers of the current frame, with the context they are written with. */
+  typedef std::vector<std::pair<AbstractHierarchyWriter *, HierarchyContext>> DeferredWrites;
 
  protected:
   ExportGraph export_graph_;
   ExportPathMap duplisource_export_path_;
   Depsgraph *depsgraph_;
   WriterMap writers_;
+  DeferredWrites deferred_data_writes_;
 
  public:
   explicit AbstractHierarchyIterator(Depsgraph *depsgraph);
@@ -196,6 +208,7 @@ class AbstractHierarchyIterator {
   void make_writers(const HierarchyContext *parent_context);
   void make_writer_object_data(const HierarchyContext *context);
   void make_writers_particle_systems(const HierarchyContext *context);
+  void write_deferred_data();
 
   /* Convenience wrappers around get_id_name(). */
   std::string get_object_name(const Object *object) const;
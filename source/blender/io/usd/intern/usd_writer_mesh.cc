@@ -47,8 +47,42 @@ extern "C" {
 
 namespace USD {
 
-USDGenericMeshWriter::USDGenericMeshWriter(const USDExporterContext &ctx) : USDAbstractWriter(ctx)
+struct USDMeshData {
+  pxr::VtArray<pxr::GfVec3f> points;
+  pxr::VtIntArray face_vertex_counts;
+  pxr::VtIntArray face_indices;
+  std::map<short, pxr::VtIntArray> face_groups;
+
+  /* The length of this array specifies the number of creases on the surface. Each element gives
+   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
+   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
+   * element of this array should be greater than one. */
+  pxr::VtIntArray crease_lengths;
+  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
+   * sum of all elements of the 'creaseLengths' attribute. */
+  pxr::VtIntArray crease_vertex_indices;
+  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
+   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
+   * the number of elements in this array will be either len(creaseLengths) or the sum over all X
+   * of (creaseLengths[X] - 1). Note that while the RI spec allows each crease to have either a
+   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
+   * a mesh, or sharpnesses for all edges making up the creases on a mesh. */
+  pxr::VtFloatArray crease_sharpnesses;
+
+  /* Face-varying normals, only when exporting normals. */
+  pxr::VtVec3fArray loop_normals;
+};
+
+USDGenericMeshWriter::USDGenericMeshWriter(const USDExporterContext &ctx)
+    : USDAbstractWriter(ctx), prepared_mesh_(nullptr), prepared_mesh_needsfree_(false)
+{
+}
+
+USDGenericMeshWriter::~USDGenericMeshWriter()
 {
+  if (prepared_mesh_ != nullptr && prepared_mesh_needsfree_) {
+    free_export_mesh(prepared_mesh_);
+  }
 }
 
 bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
@@ -76,11 +110,39 @@ bool USDGenericMeshWriter::is_supported(const HierarchyContext *context) const
   return (visibility & OB_VISIBLE_SELF) != 0;
 }
 
+bool USDGenericMeshWriter::fetch_data(HierarchyContext &context)
+{
+  /* Same as in USDAbstractWriter::write(), without animation one frame is enough. */
+  if (frame_has_been_written_ && !is_animated_) {
+    return false;
+  }
+
+  BLI_assert(prepared_mesh_ == nullptr);
+  prepared_mesh_ = get_export_mesh(context.object, prepared_mesh_needsfree_);
+  return prepared_mesh_ != nullptr;
+}
+
+void USDGenericMeshWriter::prepare_data()
+{
+  prepared_data_.reset(new USDMeshData());
+  get_geometry_data(prepared_mesh_, *prepared_data_);
+}
+
 void USDGenericMeshWriter::do_write(HierarchyContext &context)
 {
   Object *object_eval = context.object;
   bool needsfree = false;
-  Mesh *mesh = get_export_mesh(object_eval, needsfree);
+  Mesh *mesh;
+
+  if (prepared_mesh_ != nullptr) {
+    mesh = prepared_mesh_;
+    needsfree = prepared_mesh_needsfree_;
+    prepared_mesh_ = nullptr;
+    prepared_mesh_needsfree_ = false;
+  }
+  else {
+    mesh = get_export_mesh(object_eval, needsfree);
+  }
 
   if (mesh == NULL) {
     return;
@@ -106,29 +168,6 @@ void USDGenericMeshWriter::free_export_mesh(Mesh *mesh)
   BKE_id_free(NULL, mesh);
 }
 
-struct USDMeshData {
-  pxr::VtArray<pxr::GfVec3f> points;
-  pxr::VtIntArray face_vertex_counts;
-  pxr::VtIntArray face_indices;
-  std::map<short, pxr::VtIntArray> face_groups;
-
-  /* The length of this array specifies the number of creases on the surface. Each element gives
-   * the number of (must be adjacent) vertices in each crease, whose indices are linearly laid out
-   * in the 'creaseIndices' attribute. Since each crease must be at least one edge long, each
-   * element of this array should be greater than one. */
-  pxr::VtIntArray crease_lengths;
-  /* The indices of all vertices forming creased edges. The size of this array must be equal to the
-   * sum of all elements of the 'creaseLengths' attribute. */
-  pxr::VtIntArray crease_vertex_indices;
-  /* The per-crease or per-edge sharpness for all creases (Usd.Mesh.SHARPNESS_INFINITE for a
-   * perfectly sharp crease). Since 'creaseLengths' encodes the number of vertices in each crease,
-   * the number of elements in this array will be either len(creaseLengths) or the sum over all X
-   * of (creaseLengths[X] - 1). Note that while the RI spec allows each crease to have either a
-   * single sharpness or a value per-edge, USD will encode either a single sharpness per crease on
-   * a mesh, or sharpnesses for all edges making up the creases on a mesh. */
-  pxr::VtFloatArray crease_sharpnesses;
-};
-
 void USDGenericMeshWriter::write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
@@ -170,8 +209,14 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
   const pxr::SdfPath &usd_path = usd_export_context_.usd_path;
 
   pxr::UsdGeomMesh usd_mesh = pxr::UsdGeomMesh::Define(stage, usd_path);
-  USDMeshData usd_mesh_data;
-  get_geometry_data(mesh, usd_mesh_data);
+
+  /* The geometry was usually converted by prepare_data() already. */
+  if (!prepared_data_) {
+    prepared_data_.reset(new USDMeshData());
+    get_geometry_data(mesh, *prepared_data_);
+  }
+  const std::unique_ptr<USDMeshData> usd_mesh_data_ptr = std::move(prepared_data_);
+  const USDMeshData &usd_mesh_data = *usd_mesh_data_ptr;
 
   if (usd_export_context_.export_params.use_instancing && context.is_instance()) {
     // This object data is instanced, just reference the original instead of writing a copy.
@@ -244,7 +289,7 @@ void USDGenericMeshWriter::write_mesh(HierarchyContext &context, Mesh *mesh)
     write_uv_maps(mesh, usd_mesh);
   }
   if (usd_export_context_.export_params.export_normals) {
-    write_normals(mesh, usd_mesh);
+    write_normals(usd_mesh_data.loop_normals, usd_mesh);
   }
   write_surface_velocity(context.object, mesh, usd_mesh);
 
@@ -319,11 +364,56 @@ static void get_creases(const Mesh *mesh, USDMeshData &usd_mesh_data)
   }
 }
 
+static void get_loop_normals(const Mesh *mesh, USDMeshData &usd_mesh_data)
+{
+  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
+
+  pxr::VtVec3fArray &loop_normals = usd_mesh_data.loop_normals;
+  loop_normals.reserve(mesh->totloop);
+
+  if (lnors != nullptr) {
+    /* Export custom loop normals. */
+    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
+      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
+    }
+  }
+  else {
+    /* Compute the loop normals based on the 'smooth' flag. */
+    float normal[3];
+    MPoly *mpoly = mesh->mpoly;
+    const MVert *mvert = mesh->mvert;
+    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
+      MLoop *mloop = mesh->mloop + mpoly->loopstart;
+
+      if ((mpoly->flag & ME_SMOOTH) == 0) {
+        /* Flat shaded, use common normal for all verts. */
+        BKE_mesh_calc_poly_normal(mpoly, mloop, mvert, normal);
+        pxr::GfVec3f pxr_normal(normal);
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
+          loop_normals.push_back(pxr_normal);
+        }
+      }
+      else {
+        /* Smooth shaded, use individual vert normals. */
+        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
+          normal_short_to_float_v3(normal, mvert[mloop->v].no);
+          loop_normals.push_back(pxr::GfVec3f(normal));
+        }
+      }
+    }
+  }
+}
+
+/* Only reads from the mesh, so it can run for many meshes in parallel. */
 void USDGenericMeshWriter::get_geometry_data(const Mesh *mesh, USDMeshData &usd_mesh_data)
 {
   get_vertices(mesh, usd_mesh_data);
   get_loops_polys(mesh, usd_mesh_data);
   get_creases(mesh, usd_mesh_data);
+
+  if (usd_export_context_.export_params.export_normals) {
+    get_loop_normals(mesh, usd_mesh_data);
+  }
 }
 
 void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
@@ -387,45 +477,10 @@ void USDGenericMeshWriter::assign_materials(const HierarchyContext &context,
   }
 }
 
-void USDGenericMeshWriter::write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh)
+void USDGenericMeshWriter::write_normals(const pxr::VtVec3fArray &loop_normals,
+                                         pxr::UsdGeomMesh usd_mesh)
 {
   pxr::UsdTimeCode timecode = get_export_time_code();
-  const float(*lnors)[3] = static_cast<float(*)[3]>(CustomData_get_layer(&mesh->ldata, CD_NORMAL));
-
-  pxr::VtVec3fArray loop_normals;
-  loop_normals.reserve(mesh->totloop);
-
-  if (lnors != nullptr) {
-    /* Export custom loop normals. */
-    for (int loop_idx = 0, totloop = mesh->totloop; loop_idx < totloop; ++loop_idx) {
-      loop_normals.push_back(pxr::GfVec3f(lnors[loop_idx]));
-    }
-  }
-  else {
-    /* Compute the loop normals based on the 'smooth' flag. */
-    float normal[3];
-    MPoly *mpoly = mesh->mpoly;
-    const MVert *mvert = mesh->mvert;
-    for (int poly_idx = 0, totpoly = mesh->totpoly; poly_idx < totpoly; ++poly_idx, ++mpoly) {
-      MLoop *mloop = mesh->mloop + mpoly->loopstart;
-
-      if ((mpoly->flag & ME_SMOOTH) == 0) {
-        /* Flat shaded, use common normal for all verts. */
-        BKE_mesh_calc_poly_normal(mpoly, mloop, mvert, normal);
-        pxr::GfVec3f pxr_normal(normal);
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx) {
-          loop_normals.push_back(pxr_normal);
-        }
-      }
-      else {
-        /* Smooth shaded, use individual vert normals. */
-        for (int loop_idx = 0; loop_idx < mpoly->totloop; ++loop_idx, ++mloop) {
-          normal_short_to_float_v3(normal, mvert[mloop->v].no);
-          loop_normals.push_back(pxr::GfVec3f(normal));
-        }
-      }
-    }
-  }
 
   pxr::UsdAttribute attr_normals = usd_mesh.CreateNormalsAttr(pxr::VtValue(), true);
   if (!attr_normals.HasValue()) {
@@ -23,6 +23,8 @@
 
 #include <pxr/usd/usdGeom/mesh.h>
 
+#include <memory>
+
 namespace USD {
 
 struct USDMeshData;
@@ -31,6 +33,10 @@ struct USDMeshData;
 class USDGenericMeshWriter : public USDAbstractWriter {
  public:
   USDGenericMeshWriter(const USDExporterContext &ctx);
+  virtual ~USDGenericMeshWriter();
+
+  virtual bool fetch_data(HierarchyContext &context) override;
+  virtual void prepare_data() override;
 
  protected:
   virtual bool is_supported(const HierarchyContext *context) const override;
@@ -43,13 +49,18 @@ class USDGenericMeshWriter : public USDAbstractWriter {
   /* Mapping from material slot number to array of face indices with that material. */
   typedef std::map<short, pxr::VtIntArray> MaterialFaceGroups;
 
+  /* Mesh gathered by fetch_data() and the arrays prepare_data() converted from it. */
+  Mesh *prepared_mesh_;
+  bool prepared_mesh_needsfree_;
+  std::unique_ptr<struct USDMeshData> prepared_data_;
+
   void write_mesh(HierarchyContext &context, Mesh *mesh);
   void get_geometry_data(const Mesh *mesh, struct USDMeshData &usd_mesh_data);
   void assign_materials(const HierarchyContext &context,
                         pxr::UsdGeomMesh usd_mesh,
                         const MaterialFaceGroups &usd_face_groups);
   void write_uv_maps(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
-  void write_normals(const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
+  void write_normals(const pxr::VtVec3fArray &loop_normals, pxr::UsdGeomMesh usd_mesh);
   void write_surface_velocity(Object *object, const Mesh *mesh, pxr::UsdGeomMesh usd_mesh);
 };
 
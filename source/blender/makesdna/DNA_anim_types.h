@@ -591,7 +591,11 @@ typedef struct FCurve {
   /* value cache + settings */
   /** Value stored from last time curve was evaluated (not threadsafe, debug display only!). */
   float curval;
-  char _pad2[4];
+  /**
+   * Runtime, keyframe index found by the last evaluation, speeds up sequential playback.
+   * Cleared when reading and writing files.
+   */
+  int last_bezt_index;
   /** User-editable settings for this curve. */
   short flag;
   /** Value-extending mode for this curve (does not cover). */
@@ -1079,6 +1083,8 @@ typedef struct AnimData {
 
   /** Runtime data, for depsgraph evaluation. */
   FCurve **driver_array;
+  /** Runtime data, resolved channels of the active action, see anim_sys.c. */
+  struct AnimsysEvalCache *eval_cache;
 
   /* settings for animation evaluation */
   /** User-defined settings. */
@@ -54,6 +54,11 @@ typedef struct CustomDataLayer {
   char name[64];
   /** Layer data. */
   void *data;
+  /**
+   * Runtime only, user count when the data is shared with other layers
+   * (copy-on-write, see #CD_REFERENCE).
+   */
+  struct CustomDataLayerShared *shared;
 } CustomDataLayer;
 
 #define MAX_CUSTOMDATA_LAYER_NAME 64
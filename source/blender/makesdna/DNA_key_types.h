@@ -33,6 +33,7 @@
 
 struct AnimData;
 struct Ipo;
+struct KeySparseCache;
 
 typedef struct KeyBlock {
   struct KeyBlock *next, *prev;
@@ -116,6 +117,9 @@ typedef struct Key {
    * current free uid for keyblocks
    */
   int uidgen;
+
+  /** Runtime, offsets of relative key-blocks, built on evaluation (not saved in files). */
+  struct KeySparseCache *sparse_cache;
 } Key;
 
 /* **************** KEY ********************* */
@@ -95,6 +95,8 @@ typedef enum eRigidBodyWorld_Flag {
   /* RBW_FLAG_NEEDS_REBUILD = (1 << 1), */ /* UNUSED */
   /* usse split impulse when stepping the simulation */
   RBW_FLAG_USE_SPLIT_IMPULSE = (1 << 2),
+  /* solve independent simulation islands in parallel */
+  RBW_FLAG_USE_MULTITHREADING = (1 << 3),
 } eRigidBodyWorld_Flag;
 
 /* ******************************** */
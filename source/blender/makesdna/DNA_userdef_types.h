@@ -877,6 +877,13 @@ typedef struct UserDef {
 
   char _pad5[2];
 
+  /** Cache of evaluated modifier stacks, see #BKE_mesh_disk_cache.h. */
+  char mesh_disk_cache_dir[1024];
+  /** Size limit in megabytes. */
+  int mesh_disk_cache_size_limit;
+  short mesh_disk_cache_flag; /* eUserpref_MeshDiskCacheFlag */
+  char _pad14[2];
+
   struct WalkNavigation walk_navigation;
 
   /** The UI for the user preferences. */
@@ -1305,6 +1312,11 @@ typedef enum eUserpref_DiskCacheCompression {
   USER_SEQ_DISK_CACHE_COMPRESSION_HIGH = 2,
 } eUserpref_DiskCacheCompression;
 
+/** #UserDef.mesh_disk_cache_flag */
+typedef enum eUserpref_MeshDiskCacheFlag {
+  USER_MESH_DISK_CACHE_ENABLE = (1 << 0),
+} eUserpref_MeshDiskCacheFlag;
+
 #ifdef __cplusplus
 }
 #endif
@@ -149,9 +149,14 @@ int rna_ID_name_length(PointerRNA *ptr)
 void rna_ID_name_set(PointerRNA *ptr, const char *value)
 {
   ID *id = (ID *)ptr->data;
-  BLI_strncpy_utf8(id->name + 2, value, sizeof(id->name) - 2);
   BLI_assert(BKE_id_is_in_global_main(id));
-  BLI_libblock_ensure_unique_name(G_MAIN, id->name);
+  if (ID_IS_LINKED(id) || (id->tag & LIB_TAG_NO_MAIN)) {
+    BLI_strncpy_utf8(id->name + 2, value, sizeof(id->name) - 2);
+  }
+  else {
+    /* Also takes care of keeping the name unique and the list sorted. */
+    BKE_libblock_rename(G_MAIN, id, value);
+  }
 
   if (GS(id->name) == ID_OB) {
     Object *ob = (Object *)id;
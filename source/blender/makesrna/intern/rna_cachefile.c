@@ -53,6 +53,24 @@ static void rna_CacheFile_update(Main *UNUSED(bmain), Scene *UNUSED(scene), Poin
   WM_main_add_notifier(NC_OBJECT | ND_DRAW, NULL);
 }
 
+static int rna_CacheFile_prefetch_hits_get(PointerRNA *ptr)
+{
+  CacheFile *cache_file = (CacheFile *)ptr->data;
+  int hits, misses;
+
+  BKE_cachefile_prefetch_stats_get(cache_file, &hits, &misses);
+  return hits;
+}
+
+static int rna_CacheFile_prefetch_misses_get(PointerRNA *ptr)
+{
+  CacheFile *cache_file = (CacheFile *)ptr->data;
+  int hits, misses;
+
+  BKE_cachefile_prefetch_stats_get(cache_file, &hits, &misses);
+  return misses;
+}
+
 static void rna_CacheFile_object_paths_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   CacheFile *cache_file = (CacheFile *)ptr->data;
@@ -169,6 +187,24 @@ static void rna_def_cachefile(BlenderRNA *brna)
       prop, "Object Paths", "Paths of the objects inside the Alembic archive");
   rna_def_cachefile_object_paths(brna, prop);
 
+  /* ----------------- Statistics ----------------- */
+
+  prop = RNA_def_property(srna, "prefetch_hits", PROP_INT, PROP_UNSIGNED);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_CacheFile_prefetch_hits_get", NULL, NULL);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Hits",
+                           "Number of mesh samples which were read ahead in the background "
+                           "when needed (only set on the evaluated cache file)");
+
+  prop = RNA_def_property(srna, "prefetch_misses", PROP_INT, PROP_UNSIGNED);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_int_funcs(prop, "rna_CacheFile_prefetch_misses_get", NULL, NULL);
+  RNA_def_property_ui_text(prop,
+                           "Prefetch Misses",
+                           "Number of mesh samples which had to be read when needed "
+                           "(only set on the evaluated cache file)");
+
   rna_def_animdata_common(srna);
 }
 
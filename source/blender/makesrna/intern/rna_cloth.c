@@ -542,6 +542,38 @@ static void rna_def_cloth_solver_result(BlenderRNA *brna)
   RNA_def_property_clear_flag(prop, PROP_EDITABLE);
   RNA_def_property_ui_text(prop, "Average Iterations", "Average iterations during substeps");
 
+  prop = RNA_def_property(srna, "substeps", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "substeps");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop, "Substeps", "Number of substeps solved for the last frame");
+
+  prop = RNA_def_property(srna, "force_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "force_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop, "Force Time", "Time spent computing forces and constraints, in seconds");
+
+  prop = RNA_def_property(srna, "solve_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "solve_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(
+      prop, "Solve Time", "Time spent in the implicit velocity solver, in seconds");
+
+  prop = RNA_def_property(srna, "collision_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "collision_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop, "Collision Time", "Time spent resolving collisions, in seconds");
+
+  prop = RNA_def_property(srna, "avg_substep_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "avg_substep_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop, "Average Substep Time", "Average time of a substep, in seconds");
+
+  prop = RNA_def_property(srna, "max_substep_time", PROP_FLOAT, PROP_NONE);
+  RNA_def_property_float_sdna(prop, NULL, "max_substep_time");
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_ui_text(prop, "Maximum Substep Time", "Maximum time of a substep, in seconds");
+
   RNA_define_verify_sdna(1);
 }
 
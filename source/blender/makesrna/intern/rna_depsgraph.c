@@ -252,13 +252,27 @@ static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 static void rna_Depsgraph_debug_stats(Depsgraph *depsgraph, char *result)
 {
   size_t outer, ops, rels;
+  size_t bytes_copied, bytes_shared, cow_bytes_shared;
+  double build_time;
+  bool is_build_incremental;
   DEG_stats_simple(depsgraph, &outer, &ops, &rels);
+  DEG_stats_customdata(depsgraph, &bytes_copied, &bytes_shared);
+  DEG_stats_copy_on_write(depsgraph, &cow_bytes_shared);
+  DEG_stats_build(depsgraph, &build_time, &is_build_incremental, NULL, NULL);
   BLI_snprintf(result,
                STATS_MAX_SIZE,
-               "Approx %zu Operations, %zu Relations, %zu Outer Nodes",
+               "Approx %zu Operations, %zu Relations, %zu Outer Nodes, "
+               "CustomData %zu bytes copied, %zu bytes shared, "
+               "Copy-on-write %zu bytes shared with original, "
+               "Last %s build %.3f ms",
                ops,
                rels,
-               outer);
+               outer,
+               bytes_copied,
+               bytes_shared,
+               cow_bytes_shared,
+               is_build_incremental ? "incremental" : "full",
+               build_time * 1000.0);
 }
 
 static void rna_Depsgraph_update(Depsgraph *depsgraph, Main *bmain, ReportList *reports)
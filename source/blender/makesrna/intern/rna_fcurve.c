@@ -224,6 +224,22 @@ static bool rna_ChannelDriver_is_simple_expression_get(PointerRNA *ptr)
   return BKE_driver_has_simple_expression(driver);
 }
 
+static void rna_ChannelDriver_simple_expression_error_get(PointerRNA *ptr, char *value)
+{
+  ChannelDriver *driver = ptr->data;
+  const char *error = BKE_driver_simple_expression_error_get(driver);
+
+  strcpy(value, error ? error : "");
+}
+
+static int rna_ChannelDriver_simple_expression_error_length(PointerRNA *ptr)
+{
+  ChannelDriver *driver = ptr->data;
+  const char *error = BKE_driver_simple_expression_error_get(driver);
+
+  return error ? strlen(error) : 0;
+}
+
 static void rna_ChannelDriver_update_data(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   ID *id = ptr->owner_id;
@@ -1971,6 +1987,17 @@ static void rna_def_channeldriver(BlenderRNA *brna)
       "Simple Expression",
       "The scripted expression can be evaluated without using the full python interpreter");
 
+  prop = RNA_def_property(srna, "simple_expression_error", PROP_STRING, PROP_NONE);
+  RNA_def_property_clear_flag(prop, PROP_EDITABLE);
+  RNA_def_property_string_funcs(prop,
+                                "rna_ChannelDriver_simple_expression_error_get",
+                                "rna_ChannelDriver_simple_expression_error_length",
+                                NULL);
+  RNA_def_property_ui_text(
+      prop,
+      "Simple Expression Error",
+      "Reason the scripted expression needs the full python interpreter, empty if it doesn't");
+
   /* Functions */
   RNA_api_drivers(srna);
 }
@@ -90,6 +90,35 @@ static Mesh *rna_mesh(PointerRNA *ptr)
   return me;
 }
 
+/* Pointers into the geometry arrays handed out by collections may be written to. */
+static void rna_Mesh_vertices_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
+  rna_iterator_array_begin(iter, me->mvert, sizeof(MVert), me->totvert, 0, NULL);
+}
+
+static void rna_Mesh_edges_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
+  rna_iterator_array_begin(iter, me->medge, sizeof(MEdge), me->totedge, 0, NULL);
+}
+
+static void rna_Mesh_loops_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
+  rna_iterator_array_begin(iter, me->mloop, sizeof(MLoop), me->totloop, 0, NULL);
+}
+
+static void rna_Mesh_polygons_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
+{
+  Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
+  rna_iterator_array_begin(iter, me->mpoly, sizeof(MPoly), me->totpoly, 0, NULL);
+}
+
 static CustomData *rna_mesh_vdata_helper(Mesh *me)
 {
   return (me->edit_mesh) ? &me->edit_mesh->bm->vdata : &me->vdata;
@@ -675,6 +704,7 @@ static char *rna_MeshUVLoopLayer_path(PointerRNA *ptr)
 static void rna_MeshUVLoopLayer_data_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MLoopUV), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
@@ -727,6 +757,7 @@ DEFINE_CUSTOMDATA_LAYER_COLLECTION_ACTIVEITEM(
 static void rna_MeshLoopColorLayer_data_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(
       iter, layer->data, sizeof(MLoopCol), (me->edit_mesh) ? 0 : me->totloop, 0, NULL);
@@ -886,6 +917,7 @@ static char *rna_MeshSkinVertex_path(PointerRNA *ptr)
 static void rna_MeshSkinVertexLayer_data_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MVertSkin), me->totvert, 0, NULL);
 }
@@ -917,6 +949,7 @@ static char *rna_MeshPaintMask_path(PointerRNA *ptr)
 static void rna_MeshPaintMaskLayer_data_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totvert, 0, NULL);
 }
@@ -946,6 +979,7 @@ static char *rna_MeshFaceMapLayer_path(PointerRNA *ptr)
 static void rna_MeshFaceMapLayer_data_begin(CollectionPropertyIterator *iter, PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(int), me->totpoly, 0, NULL);
 }
@@ -1247,6 +1281,7 @@ static void rna_MeshVertexFloatPropertyLayer_data_begin(CollectionPropertyIterat
                                                         PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totvert, 0, NULL);
 }
@@ -1254,6 +1289,7 @@ static void rna_MeshPolygonFloatPropertyLayer_data_begin(CollectionPropertyItera
                                                          PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MFloatProperty), me->totpoly, 0, NULL);
 }
@@ -1298,6 +1334,7 @@ static void rna_MeshVertexIntPropertyLayer_data_begin(CollectionPropertyIterator
                                                       PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totvert, 0, NULL);
 }
@@ -1305,6 +1342,7 @@ static void rna_MeshPolygonIntPropertyLayer_data_begin(CollectionPropertyIterato
                                                        PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MIntProperty), me->totpoly, 0, NULL);
 }
@@ -1349,6 +1387,7 @@ static void rna_MeshVertexStringPropertyLayer_data_begin(CollectionPropertyItera
                                                          PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totvert, 0, NULL);
 }
@@ -1356,6 +1395,7 @@ static void rna_MeshPolygonStringPropertyLayer_data_begin(CollectionPropertyIter
                                                           PointerRNA *ptr)
 {
   Mesh *me = rna_mesh(ptr);
+  BKE_mesh_eval_ensure_own_geometry(me);
   CustomDataLayer *layer = (CustomDataLayer *)ptr->data;
   rna_iterator_array_begin(iter, layer->data, sizeof(MStringProperty), me->totpoly, 0, NULL);
 }
@@ -2738,24 +2778,32 @@ static void rna_def_mesh(BlenderRNA *brna)
 
   prop = RNA_def_property(srna, "vertices", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mvert", "totvert");
+  RNA_def_property_collection_funcs(
+      prop, "rna_Mesh_vertices_begin", NULL, NULL, NULL, NULL, NULL, NULL, NULL);
   RNA_def_property_struct_type(prop, "MeshVertex");
   RNA_def_property_ui_text(prop, "Vertices", "Vertices of the mesh");
   rna_def_mesh_vertices(brna, prop);
 
   prop = RNA_def_property(srna, "edges", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "medge", "totedge");
+  RNA_def_property_collection_funcs(
+      prop, "rna_Mesh_edges_begin", NULL, NULL, NULL, NULL, NULL, NULL, NULL);
   RNA_def_property_struct_type(prop, "MeshEdge");
   RNA_def_property_ui_text(prop, "Edges", "Edges of the mesh");
   rna_def_mesh_edges(brna, prop);
 
   prop = RNA_def_property(srna, "loops", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mloop", "totloop");
+  RNA_def_property_collection_funcs(
+      prop, "rna_Mesh_loops_begin", NULL, NULL, NULL, NULL, NULL, NULL, NULL);
   RNA_def_property_struct_type(prop, "MeshLoop");
   RNA_def_property_ui_text(prop, "Loops", "Loops of the mesh (polygon corners)");
   rna_def_mesh_loops(brna, prop);
 
   prop = RNA_def_property(srna, "polygons", PROP_COLLECTION, PROP_NONE);
   RNA_def_property_collection_sdna(prop, NULL, "mpoly", "totpoly");
+  RNA_def_property_collection_funcs(
+      prop, "rna_Mesh_polygons_begin", NULL, NULL, NULL, NULL, NULL, NULL, NULL);
   RNA_def_property_struct_type(prop, "MeshPolygon");
   RNA_def_property_ui_text(prop, "Polygons", "Polygons of the mesh");
   rna_def_mesh_polygons(brna, prop);
@@ -120,6 +120,7 @@ static void rna_Mesh_normals_split_custom_do(Mesh *mesh,
                                              float (*custom_loopnors)[3],
                                              const bool use_vertices)
 {
+  BKE_mesh_eval_ensure_own_geometry(mesh);
   if (use_vertices) {
     BKE_mesh_set_custom_normals_from_vertices(mesh, custom_loopnors);
   }
@@ -181,6 +182,7 @@ static void rna_Mesh_transform(Mesh *mesh, float *mat, bool shape_keys)
 
 static void rna_Mesh_flip_normals(Mesh *mesh)
 {
+  BKE_mesh_eval_ensure_own_geometry(mesh);
   BKE_mesh_polygons_flip(mesh->mpoly, mesh->mloop, &mesh->ldata, mesh->totpoly);
   BKE_mesh_tessface_clear(mesh);
   BKE_mesh_calc_normals(mesh);
@@ -191,9 +193,16 @@ static void rna_Mesh_flip_normals(Mesh *mesh)
 
 static void rna_Mesh_split_faces(Mesh *mesh, bool free_loop_normals)
 {
+  BKE_mesh_eval_ensure_own_geometry(mesh);
   BKE_mesh_split_faces(mesh, free_loop_normals != 0);
 }
 
+static bool rna_Mesh_validate(Mesh *mesh, bool verbose, bool clean_customdata)
+{
+  BKE_mesh_eval_ensure_own_geometry(mesh);
+  return BKE_mesh_validate(mesh, verbose, clean_customdata);
+}
+
 static void rna_Mesh_update_gpu_tag(Mesh *mesh)
 {
   BKE_mesh_batch_cache_dirty_tag(mesh, BKE_MESH_BATCH_DIRTY_ALL);
@@ -338,7 +347,7 @@ void RNA_api_mesh(StructRNA *srna)
       func,
       "Remove all geometry from the mesh. Note that this does not free shape keys or materials");
 
-  func = RNA_def_function(srna, "validate", "BKE_mesh_validate");
+  func = RNA_def_function(srna, "validate", "rna_Mesh_validate");
   RNA_def_function_ui_description(func,
                                   "Validate geometry, return True when the mesh has had "
                                   "invalid geometry corrected/removed");
@@ -551,6 +551,19 @@ static void rna_Userdef_disk_cache_dir_update(Main *UNUSED(bmain),
   USERDEF_TAG_DIRTY;
 }
 
+static void rna_Userdef_mesh_disk_cache_dir_update(Main *UNUSED(bmain),
+                                                   Scene *UNUSED(scene),
+                                                   PointerRNA *UNUSED(ptr))
+{
+  if (U.mesh_disk_cache_dir[0] != '\0') {
+    BLI_path_abs(U.mesh_disk_cache_dir, BKE_main_blendfile_path_from_global());
+    BLI_add_slash(U.mesh_disk_cache_dir);
+    BLI_path_make_safe(U.mesh_disk_cache_dir);
+  }
+
+  USERDEF_TAG_DIRTY;
+}
+
 static void rna_UserDef_weight_color_update(Main *bmain, Scene *scene, PointerRNA *ptr)
 {
   Object *ob;
@@ -5275,6 +5288,31 @@ static void rna_def_userdef_system(BlenderRNA *brna)
       "Disk Cache Compression Level",
       "Smaller compression will result in larger files, but less decoding overhead");
 
+  /* Mesh disk cache */
+
+  prop = RNA_def_property(srna, "use_mesh_disk_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "mesh_disk_cache_flag", USER_MESH_DISK_CACHE_ENABLE);
+  RNA_def_property_ui_text(
+      prop,
+      "Use Mesh Disk Cache",
+      "Store results of modifier stacks to disk, to reuse them when files are reloaded. Results "
+      "are stored by final renders and in background mode");
+
+  prop = RNA_def_property(srna, "mesh_disk_cache_dir", PROP_STRING, PROP_DIRPATH);
+  RNA_def_property_string_sdna(prop, NULL, "mesh_disk_cache_dir");
+  RNA_def_property_update(prop, 0, "rna_Userdef_mesh_disk_cache_dir_update");
+  RNA_def_property_ui_text(
+      prop, "Mesh Disk Cache Directory", "Directory to store evaluated meshes in");
+
+  prop = RNA_def_property(srna, "mesh_disk_cache_size_limit", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "mesh_disk_cache_size_limit");
+  RNA_def_property_range(prop, 1, INT_MAX);
+  RNA_def_property_ui_text(
+      prop,
+      "Mesh Disk Cache Limit",
+      "Mesh disk cache limit (in megabytes), applied to the files written by each instance of "
+      "Blender separately");
+
   prop = RNA_def_property(srna, "scrollback", PROP_INT, PROP_UNSIGNED);
   RNA_def_property_int_sdna(prop, NULL, "scrollback");
   RNA_def_property_range(prop, 32, 32768);
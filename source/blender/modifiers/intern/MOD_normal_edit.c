@@ -31,8 +31,8 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BKE_customdata.h"
 #include "BKE_deform.h"
-#include "BKE_lib_id.h"
 #include "BKE_lib_query.h"
 #include "BKE_mesh.h"
 
@@ -502,13 +502,26 @@ static Mesh *normalEditModifier_do(NormalEditModifierData *enmd,
   if (mesh->medge == ((Mesh *)ob->data)->medge) {
     /* We need to duplicate data here, otherwise setting custom normals
      * (which may also affect sharp edges) could
-     * modify original mesh, see T43671. */
-    BKE_id_copy_ex(NULL, &mesh->id, (ID **)&result, LIB_ID_COPY_LOCALIZE);
+     * modify original mesh, see T43671.
+     * Only the layers written to below are copied, others stay shared with 'mesh'. */
+    result = BKE_mesh_copy_for_eval(mesh, true);
   }
   else {
     result = mesh;
   }
 
+  CustomData_duplicate_referenced_layer(&result->vdata, CD_MVERT, result->totvert);
+  CustomData_duplicate_referenced_layer(&result->edata, CD_MEDGE, result->totedge);
+  CustomData_duplicate_referenced_layer(&result->pdata, CD_NORMAL, result->totpoly);
+  if ((enmd->flag & MOD_NORMALEDIT_NO_POLYNORS_FIX) == 0) {
+    /* Flipping polygons writes to all loop layers. */
+    CustomData_duplicate_referenced_layers(&result->ldata, result->totloop);
+  }
+  else {
+    CustomData_duplicate_referenced_layer(&result->ldata, CD_CUSTOMLOOPNORMAL, result->totloop);
+  }
+  BKE_mesh_update_customdata_pointers(result, false);
+
   const int num_verts = result->totvert;
   const int num_edges = result->totedge;
   const int num_loops = result->totloop;
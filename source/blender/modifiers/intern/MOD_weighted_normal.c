@@ -29,8 +29,8 @@
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BKE_customdata.h"
 #include "BKE_deform.h"
-#include "BKE_lib_id.h"
 #include "BKE_mesh.h"
 
 #include "MOD_modifiertypes.h"
@@ -566,8 +566,13 @@ static Mesh *applyModifier(ModifierData *md, const ModifierEvalContext *ctx, Mes
     return mesh;
   }
 
-  Mesh *result;
-  BKE_id_copy_ex(NULL, &mesh->id, (ID **)&result, LIB_ID_COPY_LOCALIZE);
+  /* Only copy the layers written to below, others (UVs, colors...) stay shared with 'mesh'. */
+  Mesh *result = BKE_mesh_copy_for_eval(mesh, true);
+  CustomData_duplicate_referenced_layer(&result->vdata, CD_MVERT, result->totvert);
+  CustomData_duplicate_referenced_layer(&result->edata, CD_MEDGE, result->totedge);
+  CustomData_duplicate_referenced_layer(&result->pdata, CD_NORMAL, result->totpoly);
+  CustomData_duplicate_referenced_layer(&result->ldata, CD_CUSTOMLOOPNORMAL, result->totloop);
+  BKE_mesh_update_customdata_pointers(result, false);
 
   const int numVerts = result->totvert;
   const int numEdges = result->totedge;
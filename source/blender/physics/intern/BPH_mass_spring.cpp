@@ -35,6 +35,8 @@ extern "C" {
 #include "BLI_math.h"
 #include "BLI_utildefines.h"
 
+#include "PIL_time.h"
+
 #include "BKE_cloth.h"
 #include "BKE_collision.h"
 #include "BKE_effect.h"
@@ -1088,6 +1090,30 @@ static void cloth_clear_result(ClothModifierData *clmd)
   sres->max_error = sres->min_error = sres->avg_error = 0.0f;
   sres->max_iterations = sres->min_iterations = 0;
   sres->avg_iterations = 0.0f;
+
+  sres->substeps = 0;
+  sres->force_time = sres->solve_time = sres->collision_time = 0.0f;
+  sres->avg_substep_time = sres->max_substep_time = 0.0f;
+}
+
+static void cloth_record_timing(ClothModifierData *clmd,
+                                double time_start,
+                                double time_forces,
+                                double time_solve,
+                                double time_collision,
+                                double time_end)
+{
+  ClothSolverResult *sres = clmd->solver_result;
+  const float substep_time = (float)(time_end - time_start);
+
+  sres->force_time += (float)(time_forces - time_start);
+  sres->solve_time += (float)(time_solve - time_forces);
+  sres->collision_time += (float)(time_collision - time_solve);
+
+  sres->max_substep_time = max_ff(sres->max_substep_time, substep_time);
+  sres->avg_substep_time = (sres->avg_substep_time * sres->substeps + substep_time) /
+                           (sres->substeps + 1);
+  sres->substeps++;
 }
 
 static void cloth_record_result(ClothModifierData *clmd, ImplicitSolverResult *result, float dt)
@@ -1162,6 +1188,7 @@ int BPH_cloth_solve(
 
   while (step < tf) {
     ImplicitSolverResult result;
+    const double time_start = PIL_check_seconds_timer();
 
     /* setup vertex constraints for pinned vertices */
     cloth_setup_constraints(clmd);
@@ -1171,13 +1198,16 @@ int BPH_cloth_solve(
 
     // calculate forces
     cloth_calc_force(scene, clmd, frame, effectors, step);
+    const double time_forces = PIL_check_seconds_timer();
 
     // calculate new velocity and position
     BPH_mass_spring_solve_velocities(id, dt, &result);
     cloth_record_result(clmd, &result, dt);
+    const double time_solve = PIL_check_seconds_timer();
 
     /* Calculate collision impulses. */
     cloth_solve_collisions(depsgraph, ob, clmd, step, dt);
+    const double time_collision = PIL_check_seconds_timer();
 
     if (is_hair) {
       cloth_continuum_step(clmd, dt);
@@ -1202,6 +1232,9 @@ int BPH_cloth_solve(
       BPH_mass_spring_get_motion_state(id, i, verts[i].txold, NULL);
     }
 
+    cloth_record_timing(
+        clmd, time_start, time_forces, time_solve, time_collision, PIL_check_seconds_timer());
+
     step += dt;
   }
 
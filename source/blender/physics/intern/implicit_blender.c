@@ -34,6 +34,7 @@
 #  include "DNA_texture_types.h"
 
 #  include "BLI_math.h"
+#  include "BLI_task.h"
 #  include "BLI_utildefines.h"
 
 #  include "BKE_cloth.h"
@@ -652,6 +653,182 @@ DO_INLINE void subadd_bfmatrixS_bfmatrixS(
   }
 }
 
+///////////////////////////
+// Row-wise block-sparse matrix for the parallel solver
+///////////////////////////
+
+/* Number of vertices handled by one task of the parallel kernels.
+ * Reductions store one partial sum per chunk and add them up in order afterwards,
+ * so results don't depend on the number of threads or on scheduling. */
+#  define CLOTH_PARALLEL_CHUNK_SIZE 1024
+/* Below this number of vertices the kernels run on the calling thread. */
+#  define CLOTH_PARALLEL_LIMIT 2048
+
+/* Compressed sparse row copy of the symmetric system matrix.
+ *
+ * fmatrix3x3 arrays only store the lower triangle as a list of blocks, which can't be
+ * multiplied row by row without write conflicts. Here both triangles are stored explicitly
+ * (transposed blocks pre-transposed), grouped by row in one contiguous array. */
+typedef struct BlockCSRMatrix {
+  unsigned int vcount;
+  unsigned int nnz;         /* number of off-diagonal blocks, both triangles */
+  unsigned int *row_offset; /* vcount + 1 offsets into col and values */
+  unsigned int *row_fill;   /* build cursor for each row */
+  unsigned int *col;
+  float (*values)[3][3];
+  float (*diag)[3][3];
+  float (*diag_inv)[3][3]; /* block-Jacobi preconditioner */
+
+  unsigned int num_chunks;
+  float *partial; /* two reduction results per chunk */
+} BlockCSRMatrix;
+
+static BlockCSRMatrix *create_csrmatrix(unsigned int verts, unsigned int springs)
+{
+  BlockCSRMatrix *csr = MEM_callocN(sizeof(BlockCSRMatrix), "cloth_implicit_csr");
+
+  csr->vcount = verts;
+  csr->row_offset = MEM_mallocN(sizeof(unsigned int) * (verts + 1), "cloth_implicit_csr_rows");
+  csr->row_fill = MEM_mallocN(sizeof(unsigned int) * max_ii(verts, 1), "cloth_implicit_csr_fill");
+  csr->col = MEM_mallocN(sizeof(unsigned int) * max_ii(2 * springs, 1), "cloth_implicit_csr_cols");
+  csr->values = MEM_mallocN(sizeof(float[3][3]) * max_ii(2 * springs, 1),
+                            "cloth_implicit_csr_values");
+  csr->diag = MEM_mallocN(sizeof(float[3][3]) * max_ii(verts, 1), "cloth_implicit_csr_diag");
+  csr->diag_inv = MEM_mallocN(sizeof(float[3][3]) * max_ii(verts, 1),
+                              "cloth_implicit_csr_diag_inv");
+
+  csr->num_chunks = (verts + CLOTH_PARALLEL_CHUNK_SIZE - 1) / CLOTH_PARALLEL_CHUNK_SIZE;
+  csr->partial = MEM_callocN(sizeof(float) * 2 * max_ii(csr->num_chunks, 1),
+                             "cloth_implicit_csr_partial");
+
+  return csr;
+}
+
+static void del_csrmatrix(BlockCSRMatrix *csr)
+{
+  if (csr != NULL) {
+    MEM_freeN(csr->row_offset);
+    MEM_freeN(csr->row_fill);
+    MEM_freeN(csr->col);
+    MEM_freeN(csr->values);
+    MEM_freeN(csr->diag);
+    MEM_freeN(csr->diag_inv);
+    MEM_freeN(csr->partial);
+    MEM_freeN(csr);
+  }
+}
+
+BLI_INLINE void csr_chunk_range(const BlockCSRMatrix *csr,
+                                const int chunk,
+                                unsigned int *r_start,
+                                unsigned int *r_end)
+{
+  *r_start = (unsigned int)chunk * CLOTH_PARALLEL_CHUNK_SIZE;
+  *r_end = min_ii(*r_start + CLOTH_PARALLEL_CHUNK_SIZE, csr->vcount);
+}
+
+static void csr_parallel_chunks(BlockCSRMatrix *csr, void *userdata, TaskParallelRangeFunc func)
+{
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (csr->vcount > CLOTH_PARALLEL_LIMIT);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, (int)csr->num_chunks, userdata, func, &settings);
+}
+
+/* Sum the partial reduction results of all chunks, always in the same order. */
+static void csr_sum_partial(const BlockCSRMatrix *csr, float r_sum[2])
+{
+  r_sum[0] = r_sum[1] = 0.0f;
+  for (unsigned int chunk = 0; chunk < csr->num_chunks; chunk++) {
+    r_sum[0] += csr->partial[2 * chunk];
+    r_sum[1] += csr->partial[2 * chunk + 1];
+  }
+}
+
+typedef struct CSRDiagData {
+  BlockCSRMatrix *csr;
+  fmatrix3x3 *lA;
+} CSRDiagData;
+
+/* Sylvester's criterion, only used to validate the preconditioner blocks. */
+BLI_INLINE bool fmatrix_is_positive_definite(float m[3][3])
+{
+  return (m[0][0] > 0.0f) && (m[0][0] * m[1][1] - m[0][1] * m[1][0] > 0.0f) &&
+         (determinant_m3_array(m) > 0.0f);
+}
+
+static void csr_diag_chunk_cb(void *__restrict userdata,
+                              const int chunk,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CSRDiagData *data = userdata;
+  BlockCSRMatrix *csr = data->csr;
+  fmatrix3x3 *lA = data->lA;
+  unsigned int start, end;
+
+  csr_chunk_range(csr, chunk, &start, &end);
+  for (unsigned int i = start; i < end; i++) {
+    copy_m3_m3(csr->diag[i], lA[i].m);
+
+    /* Diagonal blocks of A are positive definite unless springs are strongly compressed,
+     * fall back to no preconditioning for the vertex when that's not the case. */
+    if (!fmatrix_is_positive_definite(lA[i].m) || !invert_m3_m3(csr->diag_inv[i], lA[i].m)) {
+      unit_m3(csr->diag_inv[i]);
+    }
+  }
+}
+
+/* Fill the row-wise matrix from the first num_blocks off-diagonal blocks of lA,
+ * and compute the block-Jacobi preconditioner from its diagonal. */
+static void csr_build(BlockCSRMatrix *csr, fmatrix3x3 *lA, unsigned int num_blocks)
+{
+  const unsigned int vcount = csr->vcount;
+  fmatrix3x3 *blocks = lA + vcount;
+  unsigned int *row_offset = csr->row_offset;
+  unsigned int i;
+
+  BLI_assert(lA[0].vcount == vcount && num_blocks <= lA[0].scount);
+
+  memset(row_offset, 0, sizeof(unsigned int) * (vcount + 1));
+  for (i = 0; i < num_blocks; i++) {
+    row_offset[blocks[i].r + 1]++;
+    row_offset[blocks[i].c + 1]++;
+  }
+  for (i = 0; i < vcount; i++) {
+    row_offset[i + 1] += row_offset[i];
+  }
+  csr->nnz = row_offset[vcount];
+
+  memcpy(csr->row_fill, row_offset, sizeof(unsigned int) * vcount);
+  for (i = 0; i < num_blocks; i++) {
+    const unsigned int r = blocks[i].r, c = blocks[i].c;
+    unsigned int k;
+
+    /* This is the lower triangle of the sparse matrix,
+     * the upper triangle uses the transposed submatrices. */
+    k = csr->row_fill[r]++;
+    csr->col[k] = c;
+    copy_m3_m3(csr->values[k], blocks[i].m);
+
+    k = csr->row_fill[c]++;
+    csr->col[k] = r;
+    transpose_m3_m3(csr->values[k], blocks[i].m);
+  }
+
+  CSRDiagData data = {csr, lA};
+  csr_parallel_chunks(csr, &data, csr_diag_chunk_cb);
+}
+
+/* to = row i of (A * from) */
+BLI_INLINE void csr_mul_row(float to[3], const BlockCSRMatrix *csr, lfVector *from, unsigned int i)
+{
+  mul_fmatrix_fvector(to, csr->diag[i], from[i]);
+  for (unsigned int k = csr->row_offset[i]; k < csr->row_offset[i + 1]; k++) {
+    muladd_fmatrix_fvector(to, csr->values[k], from[csr->col[k]]);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////
 // simulator start
 ///////////////////////////////////////////////////////////////////
@@ -677,6 +854,7 @@ typedef struct Implicit_Data {
   lfVector *z;          /* target velocity in constrained directions */
   fmatrix3x3 *S;        /* filtering matrix for constraints */
   fmatrix3x3 *P, *Pinv; /* pre-conditioning matrix */
+  BlockCSRMatrix *csr;  /* row-wise copy of A used by the parallel solver */
 } Implicit_Data;
 
 Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
@@ -701,6 +879,7 @@ Implicit_Data *BPH_mass_spring_solver_create(int numverts, int numsprings)
   id->B = create_lfvector(numverts);
   id->dV = create_lfvector(numverts);
   id->z = create_lfvector(numverts);
+  id->csr = create_csrmatrix(numverts, numsprings);
 
   initdiag_bfmatrix(id->bigI, I);
 
@@ -727,6 +906,7 @@ void BPH_mass_spring_solver_free(Implicit_Data *id)
   del_lfvector(id->B);
   del_lfvector(id->dV);
   del_lfvector(id->z);
+  del_csrmatrix(id->csr);
 
   MEM_freeN(id);
 }
@@ -838,8 +1018,129 @@ static int cg_filtered(lfVector *ldV, fmatrix3x3 *lA, lfVector *lB, lfVector *z,
 }
 #  endif
 
+typedef struct CGParallelData {
+  BlockCSRMatrix *A;
+  fmatrix3x3 *S;
+  lfVector *B, *z;
+  lfVector *dV, *r, *c, *q;
+  float alpha, beta;
+} CGParallelData;
+
+/* Constrained directions are removed per vertex, so filtering fits into the row kernels. */
+BLI_INLINE void cg_filter_row(float v[3], const CGParallelData *data, unsigned int i)
+{
+  mul_m3_v3(data->S[i].m, v);
+}
+
+/* dV = z, r = filter(B - A * dV), c = filter(P^-1 * r)
+ * partial: filter(B)^T * P^-1 * filter(B), r^T * c */
+static void cg_init_chunk_cb(void *__restrict userdata,
+                             const int chunk,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CGParallelData *data = userdata;
+  BlockCSRMatrix *A = data->A;
+  float bnorm2 = 0.0f, delta = 0.0f;
+  unsigned int start, end;
+
+  csr_chunk_range(A, chunk, &start, &end);
+  for (unsigned int i = start; i < end; i++) {
+    float AdV[3], fB[3], tmp[3];
+
+    copy_v3_v3(data->dV[i], data->z[i]);
+
+    copy_v3_v3(fB, data->B[i]);
+    cg_filter_row(fB, data, i);
+    mul_fmatrix_fvector(tmp, A->diag_inv[i], fB);
+    cg_filter_row(tmp, data, i);
+    bnorm2 += dot_v3v3(fB, tmp);
+
+    csr_mul_row(AdV, A, data->z, i);
+    sub_v3_v3v3(data->r[i], data->B[i], AdV);
+    cg_filter_row(data->r[i], data, i);
+
+    mul_fmatrix_fvector(data->c[i], A->diag_inv[i], data->r[i]);
+    cg_filter_row(data->c[i], data, i);
+    delta += dot_v3v3(data->r[i], data->c[i]);
+  }
+
+  A->partial[2 * chunk] = bnorm2;
+  A->partial[2 * chunk + 1] = delta;
+}
+
+/* q = filter(A * c)
+ * partial: c^T * q */
+static void cg_mul_chunk_cb(void *__restrict userdata,
+                            const int chunk,
+                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CGParallelData *data = userdata;
+  BlockCSRMatrix *A = data->A;
+  float cq = 0.0f;
+  unsigned int start, end;
+
+  csr_chunk_range(A, chunk, &start, &end);
+  for (unsigned int i = start; i < end; i++) {
+    csr_mul_row(data->q[i], A, data->c, i);
+    cg_filter_row(data->q[i], data, i);
+    cq += dot_v3v3(data->c[i], data->q[i]);
+  }
+
+  A->partial[2 * chunk] = cq;
+  A->partial[2 * chunk + 1] = 0.0f;
+}
+
+/* dV += alpha * c, r -= alpha * q
+ * partial: r^T * filter(P^-1 * r) */
+static void cg_step_chunk_cb(void *__restrict userdata,
+                             const int chunk,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CGParallelData *data = userdata;
+  BlockCSRMatrix *A = data->A;
+  float delta = 0.0f;
+  unsigned int start, end;
+
+  csr_chunk_range(A, chunk, &start, &end);
+  for (unsigned int i = start; i < end; i++) {
+    float s[3];
+
+    madd_v3_v3fl(data->dV[i], data->c[i], data->alpha);
+    madd_v3_v3fl(data->r[i], data->q[i], -data->alpha);
+
+    mul_fmatrix_fvector(s, A->diag_inv[i], data->r[i]);
+    cg_filter_row(s, data, i);
+    delta += dot_v3v3(data->r[i], s);
+  }
+
+  A->partial[2 * chunk] = delta;
+  A->partial[2 * chunk + 1] = 0.0f;
+}
+
+/* c = filter(P^-1 * r + beta * c) */
+static void cg_direction_chunk_cb(void *__restrict userdata,
+                                  const int chunk,
+                                  const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const CGParallelData *data = userdata;
+  BlockCSRMatrix *A = data->A;
+  unsigned int start, end;
+
+  csr_chunk_range(A, chunk, &start, &end);
+  for (unsigned int i = start; i < end; i++) {
+    float s[3];
+
+    mul_fmatrix_fvector(s, A->diag_inv[i], data->r[i]);
+    madd_v3_v3v3fl(data->c[i], s, data->c[i], data->beta);
+    cg_filter_row(data->c[i], data, i);
+  }
+}
+
+/* Block-Jacobi preconditioned, filtered conjugate gradient solver.
+ * Every pass over the vertices runs in parallel chunks, vector updates are fused into
+ * the matrix-vector product and reductions so each iteration makes three passes. */
 static int cg_filtered(lfVector *ldV,
-                       fmatrix3x3 *lA,
+                       BlockCSRMatrix *lA,
                        lfVector *lB,
                        lfVector *z,
                        fmatrix3x3 *S,
@@ -849,38 +1150,30 @@ static int cg_filtered(lfVector *ldV,
   unsigned int conjgrad_loopcount = 0, conjgrad_looplimit = 100;
   float conjgrad_epsilon = 0.01f;
 
-  unsigned int numverts = lA[0].vcount;
-  lfVector *fB = create_lfvector(numverts);
-  lfVector *AdV = create_lfvector(numverts);
-  lfVector *r = create_lfvector(numverts);
-  lfVector *c = create_lfvector(numverts);
-  lfVector *q = create_lfvector(numverts);
-  lfVector *s = create_lfvector(numverts);
-  float bnorm2, delta_new, delta_old, delta_target, alpha;
-
-  cp_lfvector(ldV, z, numverts);
-
-  /* d0 = filter(B)^T * P * filter(B) */
-  cp_lfvector(fB, lB, numverts);
-  filter(fB, S);
-  bnorm2 = dot_lfvector(fB, fB, numverts);
+  unsigned int numverts = lA->vcount;
+  float bnorm2, delta_new, delta_old, delta_target, sum[2];
+  CGParallelData data = {
+      .A = lA,
+      .S = S,
+      .B = lB,
+      .z = z,
+      .dV = ldV,
+      .r = create_lfvector(numverts),
+      .c = create_lfvector(numverts),
+      .q = create_lfvector(numverts),
+  };
+
+  /* d0 = filter(B)^T * P^-1 * filter(B)
+   * r = filter(B - A * dV)
+   * c = filter(P^-1 * r)
+   * delta = r^T * c */
+  csr_parallel_chunks(lA, &data, cg_init_chunk_cb);
+  csr_sum_partial(lA, sum);
+  bnorm2 = sum[0];
+  delta_new = sum[1];
   delta_target = conjgrad_epsilon * conjgrad_epsilon * bnorm2;
 
-  /* r = filter(B - A * dV) */
-  mul_bfmatrix_lfvector(AdV, lA, ldV);
-  sub_lfvector_lfvector(r, lB, AdV, numverts);
-  filter(r, S);
-
-  /* c = filter(P^-1 * r) */
-  cp_lfvector(c, r, numverts);
-  filter(c, S);
-
-  /* delta = r^T * c */
-  delta_new = dot_lfvector(r, c, numverts);
-
 #  ifdef IMPLICIT_PRINT_SOLVER_INPUT_OUTPUT
-  printf("==== A ====\n");
-  print_bfmatrix(lA);
   printf("==== z ====\n");
   print_lvector(z, numverts);
   printf("==== B ====\n");
@@ -890,22 +1183,19 @@ static int cg_filtered(lfVector *ldV,
 #  endif
 
   while (delta_new > delta_target && conjgrad_loopcount < conjgrad_looplimit) {
-    mul_bfmatrix_lfvector(q, lA, c);
-    filter(q, S);
-
-    alpha = delta_new / dot_lfvector(c, q, numverts);
+    csr_parallel_chunks(lA, &data, cg_mul_chunk_cb);
+    csr_sum_partial(lA, sum);
 
-    add_lfvector_lfvectorS(ldV, ldV, c, alpha, numverts);
+    data.alpha = delta_new / sum[0];
 
-    add_lfvector_lfvectorS(r, r, q, -alpha, numverts);
+    csr_parallel_chunks(lA, &data, cg_step_chunk_cb);
+    csr_sum_partial(lA, sum);
 
-    /* s = P^-1 * r */
-    cp_lfvector(s, r, numverts);
     delta_old = delta_new;
-    delta_new = dot_lfvector(r, s, numverts);
+    delta_new = sum[0];
 
-    add_lfvector_lfvectorS(c, s, c, delta_new / delta_old, numverts);
-    filter(c, S);
+    data.beta = delta_new / delta_old;
+    csr_parallel_chunks(lA, &data, cg_direction_chunk_cb);
 
     conjgrad_loopcount++;
   }
@@ -916,12 +1206,9 @@ static int cg_filtered(lfVector *ldV,
   printf("========\n");
 #  endif
 
-  del_lfvector(fB);
-  del_lfvector(AdV);
-  del_lfvector(r);
-  del_lfvector(c);
-  del_lfvector(q);
-  del_lfvector(s);
+  del_lfvector(data.r);
+  del_lfvector(data.c);
+  del_lfvector(data.q);
   // printf("W/O conjgrad_loopcount: %d\n", conjgrad_loopcount);
 
   result->status = conjgrad_loopcount < conjgrad_looplimit ? BPH_SOLVER_SUCCESS :
@@ -1159,7 +1446,8 @@ bool BPH_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSol
 #  endif
 
   /* Conjugate gradient algorithm to solve Ax=b. */
-  cg_filtered(data->dV, data->A, data->B, data->z, data->S, result);
+  csr_build(data->csr, data->A, data->num_blocks);
+  cg_filtered(data->dV, data->csr, data->B, data->z, data->S, result);
 
   // cg_filtered_pre(id->dV, id->A, id->B, id->z, id->S, id->P, id->Pinv, id->bigI);
 
@@ -44,6 +44,7 @@
 #include "bpy_rna.h"
 #include "bpy_rna_gizmo.h"
 #include "bpy_rna_id_collection.h"
+#include "bpy_rna_mesh_buffer.h"
 #include "bpy_utils_previews.h"
 #include "bpy_utils_units.h"
 
@@ -383,6 +384,7 @@ void BPy_init_modules(void)
   BPY_library_write_module(mod);
 
   BPY_rna_id_collection_module(mod);
+  BPY_rna_mesh_buffer_module(mod);
 
   BPY_rna_gizmo_module(mod);
 
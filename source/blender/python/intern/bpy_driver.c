@@ -32,6 +32,7 @@
 #include "BLI_listbase.h"
 #include "BLI_math_base.h"
 #include "BLI_string.h"
+#include "BLI_utildefines.h"
 
 #include "BKE_fcurve.h"
 #include "BKE_global.h"
@@ -64,6 +65,76 @@ PyObject *bpy_pydriver_Dict = NULL;
 static PyObject *bpy_pydriver_Dict__whitelist = NULL;
 #endif
 
+/* Functions also supported by the simple expression evaluator (see BLI_expr_pylike_eval.c),
+ * so expressions using them still work when they need Python for another reason. */
+
+static PyObject *bpy_pydriver_clamp(PyObject *UNUSED(self), PyObject *args)
+{
+  double value, min = 0.0, max = 1.0;
+
+  if (!PyArg_ParseTuple(args, "d|dd:clamp", &value, &min, &max)) {
+    return NULL;
+  }
+
+  CLAMP(value, min, max);
+  return PyFloat_FromDouble(value);
+}
+
+static PyObject *bpy_pydriver_lerp(PyObject *UNUSED(self), PyObject *args)
+{
+  double a, b, t;
+
+  if (!PyArg_ParseTuple(args, "ddd:lerp", &a, &b, &t)) {
+    return NULL;
+  }
+
+  return PyFloat_FromDouble(a + (b - a) * t);
+}
+
+static bool bpy_pydriver_inverse_lerp_ex(double a, double b, double x, double *r_t)
+{
+  if (a == b) {
+    PyErr_SetString(PyExc_ZeroDivisionError, "float division by zero");
+    return false;
+  }
+
+  *r_t = (x - a) / (b - a);
+  return true;
+}
+
+static PyObject *bpy_pydriver_inverse_lerp(PyObject *UNUSED(self), PyObject *args)
+{
+  double a, b, x, t;
+
+  if (!PyArg_ParseTuple(args, "ddd:inverse_lerp", &a, &b, &x) ||
+      !bpy_pydriver_inverse_lerp_ex(a, b, x, &t)) {
+    return NULL;
+  }
+
+  return PyFloat_FromDouble(t);
+}
+
+static PyObject *bpy_pydriver_smoothstep(PyObject *UNUSED(self), PyObject *args)
+{
+  double a, b, x, t;
+
+  if (!PyArg_ParseTuple(args, "ddd:smoothstep", &a, &b, &x) ||
+      !bpy_pydriver_inverse_lerp_ex(a, b, x, &t)) {
+    return NULL;
+  }
+
+  CLAMP(t, 0.0, 1.0);
+  return PyFloat_FromDouble(t * t * (3.0 - 2.0 * t));
+}
+
+static PyMethodDef bpy_pydriver_methods[] = {
+    {"clamp", (PyCFunction)bpy_pydriver_clamp, METH_VARARGS, NULL},
+    {"lerp", (PyCFunction)bpy_pydriver_lerp, METH_VARARGS, NULL},
+    {"inverse_lerp", (PyCFunction)bpy_pydriver_inverse_lerp, METH_VARARGS, NULL},
+    {"smoothstep", (PyCFunction)bpy_pydriver_smoothstep, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL},
+};
+
 /* For faster execution we keep a special dictionary for pydrivers, with
  * the needed modules and aliases.
  */
@@ -96,6 +167,15 @@ int bpy_pydriver_create_dict(void)
   PyObject *mod_math = mod;
 #endif
 
+  /* add helper functions */
+  for (PyMethodDef *method = bpy_pydriver_methods; method->ml_name; method++) {
+    PyObject *func = PyCFunction_New(method, NULL);
+    if (func) {
+      PyDict_SetItemString(d, method->ml_name, func);
+      Py_DECREF(func);
+    }
+  }
+
   /* add bpy to global namespace */
   mod = PyImport_ImportModuleLevel("bpy", NULL, NULL, NULL, 0);
   if (mod) {
@@ -130,6 +210,11 @@ int bpy_pydriver_create_dict(void)
         "bool",
         "float",
         "int",
+        /* driver helpers */
+        "clamp",
+        "inverse_lerp",
+        "lerp",
+        "smoothstep",
 
         NULL,
     };
@@ -0,0 +1,464 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup pythonintern
+ *
+ * This file exposes the arrays of a mesh to Python through the buffer protocol,
+ * so they can be read and written without copying, see `Mesh.attribute_buffer()`.
+ */
+
+#include <Python.h>
+#include <stddef.h>
+
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
+
+#include "BKE_customdata.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "DNA_ID.h"
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+#include "DEG_depsgraph.h"
+
+#include "../generic/py_capi_utils.h"
+
+#include "RNA_access.h"
+
+#include "bpy_rna.h"
+#include "bpy_rna_mesh_buffer.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Attribute Types
+ * \{ */
+
+typedef enum eMeshBufferDomain {
+  MESH_BUFFER_VERT = 0,
+  MESH_BUFFER_EDGE,
+  MESH_BUFFER_LOOP,
+  MESH_BUFFER_POLY,
+} eMeshBufferDomain;
+
+/** One member of the elements of a custom-data layer, exposed as a (strided) array. */
+typedef struct MeshBufferType {
+  const char *identifier;
+  eMeshBufferDomain domain;
+  int cd_type;
+  /** Offset of the member in the element. */
+  int offset;
+  /** Format string as used by the struct module. */
+  const char *format;
+  int itemsize;
+  /** Number of items per element, zero for a one dimensional array. */
+  int dims;
+  /** Whether the layer is looked up by name, otherwise the mesh only has one layer of the type. */
+  bool use_name;
+} MeshBufferType;
+
+static const MeshBufferType mesh_buffer_types[] = {
+    {"POSITION", MESH_BUFFER_VERT, CD_MVERT, offsetof(MVert, co), "f", sizeof(float), 3, false},
+    {"EDGE_VERTICES",
+     MESH_BUFFER_EDGE,
+     CD_MEDGE,
+     offsetof(MEdge, v1),
+     "I",
+     sizeof(uint),
+     2,
+     false},
+    {"LOOP_VERTEX", MESH_BUFFER_LOOP, CD_MLOOP, offsetof(MLoop, v), "I", sizeof(uint), 0, false},
+    {"LOOP_EDGE", MESH_BUFFER_LOOP, CD_MLOOP, offsetof(MLoop, e), "I", sizeof(uint), 0, false},
+    {"POLYGON_LOOP_START",
+     MESH_BUFFER_POLY,
+     CD_MPOLY,
+     offsetof(MPoly, loopstart),
+     "i",
+     sizeof(int),
+     0,
+     false},
+    {"POLYGON_LOOP_TOTAL",
+     MESH_BUFFER_POLY,
+     CD_MPOLY,
+     offsetof(MPoly, totloop),
+     "i",
+     sizeof(int),
+     0,
+     false},
+    {"POLYGON_MATERIAL_INDEX",
+     MESH_BUFFER_POLY,
+     CD_MPOLY,
+     offsetof(MPoly, mat_nr),
+     "h",
+     sizeof(short),
+     0,
+     false},
+    {"UV", MESH_BUFFER_LOOP, CD_MLOOPUV, offsetof(MLoopUV, uv), "f", sizeof(float), 2, true},
+    {"COLOR", MESH_BUFFER_LOOP, CD_MLOOPCOL, offsetof(MLoopCol, r), "B", sizeof(char), 4, true},
+    {"VERTEX_FLOAT", MESH_BUFFER_VERT, CD_PROP_FLT, 0, "f", sizeof(float), 0, true},
+    {"VERTEX_INT", MESH_BUFFER_VERT, CD_PROP_INT, 0, "i", sizeof(int), 0, true},
+    {"POLYGON_FLOAT", MESH_BUFFER_POLY, CD_PROP_FLT, 0, "f", sizeof(float), 0, true},
+    {"POLYGON_INT", MESH_BUFFER_POLY, CD_PROP_INT, 0, "i", sizeof(int), 0, true},
+};
+
+static PyC_FlagSet mesh_buffer_type_items[ARRAY_SIZE(mesh_buffer_types) + 1];
+
+static CustomData *mesh_buffer_customdata(Mesh *me, eMeshBufferDomain domain, int *r_totelem)
+{
+  switch (domain) {
+    case MESH_BUFFER_VERT:
+      *r_totelem = me->totvert;
+      return &me->vdata;
+    case MESH_BUFFER_EDGE:
+      *r_totelem = me->totedge;
+      return &me->edata;
+    case MESH_BUFFER_LOOP:
+      *r_totelem = me->totloop;
+      return &me->ldata;
+    case MESH_BUFFER_POLY:
+      *r_totelem = me->totpoly;
+      return &me->pdata;
+  }
+  BLI_assert(0);
+  return NULL;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Buffer Type
+ *
+ * The buffer object only refers to the mesh and the layer, the array is looked up again each
+ * time a view is requested. Views export the array (see #CustomData_layer_export), it stays
+ * allocated as long as the view exists. Once the mesh geometry changes (adding or removing
+ * elements or layers, leaving edit-mode or freeing the mesh) the mesh uses new arrays and the
+ * view keeps the previous data. Request a new view afterwards, e.g. by calling
+ * `memoryview(buffer)` again.
+ * \{ */
+
+typedef struct BPy_MeshBuffer {
+  PyObject_HEAD
+  /** The #BPy_StructRNA of the mesh, also used to check it was not removed. */
+  PyObject *py_mesh;
+  const MeshBufferType *type;
+  char name[MAX_CUSTOMDATA_LAYER_NAME];
+} BPy_MeshBuffer;
+
+/** Storage for the shape and strides of one view, and the export of its array. */
+typedef struct MeshBufferView {
+  Py_ssize_t shape[2];
+  Py_ssize_t strides[2];
+  struct CustomDataLayerShared *export;
+  void *layer_data;
+  int cd_type;
+  int totelem;
+} MeshBufferView;
+
+static Mesh *mesh_buffer_mesh_get(BPy_MeshBuffer *self)
+{
+  if (pyrna_struct_validity_check((BPy_StructRNA *)self->py_mesh) == -1) {
+    return NULL;
+  }
+  return (Mesh *)((BPy_StructRNA *)self->py_mesh)->ptr.owner_id;
+}
+
+static int mesh_buffer_layer_index(Mesh *me, const MeshBufferType *type, const char *name)
+{
+  int totelem;
+  CustomData *data = mesh_buffer_customdata(me, type->domain, &totelem);
+
+  if (type->use_name) {
+    if (name[0] == '\0') {
+      return CustomData_get_active_layer_index(data, type->cd_type);
+    }
+    return CustomData_get_named_layer_index(data, type->cd_type, name);
+  }
+  return CustomData_get_layer_index(data, type->cd_type);
+}
+
+static int bpy_mesh_buffer_getbuffer(BPy_MeshBuffer *self, Py_buffer *view, int flags)
+{
+  const MeshBufferType *type = self->type;
+  const bool is_writable = (flags & PyBUF_WRITABLE) != 0;
+
+  Mesh *me = mesh_buffer_mesh_get(self);
+  if (me == NULL) {
+    view->obj = NULL;
+    return -1;
+  }
+
+  if (me->edit_mesh != NULL) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "Mesh.attribute_buffer(): the mesh is in edit-mode, "
+                    "its arrays are only updated when leaving edit-mode");
+    view->obj = NULL;
+    return -1;
+  }
+
+  if (is_writable) {
+    if (ID_IS_LINKED(&me->id)) {
+      PyErr_SetString(PyExc_BufferError,
+                      "Mesh.attribute_buffer(): linked mesh data can not be written to");
+      view->obj = NULL;
+      return -1;
+    }
+    if (me->id.tag & LIB_TAG_COPIED_ON_WRITE) {
+      PyErr_SetString(PyExc_BufferError,
+                      "Mesh.attribute_buffer(): evaluated mesh data can not be written to");
+      view->obj = NULL;
+      return -1;
+    }
+  }
+
+  const Py_ssize_t elem_size = (Py_ssize_t)CustomData_sizeof(type->cd_type);
+  const Py_ssize_t item_len = (type->dims != 0) ? type->dims : 1;
+  const bool is_contiguous = (elem_size == type->itemsize * item_len);
+
+  if (!is_contiguous && (flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+    PyErr_Format(PyExc_BufferError,
+                 "Mesh.attribute_buffer(): '%s' is not contiguous in memory, "
+                 "only strided views are supported",
+                 type->identifier);
+    view->obj = NULL;
+    return -1;
+  }
+
+  int totelem;
+  CustomData *data = mesh_buffer_customdata(me, type->domain, &totelem);
+  const int layer_index = mesh_buffer_layer_index(me, type, self->name);
+
+  /* Meshes without elements may not have the layer, they get an empty array. */
+  if (layer_index == -1 && (totelem != 0 || type->use_name)) {
+    PyErr_Format(PyExc_KeyError,
+                 "Mesh.attribute_buffer(): '%s' layer '%s' not found",
+                 type->identifier,
+                 self->name);
+    view->obj = NULL;
+    return -1;
+  }
+
+  MeshBufferView *view_data = PyMem_Malloc(sizeof(*view_data));
+  if (view_data == NULL) {
+    PyErr_NoMemory();
+    view->obj = NULL;
+    return -1;
+  }
+
+  char *layer_data = NULL;
+  struct CustomDataLayerShared *layer_export = NULL;
+  if (layer_index != -1) {
+    /* Writing needs data owned by this mesh, it may be shared with other meshes
+     * or referenced from the original. */
+    layer_data = CustomData_layer_export(data, layer_index, totelem, is_writable, &layer_export);
+    if (is_writable) {
+      BKE_mesh_update_customdata_pointers(me, false);
+    }
+  }
+  if (layer_data == NULL) {
+    static char empty_data[1];
+    layer_data = empty_data;
+  }
+
+  view_data->export = layer_export;
+  view_data->layer_data = layer_data;
+  view_data->cd_type = type->cd_type;
+  view_data->totelem = totelem;
+  view_data->shape[0] = totelem;
+  view_data->shape[1] = type->dims;
+  view_data->strides[0] = elem_size;
+  view_data->strides[1] = type->itemsize;
+
+  view->buf = layer_data + type->offset;
+  view->obj = (PyObject *)self;
+  Py_INCREF(self);
+  view->len = totelem * item_len * type->itemsize;
+  view->readonly = !is_writable;
+  view->itemsize = type->itemsize;
+  view->format = (flags & PyBUF_FORMAT) ? (char *)type->format : NULL;
+  view->ndim = (type->dims != 0) ? 2 : 1;
+  view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ? view_data->shape : NULL;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? view_data->strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = view_data;
+
+  return 0;
+}
+
+static void bpy_mesh_buffer_releasebuffer(BPy_MeshBuffer *self, Py_buffer *view)
+{
+  MeshBufferView *view_data = view->internal;
+
+  /* The data may have changed through this view, tag once all writes are done so evaluation
+   * sees them. Can't raise here, so the mesh is checked without #pyrna_struct_validity_check. */
+  if (!view->readonly && ((BPy_StructRNA *)self->py_mesh)->ptr.type != NULL) {
+    Mesh *me = (Mesh *)((BPy_StructRNA *)self->py_mesh)->ptr.owner_id;
+    DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY);
+  }
+
+  if (view_data->export != NULL) {
+    /* Frees the array when the mesh doesn't use it anymore. */
+    CustomData_layer_export_release(
+        view_data->export, view_data->cd_type, view_data->layer_data, view_data->totelem);
+  }
+  PyMem_Free(view_data);
+}
+
+static PyBufferProcs bpy_mesh_buffer_as_buffer = {
+    (getbufferproc)bpy_mesh_buffer_getbuffer,
+    (releasebufferproc)bpy_mesh_buffer_releasebuffer,
+};
+
+static void bpy_mesh_buffer_dealloc(BPy_MeshBuffer *self)
+{
+  Py_XDECREF(self->py_mesh);
+  Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject *bpy_mesh_buffer_repr(BPy_MeshBuffer *self)
+{
+  Mesh *me = mesh_buffer_mesh_get(self);
+  if (me == NULL) {
+    return NULL;
+  }
+  return PyUnicode_FromFormat("<Mesh(\"%s\").attribute_buffer('%s', \"%s\")>",
+                              me->id.name + 2,
+                              self->type->identifier,
+                              self->name);
+}
+
+static PyTypeObject bpy_mesh_buffer_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0) "bpy_mesh_buffer", /* tp_name */
+    sizeof(BPy_MeshBuffer),                           /* tp_basicsize */
+    0,                                                /* tp_itemsize */
+    /* methods */
+    (destructor)bpy_mesh_buffer_dealloc, /* tp_dealloc */
+    (printfunc)NULL,                     /* printfunc tp_print; */
+    NULL,                                /* getattrfunc tp_getattr; */
+    NULL,                                /* setattrfunc tp_setattr; */
+    NULL,
+    /* tp_compare */ /* DEPRECATED in python 3.0! */
+    (reprfunc)bpy_mesh_buffer_repr, /* tp_repr */
+
+    /* Method suites for standard classes */
+
+    NULL, /* PyNumberMethods *tp_as_number; */
+    NULL, /* PySequenceMethods *tp_as_sequence; */
+    NULL, /* PyMappingMethods *tp_as_mapping; */
+
+    /* More standard operations (here for binary compatibility) */
+
+    NULL, /* hashfunc tp_hash; */
+    NULL, /* ternaryfunc tp_call; */
+    NULL, /* reprfunc tp_str; */
+    NULL, /* getattrofunc tp_getattro; */
+    NULL, /* setattrofunc tp_setattro; */
+
+    /* Functions to access object as input/output buffer */
+    &bpy_mesh_buffer_as_buffer, /* PyBufferProcs *tp_as_buffer; */
+
+    /*** Flags to define presence of optional/expanded features ***/
+    Py_TPFLAGS_DEFAULT, /* long tp_flags; */
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Module Functions
+ * \{ */
+
+PyDoc_STRVAR(bpy_mesh_attribute_buffer_doc,
+             ".. method:: attribute_buffer(type, name=\"\")\n"
+             "\n"
+             "   Access an array of the mesh through the buffer protocol, without copying.\n"
+             "   Views of the buffer read and write the mesh data directly.\n"
+             "   Writable views (``numpy.asarray(buffer)``) tag the mesh for update once they\n"
+             "   are released, read-only views (``memoryview(buffer)``) leave the mesh\n"
+             "   untouched.\n"
+             "   They are invalid once the geometry of the mesh changes (elements or layers\n"
+             "   added or removed, edit-mode toggled), request a new view then.\n"
+             "\n"
+             "   :arg type: The array to access, one of "
+             "'POSITION', 'EDGE_VERTICES', 'LOOP_VERTEX', 'LOOP_EDGE',\n"
+             "      'POLYGON_LOOP_START', 'POLYGON_LOOP_TOTAL', 'POLYGON_MATERIAL_INDEX', "
+             "'UV', 'COLOR',\n"
+             "      'VERTEX_FLOAT', 'VERTEX_INT', 'POLYGON_FLOAT', 'POLYGON_INT'.\n"
+             "   :type type: string\n"
+             "   :arg name: Name of the layer for types with multiple layers,\n"
+             "      the active layer is used when empty.\n"
+             "   :type name: string\n"
+             "   :return: an object supporting the buffer protocol.\n");
+static PyObject *bpy_mesh_attribute_buffer(PyObject *UNUSED(self), PyObject *args, PyObject *kwds)
+{
+  PyObject *py_mesh;
+  const char *type_id;
+  const char *name = "";
+  ID *id;
+  int type_index;
+
+  static const char *_keywords[] = {"mesh", "type", "name", NULL};
+  static _PyArg_Parser _parser = {"Os|s:attribute_buffer", _keywords, 0};
+  if (!_PyArg_ParseTupleAndKeywordsFast(args, kwds, &_parser, &py_mesh, &type_id, &name)) {
+    return NULL;
+  }
+
+  if (!pyrna_id_FromPyObject(py_mesh, &id) || GS(id->name) != ID_ME) {
+    PyErr_Format(PyExc_TypeError,
+                 "Mesh.attribute_buffer(): expected a Mesh, not %.200s",
+                 Py_TYPE(py_mesh)->tp_name);
+    return NULL;
+  }
+
+  if (PyC_FlagSet_ValueFromID(
+          mesh_buffer_type_items, type_id, &type_index, "Mesh.attribute_buffer()") == -1) {
+    return NULL;
+  }
+
+  BPy_MeshBuffer *self = PyObject_New(BPy_MeshBuffer, &bpy_mesh_buffer_Type);
+  self->py_mesh = py_mesh;
+  Py_INCREF(py_mesh);
+  self->type = &mesh_buffer_types[type_index];
+  STRNCPY(self->name, name);
+
+  return (PyObject *)self;
+}
+
+int BPY_rna_mesh_buffer_module(PyObject *mod_par)
+{
+  static PyMethodDef attribute_buffer = {
+      "attribute_buffer",
+      (PyCFunction)bpy_mesh_attribute_buffer,
+      METH_VARARGS | METH_KEYWORDS,
+      bpy_mesh_attribute_buffer_doc,
+  };
+
+  PyModule_AddObject(
+      mod_par, "_rna_mesh_attribute_buffer", PyCFunction_New(&attribute_buffer, NULL));
+
+  for (int i = 0; i < ARRAY_SIZE(mesh_buffer_types); i++) {
+    mesh_buffer_type_items[i].value = i;
+    mesh_buffer_type_items[i].identifier = mesh_buffer_types[i].identifier;
+  }
+
+  if (PyType_Ready(&bpy_mesh_buffer_Type) < 0) {
+    return -1;
+  }
+
+  return 0;
+}
+
+/** \} */
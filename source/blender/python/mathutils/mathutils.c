@@ -796,6 +796,15 @@ PyMODINIT_FUNC PyInit_mathutils(void)
   if (PyType_Ready(&color_Type) < 0) {
     return NULL;
   }
+  if (PyType_Ready(&vector_array_Type) < 0) {
+    return NULL;
+  }
+  if (PyType_Ready(&matrix_array_Type) < 0) {
+    return NULL;
+  }
+  if (PyType_Ready(&quaternion_array_Type) < 0) {
+    return NULL;
+  }
 
   mod = PyModule_Create(&M_Mathutils_module_def);
 
@@ -805,6 +814,9 @@ PyMODINIT_FUNC PyInit_mathutils(void)
   PyModule_AddObject(mod, euler_Type.tp_name, (PyObject *)&euler_Type);
   PyModule_AddObject(mod, quaternion_Type.tp_name, (PyObject *)&quaternion_Type);
   PyModule_AddObject(mod, color_Type.tp_name, (PyObject *)&color_Type);
+  PyModule_AddObject(mod, vector_array_Type.tp_name, (PyObject *)&vector_array_Type);
+  PyModule_AddObject(mod, matrix_array_Type.tp_name, (PyObject *)&matrix_array_Type);
+  PyModule_AddObject(mod, quaternion_array_Type.tp_name, (PyObject *)&quaternion_array_Type);
 
   /* submodule */
   PyModule_AddObject(mod, "geometry", (submodule = PyInit_mathutils_geometry()));
@@ -69,6 +69,7 @@ typedef struct {
 } BaseMathObject;
 
 /* types */
+#include "mathutils_Array.h"
 #include "mathutils_Color.h"
 #include "mathutils_Euler.h"
 #include "mathutils_Matrix.h"
@@ -0,0 +1,1587 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+/** \file
+ * \ingroup pymathutils
+ *
+ * Array types (#VectorArray, #MatrixArray and #QuaternionArray) storing many elements in one
+ * buffer. Operations loop over all elements in C, without creating a Python object per element,
+ * and the data is exposed through the buffer protocol for use with other modules (numpy).
+ */
+
+#include <Python.h>
+
+#include "mathutils.h"
+
+#include "BLI_math.h"
+#include "BLI_utildefines.h"
+
+#include "BLI_strict_flags.h"
+
+/**
+ * Release the GIL while looping over arrays with at least this many elements,
+ * so other Python threads can run meanwhile. Below this the overhead isn't worth it.
+ */
+#define MATH_ARRAY_THREADS_MIN 4096
+
+#define MATH_ARRAY_BEGIN_ALLOW_THREADS(_len) \
+  { \
+    PyThreadState *_math_array_tstate = ((_len) >= MATH_ARRAY_THREADS_MIN) ? \
+                                            PyEval_SaveThread() : \
+                                            NULL; \
+    (void)0
+#define MATH_ARRAY_END_ALLOW_THREADS \
+  if (_math_array_tstate) { \
+    PyEval_RestoreThread(_math_array_tstate); \
+  } \
+  } \
+  (void)0
+
+/* -------------------------------------------------------------------- */
+/** \name Utilities
+ * \{ */
+
+static const char *math_array_type_names[] = {"VectorArray", "MatrixArray", "QuaternionArray"};
+
+static int math_array_elem_len(const int kind, const int size)
+{
+  return (kind == MATH_ARRAY_MATRIX) ? size * size : size;
+}
+
+static Py_ssize_t math_array_stride(const MathArrayObject *self)
+{
+  return (Py_ssize_t)math_array_elem_len(self->kind, self->size);
+}
+
+static int math_array_kind_from_type(PyTypeObject *type)
+{
+  if (PyType_IsSubtype(type, &matrix_array_Type)) {
+    return MATH_ARRAY_MATRIX;
+  }
+  if (PyType_IsSubtype(type, &quaternion_array_Type)) {
+    return MATH_ARRAY_QUATERNION;
+  }
+  BLI_assert(PyType_IsSubtype(type, &vector_array_Type));
+  return MATH_ARRAY_VECTOR;
+}
+
+/**
+ * Allocate an array of \a len elements, the data is left uninitialized.
+ */
+PyObject *MathArray_CreatePyObject_alloc(PyTypeObject *type, Py_ssize_t len, int size)
+{
+  const int kind = math_array_kind_from_type(type);
+  const Py_ssize_t elem_len = (Py_ssize_t)math_array_elem_len(kind, size);
+  MathArrayObject *self;
+
+  if (len > PY_SSIZE_T_MAX / (elem_len * (Py_ssize_t)sizeof(float))) {
+    PyErr_SetString(PyExc_MemoryError, "array too large");
+    return NULL;
+  }
+
+  self = (MathArrayObject *)type->tp_alloc(type, 0);
+  if (self == NULL) {
+    return NULL;
+  }
+
+  /* Never allocate zero bytes, so empty arrays still have a valid pointer. */
+  self->data = PyMem_Malloc((size_t)MAX2(len * elem_len, 1) * sizeof(float));
+  if (self->data == NULL) {
+    Py_DECREF(self);
+    PyErr_NoMemory();
+    return NULL;
+  }
+  self->len = len;
+  self->size = size;
+  self->kind = (unsigned char)kind;
+
+  return (PyObject *)self;
+}
+
+static MathArrayObject *math_array_new_like(const MathArrayObject *self, int size)
+{
+  return (MathArrayObject *)MathArray_CreatePyObject_alloc(Py_TYPE(self), self->len, size);
+}
+
+/**
+ * A float array of the same length as the input, for operations giving a scalar per element.
+ * Returned as a memoryview of a bytearray, which numpy and array.array accept without copying.
+ */
+static PyObject *math_array_float_result(Py_ssize_t len, float **r_data)
+{
+  PyObject *bytes = PyByteArray_FromStringAndSize(NULL, len * (Py_ssize_t)sizeof(float));
+  if (bytes == NULL) {
+    return NULL;
+  }
+  *r_data = (float *)PyByteArray_AS_STRING(bytes);
+  return bytes;
+}
+
+static PyObject *math_array_float_result_finish(PyObject *bytes)
+{
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  PyObject *ret;
+
+  Py_DECREF(bytes);
+  if (view == NULL) {
+    return NULL;
+  }
+
+  ret = PyObject_CallMethod(view, "cast", "s", "f");
+  Py_DECREF(view);
+  return ret;
+}
+
+/** Either an array or a single value used for all elements of the other array. */
+typedef struct MathArrayOperand {
+  const float *data;
+  /** Number of floats between elements, zero for a single value. */
+  Py_ssize_t stride;
+  /** Number of elements, -1 for a single value. */
+  Py_ssize_t len;
+  int size;
+  float value[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+} MathArrayOperand;
+
+static void math_array_operand_from_array(MathArrayOperand *op, const MathArrayObject *array)
+{
+  op->data = array->data;
+  op->stride = math_array_stride(array);
+  op->len = array->len;
+  op->size = array->size;
+}
+
+static void math_array_operand_from_value(MathArrayOperand *op, int size)
+{
+  op->data = op->value;
+  op->stride = 0;
+  op->len = -1;
+  op->size = size;
+}
+
+/**
+ * \return 1 when \a value is a vector (array), 0 when it's another type, -1 on error.
+ * Any sequence is accepted as a single vector when \a use_sequence is set.
+ */
+static int math_array_operand_vector(PyObject *value,
+                                     MathArrayOperand *op,
+                                     const bool use_sequence,
+                                     const char *error_prefix)
+{
+  int size;
+
+  if (VectorArrayObject_Check(value)) {
+    math_array_operand_from_array(op, (MathArrayObject *)value);
+    return 1;
+  }
+  if (!(VectorObject_Check(value) || (use_sequence && PySequence_Check(value)))) {
+    return 0;
+  }
+  if ((size = mathutils_array_parse(op->value, 2, 4, value, error_prefix)) == -1) {
+    return -1;
+  }
+  math_array_operand_from_value(op, size);
+  return 1;
+}
+
+static int math_array_operand_matrix(PyObject *value,
+                                     MathArrayOperand *op,
+                                     const char *error_prefix)
+{
+  MatrixObject *mat;
+
+  if (MatrixArrayObject_Check(value)) {
+    math_array_operand_from_array(op, (MathArrayObject *)value);
+    return 1;
+  }
+  if (!MatrixObject_Check(value)) {
+    return 0;
+  }
+
+  mat = (MatrixObject *)value;
+  if (BaseMath_ReadCallback(mat) == -1) {
+    return -1;
+  }
+  if (mat->num_col != mat->num_row) {
+    PyErr_Format(PyExc_ValueError, "%s: only square matrices are supported", error_prefix);
+    return -1;
+  }
+  memcpy(op->value, mat->matrix, sizeof(float) * (size_t)(mat->num_col * mat->num_row));
+  math_array_operand_from_value(op, mat->num_col);
+  return 1;
+}
+
+static int math_array_operand_quaternion(PyObject *value,
+                                         MathArrayOperand *op,
+                                         const bool use_sequence,
+                                         const char *error_prefix)
+{
+  if (QuaternionArrayObject_Check(value)) {
+    math_array_operand_from_array(op, (MathArrayObject *)value);
+    return 1;
+  }
+  if (!(QuaternionObject_Check(value) || (use_sequence && PySequence_Check(value)))) {
+    return 0;
+  }
+  if (mathutils_array_parse(op->value, 4, 4, value, error_prefix) == -1) {
+    return -1;
+  }
+  math_array_operand_from_value(op, 4);
+  return 1;
+}
+
+static int math_array_operand_len_check(const MathArrayOperand *op,
+                                        Py_ssize_t len,
+                                        const char *error_prefix)
+{
+  if (op->len != -1 && op->len != len) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: array lengths don't match (%zd, %zd)",
+                 error_prefix,
+                 len,
+                 op->len);
+    return -1;
+  }
+  return 0;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Vectorized Loops
+ *
+ * These run without the GIL held for large arrays,
+ * so they must not use the Python API.
+ * \{ */
+
+static void mul_mn_vn(const float *mat, const int mat_size, float *vec, const int vec_size)
+{
+  float tvec[MATRIX_MAX_DIM];
+  int row, col;
+
+  /* Like #column_vector_multiplication, 3D vectors are points for 4x4 matrices. */
+  copy_vn_fl(tvec, MATRIX_MAX_DIM, 1.0f);
+  memcpy(tvec, vec, sizeof(float) * (size_t)vec_size);
+
+  for (row = 0; row < vec_size; row++) {
+    double dot = 0.0;
+    for (col = 0; col < mat_size; col++) {
+      dot += (double)(mat[MATRIX_ITEM_INDEX_NUMROW(mat_size, row, col)] * tvec[col]);
+    }
+    vec[row] = (float)dot;
+  }
+}
+
+static void mul_mn_mnmn(float *r, const float *a, const float *b, const int size)
+{
+  int row, col, item;
+
+  for (col = 0; col < size; col++) {
+    for (row = 0; row < size; row++) {
+      double dot = 0.0;
+      for (item = 0; item < size; item++) {
+        dot += (double)(a[MATRIX_ITEM_INDEX_NUMROW(size, row, item)] *
+                        b[MATRIX_ITEM_INDEX_NUMROW(size, item, col)]);
+      }
+      r[MATRIX_ITEM_INDEX_NUMROW(size, row, col)] = (float)dot;
+    }
+  }
+}
+
+/** Transform vectors of \a data in place. */
+static void math_array_transform_vectors(float *data,
+                                         const Py_ssize_t len,
+                                         const int vec_size,
+                                         const MathArrayOperand *mat)
+{
+  const float *mat_data = mat->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(len);
+  if (mat->size == 4 && vec_size == 3) {
+    for (i = 0; i < len; i++, data += 3, mat_data += mat->stride) {
+      mul_m4_v3((const float(*)[4])mat_data, data);
+    }
+  }
+  else if (mat->size == 3 && vec_size == 3) {
+    for (i = 0; i < len; i++, data += 3, mat_data += mat->stride) {
+      mul_m3_v3((const float(*)[3])mat_data, data);
+    }
+  }
+  else if (mat->size == 4 && vec_size == 4) {
+    for (i = 0; i < len; i++, data += 4, mat_data += mat->stride) {
+      mul_m4_v4((const float(*)[4])mat_data, data);
+    }
+  }
+  else {
+    for (i = 0; i < len; i++, data += vec_size, mat_data += mat->stride) {
+      mul_mn_vn(mat_data, mat->size, data, vec_size);
+    }
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+}
+
+/** Rotate 3D vectors of \a data in place. */
+static void math_array_rotate_vectors(float *data,
+                                      const Py_ssize_t len,
+                                      const MathArrayOperand *quat)
+{
+  const float *quat_data = quat->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(len);
+  for (i = 0; i < len; i++, data += 3, quat_data += quat->stride) {
+    mul_qt_v3(quat_data, data);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+}
+
+static void math_array_mul_matrices(float *r,
+                                    const Py_ssize_t len,
+                                    const MathArrayOperand *a,
+                                    const MathArrayOperand *b)
+{
+  const int size = a->size;
+  const int elem_len = size * size;
+  const float *a_data = a->data, *b_data = b->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(len);
+  if (size == 4) {
+    for (i = 0; i < len; i++, r += elem_len, a_data += a->stride, b_data += b->stride) {
+      mul_m4_m4m4((float(*)[4])r, (const float(*)[4])a_data, (const float(*)[4])b_data);
+    }
+  }
+  else if (size == 3) {
+    for (i = 0; i < len; i++, r += elem_len, a_data += a->stride, b_data += b->stride) {
+      mul_m3_m3m3((float(*)[3])r, (const float(*)[3])a_data, (const float(*)[3])b_data);
+    }
+  }
+  else {
+    for (i = 0; i < len; i++, r += elem_len, a_data += a->stride, b_data += b->stride) {
+      mul_mn_mnmn(r, a_data, b_data, size);
+    }
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+}
+
+static void math_array_mul_quaternions(float *r,
+                                       const Py_ssize_t len,
+                                       const MathArrayOperand *a,
+                                       const MathArrayOperand *b)
+{
+  const float *a_data = a->data, *b_data = b->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(len);
+  for (i = 0; i < len; i++, r += 4, a_data += a->stride, b_data += b->stride) {
+    mul_qt_qtqt(r, a_data, b_data);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Creation
+ * \{ */
+
+static void math_array_fill_identity(MathArrayObject *self)
+{
+  const Py_ssize_t stride = math_array_stride(self);
+  float *data = self->data;
+  Py_ssize_t i;
+
+  if (self->kind == MATH_ARRAY_VECTOR) {
+    memset(data, 0, sizeof(float) * (size_t)(self->len * stride));
+    return;
+  }
+
+  for (i = 0; i < self->len; i++, data += stride) {
+    if (self->kind == MATH_ARRAY_QUATERNION) {
+      unit_qt(data);
+    }
+    else {
+      int j;
+      copy_vn_fl(data, (int)stride, 0.0f);
+      for (j = 0; j < self->size; j++) {
+        data[MATRIX_ITEM_INDEX_NUMROW(self->size, j, j)] = 1.0f;
+      }
+    }
+  }
+}
+
+BLI_INLINE float math_array_buffer_item(const char *ptr, const bool is_double)
+{
+  return is_double ? (float)*(const double *)ptr : *(const float *)ptr;
+}
+
+/**
+ * Check a buffer holds float or double elements of the expected shape,
+ * (len, size) for vectors and quaternions, (len, rows, columns) for matrices.
+ * \return the element size, or -1 on error.
+ */
+static int math_array_buffer_check(const Py_buffer *view,
+                                   const int kind,
+                                   const int size,
+                                   bool *r_is_double,
+                                   const char *error_prefix)
+{
+  const char *format = view->format ? view->format : "B";
+  const int ndim = (kind == MATH_ARRAY_MATRIX) ? 3 : 2;
+  int buffer_size;
+
+  if (ELEM(format[0], '@', '=')) {
+    format++;
+  }
+  if (STREQ(format, "f") && view->itemsize == sizeof(float)) {
+    *r_is_double = false;
+  }
+  else if (STREQ(format, "d") && view->itemsize == sizeof(double)) {
+    *r_is_double = true;
+  }
+  else {
+    PyErr_Format(PyExc_TypeError,
+                 "%s: expected a buffer of floats or doubles, not format '%s'",
+                 error_prefix,
+                 format);
+    return -1;
+  }
+
+  if (view->ndim != ndim) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: expected a buffer with %d dimensions, not %d",
+                 error_prefix,
+                 ndim,
+                 view->ndim);
+    return -1;
+  }
+
+  buffer_size = (int)MIN2(view->shape[1], INT_MAX);
+  if ((kind == MATH_ARRAY_MATRIX && view->shape[2] != view->shape[1]) ||
+      (kind == MATH_ARRAY_QUATERNION && buffer_size != 4) || (buffer_size < 2) ||
+      (buffer_size > 4) || (size != -1 && buffer_size != size)) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: buffer elements of an invalid size (%zd)",
+                 error_prefix,
+                 view->shape[1]);
+    return -1;
+  }
+
+  return buffer_size;
+}
+
+static void math_array_from_buffer(MathArrayObject *self,
+                                   const Py_buffer *view,
+                                   const bool is_double)
+{
+  const Py_ssize_t stride = math_array_stride(self);
+  const int size = self->size;
+  const char *buf = view->buf;
+  float *data = self->data;
+  Py_ssize_t i;
+  int row, col;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += stride, buf += view->strides[0]) {
+    if (self->kind == MATH_ARRAY_MATRIX) {
+      for (row = 0; row < size; row++) {
+        for (col = 0; col < size; col++) {
+          data[MATRIX_ITEM_INDEX_NUMROW(size, row, col)] = math_array_buffer_item(
+              buf + row * view->strides[1] + col * view->strides[2], is_double);
+        }
+      }
+    }
+    else {
+      for (col = 0; col < size; col++) {
+        data[col] = math_array_buffer_item(buf + col * view->strides[1], is_double);
+      }
+    }
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+}
+
+static int math_array_item_parse(float *data,
+                                 const int kind,
+                                 const int size,
+                                 PyObject *value,
+                                 const char *error_prefix)
+{
+  if (kind == MATH_ARRAY_MATRIX) {
+    MatrixObject *mat = (MatrixObject *)value;
+
+    if (!MatrixObject_Check(value)) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s: expected a Matrix, not %.200s",
+                   error_prefix,
+                   Py_TYPE(value)->tp_name);
+      return -1;
+    }
+    if (BaseMath_ReadCallback(mat) == -1) {
+      return -1;
+    }
+    if (mat->num_col != size || mat->num_row != size) {
+      PyErr_Format(PyExc_ValueError,
+                   "%s: expected a %dx%d matrix, not %dx%d",
+                   error_prefix,
+                   size,
+                   size,
+                   mat->num_row,
+                   mat->num_col);
+      return -1;
+    }
+    memcpy(data, mat->matrix, sizeof(float) * (size_t)(size * size));
+    return 0;
+  }
+
+  return (mathutils_array_parse(data, size, size, value, error_prefix) == -1) ? -1 : 0;
+}
+
+/**
+ * Size of the elements of a sequence, from its first item.
+ */
+static int math_array_sequence_item_size(PyObject *item, const int kind)
+{
+  if (kind == MATH_ARRAY_QUATERNION) {
+    return 4;
+  }
+  if (kind == MATH_ARRAY_MATRIX) {
+    return MatrixObject_Check(item) ? ((MatrixObject *)item)->num_row : -1;
+  }
+  return (int)MIN2(PySequence_Size(item), INT_MAX);
+}
+
+static PyObject *math_array_new_ex(PyTypeObject *type, PyObject *value, int size)
+{
+  const int kind = math_array_kind_from_type(type);
+  const char *error_prefix = math_array_type_names[kind];
+  const int size_default = (kind == MATH_ARRAY_VECTOR) ? 3 : 4;
+  MathArrayObject *self;
+
+  if (value == NULL || PyLong_Check(value)) {
+    /* Number of elements, zero vectors or identity matrices and quaternions. */
+    const Py_ssize_t len = value ? PyLong_AsSsize_t(value) : 0;
+    if (len == -1 && PyErr_Occurred()) {
+      return NULL;
+    }
+    if (len < 0) {
+      PyErr_Format(PyExc_ValueError, "%s(): negative length", error_prefix);
+      return NULL;
+    }
+    if (size == -1) {
+      size = size_default;
+    }
+    if (size < 2 || size > 4) {
+      PyErr_Format(PyExc_ValueError, "%s(): size must be between 2 and 4", error_prefix);
+      return NULL;
+    }
+    if ((self = (MathArrayObject *)MathArray_CreatePyObject_alloc(type, len, size))) {
+      math_array_fill_identity(self);
+    }
+    return (PyObject *)self;
+  }
+
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer view;
+    bool is_double;
+
+    if (PyObject_GetBuffer(value, &view, PyBUF_RECORDS_RO) == -1) {
+      return NULL;
+    }
+    if ((size = math_array_buffer_check(&view, kind, size, &is_double, error_prefix)) == -1) {
+      PyBuffer_Release(&view);
+      return NULL;
+    }
+    if ((self = (MathArrayObject *)MathArray_CreatePyObject_alloc(type, view.shape[0], size))) {
+      math_array_from_buffer(self, &view, is_double);
+    }
+    PyBuffer_Release(&view);
+    return (PyObject *)self;
+  }
+
+  {
+    PyObject *value_fast = PySequence_Fast(value, error_prefix);
+    PyObject **value_items;
+    Py_ssize_t len, i;
+    Py_ssize_t stride;
+
+    if (value_fast == NULL) {
+      return NULL;
+    }
+
+    len = PySequence_Fast_GET_SIZE(value_fast);
+    value_items = PySequence_Fast_ITEMS(value_fast);
+
+    if (size == -1) {
+      size = len ? math_array_sequence_item_size(value_items[0], kind) : size_default;
+      if (size == -1 && PyErr_Occurred()) {
+        PyErr_Clear();
+      }
+    }
+    if (size < 2 || size > 4) {
+      PyErr_Format(PyExc_ValueError,
+                   "%s(): expected a sequence of %s with 2 to 4 items",
+                   error_prefix,
+                   (kind == MATH_ARRAY_MATRIX) ? "square matrices" : "vectors");
+      Py_DECREF(value_fast);
+      return NULL;
+    }
+
+    self = (MathArrayObject *)MathArray_CreatePyObject_alloc(type, len, size);
+    if (self == NULL) {
+      Py_DECREF(value_fast);
+      return NULL;
+    }
+
+    stride = math_array_stride(self);
+    for (i = 0; i < len; i++) {
+      if (math_array_item_parse(
+              self->data + i * stride, kind, size, value_items[i], error_prefix) == -1) {
+        Py_DECREF(self);
+        Py_DECREF(value_fast);
+        return NULL;
+      }
+    }
+
+    Py_DECREF(value_fast);
+    return (PyObject *)self;
+  }
+}
+
+static PyObject *VectorArray_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  PyObject *value = NULL;
+  int size = -1;
+  const char *keywords[] = {"data", "size", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|Oi:VectorArray", (char **)keywords, &value, &size)) {
+    return NULL;
+  }
+  return math_array_new_ex(type, value, size);
+}
+
+static PyObject *MatrixArray_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  PyObject *value = NULL;
+  int size = -1;
+  const char *keywords[] = {"data", "size", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(
+          args, kwds, "|Oi:MatrixArray", (char **)keywords, &value, &size)) {
+    return NULL;
+  }
+  return math_array_new_ex(type, value, size);
+}
+
+static PyObject *QuaternionArray_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+  PyObject *value = NULL;
+  const char *keywords[] = {"data", NULL};
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwds, "|O:QuaternionArray", (char **)keywords, &value)) {
+    return NULL;
+  }
+  return math_array_new_ex(type, value, -1);
+}
+
+static void MathArray_dealloc(MathArrayObject *self)
+{
+  PyMem_Free(self->data);
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *MathArray_repr(MathArrayObject *self)
+{
+  if (self->kind == MATH_ARRAY_QUATERNION) {
+    return PyUnicode_FromFormat("<%s of %zd items>", Py_TYPE(self)->tp_name, self->len);
+  }
+  return PyUnicode_FromFormat(
+      "<%s of %zd items, size %d>", Py_TYPE(self)->tp_name, self->len, self->size);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Buffer Protocol
+ * \{ */
+
+typedef struct MathArrayBufferView {
+  Py_ssize_t shape[3];
+  Py_ssize_t strides[3];
+} MathArrayBufferView;
+
+static int MathArray_getbuffer(MathArrayObject *self, Py_buffer *view, int flags)
+{
+  const Py_ssize_t itemsize = sizeof(float);
+  const int size = self->size;
+  MathArrayBufferView *view_data;
+
+  /* Matrix elements are column-major, rows are exposed as the second dimension so indexing
+   * matches #Matrix, this needs strides. */
+  if (self->kind == MATH_ARRAY_MATRIX && (flags & PyBUF_ND) == PyBUF_ND &&
+      (flags & PyBUF_STRIDES) != PyBUF_STRIDES) {
+    PyErr_SetString(PyExc_BufferError,
+                    "MatrixArray: matrices are stored column-major, "
+                    "only strided views are supported");
+    view->obj = NULL;
+    return -1;
+  }
+
+  view_data = PyMem_Malloc(sizeof(*view_data));
+  if (view_data == NULL) {
+    PyErr_NoMemory();
+    view->obj = NULL;
+    return -1;
+  }
+
+  view_data->shape[0] = self->len;
+  view_data->shape[1] = size;
+  view_data->strides[0] = math_array_stride(self) * itemsize;
+  if (self->kind == MATH_ARRAY_MATRIX) {
+    view_data->shape[2] = size;
+    view_data->strides[1] = itemsize;
+    view_data->strides[2] = size * itemsize;
+  }
+  else {
+    view_data->strides[1] = itemsize;
+  }
+
+  view->buf = self->data;
+  view->obj = (PyObject *)self;
+  Py_INCREF(self);
+  view->len = self->len * math_array_stride(self) * itemsize;
+  view->readonly = 0;
+  view->itemsize = itemsize;
+  view->format = (flags & PyBUF_FORMAT) ? (char *)"f" : NULL;
+  view->ndim = (self->kind == MATH_ARRAY_MATRIX) ? 3 : 2;
+  view->shape = ((flags & PyBUF_ND) == PyBUF_ND) ? view_data->shape : NULL;
+  view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? view_data->strides : NULL;
+  view->suboffsets = NULL;
+  view->internal = view_data;
+
+  return 0;
+}
+
+static void MathArray_releasebuffer(MathArrayObject *UNUSED(self), Py_buffer *view)
+{
+  PyMem_Free(view->internal);
+}
+
+static PyBufferProcs MathArray_as_buffer = {
+    (getbufferproc)MathArray_getbuffer,
+    (releasebufferproc)MathArray_releasebuffer,
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Sequence Protocol
+ * \{ */
+
+static Py_ssize_t MathArray_len(MathArrayObject *self)
+{
+  return self->len;
+}
+
+static int math_array_index_check(MathArrayObject *self, Py_ssize_t i)
+{
+  if (i < 0 || i >= self->len) {
+    PyErr_Format(
+        PyExc_IndexError, "%s[index]: index out of range", math_array_type_names[self->kind]);
+    return -1;
+  }
+  return 0;
+}
+
+static PyObject *MathArray_item(MathArrayObject *self, Py_ssize_t i)
+{
+  const float *data;
+
+  if (math_array_index_check(self, i) == -1) {
+    return NULL;
+  }
+
+  data = self->data + i * math_array_stride(self);
+  switch (self->kind) {
+    case MATH_ARRAY_MATRIX:
+      return Matrix_CreatePyObject(data, (ushort)self->size, (ushort)self->size, NULL);
+    case MATH_ARRAY_QUATERNION:
+      return Quaternion_CreatePyObject(data, NULL);
+    default:
+      return Vector_CreatePyObject(data, self->size, NULL);
+  }
+}
+
+static int MathArray_ass_item(MathArrayObject *self, Py_ssize_t i, PyObject *value)
+{
+  float tmp[MATRIX_MAX_DIM * MATRIX_MAX_DIM];
+
+  if (value == NULL) {
+    PyErr_Format(PyExc_TypeError,
+                 "%s: items can't be deleted, the length is fixed",
+                 math_array_type_names[self->kind]);
+    return -1;
+  }
+  if (math_array_index_check(self, i) == -1) {
+    return -1;
+  }
+  if (math_array_item_parse(tmp, self->kind, self->size, value, "array[index] = value") == -1) {
+    return -1;
+  }
+
+  memcpy(self->data + i * math_array_stride(self),
+         tmp,
+         sizeof(float) * (size_t)math_array_stride(self));
+  return 0;
+}
+
+static PySequenceMethods MathArray_SeqMethods = {
+    (lenfunc)MathArray_len,              /* sq_length */
+    (binaryfunc)NULL,                    /* sq_concat */
+    (ssizeargfunc)NULL,                  /* sq_repeat */
+    (ssizeargfunc)MathArray_item,        /* sq_item */
+    (ssizessizeargfunc)NULL,             /* sq_slice (deprecated) */
+    (ssizeobjargproc)MathArray_ass_item, /* sq_ass_item */
+    (ssizessizeobjargproc)NULL,          /* sq_ass_slice (deprecated) */
+    (objobjproc)NULL,                    /* sq_contains */
+    (binaryfunc)NULL,                    /* sq_inplace_concat */
+    (ssizeargfunc)NULL,                  /* sq_inplace_repeat */
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Number Protocol
+ * \{ */
+
+static PyObject *math_array_matmul_matrix(PyObject *m1, PyObject *m2)
+{
+  const char *error_prefix = "MatrixArray multiplication";
+  MathArrayOperand op1, op2;
+  MathArrayObject *array, *ret;
+  int ok1, ok2;
+
+  if ((ok1 = math_array_operand_matrix(m1, &op1, error_prefix)) == -1) {
+    return NULL;
+  }
+  if (ok1 == 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  if ((ok2 = math_array_operand_matrix(m2, &op2, error_prefix)) == -1) {
+    return NULL;
+  }
+
+  if (ok2) {
+    /* MATRIX_ARRAY @ MATRIX_ARRAY */
+    array = (MathArrayObject *)(MatrixArrayObject_Check(m1) ? m1 : m2);
+    if (op1.size != op2.size) {
+      PyErr_Format(PyExc_ValueError, "%s: matrix sizes don't match", error_prefix);
+      return NULL;
+    }
+    if (math_array_operand_len_check(&op1, array->len, error_prefix) == -1 ||
+        math_array_operand_len_check(&op2, array->len, error_prefix) == -1) {
+      return NULL;
+    }
+    if ((ret = math_array_new_like(array, op1.size))) {
+      math_array_mul_matrices(ret->data, ret->len, &op1, &op2);
+    }
+    return (PyObject *)ret;
+  }
+
+  if (VectorArrayObject_Check(m2)) {
+    /* MATRIX_ARRAY @ VECTOR_ARRAY */
+    MathArrayObject *vecs = (MathArrayObject *)m2;
+
+    if (!(vecs->size == op1.size || (vecs->size == 3 && op1.size == 4))) {
+      PyErr_Format(PyExc_ValueError,
+                   "%s: vector size %d doesn't match the matrix size %d",
+                   error_prefix,
+                   vecs->size,
+                   op1.size);
+      return NULL;
+    }
+    if (math_array_operand_len_check(&op1, vecs->len, error_prefix) == -1) {
+      return NULL;
+    }
+    if ((ret = math_array_new_like(vecs, vecs->size))) {
+      memcpy(ret->data, vecs->data, sizeof(float) * (size_t)(vecs->len * vecs->size));
+      math_array_transform_vectors(ret->data, ret->len, ret->size, &op1);
+    }
+    return (PyObject *)ret;
+  }
+
+  Py_RETURN_NOTIMPLEMENTED;
+}
+
+static PyObject *math_array_matmul_quaternion(PyObject *q1, PyObject *q2)
+{
+  const char *error_prefix = "QuaternionArray multiplication";
+  MathArrayOperand op1, op2;
+  MathArrayObject *array, *ret;
+  int ok1, ok2;
+
+  if ((ok1 = math_array_operand_quaternion(q1, &op1, false, error_prefix)) == -1) {
+    return NULL;
+  }
+  if (ok1 == 0) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  if ((ok2 = math_array_operand_quaternion(q2, &op2, false, error_prefix)) == -1) {
+    return NULL;
+  }
+
+  if (ok2) {
+    /* QUATERNION_ARRAY @ QUATERNION_ARRAY */
+    array = (MathArrayObject *)(QuaternionArrayObject_Check(q1) ? q1 : q2);
+    if (math_array_operand_len_check(&op1, array->len, error_prefix) == -1 ||
+        math_array_operand_len_check(&op2, array->len, error_prefix) == -1) {
+      return NULL;
+    }
+    if ((ret = math_array_new_like(array, 4))) {
+      math_array_mul_quaternions(ret->data, ret->len, &op1, &op2);
+    }
+    return (PyObject *)ret;
+  }
+
+  if (VectorArrayObject_Check(q2)) {
+    /* QUATERNION_ARRAY @ VECTOR_ARRAY */
+    MathArrayObject *vecs = (MathArrayObject *)q2;
+
+    if (vecs->size != 3) {
+      PyErr_Format(PyExc_ValueError, "%s: only 3D vectors can be rotated", error_prefix);
+      return NULL;
+    }
+    if (math_array_operand_len_check(&op1, vecs->len, error_prefix) == -1) {
+      return NULL;
+    }
+    if ((ret = math_array_new_like(vecs, 3))) {
+      memcpy(ret->data, vecs->data, sizeof(float) * (size_t)(vecs->len * 3));
+      math_array_rotate_vectors(ret->data, ret->len, &op1);
+    }
+    return (PyObject *)ret;
+  }
+
+  Py_RETURN_NOTIMPLEMENTED;
+}
+
+static PyObject *MathArray_matmul(PyObject *m1, PyObject *m2)
+{
+  if (MatrixObject_Check(m1) || MatrixArrayObject_Check(m1)) {
+    return math_array_matmul_matrix(m1, m2);
+  }
+  if (QuaternionObject_Check(m1) || QuaternionArrayObject_Check(m1)) {
+    return math_array_matmul_quaternion(m1, m2);
+  }
+
+  Py_RETURN_NOTIMPLEMENTED;
+}
+
+static PyNumberMethods MathArray_NumMethods = {
+    NULL, /*nb_add*/
+    NULL, /*nb_subtract*/
+    NULL, /*nb_multiply*/
+    NULL, /*nb_remainder*/
+    NULL, /*nb_divmod*/
+    NULL, /*nb_power*/
+    NULL, /*nb_negative*/
+    NULL, /*tp_positive*/
+    NULL, /*tp_absolute*/
+    NULL, /*tp_bool*/
+    NULL, /*nb_invert*/
+    NULL, /*nb_lshift*/
+    NULL, /*nb_rshift*/
+    NULL, /*nb_and*/
+    NULL, /*nb_xor*/
+    NULL, /*nb_or*/
+    NULL, /*nb_int*/
+    NULL, /*nb_reserved*/
+    NULL, /*nb_float*/
+    NULL, /* nb_inplace_add */
+    NULL, /* nb_inplace_subtract */
+    NULL, /* nb_inplace_multiply */
+    NULL, /* nb_inplace_remainder */
+    NULL, /* nb_inplace_power */
+    NULL, /* nb_inplace_lshift */
+    NULL, /* nb_inplace_rshift */
+    NULL, /* nb_inplace_and */
+    NULL, /* nb_inplace_xor */
+    NULL, /* nb_inplace_or */
+    NULL, /* nb_floor_divide */
+    NULL, /* nb_true_divide */
+    NULL, /* nb_inplace_floor_divide */
+    NULL, /* nb_inplace_true_divide */
+    NULL, /* nb_index */
+    (binaryfunc)MathArray_matmul, /* nb_matrix_multiply */
+    NULL,                         /* nb_inplace_matrix_multiply */
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Shared Methods
+ * \{ */
+
+PyDoc_STRVAR(MathArray_copy_doc,
+             ".. method:: copy()\n"
+             "\n"
+             "   Returns a copy of this array.\n"
+             "\n"
+             "   :return: A copy of the array.\n");
+static PyObject *MathArray_copy(MathArrayObject *self)
+{
+  MathArrayObject *ret = math_array_new_like(self, self->size);
+  if (ret) {
+    memcpy(ret->data, self->data, sizeof(float) * (size_t)(self->len * math_array_stride(self)));
+  }
+  return (PyObject *)ret;
+}
+
+PyDoc_STRVAR(MathArray_size_doc, "Size of the elements (readonly).\n\n:type: int");
+static PyObject *MathArray_size_get(MathArrayObject *self, void *UNUSED(closure))
+{
+  return PyLong_FromLong(self->size);
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name VectorArray Methods
+ * \{ */
+
+PyDoc_STRVAR(VectorArray_normalize_doc,
+             ".. method:: normalize()\n"
+             "\n"
+             "   Normalize all vectors, making their length 1.0.\n");
+static PyObject *VectorArray_normalize(MathArrayObject *self)
+{
+  const int size = self->size;
+  float *data = self->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  if (size == 3) {
+    for (i = 0; i < self->len; i++, data += 3) {
+      normalize_v3(data);
+    }
+  }
+  else {
+    for (i = 0; i < self->len; i++, data += size) {
+      normalize_vn(data, size);
+    }
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(VectorArray_dot_doc,
+             ".. method:: dot(other)\n"
+             "\n"
+             "   Return the dot product of each vector with another.\n"
+             "\n"
+             "   :arg other: A vector for all elements or an array of the same length.\n"
+             "   :type other: :class:`Vector` or :class:`VectorArray`\n"
+             "   :return: The dot products.\n"
+             "   :rtype: memoryview of floats\n");
+static PyObject *VectorArray_dot(MathArrayObject *self, PyObject *value)
+{
+  const char *error_prefix = "VectorArray.dot(other)";
+  MathArrayOperand op;
+  const float *data = self->data;
+  const float *other;
+  PyObject *ret;
+  float *r;
+  Py_ssize_t i;
+
+  if (math_array_operand_vector(value, &op, true, error_prefix) != 1) {
+    if (!PyErr_Occurred()) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s: expected a Vector or VectorArray, not %.200s",
+                   error_prefix,
+                   Py_TYPE(value)->tp_name);
+    }
+    return NULL;
+  }
+  if (op.size != self->size) {
+    PyErr_Format(PyExc_ValueError, "%s: vector sizes don't match", error_prefix);
+    return NULL;
+  }
+  if (math_array_operand_len_check(&op, self->len, error_prefix) == -1) {
+    return NULL;
+  }
+  if ((ret = math_array_float_result(self->len, &r)) == NULL) {
+    return NULL;
+  }
+
+  other = op.data;
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += self->size, other += op.stride) {
+    r[i] = (float)dot_vn_vn(data, other, self->size);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  return math_array_float_result_finish(ret);
+}
+
+PyDoc_STRVAR(VectorArray_cross_doc,
+             ".. method:: cross(other)\n"
+             "\n"
+             "   Return the cross product of each vector with another (3D only).\n"
+             "\n"
+             "   :arg other: A vector for all elements or an array of the same length.\n"
+             "   :type other: :class:`Vector` or :class:`VectorArray`\n"
+             "   :return: The cross products.\n"
+             "   :rtype: :class:`VectorArray`\n");
+static PyObject *VectorArray_cross(MathArrayObject *self, PyObject *value)
+{
+  const char *error_prefix = "VectorArray.cross(other)";
+  MathArrayOperand op;
+  const float *data = self->data;
+  const float *other;
+  MathArrayObject *ret;
+  float *r;
+  Py_ssize_t i;
+
+  if (math_array_operand_vector(value, &op, true, error_prefix) != 1) {
+    if (!PyErr_Occurred()) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s: expected a Vector or VectorArray, not %.200s",
+                   error_prefix,
+                   Py_TYPE(value)->tp_name);
+    }
+    return NULL;
+  }
+  if (self->size != 3 || op.size != 3) {
+    PyErr_Format(PyExc_ValueError, "%s: only supports 3D vectors", error_prefix);
+    return NULL;
+  }
+  if (math_array_operand_len_check(&op, self->len, error_prefix) == -1) {
+    return NULL;
+  }
+  if ((ret = math_array_new_like(self, 3)) == NULL) {
+    return NULL;
+  }
+
+  r = ret->data;
+  other = op.data;
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += 3, other += op.stride, r += 3) {
+    cross_v3_v3v3(r, data, other);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  return (PyObject *)ret;
+}
+
+PyDoc_STRVAR(
+    VectorArray_transform_doc,
+    ".. method:: transform(matrix)\n"
+    "\n"
+    "   Transform all vectors in place, 3D vectors are treated as points by 4x4 matrices.\n"
+    "\n"
+    "   :arg matrix: A matrix for all elements or an array of the same length.\n"
+    "   :type matrix: :class:`Matrix`, :class:`MatrixArray` or :class:`QuaternionArray`\n");
+static PyObject *VectorArray_transform(MathArrayObject *self, PyObject *value)
+{
+  const char *error_prefix = "VectorArray.transform(matrix)";
+  MathArrayOperand op;
+  int ok;
+
+  if (QuaternionArrayObject_Check(value) || QuaternionObject_Check(value)) {
+    if (math_array_operand_quaternion(value, &op, false, error_prefix) == -1) {
+      return NULL;
+    }
+    if (self->size != 3) {
+      PyErr_Format(PyExc_ValueError, "%s: only 3D vectors can be rotated", error_prefix);
+      return NULL;
+    }
+    if (math_array_operand_len_check(&op, self->len, error_prefix) == -1) {
+      return NULL;
+    }
+    math_array_rotate_vectors(self->data, self->len, &op);
+    Py_RETURN_NONE;
+  }
+
+  if ((ok = math_array_operand_matrix(value, &op, error_prefix)) != 1) {
+    if (ok == 0) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s: expected a Matrix or MatrixArray, not %.200s",
+                   error_prefix,
+                   Py_TYPE(value)->tp_name);
+    }
+    return NULL;
+  }
+  if (!(self->size == op.size || (self->size == 3 && op.size == 4))) {
+    PyErr_Format(PyExc_ValueError,
+                 "%s: vector size %d doesn't match the matrix size %d",
+                 error_prefix,
+                 self->size,
+                 op.size);
+    return NULL;
+  }
+  if (math_array_operand_len_check(&op, self->len, error_prefix) == -1) {
+    return NULL;
+  }
+
+  math_array_transform_vectors(self->data, self->len, self->size, &op);
+  Py_RETURN_NONE;
+}
+
+static struct PyMethodDef VectorArray_methods[] = {
+    {"copy", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {"__copy__", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {"normalize", (PyCFunction)VectorArray_normalize, METH_NOARGS, VectorArray_normalize_doc},
+    {"dot", (PyCFunction)VectorArray_dot, METH_O, VectorArray_dot_doc},
+    {"cross", (PyCFunction)VectorArray_cross, METH_O, VectorArray_cross_doc},
+    {"transform", (PyCFunction)VectorArray_transform, METH_O, VectorArray_transform_doc},
+    {NULL, NULL, 0, NULL},
+};
+
+static PyGetSetDef VectorArray_getseters[] = {
+    {"size", (getter)MathArray_size_get, (setter)NULL, MathArray_size_doc, NULL},
+    {NULL, NULL, NULL, NULL, NULL} /* Sentinel */
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name QuaternionArray Methods
+ * \{ */
+
+PyDoc_STRVAR(QuaternionArray_normalize_doc,
+             ".. method:: normalize()\n"
+             "\n"
+             "   Normalize all quaternions.\n");
+static PyObject *QuaternionArray_normalize(MathArrayObject *self)
+{
+  float *data = self->data;
+  Py_ssize_t i;
+
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += 4) {
+    normalize_qt(data);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(QuaternionArray_slerp_doc,
+             ".. function:: slerp(other, factor)\n"
+             "\n"
+             "   Returns the interpolation of each quaternion and another.\n"
+             "\n"
+             "   :arg other: A quaternion for all elements or an array of the same length.\n"
+             "   :type other: :class:`Quaternion` or :class:`QuaternionArray`\n"
+             "   :arg factor: The interpolation value in [0.0, 1.0].\n"
+             "   :type factor: float\n"
+             "   :return: The interpolated rotations.\n"
+             "   :rtype: :class:`QuaternionArray`\n");
+static PyObject *QuaternionArray_slerp(MathArrayObject *self, PyObject *args)
+{
+  const char *error_prefix = "QuaternionArray.slerp(other)";
+  MathArrayOperand op;
+  PyObject *value;
+  MathArrayObject *ret;
+  const float *data = self->data;
+  const float *other;
+  float *r, fac;
+  Py_ssize_t i;
+
+  if (!PyArg_ParseTuple(args, "Of:slerp", &value, &fac)) {
+    return NULL;
+  }
+  if (math_array_operand_quaternion(value, &op, true, error_prefix) != 1) {
+    if (!PyErr_Occurred()) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s: expected a Quaternion or QuaternionArray, not %.200s",
+                   error_prefix,
+                   Py_TYPE(value)->tp_name);
+    }
+    return NULL;
+  }
+  if (math_array_operand_len_check(&op, self->len, error_prefix) == -1) {
+    return NULL;
+  }
+  if (fac > 1.0f || fac < 0.0f) {
+    PyErr_SetString(PyExc_ValueError,
+                    "QuaternionArray.slerp(): "
+                    "interpolation factor must be between 0.0 and 1.0");
+    return NULL;
+  }
+  if ((ret = math_array_new_like(self, 4)) == NULL) {
+    return NULL;
+  }
+
+  r = ret->data;
+  other = op.data;
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += 4, other += op.stride, r += 4) {
+    interp_qt_qtqt(r, data, other, fac);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  return (PyObject *)ret;
+}
+
+PyDoc_STRVAR(QuaternionArray_to_matrix_doc,
+             ".. method:: to_matrix()\n"
+             "\n"
+             "   Return the 3x3 rotation matrices of the quaternions.\n"
+             "\n"
+             "   :return: The rotation matrices.\n"
+             "   :rtype: :class:`MatrixArray`\n");
+static PyObject *QuaternionArray_to_matrix(MathArrayObject *self)
+{
+  MathArrayObject *ret;
+  const float *data = self->data;
+  float *r;
+  Py_ssize_t i;
+
+  ret = (MathArrayObject *)MathArray_CreatePyObject_alloc(&matrix_array_Type, self->len, 3);
+  if (ret == NULL) {
+    return NULL;
+  }
+
+  r = ret->data;
+  MATH_ARRAY_BEGIN_ALLOW_THREADS(self->len);
+  for (i = 0; i < self->len; i++, data += 4, r += 9) {
+    quat_to_mat3((float(*)[3])r, data);
+  }
+  MATH_ARRAY_END_ALLOW_THREADS;
+
+  return (PyObject *)ret;
+}
+
+static struct PyMethodDef QuaternionArray_methods[] = {
+    {"copy", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {"__copy__", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {"normalize",
+     (PyCFunction)QuaternionArray_normalize,
+     METH_NOARGS,
+     QuaternionArray_normalize_doc},
+    {"slerp", (PyCFunction)QuaternionArray_slerp, METH_VARARGS, QuaternionArray_slerp_doc},
+    {"to_matrix",
+     (PyCFunction)QuaternionArray_to_matrix,
+     METH_NOARGS,
+     QuaternionArray_to_matrix_doc},
+    {NULL, NULL, 0, NULL},
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name MatrixArray Methods
+ * \{ */
+
+static struct PyMethodDef MatrixArray_methods[] = {
+    {"copy", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {"__copy__", (PyCFunction)MathArray_copy, METH_NOARGS, MathArray_copy_doc},
+    {NULL, NULL, 0, NULL},
+};
+
+static PyGetSetDef MatrixArray_getseters[] = {
+    {"size", (getter)MathArray_size_get, (setter)NULL, MathArray_size_doc, NULL},
+    {NULL, NULL, NULL, NULL, NULL} /* Sentinel */
+};
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Types
+ * \{ */
+
+PyDoc_STRVAR(
+    vector_array_doc,
+    ".. class:: VectorArray(data=0, size=-1)\n"
+    "\n"
+    "   An array of vectors stored in one buffer, supporting the buffer protocol.\n"
+    "\n"
+    "   :arg data: The number of zero vectors, a buffer of shape (len, size) or a sequence of "
+    "vectors.\n"
+    "   :type data: int, buffer or sequence\n"
+    "   :arg size: Size of the vectors, between 2 and 4. Taken from the data when -1.\n"
+    "   :type size: int\n");
+PyTypeObject vector_array_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0) "VectorArray", /* tp_name */
+    sizeof(MathArrayObject),                      /* tp_basicsize */
+    0,                                            /* tp_itemsize */
+    /* methods */
+    (destructor)MathArray_dealloc,                /* tp_dealloc */
+    (printfunc)NULL,                              /* tp_print */
+    NULL,                                         /* tp_getattr */
+    NULL,                                         /* tp_setattr */
+    NULL,                                         /* tp_compare */
+    (reprfunc)MathArray_repr,                     /* tp_repr */
+    &MathArray_NumMethods,                        /* tp_as_number */
+    &MathArray_SeqMethods,                        /* tp_as_sequence */
+    NULL,                                         /* tp_as_mapping */
+    NULL,                                         /* tp_hash */
+    NULL,                                         /* tp_call */
+    NULL,                                         /* tp_str */
+    NULL,                                         /* tp_getattro */
+    NULL,                                         /* tp_setattro */
+    &MathArray_as_buffer,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,     /* tp_flags */
+    vector_array_doc,                             /* tp_doc */
+    NULL,                                         /* tp_traverse */
+    NULL,                                         /* tp_clear */
+    NULL,                                         /* tp_richcompare */
+    0,                                            /* tp_weaklistoffset */
+    NULL,                                         /* tp_iter */
+    NULL,                                         /* tp_iternext */
+    VectorArray_methods,                          /* tp_methods */
+    NULL,                                         /* tp_members */
+    VectorArray_getseters,                        /* tp_getset */
+    NULL,                                         /* tp_base */
+    NULL,                                         /* tp_dict */
+    NULL,                                         /* tp_descr_get */
+    NULL,                                         /* tp_descr_set */
+    0,                                            /* tp_dictoffset */
+    NULL,                                         /* tp_init */
+    (allocfunc)PyType_GenericAlloc,               /* tp_alloc */
+    (newfunc)VectorArray_new,                     /* tp_new */
+    (freefunc)0,                                  /* tp_free */
+    NULL,                                         /* tp_is_gc */
+    NULL,                                         /* tp_bases */
+    NULL,                                         /* tp_mro */
+    NULL,                                         /* tp_cache */
+    NULL,                                         /* tp_subclasses */
+    NULL,                                         /* tp_weaklist */
+    (destructor)NULL,                             /* tp_del */
+};
+
+PyDoc_STRVAR(
+    matrix_array_doc,
+    ".. class:: MatrixArray(data=0, size=-1)\n"
+    "\n"
+    "   An array of square matrices stored in one buffer, supporting the buffer protocol.\n"
+    "   Buffers have the shape (len, rows, columns).\n"
+    "\n"
+    "   :arg data: The number of identity matrices, a buffer or a sequence of matrices.\n"
+    "   :type data: int, buffer or sequence\n"
+    "   :arg size: Number of rows and columns, between 2 and 4. Taken from the data when -1.\n"
+    "   :type size: int\n");
+PyTypeObject matrix_array_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0) "MatrixArray", /* tp_name */
+    sizeof(MathArrayObject),                      /* tp_basicsize */
+    0,                                            /* tp_itemsize */
+    /* methods */
+    (destructor)MathArray_dealloc,                /* tp_dealloc */
+    (printfunc)NULL,                              /* tp_print */
+    NULL,                                         /* tp_getattr */
+    NULL,                                         /* tp_setattr */
+    NULL,                                         /* tp_compare */
+    (reprfunc)MathArray_repr,                     /* tp_repr */
+    &MathArray_NumMethods,                        /* tp_as_number */
+    &MathArray_SeqMethods,                        /* tp_as_sequence */
+    NULL,                                         /* tp_as_mapping */
+    NULL,                                         /* tp_hash */
+    NULL,                                         /* tp_call */
+    NULL,                                         /* tp_str */
+    NULL,                                         /* tp_getattro */
+    NULL,                                         /* tp_setattro */
+    &MathArray_as_buffer,                         /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,     /* tp_flags */
+    matrix_array_doc,                             /* tp_doc */
+    NULL,                                         /* tp_traverse */
+    NULL,                                         /* tp_clear */
+    NULL,                                         /* tp_richcompare */
+    0,                                            /* tp_weaklistoffset */
+    NULL,                                         /* tp_iter */
+    NULL,                                         /* tp_iternext */
+    MatrixArray_methods,                          /* tp_methods */
+    NULL,                                         /* tp_members */
+    MatrixArray_getseters,                        /* tp_getset */
+    NULL,                                         /* tp_base */
+    NULL,                                         /* tp_dict */
+    NULL,                                         /* tp_descr_get */
+    NULL,                                         /* tp_descr_set */
+    0,                                            /* tp_dictoffset */
+    NULL,                                         /* tp_init */
+    (allocfunc)PyType_GenericAlloc,               /* tp_alloc */
+    (newfunc)MatrixArray_new,                     /* tp_new */
+    (freefunc)0,                                  /* tp_free */
+    NULL,                                         /* tp_is_gc */
+    NULL,                                         /* tp_bases */
+    NULL,                                         /* tp_mro */
+    NULL,                                         /* tp_cache */
+    NULL,                                         /* tp_subclasses */
+    NULL,                                         /* tp_weaklist */
+    (destructor)NULL,                             /* tp_del */
+};
+
+PyDoc_STRVAR(quaternion_array_doc,
+             ".. class:: QuaternionArray(data=0)\n"
+             "\n"
+             "   An array of quaternions stored in one buffer, supporting the buffer protocol.\n"
+             "\n"
+             "   :arg data: The number of identity quaternions, a buffer of shape (len, 4) or a "
+             "sequence of quaternions.\n"
+             "   :type data: int, buffer or sequence\n");
+PyTypeObject quaternion_array_Type = {
+    PyVarObject_HEAD_INIT(NULL, 0) "QuaternionArray", /* tp_name */
+    sizeof(MathArrayObject),                          /* tp_basicsize */
+    0,                                                /* tp_itemsize */
+    /* methods */
+    (destructor)MathArray_dealloc,                    /* tp_dealloc */
+    (printfunc)NULL,                                  /* tp_print */
+    NULL,                                             /* tp_getattr */
+    NULL,                                             /* tp_setattr */
+    NULL,                                             /* tp_compare */
+    (reprfunc)MathArray_repr,                         /* tp_repr */
+    &MathArray_NumMethods,                            /* tp_as_number */
+    &MathArray_SeqMethods,                            /* tp_as_sequence */
+    NULL,                                             /* tp_as_mapping */
+    NULL,                                             /* tp_hash */
+    NULL,                                             /* tp_call */
+    NULL,                                             /* tp_str */
+    NULL,                                             /* tp_getattro */
+    NULL,                                             /* tp_setattro */
+    &MathArray_as_buffer,                             /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,         /* tp_flags */
+    quaternion_array_doc,                             /* tp_doc */
+    NULL,                                             /* tp_traverse */
+    NULL,                                             /* tp_clear */
+    NULL,                                             /* tp_richcompare */
+    0,                                                /* tp_weaklistoffset */
+    NULL,                                             /* tp_iter */
+    NULL,                                             /* tp_iternext */
+    QuaternionArray_methods,                          /* tp_methods */
+    NULL,                                             /* tp_members */
+    NULL,                                             /* tp_getset */
+    NULL,                                             /* tp_base */
+    NULL,                                             /* tp_dict */
+    NULL,                                             /* tp_descr_get */
+    NULL,                                             /* tp_descr_set */
+    0,                                                /* tp_dictoffset */
+    NULL,                                             /* tp_init */
+    (allocfunc)PyType_GenericAlloc,                   /* tp_alloc */
+    (newfunc)QuaternionArray_new,                     /* tp_new */
+    (freefunc)0,                                      /* tp_free */
+    NULL,                                             /* tp_is_gc */
+    NULL,                                             /* tp_bases */
+    NULL,                                             /* tp_mro */
+    NULL,                                             /* tp_cache */
+    NULL,                                             /* tp_subclasses */
+    NULL,                                             /* tp_weaklist */
+    (destructor)NULL,                                 /* tp_del */
+};
+
+/** \} */
@@ -0,0 +1,62 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __MATHUTILS_ARRAY_H__
+#define __MATHUTILS_ARRAY_H__
+
+/** \file
+ * \ingroup pymathutils
+ */
+
+extern PyTypeObject vector_array_Type;
+extern PyTypeObject matrix_array_Type;
+extern PyTypeObject quaternion_array_Type;
+
+#define VectorArrayObject_Check(v) PyObject_TypeCheck((v), &vector_array_Type)
+#define MatrixArrayObject_Check(v) PyObject_TypeCheck((v), &matrix_array_Type)
+#define QuaternionArrayObject_Check(v) PyObject_TypeCheck((v), &quaternion_array_Type)
+
+#define MathArrayObject_Check(v) \
+  (VectorArrayObject_Check(v) || MatrixArrayObject_Check(v) || QuaternionArrayObject_Check(v))
+
+/** MathArrayObject.kind */
+enum {
+  MATH_ARRAY_VECTOR = 0,
+  MATH_ARRAY_MATRIX = 1,
+  MATH_ARRAY_QUATERNION = 2,
+};
+
+/**
+ * Many vectors, square matrices or quaternions stored in one contiguous buffer,
+ * so operations on all of them run in a single C loop.
+ */
+typedef struct {
+  PyObject_HEAD
+  /** Elements one after the other, matrices are column-major like #MatrixObject. */
+  float *data;
+  /** Number of elements. */
+  Py_ssize_t len;
+  /** Vector size, number of rows and columns of matrices, always 4 for quaternions. */
+  int size;
+  unsigned char kind;
+} MathArrayObject;
+
+/* prototypes */
+PyObject *MathArray_CreatePyObject_alloc(PyTypeObject *type,
+                                         Py_ssize_t len,
+                                         int size) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL(1);
+
+#endif /* __MATHUTILS_ARRAY_H__ */
@@ -2686,6 +2686,11 @@ static PyObject *Matrix_matmul(PyObject *m1, PyObject *m2)
     }
   }
 
+  /* Let the array types handle it, see #MathArray_matmul. */
+  if (MathArrayObject_Check(m2)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
   PyErr_Format(PyExc_TypeError,
                "Matrix multiplication: "
                "not supported between '%.200s' and '%.200s' types",
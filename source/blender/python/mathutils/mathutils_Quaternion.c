@@ -1083,6 +1083,11 @@ static PyObject *Quaternion_matmul(PyObject *q1, PyObject *q2)
     }
   }
 
+  /* Let the array types handle it, see #MathArray_matmul. */
+  if (MathArrayObject_Check(q2)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
   PyErr_Format(PyExc_TypeError,
                "Quaternion multiplication: "
                "not supported between '%.200s' and '%.200s' types",
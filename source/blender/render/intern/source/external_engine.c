@@ -162,6 +162,11 @@ void RE_engine_free(RenderEngine *engine)
     BLI_threaded_malloc_end();
   }
 
+  /* Depsgraph kept for persistent data. */
+  if (engine->depsgraph) {
+    DEG_graph_free(engine->depsgraph);
+  }
+
   BLI_mutex_end(&engine->update_render_passes_mutex);
 
   MEM_freeN(engine);
@@ -504,13 +509,45 @@ RenderData *RE_engine_get_render_data(Render *re)
 }
 
 /* Depsgraph */
+
+/* With persistent data the depsgraph is kept between view layers and animation
+ * frames, so that only changed datablocks are evaluated again and the engine
+ * can sync just those updates. Otherwise it is freed right away to save memory. */
+static bool engine_keep_depsgraph(RenderEngine *engine)
+{
+  return (engine->re->r.mode & R_PERSISTENT_DATA) != 0;
+}
+
+static void engine_depsgraph_free(RenderEngine *engine)
+{
+  if (engine->depsgraph) {
+    DEG_graph_free(engine->depsgraph);
+    engine->depsgraph = NULL;
+  }
+}
+
 static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
 {
   Main *bmain = engine->re->main;
   Scene *scene = engine->re->scene;
 
-  engine->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(engine->depsgraph, "RENDER");
+  /* Reuse depsgraph from persistent data if possible. */
+  if (engine->depsgraph) {
+    if (DEG_get_bmain(engine->depsgraph) != bmain ||
+        DEG_get_input_scene(engine->depsgraph) != scene) {
+      engine_depsgraph_free(engine);
+    }
+    else if (DEG_get_input_view_layer(engine->depsgraph) != view_layer) {
+      /* Objects shared between view layers keep their evaluated data. */
+      DEG_graph_replace_owners(engine->depsgraph, bmain, scene, view_layer);
+      DEG_graph_tag_relations_update(engine->depsgraph);
+    }
+  }
+
+  if (engine->depsgraph == NULL) {
+    engine->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+    DEG_debug_name_set(engine->depsgraph, "RENDER");
+  }
 
   if (engine->re->r.scemode & R_BUTS_PREVIEW) {
     Depsgraph *depsgraph = engine->depsgraph;
@@ -520,15 +557,25 @@ static void engine_depsgraph_init(RenderEngine *engine, ViewLayer *view_layer)
     DEG_ids_clear_recalc(bmain, depsgraph);
   }
   else {
-    BKE_scene_graph_update_for_newframe(engine->depsgraph, bmain);
+    /* Keep recalc flags, so the engine can see what changed since the last frame. */
+    BKE_scene_graph_update_for_newframe_ex(
+        engine->depsgraph, bmain, !engine_keep_depsgraph(engine));
   }
 }
 
-static void engine_depsgraph_free(RenderEngine *engine)
+static void engine_depsgraph_exit(RenderEngine *engine)
 {
-  DEG_graph_free(engine->depsgraph);
+  if (engine->depsgraph == NULL) {
+    return;
+  }
 
-  engine->depsgraph = NULL;
+  if (engine_keep_depsgraph(engine)) {
+    /* The engine handled all updates for this frame by now. */
+    DEG_ids_clear_recalc(engine->re->main, engine->depsgraph);
+  }
+  else {
+    engine_depsgraph_free(engine);
+  }
 }
 
 void RE_engine_frame_set(RenderEngine *engine, int frame, float subframe)
@@ -610,6 +657,8 @@ bool RE_bake_engine(Render *re,
   engine->tile_y = re->r.tiley;
 
   if (type->bake) {
+    /* Baking uses the depsgraph of the caller, not one kept from a previous render. */
+    engine_depsgraph_free(engine);
     engine->depsgraph = depsgraph;
 
     /* update is only called so we create the engine.session */
@@ -787,7 +836,7 @@ int RE_engine_render(Render *re, int do_all)
         DRW_render_gpencil(engine, engine->depsgraph);
       }
 
-      engine_depsgraph_free(engine);
+      engine_depsgraph_exit(engine);
 
       if (RE_engine_test_break(engine)) {
         break;
@@ -879,9 +928,8 @@ void RE_engine_free_blender_memory(RenderEngine *engine)
    *
    * TODO(sergey): Find better solution for this.
    */
-  if (DRW_render_check_grease_pencil(engine->depsgraph)) {
+  if (DRW_render_check_grease_pencil(engine->depsgraph) || engine_keep_depsgraph(engine)) {
     return;
   }
-  DEG_graph_free(engine->depsgraph);
-  engine->depsgraph = NULL;
+  engine_depsgraph_free(engine);
 }
@@ -712,6 +712,7 @@ enum {
   WM_JOB_TYPE_LIGHT_BAKE,
   WM_JOB_TYPE_FSMENU_BOOKMARK_VALIDATE,
   WM_JOB_TYPE_QUADRIFLOW_REMESH,
+  WM_JOB_TYPE_VOXEL_REMESH,
   /* add as needed, bake, seq proxy build
    * if having hard coded values is a problem */
 };
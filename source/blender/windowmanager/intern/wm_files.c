@@ -80,6 +80,7 @@
 #include "BKE_lib_id.h"
 #include "BKE_lib_override.h"
 #include "BKE_main.h"
+#include "BKE_main_idmap.h"
 #include "BKE_packedFile.h"
 #include "BKE_report.h"
 #include "BKE_scene.h"
@@ -154,6 +155,7 @@ static void wm_window_match_init(bContext *C, ListBase *wmlist)
 
   *wmlist = G_MAIN->wm;
   BLI_listbase_clear(&G_MAIN->wm);
+  BKE_main_idmap_names_clear(G_MAIN);
 
   active_win = CTX_wm_window(C);
 
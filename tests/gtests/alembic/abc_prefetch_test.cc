@@ -0,0 +1,164 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+// Keep first since utildefines defines AT which conflicts with STL
+#include "intern/abc_reader_prefetch.h"
+
+#include <Alembic/AbcCoreOgawa/All.h>
+
+#include <sstream>
+
+extern "C" {
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+}
+
+using namespace Alembic::AbcGeom;
+
+#define NUM_SAMPLES 6
+#define NUM_PREFETCH 4
+
+class AlembicPrefetchTest : public testing::Test {
+ protected:
+  /* Streams of the in-memory archive, kept alive while the archive is read. */
+  std::vector<std::istringstream *> streams;
+  IArchive archive;
+  IPolyMeshSchema schema;
+
+ public:
+  static void SetUpTestCase()
+  {
+    BLI_threadapi_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    BLI_threadapi_exit();
+  }
+
+  virtual void SetUp()
+  {
+    std::stringstream buffer;
+
+    /* A triangle moving along X, with a sample per frame. */
+    {
+      OArchive out_archive(Alembic::AbcCoreOgawa::WriteArchive()(&buffer, MetaData()),
+                           kWrapExisting);
+      OPolyMesh out_mesh(OObject(out_archive, kTop), "mesh");
+      OPolyMeshSchema &out_schema = out_mesh.getSchema();
+      const int32_t face_indices[3] = {0, 1, 2};
+      const int32_t face_counts[1] = {3};
+
+      for (int i = 0; i < NUM_SAMPLES; i++) {
+        std::vector<V3f> positions;
+        for (int v = 0; v < 3; v++) {
+          positions.push_back(V3f(i + v, 2.0f, 3.0f));
+        }
+        out_schema.set(OPolyMeshSchema::Sample(P3fArraySample(positions),
+                                               Int32ArraySample(face_indices, 3),
+                                               Int32ArraySample(face_counts, 1)));
+      }
+    }
+
+    /* One stream per reading thread, like archives opened with multiple file streams. */
+    std::vector<std::istream *> input_streams;
+    for (int i = 0; i < BLI_system_thread_count(); i++) {
+      streams.push_back(new std::istringstream(buffer.str()));
+      input_streams.push_back(streams.back());
+    }
+
+    Alembic::AbcCoreOgawa::ReadArchive archive_reader(input_streams);
+    archive = IArchive(archive_reader("memory"), kWrapExisting, ErrorHandler::kThrowPolicy);
+    schema = IPolyMesh(IObject(archive, kTop), "mesh").getSchema();
+  }
+
+  virtual void TearDown()
+  {
+    schema.reset();
+    archive.reset();
+
+    for (std::istringstream *stream : streams) {
+      delete stream;
+    }
+    streams.clear();
+  }
+};
+
+TEST_F(AlembicPrefetchTest, HitsAndMisses)
+{
+  AbcPrefetchCache cache;
+  int hits, misses;
+
+  ASSERT_EQ((size_t)NUM_SAMPLES, schema.getNumSamples());
+
+  /* Nothing is cached before prefetching. */
+  EXPECT_FALSE(cache.find("/mesh", 0));
+
+  cache.prefetch(schema, "/mesh", 0, NUM_PREFETCH);
+  cache.wait();
+
+  for (int i = 0; i < NUM_PREFETCH; i++) {
+    AbcPrefetchedMeshPtr mesh = cache.find("/mesh", i);
+    ASSERT_TRUE(mesh);
+
+    /* Positions are converted from Y-up to Z-up in the background. */
+    ASSERT_EQ(9u, mesh->positions.size());
+    for (int v = 0; v < 3; v++) {
+      EXPECT_FLOAT_EQ(i + v, mesh->positions[v * 3 + 0]);
+      EXPECT_FLOAT_EQ(-3.0f, mesh->positions[v * 3 + 1]);
+      EXPECT_FLOAT_EQ(2.0f, mesh->positions[v * 3 + 2]);
+    }
+  }
+
+  /* Samples outside of the prefetched range and other objects are misses. */
+  EXPECT_FALSE(cache.find("/mesh", NUM_PREFETCH));
+  EXPECT_FALSE(cache.find("/other", 0));
+
+  cache.stats(&hits, &misses);
+  EXPECT_EQ(NUM_PREFETCH, hits);
+  EXPECT_EQ(3, misses);
+}
+
+TEST_F(AlembicPrefetchTest, PrefetchPastLastSample)
+{
+  AbcPrefetchCache cache;
+
+  cache.prefetch(schema, "/mesh", NUM_SAMPLES - 1, NUM_PREFETCH);
+  cache.wait();
+
+  EXPECT_TRUE(cache.find("/mesh", NUM_SAMPLES - 1));
+  EXPECT_FALSE(cache.find("/mesh", NUM_SAMPLES));
+}
+
+TEST_F(AlembicPrefetchTest, ReadWithoutConversion)
+{
+  /* Synchronous reads without the cache keep the positions in the sample only. */
+  AbcPrefetchedMeshPtr mesh = AbcPrefetchCache::read(schema, 2, false);
+  ASSERT_TRUE(mesh);
+  EXPECT_TRUE(mesh->positions.empty());
+
+  P3fArraySamplePtr positions = mesh->sample.getPositions();
+  ASSERT_TRUE(positions);
+  ASSERT_EQ(3u, positions->size());
+  EXPECT_FLOAT_EQ(2.0f, (*positions)[0].x);
+  EXPECT_FLOAT_EQ(2.0f, (*positions)[0].y);
+  EXPECT_FLOAT_EQ(3.0f, (*positions)[0].z);
+
+  mesh = AbcPrefetchCache::read(schema, 2, true);
+  ASSERT_TRUE(mesh);
+  EXPECT_EQ(9u, mesh->positions.size());
+}
@@ -113,6 +113,12 @@ TEST_PARSE_FAIL(Truncated7, "1 and")
 TEST_PARSE_FAIL(Truncated8, "1 or")
 TEST_PARSE_FAIL(Truncated9, "sqrt(1")
 TEST_PARSE_FAIL(Truncated10, "fmod(1,")
+TEST_PARSE_FAIL(Truncated11, "(1, 2)[")
+
+TEST_PARSE_FAIL(BadArgCount6, "clamp(1, 2)")
+TEST_PARSE_FAIL(BadArgCount7, "lerp(1, 2)")
+TEST_PARSE_FAIL(TupleNoIndex, "(1, 2)")
+TEST_PARSE_FAIL(String, "'x'")
 
 /* Constant expression with working constant folding */
 #define TEST_CONST(name, str, value) \
@@ -157,6 +163,36 @@ TEST_EVAL(FMod, "fmod(x, 2)", 3.5, 1.5)
 TEST_CONST(Pow, "pow(4, 0.5)", 2.0)
 TEST_EVAL(Pow, "pow(4, x)", 0.5, 2.0)
 
+TEST_CONST(Round1, "round(2.5)", 2.0)
+TEST_CONST(Round2, "round(-3.5)", -4.0)
+TEST_EVAL(Round, "round(x)", 1.4, 1.0)
+
+TEST_CONST(Bool, "bool(2)", TRUE_VAL)
+TEST_CONST(Float, "float(2)", 2.0)
+
+TEST_CONST(Clamp1, "clamp(2)", 1.0)
+TEST_CONST(Clamp2, "clamp(-1, -2, 2)", -1.0)
+TEST_EVAL(Clamp1, "clamp(x)", -1.0, 0.0)
+TEST_EVAL(Clamp2, "clamp(x, 1, 2)", 3.0, 2.0)
+
+TEST_CONST(Lerp, "lerp(1, 3, 0.5)", 2.0)
+TEST_EVAL(Lerp, "lerp(1, 3, x)", 0.25, 1.5)
+
+TEST_CONST(InverseLerp, "inverse_lerp(2, 4, 3)", 0.5)
+TEST_EVAL(InverseLerp, "inverse_lerp(2, 4, x)", 5.0, 1.5)
+
+TEST_CONST(SmoothStep, "smoothstep(0, 2, 1)", 0.5)
+TEST_EVAL(SmoothStep1, "smoothstep(0, 2, x)", 3.0, 1.0)
+TEST_EVAL(SmoothStep2, "smoothstep(0, 2, x)", 0.5, 0.15625)
+
+TEST_RESULT(Tuple1, "(1, 2, 3)[1]", 2.0)
+TEST_RESULT(Tuple2, "(1, 2, 3)[-1]", 3.0)
+TEST_RESULT(Tuple3, "(1,)[0]", 1.0)
+TEST_RESULT(List1, "[1, 2, 3,][2]", 3.0)
+
+TEST_EVAL(Tuple1, "(1, 2, 3)[x]", 1.0, 2.0)
+TEST_EVAL(Tuple2, "(x, x * 2)[int(x)]", 1.0, 2.0)
+
 TEST_RESULT(Min1, "min(3,1,2)", 1.0)
 TEST_RESULT(Max1, "max(3,1,2)", 3.0)
 TEST_RESULT(Min2, "min(1,2,3)", 1.0)
@@ -314,6 +350,12 @@ TEST_ERROR(PowDomain1, "pow(-1, 0.5)", 0.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain2, "pow(-1, x)", 0.5, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(PowDomain3, "pow(-1, x)", 2.0, EXPR_PYLIKE_SUCCESS)
 
+TEST_ERROR(TupleIndex1, "(1, 2)[x]", 2.0, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(TupleIndex2, "(1, 2)[x]", 0.5, EXPR_PYLIKE_MATH_ERROR)
+TEST_ERROR(TupleIndex3, "(1, 2)[x]", -2.0, EXPR_PYLIKE_SUCCESS)
+
+TEST_ERROR(SmoothStepDomain, "smoothstep(x, 1, 0.5)", 1.0, EXPR_PYLIKE_DIV_BY_ZERO)
+
 TEST_ERROR(Mixed1, "sqrt(x) + 1 / max(0, x)", -1.0, EXPR_PYLIKE_MATH_ERROR)
 TEST_ERROR(Mixed2, "sqrt(x) + 1 / max(0, x)", 0.0, EXPR_PYLIKE_DIV_BY_ZERO)
 TEST_ERROR(Mixed3, "sqrt(x) + 1 / max(0, x)", 1.0, EXPR_PYLIKE_SUCCESS)
@@ -337,3 +379,44 @@ TEST(expr_pylike, Error_ArgumentCount)
 
   BLI_expr_pylike_free(expr);
 }
+
+TEST(expr_pylike, ErrorMessage)
+{
+  const char *names[1] = {"x"};
+
+  ExprPyLike_Parsed *expr = BLI_expr_pylike_parse("x + 1", names, ARRAY_SIZE(names));
+  EXPECT_EQ(BLI_expr_pylike_error_get(expr), (const char *)NULL);
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("foo(x)", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_error_get(expr), "unknown name 'foo'");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("sqrt(1, 2)", names, ARRAY_SIZE(names));
+  EXPECT_STREQ(BLI_expr_pylike_error_get(expr), "'sqrt' takes 1 argument(s) (2 given)");
+  BLI_expr_pylike_free(expr);
+
+  expr = BLI_expr_pylike_parse("x.y", names, ARRAY_SIZE(names));
+  EXPECT_NE(BLI_expr_pylike_error_get(expr), (const char *)NULL);
+  BLI_expr_pylike_free(expr);
+}
+
+static double expr_pylike_test_func(double a, double b)
+{
+  return a * 10.0 + b;
+}
+
+TEST(expr_pylike, RegisterFunction)
+{
+  EXPECT_FALSE(BLI_expr_pylike_register_function("sqrt", 1, (void *)expr_pylike_test_func));
+  EXPECT_FALSE(BLI_expr_pylike_register_function("test_func", 4, (void *)expr_pylike_test_func));
+  EXPECT_TRUE(BLI_expr_pylike_register_function("test_func", 2, (void *)expr_pylike_test_func));
+
+  expr_pylike_const_test("test_func(1, 2)", 12.0, true);
+  expr_pylike_eval_test("test_func(x, 2)", 3.0, 32.0);
+  expr_pylike_parse_fail_test("test_func(1)");
+
+  BLI_expr_pylike_unregister_function("test_func");
+
+  expr_pylike_parse_fail_test("test_func(1, 2)");
+}
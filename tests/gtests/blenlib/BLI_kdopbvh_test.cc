@@ -2,7 +2,9 @@
 
 #include "testing/testing.h"
 
-/* TODO: ray intersection, overlap ... etc.*/
+#include <algorithm>
+
+/* TODO: ray intersection ... etc.*/
 
 #include "MEM_guardedalloc.h"
 
@@ -136,3 +138,72 @@ TEST(kdopbvh, OptimalFindNearest_500)
 {
   find_nearest_points_test(500, 1.0, 1000, 12, true);
 }
+
+static bool overlap_pair_less(const BVHTreeOverlap &a, const BVHTreeOverlap &b)
+{
+  return (a.indexA != b.indexA) ? (a.indexA < b.indexA) : (a.indexB < b.indexB);
+}
+
+static bool overlap_pair_is_reversed(const BVHTreeOverlap &a)
+{
+  return a.indexA > a.indexB;
+}
+
+/**
+ * Overlapping a tree with itself into a caller owned buffer must give the pairs of
+ * #BLI_bvhtree_overlap once each, and report the needed size when the buffer is too small.
+ */
+static void overlap_buffer_test(int points_len, float epsilon, int random_seed)
+{
+  struct RNG *rng = BLI_rng_new(random_seed);
+  BVHTree *tree = BLI_bvhtree_new(points_len, epsilon, 4, 26);
+
+  for (int i = 0; i < points_len; i++) {
+    float co[3];
+    rng_v3_round(co, 3, rng, 1000, 1.0f);
+    BLI_bvhtree_insert(tree, i, co, 1);
+  }
+  BLI_bvhtree_balance(tree);
+
+  uint expected_len = 0;
+  BVHTreeOverlap *expected = BLI_bvhtree_overlap(tree, tree, &expected_len, NULL, NULL);
+  BVHTreeOverlap *expected_end = std::remove_if(
+      expected, expected + expected_len, overlap_pair_is_reversed);
+  expected_len = (uint)(expected_end - expected);
+  EXPECT_GT(expected_len, 0);
+
+  /* Too small buffers only count the results. */
+  EXPECT_EQ(BLI_bvhtree_overlap_buffer(tree, tree, NULL, 0, NULL, NULL), expected_len);
+
+  BVHTreeOverlap *partial = (BVHTreeOverlap *)MEM_mallocN(sizeof(BVHTreeOverlap) * 4, __func__);
+  EXPECT_EQ(BLI_bvhtree_overlap_buffer(tree, tree, partial, 4, NULL, NULL), expected_len);
+  MEM_freeN(partial);
+
+  BVHTreeOverlap *overlap = (BVHTreeOverlap *)MEM_mallocN(
+      sizeof(BVHTreeOverlap) * expected_len, __func__);
+  const uint overlap_len = BLI_bvhtree_overlap_buffer(
+      tree, tree, overlap, expected_len, NULL, NULL);
+  EXPECT_EQ(overlap_len, expected_len);
+
+  std::sort(expected, expected + expected_len, overlap_pair_less);
+  std::sort(overlap, overlap + overlap_len, overlap_pair_less);
+  for (uint i = 0; i < expected_len; i++) {
+    EXPECT_EQ(overlap[i].indexA, expected[i].indexA);
+    EXPECT_EQ(overlap[i].indexB, expected[i].indexB);
+  }
+
+  MEM_freeN(overlap);
+  MEM_freeN(expected);
+  BLI_bvhtree_free(tree);
+  BLI_rng_free(rng);
+}
+
+TEST(kdopbvh, OverlapBuffer_100)
+{
+  overlap_buffer_test(100, 0.05f, 12);
+}
+TEST(kdopbvh, OverlapBuffer_5000)
+{
+  /* Large enough to use threading. */
+  overlap_buffer_test(5000, 0.02f, 123);
+}
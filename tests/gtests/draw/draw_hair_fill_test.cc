@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+#include "testing/testing.h"
+
+#include <vector>
+
+extern "C" {
+#include "BLI_math_vector.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_customdata_types.h"
+
+#include "BKE_particle.h"
+
+#include "GPU_batch.h"
+#include "GPU_texture.h"
+#include "GPU_vertex_buffer.h"
+
+#include "draw_hair_private.h"
+}
+
+/* Enough paths for the fill to be threaded. */
+#define NUM_PATHS 2000
+/* Position and normalized length along the strand. */
+#define POINT_STRIDE (sizeof(float) * 4)
+
+class DrawHairFillTest : public testing::Test {
+ protected:
+  std::vector<std::vector<ParticleCacheKey>> paths;
+  std::vector<ParticleCacheKey *> path_cache;
+  int point_len = 0;
+
+ public:
+  static void SetUpTestCase()
+  {
+    BLI_threadapi_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    BLI_threadapi_exit();
+  }
+
+  virtual void SetUp()
+  {
+    for (int i = 0; i < NUM_PATHS; i++) {
+      /* Mix drawn paths of varying length, paths without segments which are skipped,
+       * and zero length paths which are not normalized. */
+      const int segments = (i % 7 == 0) ? 0 : 1 + i % 5;
+      const bool zero_length = (i % 11 == 0);
+
+      std::vector<ParticleCacheKey> path(segments + 1);
+      for (int j = 0; j <= segments; j++) {
+        memset(&path[j], 0, sizeof(ParticleCacheKey));
+        if (!zero_length) {
+          path[j].co[0] = (float)i;
+          path[j].co[1] = 0.1f * j * j;
+          path[j].co[2] = 0.3f * j + 0.01f * i;
+        }
+      }
+      path[0].segments = segments;
+      paths.push_back(path);
+
+      if (segments > 0) {
+        point_len += segments + 1;
+      }
+    }
+    for (std::vector<ParticleCacheKey> &path : paths) {
+      path_cache.push_back(path.data());
+    }
+  }
+
+  void raw_init(GPUVertBufRaw *raw, std::vector<unsigned char> &buffer)
+  {
+    buffer.assign(POINT_STRIDE * point_len, 0);
+    raw->size = POINT_STRIDE;
+    raw->stride = POINT_STRIDE;
+    raw->data = buffer.data();
+    raw->data_init = buffer.data();
+#if TRUST_NO_ONE
+    raw->_data_end = buffer.data() + buffer.size();
+#endif
+  }
+};
+
+/* Point by point fill, the way paths were filled before it was threaded. */
+static void fill_proc_pos_serial(ParticleCacheKey **path_cache,
+                                 const int num_path_keys,
+                                 GPUVertBufRaw *attr_step)
+{
+  for (int i = 0; i < num_path_keys; i++) {
+    ParticleCacheKey *path = path_cache[i];
+    if (path->segments <= 0) {
+      continue;
+    }
+    float total_len = 0.0f;
+    float *co_prev = NULL, *seg_data_first = NULL;
+    for (int j = 0; j <= path->segments; j++) {
+      float *seg_data = (float *)GPU_vertbuf_raw_step(attr_step);
+      copy_v3_v3(seg_data, path[j].co);
+      if (co_prev) {
+        total_len += len_v3v3(co_prev, path[j].co);
+      }
+      else {
+        seg_data_first = seg_data;
+      }
+      seg_data[3] = total_len;
+      co_prev = path[j].co;
+    }
+    if (total_len > 0.0f) {
+      for (int j = 0; j <= path->segments; j++, seg_data_first += 4) {
+        seg_data_first[3] /= total_len;
+      }
+    }
+  }
+}
+
+TEST_F(DrawHairFillTest, ParallelMatchesSerial)
+{
+  GPUVertBufRaw serial, parallel;
+  std::vector<unsigned char> serial_buffer, parallel_buffer;
+  raw_init(&serial, serial_buffer);
+  raw_init(&parallel, parallel_buffer);
+
+  fill_proc_pos_serial(path_cache.data(), NUM_PATHS, &serial);
+  particle_batch_cache_fill_segments_proc_pos(path_cache.data(), NUM_PATHS, &parallel);
+
+  /* Both steps end after the last written point. */
+  EXPECT_EQ((uint)point_len, GPU_vertbuf_raw_used(&serial));
+  EXPECT_EQ((uint)point_len, GPU_vertbuf_raw_used(&parallel));
+
+  EXPECT_EQ(0, memcmp(serial_buffer.data(), parallel_buffer.data(), serial_buffer.size()));
+}
+
+TEST_F(DrawHairFillTest, NormalizedLength)
+{
+  GPUVertBufRaw raw;
+  std::vector<unsigned char> buffer;
+  raw_init(&raw, buffer);
+
+  particle_batch_cache_fill_segments_proc_pos(path_cache.data(), NUM_PATHS, &raw);
+
+  const float *point = (const float *)buffer.data();
+  for (int i = 0; i < NUM_PATHS; i++) {
+    const int segments = path_cache[i]->segments;
+    if (segments <= 0) {
+      continue;
+    }
+    /* Strands start at zero, and end at one unless they have no length. */
+    EXPECT_FLOAT_EQ(0.0f, point[3]);
+    EXPECT_FLOAT_EQ((i % 11 == 0) ? 0.0f : 1.0f, point[segments * 4 + 3]);
+    point += (segments + 1) * 4;
+  }
+}
+
+TEST_F(DrawHairFillTest, EmptyPaths)
+{
+  GPUVertBufRaw raw;
+  std::vector<unsigned char> buffer;
+  raw_init(&raw, buffer);
+
+  /* Nothing is written when there is no path. */
+  particle_batch_cache_fill_segments_proc_pos(path_cache.data(), 0, &raw);
+  EXPECT_EQ(0u, GPU_vertbuf_raw_used(&raw));
+}
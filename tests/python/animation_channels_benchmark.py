@@ -0,0 +1,81 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/animation_channels_benchmark.py -- --objects=100 --properties=1000
+#
+# Animation evaluation throughput in channels per second, for objects with actions animating
+# their transform and many custom properties.
+
+import math
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments, time_frames
+
+
+def add_fcurve(action, data_path, index, phase, args):
+    fcurve = action.fcurves.new(data_path, index=index)
+    fcurve.keyframe_points.add(args.keys)
+    step = max(args.frames / max(args.keys - 1, 1), 1.0)
+    for i, point in enumerate(fcurve.keyframe_points):
+        frame = 1.0 + i * step
+        point.co = (frame, math.sin(frame * 0.1 + phase))
+    fcurve.update()
+
+
+def build_scene(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    totchannel = 0
+
+    for i in range(args.objects):
+        ob = bpy.data.objects.new("Object%d" % i, None)
+        scene.collection.objects.link(ob)
+        action = bpy.data.actions.new("Action%d" % i)
+        ob.animation_data_create().action = action
+
+        for data_path in ("location", "rotation_euler", "scale"):
+            for index in range(3):
+                add_fcurve(action, data_path, index, i + index, args)
+        for p in range(args.properties):
+            ob["prop%d" % p] = 0.0
+            add_fcurve(action, '["prop%d"]' % p, 0, i + p, args)
+        totchannel += 9 + args.properties
+
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+    return scene, totchannel
+
+
+def main():
+    args = parse_arguments("Animation channels benchmark", (
+        ("--objects", 100, "Number of animated objects"),
+        ("--properties", 1000, "Animated custom properties per object"),
+        ("--keys", 20, "Keyframes per channel"),
+        ("--frames", 100, "Number of frames to evaluate"),
+    ))
+    scene, totchannel = build_scene(args)
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    # The first frame resolves all channels, report it separately.
+    start_time = time.time()
+    scene.frame_set(scene.frame_start)
+    depsgraph.update()
+    first_frame_time = time.time() - start_time
+
+    frame_times = time_frames(scene, depsgraph)
+    total_time = sum(frame_times)
+
+    print("")
+    print("%d objects, %d channels, %d frames" % (args.objects, totchannel, args.frames))
+    print("First frame: %.2f ms" % (first_frame_time * 1000.0))
+    if total_time > 0.0:
+        print("Per frame:   %.2f ms" % (total_time / len(frame_times) * 1000.0))
+        print("Throughput:  %.0f channels/s" % (totchannel * len(frame_times) / total_time))
+
+
+if __name__ == "__main__":
+    main()
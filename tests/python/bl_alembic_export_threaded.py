@@ -0,0 +1,126 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_alembic_export_threaded.py -- --verbose
+import bpy
+import os
+import sys
+import tempfile
+import unittest
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import compare_single_threaded
+
+NUM_FRAMES = 3
+NUM_CUBES = 6
+
+
+def build_scene():
+    """
+    Objects with deforming modifiers, topology changes, UVs and a parent, so every stage of the
+    mesh conversion runs for several objects at once.
+    """
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+    scene.frame_start = 1
+    scene.frame_end = NUM_FRAMES
+
+    bpy.ops.mesh.primitive_cube_add(size=2.0)
+    cube = bpy.context.object
+    cube.data.edges[0].crease = 1.0
+    cube.modifiers.new("Subdivision", 'SUBSURF').levels = 2
+    wave = cube.modifiers.new("Wave", 'WAVE')
+    wave.height = 0.3
+    for i in range(1, NUM_CUBES):
+        ob = cube.copy()
+        ob.location.x = i * 3.0
+        ob.modifiers["Wave"].time_offset = -i
+        scene.collection.objects.link(ob)
+
+    bpy.ops.mesh.primitive_monkey_add(location=(0.0, 4.0, 0.0))
+    monkey = bpy.context.object
+    twist = monkey.modifiers.new("Twist", 'SIMPLE_DEFORM')
+    for frame, angle in ((1, 0.0), (NUM_FRAMES, 1.0)):
+        twist.angle = angle
+        monkey.keyframe_insert('modifiers["Twist"].angle', frame=frame)
+
+    bpy.ops.mesh.primitive_circle_add(vertices=12, fill_type='NGON', location=(4.0, 4.0, 0.0))
+
+    bpy.ops.mesh.primitive_plane_add(location=(0.0, 0.0, 2.0))
+    plane = bpy.context.object
+    plane.parent = cube
+    for frame, z in ((1, 2.0), (NUM_FRAMES, 3.0)):
+        plane.location.z = z
+        plane.keyframe_insert("location", index=2, frame=frame)
+
+    return scene
+
+
+def export_and_read(triangulate):
+    """
+    Export the scene, import the archive in an empty scene and return the evaluated meshes of
+    all frames as lists of matrices, positions, face vertices and UVs.
+    """
+    build_scene()
+    filepath = os.path.join(tempfile.gettempdir(),
+                            "bl_alembic_export_threaded_%d.abc" % os.getpid())
+    result = bpy.ops.wm.alembic_export(filepath=filepath, start=1, end=NUM_FRAMES,
+                                       triangulate=triangulate, as_background_job=False)
+    if result != {'FINISHED'}:
+        raise RuntimeError("Export failed")
+
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.wm.alembic_import(filepath=filepath, as_background_job=False)
+    scene = bpy.context.scene
+
+    frames = []
+    for frame in range(1, NUM_FRAMES + 1):
+        scene.frame_set(frame)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        objects = {}
+        for ob in scene.objects:
+            if ob.type != 'MESH':
+                continue
+            ob_eval = ob.evaluated_get(depsgraph)
+            mesh = ob_eval.to_mesh()
+            objects[ob.name] = {
+                "matrix": [value for row in ob_eval.matrix_world for value in row],
+                "positions": [value for v in mesh.vertices for value in v.co],
+                "faces": [list(poly.vertices) for poly in mesh.polygons],
+                "uvs": [value for layer in mesh.uv_layers
+                        for loop in layer.data for value in loop.uv],
+            }
+            ob_eval.to_mesh_clear()
+        frames.append(objects)
+
+    os.remove(filepath)
+    return frames
+
+
+class AlembicExportThreadedTest(unittest.TestCase):
+    def check_export(self, triangulate):
+        frames, frames_serial = compare_single_threaded(export_and_read, triangulate)
+
+        self.assertEqual(NUM_FRAMES, len(frames))
+        self.assertEqual(NUM_CUBES + 3, len(frames[0]))
+        for name in frames[0]:
+            # Animation is exported, so samples of later frames are not a copy of the first.
+            if name.startswith(("Cube", "Suzanne")):
+                self.assertNotEqual(frames[0][name]["positions"],
+                                    frames[-1][name]["positions"], name)
+            elif name.startswith("Plane"):
+                self.assertNotEqual(frames[0][name]["matrix"], frames[-1][name]["matrix"])
+            if triangulate:
+                self.assertTrue(all(len(face) == 3 for face in frames[0][name]["faces"]), name)
+
+        self.assertEqual(frames, frames_serial)
+
+    def test_export(self):
+        self.check_export(False)
+
+    def test_export_triangulate(self):
+        self.check_export(True)
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,140 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_animation_channels.py -- --verbose
+import bpy
+import math
+import unittest
+
+# More channels than evaluated serially by the animation system.
+NUM_PROPERTIES = 300
+
+# Frames evaluated in playback order, backwards, jumping around and exactly on keys.
+FRAMES = ([1.0 + i * 0.5 for i in range(50)] +
+          [25.0 - i * 0.75 for i in range(30)] +
+          [13.0, 2.0, 24.5, 7.25, 7.5, 30.0, -2.0, 1.0, 16.0, 4.0])
+
+
+def add_fcurve(action, data_path, phase):
+    """Keys with varying spacing, including two keys closer than the search threshold."""
+    fcurve = action.fcurves.new(data_path)
+    frames = [1.0, 2.0, 2.00005, 4.0, 7.5, 8.0, 13.0, 16.0, 20.0, 24.5]
+    fcurve.keyframe_points.add(len(frames))
+    for i, point in enumerate(fcurve.keyframe_points):
+        point.co = (frames[i], math.sin(i + phase))
+        point.interpolation = 'LINEAR' if i % 3 == 0 else 'BEZIER'
+    fcurve.update()
+    return fcurve
+
+
+def build_object():
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    ob = bpy.data.objects.new("Object", None)
+    bpy.context.scene.collection.objects.link(ob)
+
+    action = bpy.data.actions.new("Action")
+    ob.animation_data_create().action = action
+    for i in range(NUM_PROPERTIES):
+        ob["prop%d" % i] = 0.0
+        add_fcurve(action, '["prop%d"]' % i, i)
+    return ob
+
+
+class TestAnimationChannels(unittest.TestCase):
+    """
+    F-Curves remember the keyframe segment of the last evaluation, and the channels of
+    evaluated data-blocks are resolved once. Edits made after the first evaluation must not
+    use a stale segment or channel.
+    """
+
+    def assertChannelsMatch(self, ob, frame):
+        scene = bpy.context.scene
+        scene.frame_set(frame)
+        ob_eval = ob.evaluated_get(bpy.context.evaluated_depsgraph_get())
+        for fcurve in ob.animation_data.action.fcurves:
+            name = fcurve.data_path[2:-2]
+            self.assertEqual(ob_eval[name], fcurve.evaluate(frame), name)
+
+    def test_keyframe_segments(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        fcurve = add_fcurve(bpy.data.actions.new("Action"), "location", 0.5)
+
+        for frame in FRAMES:
+            # A new curve has no previous segment to start from.
+            reference_action = bpy.data.actions.new("Reference")
+            reference = add_fcurve(reference_action, "location", 0.5).evaluate(frame)
+            bpy.data.actions.remove(reference_action)
+            self.assertEqual(fcurve.evaluate(frame), reference, "frame %f" % frame)
+
+    def test_evaluated_channels(self):
+        ob = build_object()
+        scene = bpy.context.scene
+        fcurves = ob.animation_data.action.fcurves
+        for frame in FRAMES:
+            scene.frame_set(int(math.floor(frame)), subframe=frame - math.floor(frame))
+            ob_eval = ob.evaluated_get(bpy.context.evaluated_depsgraph_get())
+            for i, fcurve in enumerate(fcurves):
+                self.assertEqual(ob_eval["prop%d" % i], fcurve.evaluate(scene.frame_current_final))
+
+    def test_data_path_change(self):
+        ob = build_object()
+        scene = bpy.context.scene
+        scene.frame_set(5)
+        ob["other"] = 0.0
+
+        # Cached channels are resolved again after the F-Curve changes.
+        fcurve = ob.animation_data.action.fcurves[0]
+        fcurve.data_path = '["other"]'
+        scene.frame_set(6)
+        ob_eval = ob.evaluated_get(bpy.context.evaluated_depsgraph_get())
+        self.assertEqual(ob_eval["other"], fcurve.evaluate(6.0))
+        self.assertEqual(ob_eval["prop0"], ob["prop0"])
+
+    def test_keyframes_edited(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        action = bpy.data.actions.new("Action")
+        fcurve = add_fcurve(action, "location", 0.5)
+        fcurve.evaluate(22.0)
+
+        # The remembered segment is past the last key, then points at a different segment.
+        points = fcurve.keyframe_points
+        points.remove(points[-1])
+        points.remove(points[-1])
+        points.insert(10.0, 3.0)
+        fcurve.update()
+
+        reference = action.fcurves.new("rotation_euler")
+        reference.keyframe_points.add(len(points))
+        for point, point_reference in zip(points, reference.keyframe_points):
+            point_reference.co = point.co
+            point_reference.interpolation = point.interpolation
+            point_reference.handle_left = point.handle_left
+            point_reference.handle_right = point.handle_right
+        for frame in (22.0, 15.0, 10.5, 9.0):
+            self.assertEqual(fcurve.evaluate(frame), reference.evaluate(frame), frame)
+
+    def test_action_change(self):
+        ob = build_object()
+        self.assertChannelsMatch(ob, 5)
+
+        # Other channels, in another order.
+        action = bpy.data.actions.new("Other")
+        for i in reversed(range(0, NUM_PROPERTIES, 2)):
+            add_fcurve(action, '["prop%d"]' % i, i + 10)
+        ob.animation_data.action = action
+        self.assertChannelsMatch(ob, 6)
+
+    def test_fcurves_added_and_removed(self):
+        ob = build_object()
+        self.assertChannelsMatch(ob, 5)
+
+        action = ob.animation_data.action
+        ob["added"] = 0.0
+        action.fcurves.remove(action.fcurves[1])
+        add_fcurve(action, '["added"]', 3.0)
+        self.assertChannelsMatch(ob, 6)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
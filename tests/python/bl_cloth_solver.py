@@ -0,0 +1,117 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_cloth_solver.py -- --verbose
+import bpy
+import unittest
+
+NUM_FRAMES = 6
+QUALITY = 3
+
+
+def build_cloth(tension_stiffness=15.0):
+    """Grid with more vertices than solved on a single thread, pinned along one edge."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=60, y_subdivisions=60, size=2.0)
+    ob = bpy.context.object
+
+    group = ob.vertex_groups.new(name="Pin")
+    group.add([v.index for v in ob.data.vertices if v.co.y > 1.0 - 1e-4], 1.0, 'REPLACE')
+
+    modifier = ob.modifiers.new(name="Cloth", type='CLOTH')
+    modifier.settings.quality = QUALITY
+    modifier.settings.vertex_group_mass = group.name
+    modifier.settings.tension_stiffness = tension_stiffness
+    modifier.collision_settings.use_collision = False
+    modifier.point_cache.frame_end = NUM_FRAMES
+    return ob
+
+
+def simulate(ob):
+    """Evaluated coordinates and solver result for every frame."""
+    scene = bpy.context.scene
+    frames = []
+    for frame in range(1, NUM_FRAMES + 1):
+        scene.frame_set(frame)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        ob_eval = ob.evaluated_get(depsgraph)
+        mesh = ob_eval.data
+        co = [0.0] * (len(mesh.vertices) * 3)
+        mesh.vertices.foreach_get("co", co)
+        result = ob_eval.modifiers["Cloth"].solver_result
+        frames.append({
+            "co": co,
+            "status": sorted(result.status),
+            "iterations": (result.min_iterations, result.max_iterations),
+            "max_error": result.max_error,
+            "substeps": result.substeps,
+            "times": (result.force_time, result.solve_time, result.collision_time),
+            "substep_times": (result.avg_substep_time, result.max_substep_time),
+        })
+    return frames
+
+
+def edge_stretch(ob, co):
+    """Average ratio of the edge lengths to their rest lengths."""
+    rest = ob.data.vertices
+    stretch = 0.0
+    for edge in ob.data.edges:
+        a, b = edge.vertices
+        length = sum((co[a * 3 + i] - co[b * 3 + i]) ** 2 for i in range(3)) ** 0.5
+        stretch += length / (rest[a].co - rest[b].co).length
+    return stretch / len(ob.data.edges)
+
+
+class TestClothSolver(unittest.TestCase):
+    """
+    The conjugate gradient solver works on a row-wise copy of the system matrix with a block
+    Jacobi preconditioner, and reports timings of every substep.
+    """
+
+    def test_pinned_and_falling(self):
+        frames = simulate(build_cloth())
+        first = frames[0]["co"]
+        last = frames[-1]["co"]
+        fall = []
+        for i in range(0, len(first), 3):
+            if first[i + 1] > 1.0 - 1e-4:
+                # Pinned.
+                for a, b in zip(last[i:i + 3], first[i:i + 3]):
+                    self.assertAlmostEqual(a, b, places=5)
+            else:
+                fall.append(first[i + 2] - last[i + 2])
+        self.assertGreater(sum(fall) / len(fall), 0.01)
+
+    def test_convergence(self):
+        for frame in simulate(build_cloth())[1:]:
+            self.assertEqual(frame["status"], ['SUCCESS'])
+            self.assertGreater(frame["iterations"][0], 0)
+            # Residual relative to the right hand side, below the solver tolerance.
+            self.assertLessEqual(frame["max_error"], 0.01)
+
+    def test_substep_timings(self):
+        for frame in simulate(build_cloth())[1:]:
+            self.assertEqual(frame["substeps"], QUALITY)
+            force_time, solve_time, collision_time = frame["times"]
+            avg_substep_time, max_substep_time = frame["substep_times"]
+            self.assertGreater(solve_time, 0.0)
+            self.assertGreaterEqual(force_time, 0.0)
+            self.assertGreaterEqual(collision_time, 0.0)
+            self.assertLessEqual(avg_substep_time, max_substep_time)
+            # Substeps include all stages.
+            self.assertGreaterEqual(avg_substep_time * QUALITY * 1.0001,
+                                    force_time + solve_time + collision_time)
+
+    def test_stiffness(self):
+        ob = build_cloth(tension_stiffness=2.0)
+        stretch_soft = edge_stretch(ob, simulate(ob)[-1]["co"])
+        ob = build_cloth(tension_stiffness=200.0)
+        stretch_stiff = edge_stretch(ob, simulate(ob)[-1]["co"])
+
+        self.assertGreater(stretch_soft, 1.0)
+        self.assertLess(stretch_stiff, stretch_soft)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,110 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_cycles_light_tree.py -- --verbose
+import bpy
+import os
+import shutil
+import tempfile
+import unittest
+
+
+class TestLightTree(unittest.TestCase):
+    """
+    Sampling lights with the light tree converges to the same image as the flat distribution,
+    only the noise differs.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.temp_dir = tempfile.mkdtemp()
+        scene = bpy.context.scene
+
+        bpy.ops.mesh.primitive_plane_add(size=20.0)
+
+        for i in range(16):
+            light = bpy.data.lights.new("Light%d" % i, 'SPOT' if i % 4 == 0 else 'POINT')
+            light.energy = 20.0 + 10.0 * (i % 3)
+            light.color = (1.0, 0.5 + (i % 2) * 0.5, 0.5)
+            light.spot_size = 2.0
+            ob = bpy.data.objects.new("Light%d" % i, light)
+            ob.location = ((i % 4) * 4.0 - 6.0, (i // 4) * 4.0 - 6.0, 1.0 + (i % 3) * 0.5)
+            scene.collection.objects.link(ob)
+
+        # Emissive triangles, sampled as mesh lights.
+        material = bpy.data.materials.new("Emission")
+        material.use_nodes = True
+        nodes = material.node_tree.nodes
+        nodes.clear()
+        emission = nodes.new("ShaderNodeEmission")
+        emission.inputs["Strength"].default_value = 10.0
+        output = nodes.new("ShaderNodeOutputMaterial")
+        material.node_tree.links.new(emission.outputs["Emission"], output.inputs["Surface"])
+        bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=1, radius=0.5, location=(2.0, 2.0, 1.0))
+        bpy.context.object.data.materials.append(material)
+
+        camera_ob = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+        camera_ob.location = (0.0, 0.0, 20.0)
+        scene.collection.objects.link(camera_ob)
+        scene.camera = camera_ob
+
+        scene.world = bpy.data.worlds.new("World")
+        scene.world.color = (0.0, 0.0, 0.0)
+
+        scene.render.engine = 'CYCLES'
+        scene.render.resolution_x = 32
+        scene.render.resolution_y = 32
+        scene.render.resolution_percentage = 100
+        scene.render.image_settings.file_format = 'OPEN_EXR'
+        scene.render.image_settings.color_depth = '32'
+        scene.cycles.device = 'CPU'
+        scene.cycles.progressive = 'PATH'
+        scene.cycles.samples = 256
+        scene.cycles.max_bounces = 1
+        scene.cycles.use_denoising = False
+        scene.cycles.light_sampling_threshold = 0.0
+
+    def tearDown(self):
+        shutil.rmtree(self.temp_dir)
+
+    def render_quadrants(self, use_light_tree):
+        """Mean color of each quarter of the image."""
+        scene = bpy.context.scene
+        scene.cycles.use_light_tree = use_light_tree
+        scene.render.filepath = os.path.join(self.temp_dir, "light_tree_%d.exr" % use_light_tree)
+        bpy.ops.render.render(write_still=True)
+
+        image = bpy.data.images.load(scene.render.filepath)
+        width, height = image.size
+        pixels = list(image.pixels)
+        bpy.data.images.remove(image)
+
+        sums = [0.0] * 4
+        for y in range(height):
+            for x in range(width):
+                quadrant = (2 * y // height) * 2 + (2 * x // width)
+                offset = (y * width + x) * 4
+                sums[quadrant] += sum(pixels[offset:offset + 3])
+        return [value / (width * height / 4) for value in sums]
+
+    def assertImagesConverge(self):
+        flat = self.render_quadrants(False)
+        tree = self.render_quadrants(True)
+        for value_flat, value_tree in zip(flat, tree):
+            self.assertGreater(value_flat, 0.0)
+            self.assertAlmostEqual(value_tree / value_flat, 1.0, delta=0.05)
+
+    def test_lamps_and_mesh_lights(self):
+        self.assertImagesConverge()
+
+    def test_distant_light(self):
+        # Sun lights are outside of the tree.
+        sun = bpy.data.objects.new("Sun", bpy.data.lights.new("Sun", 'SUN'))
+        sun.data.energy = 0.5
+        bpy.context.scene.collection.objects.link(sun)
+        self.assertImagesConverge()
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
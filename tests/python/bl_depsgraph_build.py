@@ -0,0 +1,139 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_depsgraph_build.py -- --verbose
+import bpy
+import os
+import re
+import sys
+import tempfile
+import unittest
+
+NODE_RE = re.compile(r'^"node_([^"]+)"\[(label|shape)=')
+EDGE_RE = re.compile(r'^"node_([^"]+)" -> "node_([^"]+)"\[id="([^"]*)"')
+ID_RE = re.compile(r'^ID_REF : (\S+) \(orig')
+
+
+def build_scene():
+    """Objects sharing meshes, with parents, modifiers and constraints, over a few collections."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    meshes = [bpy.data.meshes.new("Mesh%d" % i) for i in range(3)]
+    collections = []
+    for i in range(5):
+        collection = bpy.data.collections.new("Collection%d" % i)
+        scene.collection.children.link(collection)
+        collections.append(collection)
+
+    previous = None
+    for i in range(200):
+        data = meshes[i % len(meshes)] if i % 5 != 0 else None
+        ob = bpy.data.objects.new("Object%d" % i, data)
+        collections[i % len(collections)].objects.link(ob)
+        if previous is not None and i % 10 == 1:
+            ob.parent = previous
+        if data is not None and i % 7 == 0:
+            ob.modifiers.new("Array", 'ARRAY')
+        if previous is not None and i % 11 == 0:
+            constraint = ob.constraints.new('COPY_ROTATION')
+            constraint.target = previous
+        previous = ob
+    return scene
+
+
+def graph_relations(depsgraph):
+    """
+    Sorted relations of the graph, as names of the nodes they link and of the relation. Nodes are
+    named by the path of the clusters they're in, since the graphviz output identifies them by
+    memory address.
+    """
+    with tempfile.TemporaryDirectory() as tempdir:
+        filepath = os.path.join(tempdir, "relations.dot")
+        depsgraph.debug_relations_graphviz(filepath)
+        with open(filepath) as f:
+            lines = f.read().splitlines()
+
+    names = {}
+    relations = []
+    path = []
+    identifier = None
+    for line in lines:
+        if line.startswith("// "):
+            identifier = line[3:]
+        elif line.startswith("subgraph \"cluster_"):
+            path.append(identifier)
+        elif line == "}" and path:
+            path.pop()
+        else:
+            match = NODE_RE.match(line)
+            if match:
+                # Clusters have a point node of their own.
+                names[match.group(1)] = "/".join(
+                    path if match.group(2) == "shape" else path + [identifier])
+                continue
+            match = EDGE_RE.match(line)
+            if match:
+                relations.append([names[match.group(1)], names[match.group(2)], match.group(3)])
+    return sorted(relations)
+
+
+def relation_id_names(relation):
+    """Names of the data-blocks owning both ends of a relation, None for other nodes."""
+    matches = [ID_RE.match(path.split("/")[0]) for path in relation[:2]]
+    return tuple(match.group(1) if match else None for match in matches)
+
+
+class TestDepsgraphBuild(unittest.TestCase):
+    """
+    Copy-on-write relations are built and components are finalized per ID in parallel.
+    Every ID gets its relations, in the same graph for every build.
+    """
+
+    def test_rebuild(self):
+        scene = build_scene()
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        relations = graph_relations(depsgraph)
+        self.assertIn("CoW Dependency", [name for _, _, name in relations])
+
+        dummy = bpy.data.objects.new("Dummy", None)
+        for _ in range(3):
+            # Linking an object tags relations of the whole graph for update.
+            scene.collection.objects.link(dummy)
+            scene.collection.objects.unlink(dummy)
+            depsgraph.update()
+            self.assertEqual(graph_relations(depsgraph), relations)
+
+    def test_copy_on_write_relations(self):
+        build_scene()
+        relations = graph_relations(bpy.context.evaluated_depsgraph_get())
+        names = {relation_id_names(relation)[1] for relation in relations
+                 if relation[2] == "CoW Dependency"}
+
+        # All operations of an ID depend on its own copy, for every ID in the graph.
+        expected = (["OB" + ob.name for ob in bpy.data.objects] +
+                    ["ME" + mesh.name for mesh in bpy.data.meshes])
+        for name in expected:
+            self.assertIn(name, names)
+
+    def test_relations_edit(self):
+        build_scene()
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        ob = bpy.data.objects["Object150"]
+        link = ("OBObject3", "OBObject150")
+
+        # Relations between IDs built separately are part of the graph.
+        constraint = ob.constraints.new('COPY_LOCATION')
+        constraint.target = bpy.data.objects["Object3"]
+        depsgraph.update()
+        self.assertIn(link, {relation_id_names(relation) for relation in
+                             graph_relations(depsgraph)})
+
+        ob.constraints.remove(constraint)
+        depsgraph.update()
+        self.assertNotIn(link, {relation_id_names(relation) for relation in
+                                graph_relations(depsgraph)})
+
+
+if __name__ == '__main__':
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
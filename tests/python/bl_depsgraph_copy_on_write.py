@@ -0,0 +1,75 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_depsgraph_copy_on_write.py -- --verbose
+import bpy
+import re
+import unittest
+from mathutils import Matrix
+
+
+class TestCopyOnWriteSharing(unittest.TestCase):
+    """
+    Copy-on-write meshes share their geometry arrays with the original mesh,
+    writing to an evaluated mesh is still not to affect the original one.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        size = 16
+        verts = [(x, y, 0.0) for y in range(size) for x in range(size)]
+        faces = [(y * size + x, y * size + x + 1, (y + 1) * size + x + 1, (y + 1) * size + x)
+                 for y in range(size - 1) for x in range(size - 1)]
+        self.mesh = bpy.data.meshes.new("Mesh")
+        self.mesh.from_pydata(verts, (), faces)
+        self.object = bpy.data.objects.new("Object", self.mesh)
+        bpy.context.scene.collection.objects.link(self.object)
+        self.depsgraph = bpy.context.evaluated_depsgraph_get()
+        self.depsgraph.update()
+
+    def original_coordinates(self):
+        return [tuple(v.co) for v in self.mesh.vertices]
+
+    def evaluated_meshes(self):
+        # The copy-on-write mesh, and the evaluated mesh of the object referencing its arrays.
+        return (self.mesh.evaluated_get(self.depsgraph),
+                self.object.evaluated_get(self.depsgraph).data)
+
+    def test_shared_bytes(self):
+        match = re.search(r"Copy-on-write (\d+) bytes shared", self.depsgraph.debug_stats())
+        self.assertIsNotNone(match)
+        self.assertGreater(int(match.group(1)), 0)
+
+    def test_write_coordinate(self):
+        expected = self.original_coordinates()
+        for mesh_eval in self.evaluated_meshes():
+            mesh_eval.vertices[0].co = (10.0, 20.0, 30.0)
+            self.assertEqual(tuple(mesh_eval.vertices[0].co), (10.0, 20.0, 30.0))
+        self.assertEqual(self.original_coordinates(), expected)
+
+    def test_foreach_set(self):
+        expected = self.original_coordinates()
+        for mesh_eval in self.evaluated_meshes():
+            mesh_eval.vertices.foreach_set("co", [1.0] * (len(mesh_eval.vertices) * 3))
+            mesh_eval.polygons.foreach_set("material_index", [1] * len(mesh_eval.polygons))
+        self.assertEqual(self.original_coordinates(), expected)
+        self.assertEqual({p.material_index for p in self.mesh.polygons}, {0})
+
+    def test_transform(self):
+        expected = self.original_coordinates()
+        for mesh_eval in self.evaluated_meshes():
+            mesh_eval.transform(Matrix.Translation((1.0, 0.0, 0.0)))
+        self.assertEqual(self.original_coordinates(), expected)
+
+    def test_original_edit(self):
+        # Writing to the original mesh is seen by the evaluated mesh after an update.
+        self.mesh.vertices[0].co = (10.0, 20.0, 30.0)
+        self.mesh.update()
+        self.depsgraph.update()
+        for mesh_eval in self.evaluated_meshes():
+            self.assertEqual(tuple(mesh_eval.vertices[0].co), (10.0, 20.0, 30.0))
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
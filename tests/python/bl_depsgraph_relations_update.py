@@ -0,0 +1,93 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_depsgraph_relations_update.py -- --verbose
+import bpy
+import unittest
+
+
+class TestRelationsUpdate(unittest.TestCase):
+    """
+    Editing modifiers and constraints only updates relations of the edited object,
+    evaluated state is to be the same as after full relations update.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        scene = bpy.context.scene
+
+        mesh = bpy.data.meshes.new("Mesh")
+        mesh.from_pydata(((1.0, 0.0, 0.0), (2.0, 0.0, 0.0), (2.0, 1.0, 0.0)), (), ((0, 1, 2),))
+        self.object = bpy.data.objects.new("Object", mesh)
+        self.target = bpy.data.objects.new("Target", None)
+        self.other = bpy.data.objects.new("Other", None)
+        for ob in (self.object, self.target, self.other):
+            scene.collection.objects.link(ob)
+
+        self.depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    def evaluated_object(self):
+        self.depsgraph.update()
+        return self.object.evaluated_get(self.depsgraph)
+
+    def test_modifier_add_remove(self):
+        mirror = self.object.modifiers.new("Mirror", 'MIRROR')
+        mirror.mirror_object = self.target
+        self.assertEqual(len(self.evaluated_object().data.vertices), 6)
+
+        self.target.location.x = 3.0
+        mesh_eval = self.evaluated_object().data
+        self.assertAlmostEqual(max(v.co.x for v in mesh_eval.vertices), 5.0)
+
+        self.object.modifiers.remove(mirror)
+        self.assertEqual(len(self.evaluated_object().data.vertices), 3)
+
+        # Target is no longer a dependency of the object.
+        self.target.location.x = 4.0
+        mesh_eval = self.evaluated_object().data
+        self.assertAlmostEqual(max(v.co.x for v in mesh_eval.vertices), 2.0)
+
+    def test_modifier_add_keeps_users(self):
+        # Relations from the edited object to other objects are to be kept.
+        constraint = self.other.constraints.new('COPY_LOCATION')
+        constraint.target = self.object
+        self.object.modifiers.new("Subdivision", 'SUBSURF')
+
+        self.object.location.y = 2.0
+        self.depsgraph.update()
+        self.assertAlmostEqual(self.other.evaluated_get(self.depsgraph).matrix_world.translation.y,
+                               2.0)
+
+    def test_modifier_add_keeps_driver_users(self):
+        # The property operation a driver of another object reads is not built by the edited
+        # object itself.
+        self.object["prop"] = 1.0
+        driver = self.other.driver_add("location", 0).driver
+        driver.type = 'AVERAGE'
+        var = driver.variables.new()
+        var.targets[0].id = self.object
+        var.targets[0].data_path = '["prop"]'
+        self.depsgraph.update()
+
+        self.object.modifiers.new("Subdivision", 'SUBSURF')
+        self.depsgraph.update()
+
+        self.object["prop"] = 3.0
+        self.object.update_tag()
+        self.depsgraph.update()
+        self.assertAlmostEqual(self.other.evaluated_get(self.depsgraph).location.x, 3.0)
+
+    def test_constraint_add_remove(self):
+        constraint = self.object.constraints.new('COPY_LOCATION')
+        constraint.target = self.target
+
+        self.target.location.z = 2.0
+        self.assertAlmostEqual(self.evaluated_object().matrix_world.translation.z, 2.0)
+
+        self.object.constraints.remove(constraint)
+        self.assertAlmostEqual(self.evaluated_object().matrix_world.translation.z, 0.0)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
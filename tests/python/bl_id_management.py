@@ -177,6 +177,27 @@ class TestIdRename(TestHelper, unittest.TestCase):
         # ~ self.assertEqual(data.name, self.default_name + ".001")
         self.ensure_proper_order()
 
+    def test_rename_lookup(self):
+        self.clear_container()
+        data = self.add_to_container(name=self.default_name)
+        other = self.add_to_container(name=self.default_name)
+        self.assertEqual(other.name, self.default_name + ".001")
+
+        data.name = "ZZZ" + self.default_name
+        self.assertIs(self.data_container["ZZZ" + self.default_name], data)
+        self.assertNotIn(self.default_name, self.data_container)
+        self.assertIs(self.data_container.get(self.default_name + ".001"), other)
+
+        # Old name and number are free again.
+        data = self.add_to_container(name=self.default_name + ".001")
+        self.assertEqual(data.name, self.default_name + ".002")
+        data = self.add_to_container(name=self.default_name)
+        self.assertEqual(data.name, self.default_name)
+        self.remove_from_container(data=other)
+        data = self.add_to_container(name=self.default_name)
+        self.assertEqual(data.name, self.default_name + ".001")
+        self.ensure_proper_order()
+
 
 if __name__ == '__main__':
     import sys
@@ -0,0 +1,125 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_mesh_boolean.py -- --verbose
+import bmesh
+import bpy
+import math
+import unittest
+
+NUM_CUTTERS = 12
+
+
+def build_scene(operation):
+    """Ico sphere with a boolean modifier for each of the cutters spread over its surface."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=4, radius=1.0)
+    base = bpy.context.object
+
+    for i in range(NUM_CUTTERS):
+        z = 1.0 - 2.0 * (i + 0.5) / NUM_CUTTERS
+        r = math.sqrt(1.0 - z * z)
+        angle = i * 2.39996
+        bpy.ops.mesh.primitive_uv_sphere_add(
+            segments=16, ring_count=8, radius=0.2,
+            location=(r * math.cos(angle) + 0.0123, r * math.sin(angle), z))
+        mod = base.modifiers.new("Boolean %d" % i, 'BOOLEAN')
+        mod.operation = operation
+        mod.object = bpy.context.object
+    return base
+
+
+def evaluated_bmesh(base):
+    bm = bmesh.new()
+    bm.from_mesh(base.evaluated_get(bpy.context.evaluated_depsgraph_get()).data)
+    return bm
+
+
+def build_cube_and_cutter(operation, location, radius):
+    """Cube of size 2 at the origin with a single sphere cutter."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_cube_add(size=2.0)
+    base = bpy.context.object
+    bpy.ops.mesh.primitive_uv_sphere_add(segments=16, ring_count=8, radius=radius,
+                                         location=location)
+    cutter = bpy.context.object
+    mod = base.modifiers.new("Boolean", 'BOOLEAN')
+    mod.operation = operation
+    mod.object = cutter
+    return base, cutter
+
+
+def mesh_volume(mesh):
+    bm = bmesh.new()
+    bm.from_mesh(mesh)
+    volume = bm.calc_volume()
+    bm.free()
+    return volume
+
+
+class TestMeshBoolean(unittest.TestCase):
+    """
+    Mesh intersection skips triangle pairs which are on one side of each other's plane, and
+    tests face groups for being inside in parallel. Results are to be closed meshes.
+    """
+
+    def check_operation(self, operation):
+        base = build_scene(operation)
+        bm = bmesh.new()
+        bm.from_mesh(base.data)
+        volume = bm.calc_volume()
+        bm.free()
+
+        bm = evaluated_bmesh(base)
+        self.assertTrue(all(e.is_manifold for e in bm.edges))
+        result = bm.calc_volume()
+        bm.free()
+        return volume, result
+
+    def test_difference(self):
+        volume, result = self.check_operation('DIFFERENCE')
+        self.assertLess(result, volume)
+        self.assertGreater(result, volume * 0.8)
+
+    def test_union(self):
+        volume, result = self.check_operation('UNION')
+        self.assertGreater(result, volume)
+        self.assertLess(result, volume * 1.2)
+
+    def test_cutter_overlapping_bounds(self):
+        # Bounds overlap the corner of the cube, but the sphere doesn't touch it.
+        for operation in ('DIFFERENCE', 'INTERSECT'):
+            base, cutter = build_cube_and_cutter(operation, (1.15, 1.15, 1.15), 0.2)
+            bm = evaluated_bmesh(base)
+            if operation == 'DIFFERENCE':
+                self.assertEqual(len(bm.verts), 8)
+                self.assertAlmostEqual(bm.calc_volume(), 8.0, places=5)
+            else:
+                self.assertEqual(len(bm.verts), 0)
+            bm.free()
+
+    def test_cutter_inside(self):
+        # Nothing intersects, the inside test alone decides what is kept.
+        base, cutter = build_cube_and_cutter('DIFFERENCE', (0.0, 0.0, 0.0), 0.3)
+        cutter_volume = mesh_volume(cutter.data)
+        bm = evaluated_bmesh(base)
+        self.assertEqual(len(bm.verts), 8 + len(cutter.data.vertices))
+        self.assertTrue(all(e.is_manifold for e in bm.edges))
+        self.assertAlmostEqual(bm.calc_volume(), 8.0 - cutter_volume, places=5)
+        bm.free()
+
+        base, cutter = build_cube_and_cutter('UNION', (0.0, 0.0, 0.0), 0.3)
+        bm = evaluated_bmesh(base)
+        self.assertEqual(len(bm.verts), 8)
+        bm.free()
+
+        base, cutter = build_cube_and_cutter('INTERSECT', (0.0, 0.0, 0.0), 0.3)
+        bm = evaluated_bmesh(base)
+        self.assertEqual(len(bm.verts), len(cutter.data.vertices))
+        self.assertAlmostEqual(bm.calc_volume(), cutter_volume, places=5)
+        bm.free()
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
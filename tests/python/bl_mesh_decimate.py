@@ -0,0 +1,97 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_mesh_decimate.py -- --verbose
+import bmesh
+import bpy
+import unittest
+
+from mathutils import kdtree
+
+RATIO = 0.2
+
+
+def build_object():
+    """UV sphere with displacement, symmetric on the X axis."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_uv_sphere_add(segments=128, ring_count=64, radius=1.0)
+    ob = bpy.context.object
+    for v in ob.data.vertices:
+        co = v.co
+        v.co = co * (1.0 + 0.05 * ((abs(co.x) * 7.0) % 1.0) * ((co.y * 5.0) % 1.0))
+    ob.data.update()
+    return ob
+
+
+def mesh_volume(mesh):
+    bm = bmesh.new()
+    bm.from_mesh(mesh)
+    volume = bm.calc_volume()
+    bm.free()
+    return volume
+
+
+def decimate(use_symmetry, ratio=RATIO, use_collapse_triangulate=False):
+    ob = build_object()
+    mod = ob.modifiers.new("Decimate", 'DECIMATE')
+    mod.ratio = ratio
+    mod.use_symmetry = use_symmetry
+    mod.symmetry_axis = 'X'
+    mod.use_collapse_triangulate = use_collapse_triangulate
+
+    mesh = ob.evaluated_get(bpy.context.evaluated_depsgraph_get()).data
+    co = [0.0] * (len(mesh.vertices) * 3)
+    mesh.vertices.foreach_get("co", co)
+    return {"totpoly_orig": len(ob.data.polygons), "totpoly": len(mesh.polygons),
+            "tottri_orig": sum(len(p.vertices) - 2 for p in ob.data.polygons),
+            "volume_orig": mesh_volume(ob.data), "volume": mesh_volume(mesh),
+            "co": co}
+
+
+class TestMeshDecimate(unittest.TestCase):
+    """
+    The collapse decimator computes edge costs and the symmetry map in parallel, then collapses
+    edges by cost until the target number of triangles is reached.
+    """
+
+    def check_face_count(self, result):
+        # The decimator targets a number of triangles, quads are triangulated and joined back
+        # afterwards where possible.
+        self.assertLess(result["totpoly"], result["totpoly_orig"] * 2 * RATIO * 1.05)
+        self.assertGreater(result["totpoly"], result["totpoly_orig"] * RATIO * 0.9)
+
+    def test_decimate(self):
+        self.check_face_count(decimate(False))
+
+    def test_symmetry(self):
+        result = decimate(True)
+        self.check_face_count(result)
+
+        co = result["co"]
+        tree = kdtree.KDTree(len(co) // 3)
+        for i in range(0, len(co), 3):
+            tree.insert(co[i:i + 3], i // 3)
+        tree.balance()
+        for i in range(0, len(co), 3):
+            _co, _index, dist = tree.find((-co[i], co[i + 1], co[i + 2]))
+            self.assertLess(dist, 1e-4)
+
+    def test_targets(self):
+        for use_symmetry in (False, True):
+            for ratio in (0.1, 0.25, 0.5):
+                result = decimate(use_symmetry, ratio, use_collapse_triangulate=True)
+                # Every collapse removes two triangles, or four with symmetry.
+                target = int(result["tottri_orig"] * ratio)
+                self.assertLessEqual(result["totpoly"], target, ratio)
+                self.assertGreaterEqual(result["totpoly"], target - 4, ratio)
+
+    def test_quality(self):
+        # Collapsing by quadric cost keeps the shape, so the volume barely changes.
+        for ratio in (0.05, RATIO):
+            result = decimate(False, ratio)
+            self.assertAlmostEqual(result["volume"] / result["volume_orig"], 1.0, delta=0.02)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
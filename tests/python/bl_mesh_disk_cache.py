@@ -0,0 +1,154 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_mesh_disk_cache.py -- --verbose
+import bpy
+import os
+import shutil
+import struct
+import tempfile
+import unittest
+
+
+class TestMeshDiskCache(unittest.TestCase):
+    """
+    Results of modifier stacks are stored to disk and read back after the file is reloaded,
+    giving the same evaluated mesh as evaluating the modifiers.
+    """
+
+    def setUp(self):
+        bpy.ops.wm.read_factory_settings(use_empty=True)
+        self.temp_dir = tempfile.mkdtemp()
+        self.cache_dir = os.path.join(self.temp_dir, "cache")
+        self.blend_path = os.path.join(self.temp_dir, "mesh_disk_cache.blend")
+
+        system = bpy.context.preferences.system
+        system.use_mesh_disk_cache = True
+        system.mesh_disk_cache_dir = self.cache_dir
+        system.mesh_disk_cache_size_limit = 64
+
+        bpy.ops.mesh.primitive_cube_add()
+        self.object_name = bpy.context.active_object.name
+        self.subsurf = bpy.context.active_object.modifiers.new("Subdivision", 'SUBSURF')
+        self.subsurf.levels = 2
+
+    def tearDown(self):
+        bpy.context.preferences.system.use_mesh_disk_cache = False
+        shutil.rmtree(self.temp_dir)
+
+    def cache_files(self):
+        directory = os.path.join(self.cache_dir, "meshes")
+        if not os.path.isdir(directory):
+            return []
+        return sorted(os.path.join(directory, name)
+                      for name in os.listdir(directory) if name.endswith(".mdc"))
+
+    def evaluated_coordinates(self):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        depsgraph.update()
+        ob = bpy.data.objects[self.object_name]
+        mesh_eval = ob.evaluated_get(depsgraph).data
+        return [tuple(v.co) for v in mesh_eval.vertices]
+
+    def reload(self):
+        bpy.ops.wm.save_as_mainfile(filepath=self.blend_path, check_existing=False)
+        bpy.ops.wm.open_mainfile(filepath=self.blend_path)
+
+    def assertCoordinatesEqual(self, coordinates, expected):
+        self.assertEqual(len(coordinates), len(expected))
+        for co, co_expected in zip(coordinates, expected):
+            for a, b in zip(co, co_expected):
+                self.assertAlmostEqual(a, b, places=5)
+
+    def test_reload(self):
+        expected = self.evaluated_coordinates()
+        self.assertEqual(len(expected), 98)
+        self.assertEqual(len(self.cache_files()), 1)
+
+        self.reload()
+        self.assertCoordinatesEqual(self.evaluated_coordinates(), expected)
+        self.assertEqual(len(self.cache_files()), 1)
+
+    def test_reload_reads_file(self):
+        expected = self.evaluated_coordinates()
+        cache_file, = self.cache_files()
+
+        # Move the first vertex in the stored mesh, which is only visible when the file is read.
+        with open(cache_file, "rb") as f:
+            data = f.read()
+        # Vertices are the first layer, other layers may store the same coordinates.
+        co_bytes = struct.pack("=3f", *expected[0])
+        self.assertIn(co_bytes, data)
+        with open(cache_file, "wb") as f:
+            f.write(data.replace(co_bytes, struct.pack("=3f", 10.0, 20.0, 30.0), 1))
+
+        self.reload()
+        coordinates = self.evaluated_coordinates()
+        self.assertCoordinatesEqual(coordinates[:1], [(10.0, 20.0, 30.0)])
+        self.assertCoordinatesEqual(coordinates[1:], expected[1:])
+
+    def test_reload_with_leading_deform(self):
+        # Leading deform modifiers are evaluated for the deformed mesh of the depsgraph.
+        ob = bpy.data.objects[self.object_name]
+        ob.modifiers.remove(self.subsurf)
+        ob.modifiers.new("Displace", 'DISPLACE')
+        self.subsurf = ob.modifiers.new("Subdivision", 'SUBSURF')
+        self.subsurf.levels = 2
+        expected = self.evaluated_coordinates()
+        self.assertEqual(len(self.cache_files()), 1)
+
+        self.reload()
+        self.assertCoordinatesEqual(self.evaluated_coordinates(), expected)
+        self.assertEqual(len(self.cache_files()), 1)
+
+    def test_settings_change(self):
+        self.evaluated_coordinates()
+        self.subsurf.levels = 3
+        self.assertEqual(len(self.evaluated_coordinates()), 386)
+        self.assertEqual(len(self.cache_files()), 2)
+
+    def test_invalid_file(self):
+        expected = self.evaluated_coordinates()
+        cache_file, = self.cache_files()
+        size = os.path.getsize(cache_file)
+        with open(cache_file, "r+b") as f:
+            f.truncate(size // 2)
+
+        # Truncated file is rejected, and replaced by a new evaluation.
+        self.reload()
+        self.assertCoordinatesEqual(self.evaluated_coordinates(), expected)
+        self.assertEqual([os.path.getsize(f) for f in self.cache_files()], [size])
+
+    def test_foreign_file_kept(self):
+        expected = self.evaluated_coordinates()
+        cache_file, = self.cache_files()
+
+        # A file with the same name written for another stack, or by another version.
+        with open(cache_file, "r+b") as f:
+            f.write(b"XXXX")
+        with open(cache_file, "rb") as f:
+            data = f.read()
+
+        self.reload()
+        self.assertCoordinatesEqual(self.evaluated_coordinates(), expected)
+        self.assertEqual(self.cache_files(), [cache_file])
+        with open(cache_file, "rb") as f:
+            self.assertEqual(f.read(), data)
+
+    def test_size_limit(self):
+        bpy.context.preferences.system.mesh_disk_cache_size_limit = 1
+        self.subsurf.levels = 6
+        self.evaluated_coordinates()
+        self.assertEqual(self.cache_files(), [])
+
+    def test_linked_modifier_not_cached(self):
+        ob = bpy.data.objects[self.object_name]
+        mirror = ob.modifiers.new("Mirror", 'MIRROR')
+        mirror.mirror_object = bpy.data.objects.new("Empty", None)
+        self.evaluated_coordinates()
+        self.assertEqual(self.cache_files(), [])
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -0,0 +1,120 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_mesh_remesh.py -- --verbose
+import bmesh
+import bpy
+import unittest
+
+
+def build_mesh():
+    """Displaced ico sphere, with the upper half masked."""
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=5, radius=1.0)
+    ob = bpy.context.object
+
+    bm = bmesh.new()
+    bm.from_mesh(ob.data)
+    mask = bm.verts.layers.paint_mask.new()
+    for v in bm.verts:
+        v.co *= 1.0 + 0.05 * ((v.co.x * 7.0) % 1.0) * ((v.co.y * 5.0) % 1.0)
+        v[mask] = 1.0 if v.co.z > 0.0 else 0.0
+    bm.to_mesh(ob.data)
+    bm.free()
+    return ob
+
+
+def mesh_data(mesh):
+    co = [0.0] * (len(mesh.vertices) * 3)
+    mesh.vertices.foreach_get("co", co)
+    loops = [0] * len(mesh.loops)
+    mesh.loops.foreach_get("vertex_index", loops)
+    mask = [0.0] * len(mesh.vertices)
+    if mesh.vertex_paint_masks:
+        mesh.vertex_paint_masks[0].data.foreach_get("value", mask)
+    return {"co": co, "loops": loops, "mask": mask}
+
+
+def mesh_volume(mesh):
+    bm = bmesh.new()
+    bm.from_mesh(mesh)
+    volume = bm.calc_volume()
+    bm.free()
+    return volume
+
+
+def voxel_remesh(use_preserve_volume=False, voxel_size=0.05):
+    ob = build_mesh()
+    mesh = ob.data
+    mesh.remesh_voxel_size = voxel_size
+    mesh.use_remesh_preserve_volume = use_preserve_volume
+    mesh.use_remesh_preserve_paint_mask = True
+    bpy.ops.object.voxel_remesh()
+    return mesh_data(ob.data)
+
+
+def quadriflow_remesh(seed):
+    ob = build_mesh()
+    result = bpy.ops.object.quadriflow_remesh(
+        mode='FACES', target_faces=1000, seed=seed, use_paint_symmetry=False)
+    if result != {'FINISHED'}:
+        return None
+    return mesh_data(ob.data)
+
+
+class TestMeshRemesh(unittest.TestCase):
+    """
+    The remeshers run in stages, filling their input and output arrays and reprojecting the
+    paint mask in parallel. QuadriFlow numbers its input vertices with a remap table.
+    """
+
+    def test_voxel(self):
+        result = voxel_remesh(False)
+        co = result["co"]
+        self.assertGreater(len(co), 1000)
+        self.assertEqual(len(result["loops"]) % 4, 0)
+        for i in range(0, len(co), 3):
+            radius = (co[i] ** 2 + co[i + 1] ** 2 + co[i + 2] ** 2) ** 0.5
+            self.assertGreater(radius, 0.8)
+            self.assertLess(radius, 1.2)
+            z = co[i + 2]
+            if abs(z) > 0.1:
+                self.assertEqual(result["mask"][i // 3], 1.0 if z > 0.0 else 0.0)
+
+    def test_quadriflow(self):
+        ob = build_mesh()
+        result = bpy.ops.object.quadriflow_remesh(
+            mode='FACES', target_faces=1000, seed=1, use_paint_symmetry=False)
+        self.assertEqual(result, {'FINISHED'})
+        polygons = ob.data.polygons
+        self.assertGreater(len(polygons), 500)
+        self.assertLess(len(polygons), 2000)
+        self.assertTrue(all(len(p.vertices) == 4 for p in polygons))
+
+    def test_voxel_size(self):
+        coarse = voxel_remesh(voxel_size=0.1)
+        fine = voxel_remesh(voxel_size=0.05)
+
+        # Vertices are spread over the surface, halving the voxel size about quadruples them.
+        ratio = len(fine["co"]) / len(coarse["co"])
+        self.assertGreater(ratio, 3.0)
+        self.assertLess(ratio, 5.0)
+
+    def test_voxel_preserve_volume(self):
+        volume = mesh_volume(build_mesh().data)
+        voxel_remesh(use_preserve_volume=True, voxel_size=0.1)
+        self.assertAlmostEqual(mesh_volume(bpy.context.object.data) / volume, 1.0, delta=0.03)
+
+    def test_voxel_repeatable(self):
+        # Output arrays are filled in parallel, in a fixed order.
+        self.assertEqual(voxel_remesh(), voxel_remesh())
+
+    def test_quadriflow_seed(self):
+        result = quadriflow_remesh(1)
+        self.assertIsNotNone(result)
+        self.assertEqual(result, quadriflow_remesh(1))
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
@@ -3,6 +3,7 @@
 # ./blender.bin --background -noaudio --python tests/python/bl_pyapi_mathutils.py -- --verbose
 import unittest
 from mathutils import Matrix, Vector, Quaternion
+from mathutils import MatrixArray, VectorArray, QuaternionArray
 from mathutils import kdtree, geometry
 import math
 
@@ -317,6 +318,92 @@ class QuaternionTesting(unittest.TestCase):
         self.assertAlmostEqual(axis.z, 0)
 
 
+class ArrayTesting(unittest.TestCase):
+
+    def assertVectorAlmostEqual(self, vec, expected):
+        # Relative, the test data has large vectors.
+        self.assertAlmostEqual((vec - expected).length, 0.0, delta=1e-6 * (expected.length + 1.0))
+
+    def test_vector_array_create(self):
+        vecs = VectorArray(vector_data)
+        self.assertEqual(len(vecs), len(vector_data))
+        self.assertEqual(vecs.size, 3)
+        for vec, data in zip(vecs, vector_data):
+            self.assertAlmostEqual((vec - Vector(data)).length, 0.0, 6)
+
+        self.assertEqual(VectorArray(4, size=2)[3], Vector((0.0, 0.0)))
+        self.assertEqual(VectorArray(memoryview(vecs))[4], vecs[4])
+
+    def test_vector_array_buffer(self):
+        vecs = VectorArray(vector_data)
+        view = memoryview(vecs)
+        self.assertEqual(view.shape, (len(vector_data), 3))
+        self.assertEqual(view.format, "f")
+
+        view[0, 2] = 5.0
+        self.assertEqual(vecs[0].z, 5.0)
+
+    def test_vector_array_transform(self):
+        mat = Matrix.Rotation(math.radians(30.0), 4, 'X') @ Matrix.Translation((1.0, 2.0, 3.0))
+        vecs = VectorArray(vector_data)
+        vecs.transform(mat)
+        for vec, data in zip(vecs, vector_data):
+            self.assertVectorAlmostEqual(vec, mat @ Vector(data))
+
+        mats = MatrixArray([mat] * len(vector_data))
+        for vec, data in zip(mats @ VectorArray(vector_data), vector_data):
+            self.assertVectorAlmostEqual(vec, mat @ Vector(data))
+
+    def test_vector_array_products(self):
+        vecs = VectorArray(vector_data)
+        other = Vector((0.5, -1.0, 2.0))
+        dots = vecs.dot(other)
+        crosses = vecs.cross(other)
+        for i, data in enumerate(vector_data):
+            dot = Vector(data).dot(other)
+            cross = Vector(data).cross(other)
+            self.assertAlmostEqual(dots[i], dot, delta=1e-6 * (abs(dot) + 1.0))
+            self.assertVectorAlmostEqual(crosses[i], cross)
+
+        vecs.normalize()
+        for vec, data in zip(vecs, vector_data):
+            self.assertAlmostEqual(vec.length, 1.0 if any(data) else 0.0, 5)
+
+    def test_matrix_array_matmul(self):
+        mat_a = Matrix.Rotation(math.radians(45.0), 4, 'Z')
+        mat_b = Matrix.Translation((1.0, 0.0, 0.0))
+        mats = MatrixArray([mat_a, mat_b])
+
+        self.assertEqual(MatrixArray(mats)[0], mat_a)
+        for result, expected in zip(mats @ mat_b, (mat_a @ mat_b, mat_b @ mat_b)):
+            self.assertEqual(result, expected)
+        for result, expected in zip(mat_b @ mats, (mat_b @ mat_a, mat_b @ mat_b)):
+            self.assertEqual(result, expected)
+
+        with self.assertRaises(ValueError):
+            mats @ MatrixArray(3)
+
+    def test_matrix_array_buffer(self):
+        mats = MatrixArray([Matrix.Translation((1.0, 2.0, 3.0))])
+        view = memoryview(mats)
+        self.assertEqual(view.shape, (1, 4, 4))
+        # Rows and columns index like Matrix.
+        self.assertEqual(view[0, 1, 3], 2.0)
+
+    def test_quaternion_array(self):
+        quat = Quaternion((0.0, 0.0, 1.0), math.radians(90.0))
+        quats = QuaternionArray([quat, Quaternion()])
+
+        for result, expected in zip(quats.slerp(Quaternion(), 0.5),
+                                    (quat.slerp(Quaternion(), 0.5), Quaternion())):
+            self.assertAlmostEqual((Vector(result) - Vector(expected)).length, 0.0, 6)
+
+        vecs = VectorArray([(1.0, 0.0, 0.0)] * 2)
+        vecs.transform(quats)
+        self.assertAlmostEqual((vecs[0] - quat @ Vector((1.0, 0.0, 0.0))).length, 0.0, 6)
+        self.assertEqual(quats.to_matrix()[0], quat.to_matrix())
+
+
 class KDTreeTesting(unittest.TestCase):
     @staticmethod
     def kdtree_create_grid_3d_data(tot):
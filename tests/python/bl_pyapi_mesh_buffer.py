@@ -0,0 +1,114 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --python tests/python/bl_pyapi_mesh_buffer.py -- --verbose
+import bpy
+import unittest
+import numpy as np
+
+
+class TestMeshBuffer(unittest.TestCase):
+    def setUp(self):
+        self.mesh = bpy.data.meshes.new("TestMeshBuffer")
+        self.mesh.from_pydata(
+            ((0.0, 0.0, 0.0), (1.0, 0.0, 0.0), (1.0, 1.0, 0.0), (0.0, 1.0, 0.0)),
+            (),
+            ((0, 1, 2, 3),),
+        )
+
+    def tearDown(self):
+        bpy.data.meshes.remove(self.mesh)
+
+    def test_position_read(self):
+        view = memoryview(self.mesh.attribute_buffer('POSITION'))
+        self.assertTrue(view.readonly)
+        self.assertEqual(view.shape, (4, 3))
+        self.assertEqual(view.format, "f")
+
+        co = np.empty(12, dtype=np.float32)
+        self.mesh.vertices.foreach_get("co", co)
+        self.assertTrue(np.array_equal(np.asarray(view).ravel(), co))
+
+    def test_position_write(self):
+        positions = np.asarray(self.mesh.attribute_buffer('POSITION'))
+        self.assertTrue(positions.flags.writeable)
+        positions[:, 2] = 5.0
+
+        for v in self.mesh.vertices:
+            self.assertEqual(v.co.z, 5.0)
+
+    def test_position_write_evaluated(self):
+        ob = bpy.data.objects.new("TestMeshBuffer", self.mesh)
+        bpy.context.collection.objects.link(ob)
+
+        # Evaluate while the view is alive, writes after that are only seen once it's released.
+        positions = np.asarray(self.mesh.attribute_buffer('POSITION'))
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        positions[:, 2] = 3.0
+        del positions
+
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        mesh_eval = ob.evaluated_get(depsgraph).data
+        self.assertTrue(all(v.co.z == 3.0 for v in mesh_eval.vertices))
+        bpy.data.objects.remove(ob)
+
+    def test_loops(self):
+        loop_vertex = np.asarray(memoryview(self.mesh.attribute_buffer('LOOP_VERTEX')))
+        self.assertEqual(list(loop_vertex), [0, 1, 2, 3])
+
+        loop_total = np.asarray(memoryview(self.mesh.attribute_buffer('POLYGON_LOOP_TOTAL')))
+        self.assertEqual(list(loop_total), [4])
+
+    def test_uv(self):
+        uv_layer = self.mesh.uv_layers.new(name="UVMap")
+        uv = np.asarray(self.mesh.attribute_buffer('UV', "UVMap"))
+        self.assertEqual(uv.shape, (4, 2))
+        uv[:] = 0.25
+        for data in uv_layer.data:
+            self.assertEqual(tuple(data.uv), (0.25, 0.25))
+
+        with self.assertRaises(KeyError):
+            memoryview(self.mesh.attribute_buffer('UV', "Missing"))
+
+    def test_invalid_type(self):
+        with self.assertRaises(ValueError):
+            self.mesh.attribute_buffer('NOT_A_TYPE')
+
+    def test_reallocation(self):
+        buffer = self.mesh.attribute_buffer('POSITION')
+        self.mesh.vertices.add(2)
+        self.assertEqual(memoryview(buffer).shape, (6, 3))
+
+    def test_view_kept_on_reallocation(self):
+        positions = np.asarray(self.mesh.attribute_buffer('POSITION'))
+        expected = positions.copy()
+        self.mesh.vertices.add(1)
+
+        # The view keeps the previous array, the mesh uses a new one.
+        self.assertTrue(np.array_equal(positions, expected))
+        positions[:] = 7.0
+        self.assertEqual(tuple(self.mesh.vertices[0].co), tuple(expected[0]))
+
+        # Edit-mode replaces all arrays when leaving it.
+        ob = bpy.data.objects.new("TestMeshBuffer", self.mesh)
+        bpy.context.collection.objects.link(ob)
+        bpy.context.view_layer.objects.active = ob
+        loop_vertex = np.asarray(self.mesh.attribute_buffer('LOOP_VERTEX'))
+        bpy.ops.object.mode_set(mode='EDIT')
+        bpy.ops.object.mode_set(mode='OBJECT')
+        self.assertEqual(list(loop_vertex), [0, 1, 2, 3])
+        bpy.data.objects.remove(ob)
+
+    def test_view_kept_on_remove(self):
+        mesh = bpy.data.meshes.new("TestMeshBufferRemove")
+        mesh.vertices.add(3)
+        mesh.vertices.foreach_set("co", [float(i) for i in range(9)])
+        positions = np.asarray(mesh.attribute_buffer('POSITION'))
+        bpy.data.meshes.remove(mesh)
+
+        self.assertEqual(positions.ravel().tolist(), [float(i) for i in range(9)])
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
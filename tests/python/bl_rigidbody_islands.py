@@ -0,0 +1,125 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_rigidbody_islands.py -- --verbose
+import bpy
+import unittest
+
+NUM_STACKS = 100
+STACK_HEIGHT = 5
+NUM_FRAMES = 20
+
+
+def build_scene(spacing=3.0):
+    """
+    Separate stacks of boxes on a ground plane, enough to be solved in several batches of
+    islands. The first stack stands on an animated kinematic slab. With a small spacing, the
+    bounds of neighboring stacks overlap and all boxes are in a single island.
+    """
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    bpy.ops.mesh.primitive_plane_add(size=40.0, location=(13.5, 13.5, 0.0))
+    bpy.ops.rigidbody.object_add(type='PASSIVE')
+
+    bpy.ops.mesh.primitive_cube_add(size=1.0, location=(0.0, 0.0, 0.5))
+    slab = bpy.context.object
+    slab.scale = (2.0, 2.0, 0.5)
+    bpy.ops.rigidbody.object_add(type='PASSIVE')
+    slab.rigid_body.kinematic = True
+    for frame, x in ((1, 0.0), (NUM_FRAMES, 1.0)):
+        slab.location.x = x
+        slab.keyframe_insert("location", index=0, frame=frame)
+
+    bpy.ops.mesh.primitive_cube_add(size=1.0)
+    box = bpy.context.object
+    boxes = []
+    for i in range(NUM_STACKS):
+        for j in range(STACK_HEIGHT):
+            ob = box if not boxes else box.copy()
+            ob.location = ((i % 10) * spacing, (i // 10) * spacing, 1.5 + j * 1.1)
+            ob.rotation_euler.z = 0.1 * j
+            if ob is not box:
+                scene.collection.objects.link(ob)
+            boxes.append(ob)
+
+    for ob in boxes[1:]:
+        scene.rigidbody_world.collection.objects.link(ob)
+    bpy.context.view_layer.objects.active = box
+    bpy.ops.rigidbody.object_add(type='ACTIVE')
+
+    scene.rigidbody_world.point_cache.frame_start = 1
+    scene.rigidbody_world.point_cache.frame_end = NUM_FRAMES
+    return scene, boxes
+
+
+def box_matrices(boxes):
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    return [[value for row in ob.evaluated_get(depsgraph).matrix_world for value in row]
+            for ob in boxes]
+
+
+def simulate(use_multithreading, spacing=3.0):
+    """World matrices of all boxes on the last frame."""
+    scene, boxes = build_scene(spacing)
+    scene.rigidbody_world.use_multithreading = use_multithreading
+    for frame in range(1, NUM_FRAMES + 1):
+        scene.frame_set(frame)
+    return box_matrices(boxes)
+
+
+class TestRigidBodyIslands(unittest.TestCase):
+    """
+    With multithreading, batches of simulation islands are solved in parallel and batches
+    touching kinematic objects afterwards. Simulated transforms are cached in one pass.
+    """
+
+    def test_simulation(self):
+        scene, boxes = build_scene()
+        start = [ob.location.z for ob in boxes]
+        for frame in range(1, NUM_FRAMES + 1):
+            scene.frame_set(frame)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        for ob, z in zip(boxes, start):
+            self.assertLess(ob.evaluated_get(depsgraph).matrix_world.translation.z, z, ob.name)
+
+    def test_multithreading(self):
+        self.assertEqual(simulate(True), simulate(False))
+
+    def test_single_island(self):
+        # Nothing to split, the whole world is solved as one batch.
+        self.assertEqual(simulate(True, spacing=1.1), simulate(False, spacing=1.1))
+
+    def test_kinematic_batch(self):
+        scene, boxes = build_scene()
+        scene.rigidbody_world.use_multithreading = True
+        start = [ob.location.x for ob in boxes]
+        for frame in range(1, NUM_FRAMES + 1):
+            scene.frame_set(frame)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+
+        # The stack on the slab is carried along, the others stay in place.
+        for i, (ob, x) in enumerate(zip(boxes, start)):
+            x_eval = ob.evaluated_get(depsgraph).matrix_world.translation.x
+            if i < STACK_HEIGHT:
+                self.assertGreater(x_eval, x + 0.2, ob.name)
+            else:
+                self.assertAlmostEqual(x_eval, x, delta=0.2, msg=ob.name)
+
+    def test_cache(self):
+        scene, boxes = build_scene()
+        scene.rigidbody_world.use_multithreading = True
+        simulated = []
+        for frame in range(1, NUM_FRAMES + 1):
+            scene.frame_set(frame)
+            simulated.append(box_matrices(boxes))
+
+        # Frames are read back from the cache written while simulating.
+        for frame in reversed(range(1, NUM_FRAMES + 1)):
+            scene.frame_set(frame)
+            self.assertEqual(box_matrices(boxes), simulated[frame - 1], frame)
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
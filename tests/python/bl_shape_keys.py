@@ -0,0 +1,132 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background -noaudio --factory-startup --python tests/python/bl_shape_keys.py -- --verbose
+import bpy
+import unittest
+
+
+def build_object():
+    """
+    Grid with more vertices than evaluated by a single task, with keys moving all vertices,
+    correctives moving a small region, a key relative to another key and one using a group.
+    """
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=120, y_subdivisions=120, size=2.0)
+    ob = bpy.context.object
+    totvert = len(ob.data.vertices)
+
+    ob.shape_key_add(name="Basis", from_mix=False)
+    group = ob.vertex_groups.new(name="Group")
+    group.add(list(range(0, totvert, 3)), 0.5, 'REPLACE')
+
+    for k in range(8):
+        key_block = ob.shape_key_add(name="Key%d" % k, from_mix=False)
+        if k < 2:
+            indices = range(totvert)
+        else:
+            indices = range(k * 1000, k * 1000 + 300)
+        for i in indices:
+            key_block.data[i].co.z += 0.01 * (k + 1) + 0.001 * (i % 7)
+        key_block.value = 0.1 * (k + 1)
+
+    key_blocks = ob.data.shape_keys.key_blocks
+    key_blocks["Key3"].relative_key = key_blocks["Key2"]
+    key_blocks["Key4"].vertex_group = group.name
+    key_blocks["Key5"].value = 0.0
+    key_blocks["Key6"].mute = True
+    return ob
+
+
+def mesh_coordinates(mesh):
+    co = [0.0] * (len(mesh.vertices) * 3)
+    mesh.vertices.foreach_get("co", co)
+    return co
+
+
+class TestShapeKeys(unittest.TestCase):
+    """
+    Evaluated keys keep the offsets of correctives as sorted indices, converted on first use.
+    Original keys blend the full key-block data, so mixing them is the reference. Edits after
+    the first evaluation check that stale offsets are not used.
+    """
+
+    def setUp(self):
+        self.ob = build_object()
+        self.key_blocks = self.ob.data.shape_keys.key_blocks
+
+    def mix_coordinates(self):
+        key_block = self.ob.shape_key_add(name="Mix", from_mix=True)
+        co = [0.0] * (len(key_block.data) * 3)
+        key_block.data.foreach_get("co", co)
+        self.ob.shape_key_remove(key_block)
+        return co
+
+    def evaluated_coordinates(self):
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        depsgraph.update()
+        return mesh_coordinates(self.ob.evaluated_get(depsgraph).data)
+
+    def assertEvaluatedMatchesMix(self):
+        self.assertEqual(self.evaluated_coordinates(), self.mix_coordinates())
+
+    def test_evaluated_matches_original(self):
+        self.assertEvaluatedMatchesMix()
+
+    def test_corrective_offsets(self):
+        # Only the corrective at full influence, its region is moved by its offsets exactly.
+        for key_block in self.key_blocks[1:]:
+            key_block.value = 0.0
+        self.key_blocks["Key7"].value = 1.0
+        basis = mesh_coordinates(self.ob.data)
+        co = self.evaluated_coordinates()
+
+        key_block = self.key_blocks["Key7"]
+        for i in range(len(key_block.data)):
+            if 7000 <= i < 7300:
+                for axis in range(3):
+                    self.assertAlmostEqual(co[i * 3 + axis], key_block.data[i].co[axis], places=6)
+            else:
+                self.assertEqual(co[i * 3:i * 3 + 3], basis[i * 3:i * 3 + 3], i)
+
+    def test_key_data_edit(self):
+        self.evaluated_coordinates()
+
+        # Moves vertices which were not moved by the key before.
+        key_block = self.key_blocks["Key2"]
+        for i in range(5000, 5100):
+            key_block.data[i].co.x += 0.5
+        self.ob.data.shape_keys.update_tag()
+        self.assertEvaluatedMatchesMix()
+
+    def test_relative_key_change(self):
+        self.evaluated_coordinates()
+
+        # Offsets of Key3 were taken relative to Key2.
+        self.key_blocks["Key3"].relative_key = self.key_blocks["Basis"]
+        self.assertEvaluatedMatchesMix()
+
+    def test_influence_change(self):
+        self.evaluated_coordinates()
+
+        # Keys which had no influence at the first evaluation are used now, and the other way.
+        self.key_blocks["Key5"].value = 0.7
+        self.key_blocks["Key6"].mute = False
+        self.key_blocks["Key2"].value = 0.0
+        self.key_blocks["Key4"].vertex_group = ""
+        self.assertEvaluatedMatchesMix()
+
+    def test_keys_added_and_removed(self):
+        self.evaluated_coordinates()
+
+        self.ob.shape_key_remove(self.key_blocks["Key2"])
+        key_block = self.ob.shape_key_add(name="Added", from_mix=False)
+        for i in range(100, 200):
+            key_block.data[i].co.y -= 0.25
+        key_block.value = 1.0
+        self.assertEvaluatedMatchesMix()
+
+
+if __name__ == '__main__':
+    import sys
+    sys.argv = [__file__] + (sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else [])
+    unittest.main()
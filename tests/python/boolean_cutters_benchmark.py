@@ -0,0 +1,68 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/boolean_cutters_benchmark.py -- --cutters=1,8,32 --operation=DIFFERENCE --iterations=5
+#
+# Cost of evaluating a hard-surface style mesh with many boolean cutters: cutter spheres spread
+# over the surface of a dense base object, each one with its own boolean modifier.
+
+import math
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments, print_times
+
+
+def build_scene(args, num_cutters):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=args.subdivisions, radius=1.0)
+    base = bpy.context.object
+
+    # Spread the cutters evenly over the base surface (golden angle spiral),
+    # slightly offset so no vertices line up exactly with the base.
+    for i in range(num_cutters):
+        z = 1.0 - 2.0 * (i + 0.5) / num_cutters
+        r = math.sqrt(1.0 - z * z)
+        angle = i * 2.39996
+        bpy.ops.mesh.primitive_uv_sphere_add(
+            segments=args.segments, ring_count=args.segments // 2, radius=0.2,
+            location=(r * math.cos(angle) + 0.0123, r * math.sin(angle), z))
+        cutter = bpy.context.object
+        cutter.display_type = 'WIRE'
+
+        mod = base.modifiers.new("Boolean %d" % i, 'BOOLEAN')
+        mod.operation = args.operation
+        mod.object = cutter
+
+    return base
+
+
+def main():
+    args = parse_arguments("Boolean cutters benchmark", (
+        ("--cutters", "1,8,32", "Comma separated list of cutter counts to test"),
+        ("--operation", 'DIFFERENCE', "INTERSECT, UNION or DIFFERENCE"),
+        ("--subdivisions", 5, "Subdivisions of the base ico sphere"),
+        ("--segments", 32, "Segments of each cutter sphere"),
+        ("--iterations", 5, "Number of evaluations to average"),
+    ))
+
+    print("")
+    for num_cutters in [int(value) for value in args.cutters.split(",")]:
+        base = build_scene(args, num_cutters)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+        times = []
+        for _ in range(args.iterations):
+            base.update_tag()
+            start_time = time.time()
+            depsgraph.update()
+            times.append(time.time() - start_time)
+
+        totpoly = len(base.evaluated_get(depsgraph).data.polygons)
+        print_times("%d cutters, %d faces" % (num_cutters, totpoly), times)
+
+
+if __name__ == "__main__":
+    main()
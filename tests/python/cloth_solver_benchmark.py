@@ -0,0 +1,79 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/cloth_solver_benchmark.py -- --vertices=50000 --frames=20
+#
+# Cost of the cloth solver on a dense grid pinned along one edge, with the per substep
+# timings of the cloth modifier solver result.
+
+import math
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments, print_times
+
+
+def build_cloth(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    side = max(int(math.sqrt(args.vertices)), 2)
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=side, y_subdivisions=side, size=2.0)
+    ob = bpy.context.object
+
+    group = ob.vertex_groups.new(name="Pin")
+    group.add([v.index for v in ob.data.vertices if v.co.y > 1.0 - 1e-4], 1.0, 'REPLACE')
+
+    modifier = ob.modifiers.new(name="Cloth", type='CLOTH')
+    modifier.settings.quality = args.quality
+    modifier.settings.vertex_group_mass = group.name
+    modifier.collision_settings.use_collision = False
+    modifier.point_cache.frame_end = args.frames
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+    return scene, ob
+
+
+def main():
+    args = parse_arguments("Cloth solver benchmark", (
+        ("--vertices", 50000, "Approximate number of vertices"),
+        ("--frames", 20, "Number of frames to simulate"),
+        ("--quality", 5, "Substeps per frame"),
+    ))
+    scene, ob = build_cloth(args)
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    scene.frame_set(scene.frame_start)
+
+    frame_times = []
+    totals = {"force_time": 0.0, "solve_time": 0.0, "collision_time": 0.0, "avg_iterations": 0.0}
+    max_substep_time = 0.0
+    for frame in range(scene.frame_start + 1, scene.frame_end + 1):
+        start_time = time.time()
+        scene.frame_set(frame)
+        depsgraph.update()
+        frame_times.append(time.time() - start_time)
+
+        result = ob.evaluated_get(depsgraph).modifiers["Cloth"].solver_result
+        for name in totals:
+            totals[name] += getattr(result, name)
+        max_substep_time = max(max_substep_time, result.max_substep_time)
+    if not frame_times:
+        return
+
+    num_frames = len(frame_times)
+    print("")
+    print("%d vertices, %d frames, %d substeps per frame" %
+          (len(ob.data.vertices), num_frames, args.quality))
+    print_times("Per frame", frame_times)
+    print("Forces:        %.2f ms per frame" % (totals["force_time"] / num_frames * 1000.0))
+    print("Solver:        %.2f ms per frame, %.1f iterations" %
+          (totals["solve_time"] / num_frames * 1000.0, totals["avg_iterations"] / num_frames))
+    print("Collisions:    %.2f ms per frame" % (totals["collision_time"] / num_frames * 1000.0))
+    print("Slowest substep: %.2f ms" % (max_substep_time * 1000.0))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,135 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/cycles_light_tree_benchmark.py -- --lights=1024 --samples=16
+#
+# Convergence of Cycles light sampling in a scene with many lights: renders a reference, then
+# reports error times render time with and without the light tree.
+
+import math
+import os
+import sys
+import tempfile
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments
+
+
+def emission_material(name, color, strength):
+    material = bpy.data.materials.new(name)
+    material.use_nodes = True
+    nodes = material.node_tree.nodes
+    nodes.clear()
+    emission = nodes.new("ShaderNodeEmission")
+    emission.inputs["Color"].default_value = color
+    emission.inputs["Strength"].default_value = strength
+    output = nodes.new("ShaderNodeOutputMaterial")
+    material.node_tree.links.new(emission.outputs["Emission"], output.inputs["Surface"])
+    return material
+
+
+def build_scene(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    bpy.ops.mesh.primitive_plane_add(size=200.0)
+
+    # Grid of lamps, most of which are far away from any given shading point.
+    side = max(int(math.ceil(math.sqrt(args.lights))), 1)
+    for i in range(args.lights):
+        light = bpy.data.lights.new("Light%d" % i, 'SPOT' if i % 3 == 0 else 'POINT')
+        light.energy = 5.0 + (i * 7919 % 100)
+        light.color = ((i * 13 % 7) / 7.0, (i * 17 % 5) / 5.0, 1.0)
+        light.shadow_soft_size = 0.1
+        ob = bpy.data.objects.new("Light%d" % i, light)
+        ob.location = ((i % side) / side * 180.0 - 90.0,
+                       (i // side) / side * 180.0 - 90.0,
+                       1.5 + (i % 5) * 0.5)
+        scene.collection.objects.link(ob)
+
+    # Emissive tiles, sampled as mesh lights.
+    material = emission_material("Emission", (1.0, 0.8, 0.6, 1.0), 5.0)
+    side = max(int(math.ceil(math.sqrt(args.emissive_tiles))), 1)
+    for i in range(args.emissive_tiles):
+        bpy.ops.mesh.primitive_plane_add(
+            size=0.5,
+            location=((i % side) / side * 180.0 - 89.0, (i // side) / side * 180.0 - 89.0, 0.01))
+        bpy.context.object.data.materials.append(material)
+
+    camera_ob = bpy.data.objects.new("Camera", bpy.data.cameras.new("Camera"))
+    camera_ob.location = (0.0, -30.0, 12.0)
+    camera_ob.rotation_euler = (math.radians(70.0), 0.0, 0.0)
+    scene.collection.objects.link(camera_ob)
+    scene.camera = camera_ob
+
+    scene.world = bpy.data.worlds.new("World")
+    scene.world.color = (0.0, 0.0, 0.0)
+
+    scene.render.engine = 'CYCLES'
+    scene.render.resolution_x = args.resolution
+    scene.render.resolution_y = args.resolution
+    scene.render.resolution_percentage = 100
+    scene.render.image_settings.file_format = 'OPEN_EXR'
+    scene.render.image_settings.color_depth = '32'
+    scene.cycles.progressive = 'PATH'
+    scene.cycles.max_bounces = 1
+    scene.cycles.use_denoising = False
+    scene.cycles.light_sampling_threshold = 0.0
+    return scene
+
+
+def render(scene, filepath, samples, use_light_tree):
+    scene.cycles.samples = samples
+    scene.cycles.use_light_tree = use_light_tree
+    scene.render.filepath = filepath
+
+    start_time = time.time()
+    bpy.ops.render.render(write_still=True)
+    render_time = time.time() - start_time
+
+    image = bpy.data.images.load(filepath)
+    pixels = list(image.pixels)
+    bpy.data.images.remove(image)
+    return pixels, render_time
+
+
+def mean_squared_error(pixels, reference):
+    diffs = [pixels[i] - reference[i] for i in range(len(pixels)) if i % 4 != 3]
+    return sum(diff * diff for diff in diffs) / max(len(diffs), 1)
+
+
+def main():
+    args = parse_arguments("Cycles light tree convergence benchmark", (
+        ("--lights", 1024, "Number of lamps"),
+        ("--emissive-tiles", 256, "Number of emissive tiles"),
+        ("--samples", 16, "Samples per measured render"),
+        ("--reference-samples", 1024, "Samples of the reference render"),
+        ("--resolution", 256, "Width and height of the image"),
+    ))
+    scene = build_scene(args)
+
+    print("")
+    print("%d lights, %d emissive tiles, %d samples" %
+          (args.lights, args.emissive_tiles, args.samples))
+    with tempfile.TemporaryDirectory() as tmpdir:
+        reference, _ = render(scene, os.path.join(tmpdir, "reference.exr"),
+                              args.reference_samples, False)
+
+        efficiencies = []
+        for use_light_tree in (False, True):
+            pixels, render_time = render(scene, os.path.join(tmpdir, "image.exr"),
+                                         args.samples, use_light_tree)
+            mse = mean_squared_error(pixels, reference)
+            efficiencies.append(1.0 / (mse * render_time) if mse > 0.0 else float("inf"))
+            print("%-12s %.2f s, MSE %.6g, efficiency %.6g" %
+                  ("Light tree:" if use_light_tree else "Flat CDF:",
+                   render_time, mse, efficiencies[-1]))
+
+    if efficiencies[0] > 0.0:
+        print("Light tree converges %.2fx faster per second" % (efficiencies[1] / efficiencies[0]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,75 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/decimate_benchmark.py -- --subdivisions=8 --ratio=0.1
+#
+# Cost and quality of the collapse decimator, multithreaded and in a Blender started with
+# ``--threads 1``. Reports the time, the resulting face count, and the mean and max distance
+# from the input vertices to the decimated surface.
+
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import evaluate_single_threaded, parse_arguments
+
+
+def build_mesh(subdivisions):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=subdivisions, radius=1.0)
+    ob = bpy.context.object
+
+    # Some displacement, so the decimator has features to preserve.
+    for v in ob.data.vertices:
+        co = v.co
+        v.co = co * (1.0 + 0.05 * ((co.x * 7.0) % 1.0) * ((co.y * 5.0) % 1.0))
+    ob.data.update()
+    return ob
+
+
+def decimate(subdivisions, ratio, use_symmetry):
+    """Decimate and return the time, face counts and distances to the input vertices."""
+    from mathutils.bvhtree import BVHTree
+
+    ob = build_mesh(subdivisions)
+    coords = [v.co.copy() for v in ob.data.vertices]
+
+    mod = ob.modifiers.new("Decimate", 'DECIMATE')
+    mod.ratio = ratio
+    mod.use_symmetry = use_symmetry
+
+    start_time = time.time()
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    elapsed = time.time() - start_time
+
+    tree = BVHTree.FromObject(ob, depsgraph)
+    distances = [tree.find_nearest(co)[3] for co in coords]
+    return {
+        "totpoly_orig": len(ob.data.polygons),
+        "totpoly": len(ob.evaluated_get(depsgraph).data.polygons),
+        "time": elapsed,
+        "distance_mean": sum(distances) / max(len(distances), 1),
+        "distance_max": max(distances, default=0.0),
+    }
+
+
+def main():
+    args = parse_arguments("Decimate benchmark", (
+        ("--subdivisions", 8, "Subdivisions of the input ico sphere"),
+        ("--ratio", 0.1, "Decimate ratio"),
+        ("--symmetry", False, "Use symmetric decimation"),
+    ))
+    decimate_args = (args.subdivisions, args.ratio, args.symmetry)
+
+    print("")
+    for name, result in (("Serial", evaluate_single_threaded(decimate, *decimate_args)),
+                         ("Multithreaded", decimate(*decimate_args))):
+        print("%-14s %d -> %d faces in %.3f s, distance mean %.6f, max %.6f" %
+              (name + ":", result["totpoly_orig"], result["totpoly"], result["time"],
+               result["distance_mean"], result["distance_max"]))
+
+
+if __name__ == "__main__":
+    main()
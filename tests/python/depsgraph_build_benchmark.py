@@ -0,0 +1,127 @@
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Dependency graph construction time for synthetic scenes of increasing size.
+
+For every size a scene is generated with objects sharing a few meshes, some of
+them parented, with modifiers and constraints, spread over collections. The
+relations are then tagged for update and the full rebuild time of the graph is
+reported, as measured by the dependency graph itself.
+
+Only the copy-on-write relations and the finalization of ID nodes are built in
+parallel, run with "--threads 1" to compare against single threaded construction.
+
+Example Usage:
+
+./blender.bin --background --factory-startup \
+    --python tests/python/depsgraph_build_benchmark.py -- \
+    --sizes=1000,10000,100000 --repeat=3
+"""
+
+import os
+import re
+import sys
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments
+
+
+def build_scene(num_objects, args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    bpy.ops.mesh.primitive_cube_add()
+    cube = bpy.context.active_object
+    meshes = [cube.data] + [cube.data.copy() for _ in range(3)]
+    bpy.data.objects.remove(cube)
+
+    collections = []
+    for i in range(args.collections):
+        collection = bpy.data.collections.new("Collection%d" % i)
+        scene.collection.children.link(collection)
+        collections.append(collection)
+
+    previous = None
+    for i in range(num_objects):
+        data = meshes[i % len(meshes)] if i % 5 != 0 else None
+        ob = bpy.data.objects.new("Object%d" % i, data)
+        ob.location = (i % 100, (i // 100) % 100, i // 10000)
+        collections[i % len(collections)].objects.link(ob)
+        if previous is not None and i % 10 == 1:
+            ob.parent = previous
+        if data is not None and i % 7 == 0:
+            ob.modifiers.new("Array", 'ARRAY')
+        if previous is not None and i % 11 == 0:
+            constraint = ob.constraints.new('COPY_ROTATION')
+            constraint.target = previous
+        previous = ob
+
+    return scene
+
+
+def last_build_time(depsgraph):
+    match = re.search(r"Last full build ([0-9.]+) ms", depsgraph.debug_stats())
+    return float(match.group(1)) if match else 0.0
+
+
+def graph_size(depsgraph):
+    match = re.search(r"Approx (\d+) Operations, (\d+) Relations", depsgraph.debug_stats())
+    return (int(match.group(1)), int(match.group(2))) if match else (0, 0)
+
+
+def main():
+    args = parse_arguments("Depsgraph build benchmark", (
+        ("--sizes", "1000,10000,100000",
+         "Comma separated number of objects of the generated scenes"),
+        ("--repeat", 3, "Number of rebuilds per scene"),
+        ("--collections", 100, "Number of collections objects are spread over"),
+    ))
+    sizes = [int(size) for size in args.sizes.split(",") if size]
+
+    print("")
+    print("%10s %12s %12s %12s %12s" %
+          ("Objects", "Operations", "Relations", "Best (ms)", "Avg (ms)"))
+    for num_objects in sizes:
+        scene = build_scene(num_objects, args)
+        depsgraph = bpy.context.evaluated_depsgraph_get()
+
+        timings = []
+        sizes_seen = set()
+        dummy = bpy.data.objects.new("Dummy", None)
+        for _ in range(args.repeat):
+            # Linking an object tags relations of the whole graph for update.
+            scene.collection.objects.link(dummy)
+            scene.collection.objects.unlink(dummy)
+            depsgraph.update()
+            timings.append(last_build_time(depsgraph))
+            sizes_seen.add(graph_size(depsgraph))
+
+        operations, relations = graph_size(depsgraph)
+        print("%10d %12d %12d %12.2f %12.2f" % (num_objects, operations, relations,
+                                               min(timings), sum(timings) / len(timings)))
+        if len(sizes_seen) != 1:
+            print("Graph differs between rebuilds: %r" % sorted(sizes_seen))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,98 @@
+# Apache License, Version 2.0
+
+# <pep8 compliant>
+
+"""
+Shared code of the benchmark scripts, and of tests comparing multithreaded results
+with those of a Blender using a single thread.
+"""
+
+import argparse
+import inspect
+import json
+import subprocess
+import sys
+import time
+
+RESULT_PREFIX = "BENCHMARK_UTILS_RESULT:"
+
+
+def parse_arguments(description, arguments):
+    """
+    Parse the arguments after ``--``. Every argument is a ``(name, default, help)`` tuple,
+    the type is the one of the default, booleans are flags.
+    """
+    argv = sys.argv[sys.argv.index("--") + 1:] if "--" in sys.argv else []
+
+    parser = argparse.ArgumentParser(description=description)
+    for name, default, help_text in arguments:
+        if isinstance(default, bool):
+            parser.add_argument(name, action="store_true", help=help_text)
+        else:
+            parser.add_argument(name, type=type(default), default=default, help=help_text)
+    return parser.parse_args(argv)
+
+
+def time_frames(scene, depsgraph=None):
+    """
+    Step through the frames of the scene after the first one, returning the time of every frame
+    in seconds. When a depsgraph is given, it's updated as part of the frame.
+    """
+    times = []
+    for frame in range(scene.frame_start + 1, scene.frame_end + 1):
+        start_time = time.time()
+        scene.frame_set(frame)
+        if depsgraph is not None:
+            depsgraph.update()
+        times.append(time.time() - start_time)
+    return times
+
+
+def print_times(label, times):
+    if not times:
+        return
+    print("%-14s %.2f ms average, %.2f ms min, %.2f ms max" %
+          (label + ":",
+           sum(times) / len(times) * 1000.0,
+           min(times) * 1000.0,
+           max(times) * 1000.0))
+
+
+def evaluate_single_threaded(function, *args, timeout=600):
+    """
+    Call ``function(*args)`` in a new Blender process started with ``--threads 1``.
+
+    The function is looked up by name in the file it's defined in, its arguments and
+    result must be JSON compatible. Returns the result, converted from JSON.
+    """
+    expr = (
+        "import importlib.util, json\n"
+        "spec = importlib.util.spec_from_file_location('single_threaded', %r)\n"
+        "module = importlib.util.module_from_spec(spec)\n"
+        "spec.loader.exec_module(module)\n"
+        "print('\\n' + %r + json.dumps(module.%s(*json.loads(%r))))\n"
+    ) % (inspect.getsourcefile(function), RESULT_PREFIX, function.__name__, json.dumps(args))
+
+    import bpy
+    proc = subprocess.run(
+        [bpy.app.binary_path, "--background", "-noaudio", "--factory-startup",
+         "--threads", "1", "--python-exit-code", "1", "--python-expr", expr],
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True,
+        timeout=timeout)
+    if proc.returncode:
+        raise RuntimeError("Error %d running Blender:\n%s" % (proc.returncode, proc.stdout))
+
+    for line in reversed(proc.stdout.splitlines()):
+        if line.startswith(RESULT_PREFIX):
+            return json.loads(line[len(RESULT_PREFIX):])
+    raise RuntimeError("No result in the output of Blender:\n%s" % proc.stdout)
+
+
+def compare_single_threaded(function, *args):
+    """
+    Return the results of ``function(*args)`` in this Blender and in one using a single thread
+    (see ``evaluate_single_threaded``). Both are JSON data, floats compare equal only when they
+    are bitwise identical.
+    """
+    result = json.loads(json.dumps(function(*args)))
+    return result, evaluate_single_threaded(function, *args)
@@ -0,0 +1,67 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --log "bke.remesh" --log-level 1 --python tests/python/remesh_benchmark.py -- --subdivisions=8 --voxel-size=0.01 --quad-faces=20000
+#
+# Cost of the voxel and QuadriFlow remeshers on a subdivided, displaced sphere. The time of every
+# remesher stage is logged by the "bke.remesh" logger, enable it to get the per stage timings.
+
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments
+
+
+def build_mesh(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    bpy.ops.mesh.primitive_ico_sphere_add(subdivisions=args.subdivisions, radius=1.0)
+    ob = bpy.context.object
+
+    # Some displacement, so the remeshers do not work on a perfect sphere.
+    for v in ob.data.vertices:
+        co = v.co
+        v.co = co * (1.0 + 0.05 * ((co.x * 7.0) % 1.0) * ((co.y * 5.0) % 1.0))
+    ob.data.update()
+    return ob
+
+
+def remesh(ob, name, operator):
+    mesh = ob.data.copy()
+    ob.data = mesh
+    totpoly = len(mesh.polygons)
+
+    start_time = time.time()
+    result = operator()
+    elapsed = time.time() - start_time
+
+    print("%-12s %s, %d -> %d faces in %.3f s" %
+          (name + ":", ", ".join(result), totpoly, len(ob.data.polygons), elapsed))
+
+
+def main():
+    args = parse_arguments("Remesh benchmark", (
+        ("--subdivisions", 8, "Subdivisions of the input ico sphere"),
+        ("--voxel-size", 0.01, "Voxel remesh voxel size"),
+        ("--quad-faces", 20000, "Target face count of QuadriFlow"),
+        ("--skip-quadriflow", False, "Only run the voxel remesher"),
+    ))
+    ob = build_mesh(args)
+    base_mesh = ob.data
+
+    print("")
+    print("Input: %d vertices, %d faces" % (len(base_mesh.vertices), len(base_mesh.polygons)))
+
+    base_mesh.remesh_voxel_size = args.voxel_size
+    remesh(ob, "Voxel", bpy.ops.object.voxel_remesh)
+
+    if not args.skip_quadriflow:
+        ob.data = base_mesh
+        remesh(ob, "QuadriFlow", lambda: bpy.ops.object.quadriflow_remesh(
+            mode='FACES', target_faces=args.quad_faces, use_paint_symmetry=False))
+
+
+if __name__ == "__main__":
+    main()
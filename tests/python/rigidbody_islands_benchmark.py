@@ -0,0 +1,68 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/rigidbody_islands_benchmark.py -- --stacks=1000 --height=8 --frames=50
+#
+# Cost of the rigid body world with and without multithreaded island solving, on many separate
+# stacks of boxes so the simulation has a lot of independent islands.
+
+import os
+import sys
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments, print_times, time_frames
+
+
+def build_scene(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    side = max(int(args.stacks ** 0.5), 1)
+    bpy.ops.mesh.primitive_plane_add(size=side * 3.0 + 10.0)
+    bpy.ops.rigidbody.object_add(type='PASSIVE')
+
+    bpy.ops.mesh.primitive_cube_add(size=1.0)
+    box = bpy.context.object
+    boxes = []
+    for i in range(args.stacks):
+        for j in range(args.height):
+            ob = box if not boxes else box.copy()
+            ob.location = ((i % side) * 3.0, (i // side) * 3.0, 0.5 + j * 1.05)
+            ob.rotation_euler.z = 0.1 * j
+            if ob is not box:
+                scene.collection.objects.link(ob)
+            boxes.append(ob)
+
+    # Adding objects to the rigid body world one at a time is slow, link them directly,
+    # the simulation gives them rigid body settings.
+    for ob in boxes[1:]:
+        scene.rigidbody_world.collection.objects.link(ob)
+    bpy.context.view_layer.objects.active = box
+    bpy.ops.rigidbody.object_add(type='ACTIVE')
+
+    scene.rigidbody_world.point_cache.frame_start = 1
+    scene.rigidbody_world.point_cache.frame_end = args.frames
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+    return scene, boxes
+
+
+def main():
+    args = parse_arguments("Rigid body islands benchmark", (
+        ("--stacks", 1000, "Number of box stacks"),
+        ("--height", 8, "Boxes per stack"),
+        ("--frames", 50, "Number of frames to simulate"),
+    ))
+
+    print("")
+    print("%d boxes, %d frames" % (args.stacks * args.height, args.frames - 1))
+    for use_multithreading in (False, True):
+        scene, boxes = build_scene(args)
+        scene.rigidbody_world.use_multithreading = use_multithreading
+        scene.frame_set(scene.frame_start)
+        print_times("Multithreaded" if use_multithreading else "Serial", time_frames(scene))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,78 @@
+# Apache License, Version 2.0
+
+# ./blender.bin --background --factory-startup --python tests/python/shape_key_benchmark.py -- --vertices=100000 --keys=300
+#
+# Per-frame cost of shape key evaluation on a facial rig like mesh: most keys are animated
+# correctives moving a small region of the mesh, a few move the whole mesh.
+
+import math
+import os
+import sys
+import time
+
+import bpy
+
+sys.path.append(os.path.dirname(os.path.realpath(__file__)))
+from modules.benchmark_utils import parse_arguments, print_times, time_frames
+
+
+def build_rig(args):
+    bpy.ops.wm.read_factory_settings(use_empty=True)
+    scene = bpy.context.scene
+
+    side = max(int(math.sqrt(args.vertices)), 2)
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=side, y_subdivisions=side, size=2.0)
+    ob = bpy.context.object
+    totvert = len(ob.data.vertices)
+
+    basis_co = [0.0] * (totvert * 3)
+    ob.data.vertices.foreach_get("co", basis_co)
+
+    ob.shape_key_add(name="Basis", from_mix=False)
+    for k in range(args.keys):
+        key_block = ob.shape_key_add(name="Key%d" % k, from_mix=False)
+        co = list(basis_co)
+        if k < args.full_keys:
+            indices = range(totvert)
+        else:
+            first = (k * 7919) % totvert
+            indices = [(first + i) % totvert for i in range(min(args.region, totvert))]
+        for i in indices:
+            co[i * 3 + 2] += 0.01 * math.sin(i * 0.1 + k)
+        key_block.data.foreach_set("co", co)
+
+        for frame in range(1, args.frames + 1, 10):
+            key_block.value = 0.5 + 0.5 * math.sin(frame * 0.3 + k)
+            key_block.keyframe_insert("value", frame=frame)
+
+    scene.frame_start = 1
+    scene.frame_end = args.frames
+    return scene, totvert
+
+
+def main():
+    args = parse_arguments("Shape key evaluation benchmark", (
+        ("--vertices", 100000, "Approximate number of vertices"),
+        ("--keys", 300, "Number of shape keys"),
+        ("--region", 500, "Vertices moved by corrective keys"),
+        ("--full-keys", 10, "Keys moving all vertices"),
+        ("--frames", 50, "Number of frames to evaluate"),
+    ))
+    scene, totvert = build_rig(args)
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+
+    # The first frame converts the shape keys, report it separately.
+    start_time = time.time()
+    scene.frame_set(scene.frame_start)
+    depsgraph.update()
+    first_frame_time = time.time() - start_time
+
+    print("")
+    print("%d vertices, %d shape keys (%d moving all vertices), %d frames" %
+          (totvert, args.keys, args.full_keys, args.frames))
+    print("First frame:   %.2f ms" % (first_frame_time * 1000.0))
+    print_times("Per frame", time_frames(scene, depsgraph))
+
+
+if __name__ == "__main__":
+    main()